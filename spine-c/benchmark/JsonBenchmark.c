@@ -0,0 +1,228 @@
+/* Measures parsing JSON with Json_create, Json_createInArena and Json_createInSitu, and reading skeletons and animations with
+ * SkeletonJson, on the spineboy data and on a generated large skeleton and animation. Prints one JSON object per line:
+ *
+ * {"name": "json.createInArena/spineboy-animation", "iterations": 16384, "nsPerOp": 44210.5}
+ *
+ * SkeletonJson reads into an arena that is disposed after each iteration, so the time includes freeing what was read.
+ *
+ * Usage: spine-c-benchmark [dataDirectory] [nameFilter] [secondsPerBenchmark]
+ * An empty data directory uses the default.
+ * The data directory must contain spineboy-skeleton.json, spineboy-walk.json and spineboy.atlas. Only benchmarks whose name contains
+ * the filter are run. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <time.h>
+#include <spine/spine.h>
+#include <spine/Json.h>
+#include <spine/util.h>
+
+#ifndef SPINE_BENCHMARK_DATA
+#define SPINE_BENCHMARK_DATA "data/"
+#endif
+
+typedef struct {
+	const char* text;
+	size_t length;
+	/* Receives a copy of the text for each in situ parse. */
+	char* buffer;
+	SkeletonJson* json;
+	SkeletonData* skeletonData;
+} Input;
+
+typedef void (*Op) (Input* input);
+
+static const char* filter = "";
+static double secondsPerBenchmark = 0.25;
+
+/* Runs op in batches that double in size until a batch takes secondsPerBenchmark, then reports the last batch. */
+static void run (const char* name, Op op, Input* input) {
+	if (!strstr(name, filter)) return;
+	op(input);
+	long iterations;
+	for (iterations = 1;; iterations *= 2) {
+		clock_t start = clock();
+		long i;
+		for (i = 0; i < iterations; i++)
+			op(input);
+		double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+		if (seconds < secondsPerBenchmark && iterations < (1L << 30)) continue;
+		printf("{\"name\": \"%s\", \"iterations\": %ld, \"nsPerOp\": %.2f}\n", name, iterations, seconds * 1e9 / iterations);
+		fflush(stdout);
+		return;
+	}
+}
+
+static void create (Input* input) {
+	Json_dispose(Json_create(input->text));
+}
+
+static void createInArena (Input* input) {
+	Json_dispose(Json_createInArena(input->text));
+}
+
+static void createInSitu (Input* input) {
+	memcpy(input->buffer, input->text, input->length + 1);
+	Json_dispose(Json_createInSitu(input->buffer));
+}
+
+static void readSkeletonData (Input* input) {
+	Arena* arena = Arena_create(0);
+	Arena* previous = Arena_setCurrent(arena);
+	SkeletonJson_readSkeletonData(input->json, input->text);
+	Arena_setCurrent(previous);
+	Arena_dispose(arena);
+}
+
+static void readAnimation (Input* input) {
+	Arena* arena = Arena_create(0);
+	Arena* previous = Arena_setCurrent(arena);
+	SkeletonJson_readAnimation(input->json, input->text, input->skeletonData);
+	Arena_setCurrent(previous);
+	Arena_dispose(arena);
+}
+
+static void benchmarkParse (const char* suffix, const char* text) {
+	Input input = {0};
+	input.text = text;
+	input.length = strlen(text);
+	input.buffer = (char*)malloc(input.length + 1);
+	char name[256];
+	snprintf(name, sizeof(name), "json.create/%s", suffix);
+	run(name, create, &input);
+	snprintf(name, sizeof(name), "json.createInArena/%s", suffix);
+	run(name, createInArena, &input);
+	snprintf(name, sizeof(name), "json.createInSitu/%s", suffix);
+	run(name, createInSitu, &input);
+	free(input.buffer);
+}
+
+static void benchmarkRig (const char* suffix, SkeletonJson* json, const char* skeletonText, const char* animationText) {
+	benchmarkParse(suffix, skeletonText);
+	char animationSuffix[256];
+	snprintf(animationSuffix, sizeof(animationSuffix), "%s-animation", suffix);
+	benchmarkParse(animationSuffix, animationText);
+
+	Arena* arena = Arena_create(0);
+	Arena* previous = Arena_setCurrent(arena);
+	SkeletonData* skeletonData = SkeletonJson_readSkeletonData(json, skeletonText);
+	Arena_setCurrent(previous);
+	if (!skeletonData) {
+		fprintf(stderr, "Unable to read skeleton %s: %s\n", suffix, json->error);
+		exit(1);
+	}
+
+	Input input = {0};
+	input.json = json;
+	input.skeletonData = skeletonData;
+	char name[256];
+	input.text = skeletonText;
+	snprintf(name, sizeof(name), "skeletonJson.readSkeletonData/%s", suffix);
+	run(name, readSkeletonData, &input);
+	input.text = animationText;
+	snprintf(name, sizeof(name), "skeletonJson.readAnimation/%s", suffix);
+	run(name, readAnimation, &input);
+
+	Arena_dispose(arena);
+}
+
+/**/
+
+typedef struct {
+	char* data;
+	size_t length, capacity;
+} Text;
+
+static void append (Text* text, const char* format, ...) {
+	for (;;) {
+		va_list args;
+		va_start(args, format);
+		int count = vsnprintf(text->data + text->length, text->capacity - text->length, format, args);
+		va_end(args);
+		if (count >= 0 && (size_t)count < text->capacity - text->length) {
+			text->length += count;
+			return;
+		}
+		text->capacity = text->capacity ? text->capacity * 2 : 4096;
+		text->data = (char*)realloc(text->data, text->capacity);
+	}
+}
+
+/* A chain of bones, each the parent of the next. */
+static char* generateSkeleton (int boneCount) {
+	Text text = {0};
+	append(&text, "{\"bones\": [\n\t{\"name\": \"bone0\"}");
+	int i;
+	for (i = 1; i < boneCount; i++) {
+		append(&text, ",\n\t{\"name\": \"bone%d\", \"parent\": \"bone%d\", \"length\": %d, \"x\": %d.5, \"y\": -%d.25, \"rotation\": %d}",
+				i, i - 1, 10 + i % 50, i % 17, i % 13, i % 360);
+	}
+	append(&text, "\n]}\n");
+	return text.data;
+}
+
+/* Rotate and translate timelines for every bone after the root, with curves on every other keyframe. */
+static char* generateAnimation (int boneCount, int frameCount) {
+	Text text = {0};
+	append(&text, "{\"bones\": {");
+	int i, ii;
+	for (i = 1; i < boneCount; i++) {
+		append(&text, "%s\n\t\"bone%d\": {\n\t\t\"rotate\": [", i == 1 ? "" : ",", i);
+		for (ii = 0; ii < frameCount; ii++) {
+			append(&text, "%s\n\t\t\t{\"time\": %.4f, \"angle\": %d.5%s}", ii ? "," : "", ii / 30.f, (i * 7 + ii) % 360,
+					ii % 2 ? ", \"curve\": [0.25, 0, 0.75, 1]" : "");
+		}
+		append(&text, "\n\t\t],\n\t\t\"translate\": [");
+		for (ii = 0; ii < frameCount; ii++) {
+			append(&text, "%s\n\t\t\t{\"time\": %.4f, \"x\": %d.25, \"y\": -%d.75}", ii ? "," : "", ii / 30.f, (i + ii) % 100,
+					(i * 3 + ii) % 100);
+		}
+		append(&text, "\n\t\t]\n\t}");
+	}
+	append(&text, "\n}}\n");
+	return text.data;
+}
+
+static const char* readData (const char* dir, const char* file) {
+	char path[1024];
+	snprintf(path, sizeof(path), "%s%s", dir, file);
+	const char* data = readFile(path);
+	if (!data) {
+		fprintf(stderr, "Unable to read: %s\n", path);
+		exit(1);
+	}
+	return data;
+}
+
+int main (int argc, char** argv) {
+	const char* dir = argc > 1 && argv[1][0] ? argv[1] : SPINE_BENCHMARK_DATA;
+	if (argc > 2) filter = argv[2];
+	if (argc > 3) secondsPerBenchmark = atof(argv[3]);
+
+	char atlasPath[1024];
+	snprintf(atlasPath, sizeof(atlasPath), "%s%s", dir, "spineboy.atlas");
+	Atlas* atlas = Atlas_readAtlasFile(atlasPath);
+	if (!atlas) {
+		fprintf(stderr, "Unable to read: %s\n", atlasPath);
+		return 1;
+	}
+	SkeletonJson* json = SkeletonJson_create(atlas);
+
+	const char* skeletonText = readData(dir, "spineboy-skeleton.json");
+	const char* animationText = readData(dir, "spineboy-walk.json");
+	benchmarkRig("spineboy", json, skeletonText, animationText);
+	FREE(skeletonText)
+	FREE(animationText)
+
+	char* generatedSkeleton = generateSkeleton(2000);
+	char* generatedAnimation = generateAnimation(200, 500);
+	benchmarkRig("generated", json, generatedSkeleton, generatedAnimation);
+	free(generatedSkeleton);
+	free(generatedAnimation);
+
+	SkeletonJson_dispose(json);
+	Atlas_dispose(atlas);
+	return 0;
+}
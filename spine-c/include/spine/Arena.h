@@ -0,0 +1,40 @@
+#ifndef SPINE_ARENA_H_
+#define SPINE_ARENA_H_
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+namespace spine {
+extern "C" {
+#endif
+
+/* A region that many allocations are carved from and that is released in one call. While an arena is current, all runtime
+ * allocations come from it and freeing memory that belongs to any arena does nothing. Everything loaded while it was current, eg
+ * a SkeletonData, an Atlas or a Json tree, is then released by Arena_dispose instead of its dispose function. Dispose functions
+ * that release more than memory, such as an AtlasPage's texture, must still be called before disposing the arena. Each thread has
+ * its own current arena, so threads can load into different arenas at the same time. An arena must not be used by two threads at
+ * once. */
+typedef struct Arena Arena;
+
+/* @param chunkSize The size of the first block of memory, later blocks double in size. 0 for a default. */
+Arena* Arena_create (size_t chunkSize);
+void Arena_dispose (Arena* arena);
+
+/* Makes runtime allocations come from the arena, or from the allocation functions if null. Returns the previous arena. */
+Arena* Arena_setCurrent (Arena* arena);
+Arena* Arena_getCurrent ();
+
+/* Returns the bytes allocated from the arena. */
+size_t Arena_getSize (const Arena* arena);
+
+/* Sets the functions used to allocate and free memory outside of arenas. Defaults to malloc and free. Must be called before
+ * anything is allocated, as memory is freed with the function that is set when it is freed. */
+void _setMalloc (void* (*malloc) (size_t size));
+void _setFree (void (*free) (void* ptr));
+
+#ifdef __cplusplus
+}
+}
+#endif
+
+#endif /* SPINE_ARENA_H_ */
@@ -65,7 +65,11 @@ typedef struct {
 	AtlasRegion* regions;
 } Atlas;
 
+/* Atlases can be read on multiple threads at once, provided AtlasPage_create is thread safe. The calling thread must have no Arena
+ * current. */
 Atlas* Atlas_readAtlas (const char* data);
+/* @param data Does not need to be NUL terminated, eg memory mapped from a file. */
+Atlas* Atlas_readAtlasData (const char* data, int length);
 Atlas* Atlas_readAtlasFile (const char* path);
 void Atlas_dispose (Atlas* atlas);
 
@@ -28,10 +28,18 @@ void Bone_setYDown (int/*bool*/yDown);
 Bone* Bone_create (BoneData* data, Bone* parent);
 void Bone_dispose (Bone* bone);
 
+/* Initializes a bone in memory owned by the caller, eg a Skeleton's bone array.
+ * @param parent May be zero. */
+void _Bone_init (Bone* bone, BoneData* data, Bone* parent);
+
 void Bone_setToBindPose (Bone* bone);
 
 void Bone_updateWorldTransform (Bone* bone, int/*bool*/flipX, int/*bool*/flipY);
 
+/* Updates the world transform of count contiguous bones, in order. Each parent must come before its children, as it does in
+ * SkeletonData. Produces the same results as calling Bone_updateWorldTransform for each bone. */
+void Bone_updateWorldTransforms (Bone* bones, int count, int/*bool*/flipX, int/*bool*/flipY);
+
 #ifdef __cplusplus
 }
 }
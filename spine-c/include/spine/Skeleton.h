@@ -14,6 +14,8 @@ typedef struct Skeleton Skeleton;
 struct Skeleton {
 	SkeletonData* const data;
 
+	/* The bones and slots are each stored contiguously in the same order as the pointers, so bones[0] is the array of all
+	 * bones and slots[0] the array of all slots. The pointers must not be changed, except to reorder drawOrder. */
 	int boneCount;
 	Bone** bones;
 
@@ -8,6 +8,8 @@ namespace spine {
 extern "C" {
 #endif
 
+struct Skeleton;
+
 typedef struct SkinEntry SkinEntry;
 struct SkinEntry {
 	int slotIndex;
@@ -16,19 +18,24 @@ struct SkinEntry {
 	const SkinEntry* next;
 };
 
+/* Attachments are hashed by slot index and name, so lookups don't depend on the number of attachments in the skin. */
 typedef struct {
 	const char* const name;
+	/* In the order the attachments were added. */
 	const SkinEntry* const entries;
 } Skin;
 
 Skin* Skin_create (const char* name);
 void Skin_dispose (Skin* skin);
 
-/* The Skin owns the attachment. */
-void Skin_addAttachment (Skin* skin, int slotIndex, const char* name, Attachment* attachment);
+/* The Skin owns the attachment. Returns 0 and disposes the attachment if memory could not be allocated. */
+int Skin_addAttachment (Skin* skin, int slotIndex, const char* name, Attachment* attachment);
 /* May return null. */
 Attachment* Skin_getAttachment (const Skin* skin, int slotIndex, const char* name);
 
+/* Attach each attachment in this skin if the corresponding attachment in the old skin is currently attached. */
+void Skin_attachAll (const Skin* skin, struct Skeleton* skeleton, const Skin* oldSkin);
+
 #ifdef __cplusplus
 }
 }
@@ -18,11 +18,16 @@ typedef struct {
 	Bone* const bone;
 	float r, g, b, a;
 	Attachment* const attachment;
+
+	float _attachmentTime;
 } Slot;
 
 Slot* Slot_create (SlotData* data, struct Skeleton* skeleton, Bone* bone);
 void Slot_dispose (Slot* slot);
 
+/* Initializes a slot in memory owned by the caller, eg a Skeleton's slot array. */
+void _Slot_init (Slot* slot, SlotData* data, struct Skeleton* skeleton, Bone* bone);
+
 /* @param attachment May be null. */
 void Slot_setAttachment (Slot* slot, Attachment* attachment);
 
@@ -2,6 +2,7 @@
 #define SPINE_SPINE_H_
 
 #include <spine/Animation.h>
+#include <spine/Arena.h>
 #include <spine/Atlas.h>
 #include <spine/AtlasAttachmentLoader.h>
 #include <spine/Attachment.h>
@@ -0,0 +1,84 @@
+#include <spine/Arena.h>
+#include <spine/util.h>
+
+#define DEFAULT_CHUNK_SIZE (64 * 1024)
+#define ALIGNMENT 16
+
+typedef struct ArenaChunk ArenaChunk;
+struct ArenaChunk {
+	ArenaChunk* next;
+	char* start;
+	char* end;
+	char* current;
+};
+
+struct Arena {
+	ArenaChunk* chunks;
+	size_t nextChunkSize;
+	size_t size;
+};
+
+static THREAD_LOCAL Arena* current;
+
+Arena* Arena_create (size_t chunkSize) {
+	Arena* previous = Arena_setCurrent(0);
+	Arena* self = (Arena*)_malloc(sizeof(Arena));
+	Arena_setCurrent(previous);
+	if (!self) return 0;
+	self->chunks = 0;
+	self->nextChunkSize = chunkSize ? chunkSize : DEFAULT_CHUNK_SIZE;
+	self->size = 0;
+	return self;
+}
+
+void Arena_dispose (Arena* self) {
+	if (current == self) current = 0;
+
+	ArenaChunk* chunk = self->chunks;
+	while (chunk) {
+		ArenaChunk* next = chunk->next;
+		_free(chunk);
+		chunk = next;
+	}
+	_free(self);
+}
+
+Arena* Arena_setCurrent (Arena* arena) {
+	Arena* previous = current;
+	current = arena;
+	return previous;
+}
+
+Arena* Arena_getCurrent () {
+	return current;
+}
+
+size_t Arena_getSize (const Arena* self) {
+	return self->size;
+}
+
+void* _Arena_malloc (Arena* self, size_t size) {
+	if (size > (size_t)-1 / 2) return 0;
+	size = (size + ALIGNMENT - 1) & ~(size_t)(ALIGNMENT - 1);
+	ArenaChunk* chunk = self->chunks;
+	if (!chunk || (size_t)(chunk->end - chunk->current) < size) {
+		size_t chunkSize = self->nextChunkSize;
+		if (chunkSize < size) chunkSize = size;
+		size_t headerSize = (sizeof(ArenaChunk) + ALIGNMENT - 1) & ~(size_t)(ALIGNMENT - 1);
+		/* The chunk is allocated outside of any arena. */
+		Arena* previous = Arena_setCurrent(0);
+		chunk = (ArenaChunk*)_malloc(headerSize + chunkSize);
+		Arena_setCurrent(previous);
+		if (!chunk) return 0;
+		chunk->start = (char*)chunk + headerSize;
+		chunk->end = chunk->start + chunkSize;
+		chunk->current = chunk->start;
+		chunk->next = self->chunks;
+		self->chunks = chunk;
+		self->nextChunkSize *= 2;
+	}
+	void* memory = chunk->current;
+	chunk->current += size;
+	self->size += size;
+	return memory;
+}
@@ -38,35 +38,32 @@ typedef struct {
 	const char* end;
 } Str;
 
+/* Parser state, so atlases can be read on multiple threads at once. */
+typedef struct {
+	const char* next;
+	const char* end;
+} Parser;
+
 static void trim (Str* str) {
-	while (isspace(*str->begin) && str->begin < str->end)
-		(str->begin)++;
-	if (str->begin == str->end) return;
-	str->end--;
-	while (isspace(*str->end) && str->end >= str->begin)
+	while (str->begin < str->end && isspace((unsigned char)*str->begin))
+		str->begin++;
+	while (str->end > str->begin && isspace((unsigned char)*(str->end - 1)))
 		str->end--;
-	str->end++;
 }
 
 /* Tokenize string without modification. Returns 0 on failure. */
-static int readLine (const char* data, Str* str) {
-	static const char* nextStart;
-	if (data) {
-		nextStart = data;
-		return 1;
-	}
-	if (*nextStart == '\0') return 0;
-	str->begin = nextStart;
+static int readLine (Parser* parser, Str* str) {
+	if (parser->next == parser->end) return 0;
+	str->begin = parser->next;
 
 	/* Find next delimiter. */
-	do {
-		nextStart++;
-	} while (*nextStart != '\0' && *nextStart != '\n');
+	while (parser->next != parser->end && *parser->next != '\n')
+		parser->next++;
 
-	str->end = nextStart;
+	str->end = parser->next;
 	trim(str);
 
-	if (*nextStart != '\0') nextStart++;
+	if (parser->next != parser->end) parser->next++;
 	return 1;
 }
 
@@ -74,8 +71,8 @@ static int readLine (const char* data, Str* str) {
 static int beginPast (Str* str, char c) {
 	const char* begin = str->begin;
 	while (1) {
-		char lastSkippedChar = *begin;
 		if (begin == str->end) return 0;
+		char lastSkippedChar = *begin;
 		begin++;
 		if (lastSkippedChar == c) break;
 	}
@@ -84,17 +81,17 @@ static int beginPast (Str* str, char c) {
 }
 
 /* Returns 0 on failure. */
-static int readValue (Str* str) {
-	readLine(0, str);
+static int readValue (Parser* parser, Str* str) {
+	if (!readLine(parser, str)) return 0;
 	if (!beginPast(str, ':')) return 0;
 	trim(str);
 	return 1;
 }
 
 /* Returns the number of tuple values read (2, 4, or 0 for failure). */
-static int readTuple (Str tuple[]) {
+static int readTuple (Parser* parser, Str tuple[]) {
 	Str str;
-	readLine(0, &str);
+	if (!readLine(parser, &str)) return 0;
 	if (!beginPast(&str, ':')) return 0;
 	int i = 0;
 	for (i = 0; i < 3; ++i) {
@@ -103,7 +100,7 @@ static int readTuple (Str tuple[]) {
 			if (i == 0) return 0;
 			break;
 		}
-		tuple[i].end = str.begin - 2;
+		tuple[i].end = str.begin - 1;
 		trim(&tuple[i]);
 	}
 	tuple[i].begin = str.begin;
@@ -132,24 +129,73 @@ static int equals (Str* str, const char* other) {
 	return strncmp(other, str->begin, str->end - str->begin) == 0;
 }
 
+/* Doesn't read past str->end, which may not be followed by a NUL. */
 static int toInt (Str* str) {
-	return strtol(str->begin, (char**)&str->end, 10);
+	const char* c = str->begin;
+	int negative = c != str->end && *c == '-';
+	if (negative) c++;
+	int value = 0;
+	while (c != str->end && isdigit((unsigned char)*c))
+		value = value * 10 + (*c++ - '0');
+	return negative ? -value : value;
 }
 
 static const char* formatNames[] = {"Alpha", "Intensity", "LuminanceAlpha", "RGB565", "RGBA4444", "RGB888", "RGBA8888"};
 static const char* textureFilterNames[] = {"Nearest", "Linear", "MipMap", "MipMapNearestNearest", "MipMapLinearNearest",
 		"MipMapNearestLinear", "MipMapLinearLinear"};
 
+typedef struct {
+	Atlas super;
+	/* Power of two, indexed by the hash of the region name. Only the first region with each name is stored. */
+	int regionTableSize;
+	AtlasRegion** regionTable;
+} Internal;
+
+static unsigned int findRegionIndex (const Internal* self, const char* name) {
+	unsigned int mask = self->regionTableSize - 1;
+	unsigned int index = hashString(name) & mask;
+	while (self->regionTable[index] && strcmp(self->regionTable[index]->name, name) != 0)
+		index = (index + 1) & mask;
+	return index;
+}
+
+static int buildRegionTable (Internal* self) {
+	int count = 0;
+	AtlasRegion* region = self->super.regions;
+	for (; region; region = region->next)
+		count++;
+	int size = 16;
+	while (size < count * 2)
+		size *= 2;
+	self->regionTable = CALLOC(AtlasRegion*, size)
+	if (!self->regionTable) return 0;
+	self->regionTableSize = size;
+	for (region = self->super.regions; region; region = region->next) {
+		unsigned int index = findRegionIndex(self, region->name);
+		if (!self->regionTable[index]) self->regionTable[index] = region;
+	}
+	return 1;
+}
+
+static Atlas* abortAtlas (Atlas* self) {
+	Atlas_dispose(self);
+	return 0;
+}
+
 Atlas* Atlas_readAtlas (const char* data) {
-	Atlas* self = CALLOC(Atlas, 1)
+	return Atlas_readAtlasData(data, strlen(data));
+}
+
+Atlas* Atlas_readAtlasData (const char* data, int length) {
+	Atlas* self = (Atlas*)CALLOC(Internal, 1)
+	Parser parser = {data, data + length};
 
 	AtlasPage *page = 0;
 	AtlasPage *lastPage = 0;
 	AtlasRegion *lastRegion = 0;
 	Str str;
 	Str tuple[4];
-	readLine(data, 0);
-	while (readLine(0, &str)) {
+	while (readLine(&parser, &str)) {
 		if (str.end - str.begin == 0) {
 			page = 0;
 		} else if (!page) {
@@ -160,14 +206,14 @@ Atlas* Atlas_readAtlas (const char* data) {
 				self->pages = page;
 			lastPage = page;
 
-			if (!readValue(&str)) return 0;
+			if (!readValue(&parser, &str)) return abortAtlas(self);
 			page->format = (AtlasFormat)indexOf(formatNames, 7, &str);
 
-			if (!readTuple(tuple)) return 0;
+			if (!readTuple(&parser, tuple)) return abortAtlas(self);
 			page->minFilter = (AtlasFilter)indexOf(textureFilterNames, 7, tuple);
 			page->magFilter = (AtlasFilter)indexOf(textureFilterNames, 7, tuple + 1);
 
-			if (!readValue(&str)) return 0;
+			if (!readValue(&parser, &str)) return abortAtlas(self);
 			if (!equals(&str, "none")) {
 				page->uWrap = *str.begin == 'x' ? ATLAS_REPEAT : (*str.begin == 'y' ? ATLAS_CLAMPTOEDGE : ATLAS_REPEAT);
 				page->vWrap = *str.begin == 'x' ? ATLAS_CLAMPTOEDGE : (*str.begin == 'y' ? ATLAS_REPEAT : ATLAS_REPEAT);
@@ -183,19 +229,19 @@ Atlas* Atlas_readAtlas (const char* data) {
 			region->page = page;
 			region->name = mallocString(&str);
 
-			if (!readValue(&str)) return 0;
+			if (!readValue(&parser, &str)) return abortAtlas(self);
 			region->rotate = equals(&str, "true");
 
-			if (readTuple(tuple) != 2) return 0;
+			if (readTuple(&parser, tuple) != 2) return abortAtlas(self);
 			region->x = toInt(tuple);
 			region->y = toInt(tuple + 1);
 
-			if (readTuple(tuple) != 2) return 0;
+			if (readTuple(&parser, tuple) != 2) return abortAtlas(self);
 			region->width = toInt(tuple);
 			region->height = toInt(tuple + 1);
 
 			int count;
-			if (!(count = readTuple(tuple))) return 0;
+			if (!(count = readTuple(&parser, tuple))) return abortAtlas(self);
 			if (count == 4) { /* split is optional */
 				region->splits = MALLOC(int, 4)
 				region->splits[0] = toInt(tuple);
@@ -203,7 +249,7 @@ Atlas* Atlas_readAtlas (const char* data) {
 				region->splits[2] = toInt(tuple + 2);
 				region->splits[3] = toInt(tuple + 3);
 
-				if (!(count = readTuple(tuple))) return 0;
+				if (!(count = readTuple(&parser, tuple))) return abortAtlas(self);
 				if (count == 4) { /* pad is optional, but only present with splits */
 					region->pads = MALLOC(int, 4)
 					region->pads[0] = toInt(tuple);
@@ -211,22 +257,23 @@ Atlas* Atlas_readAtlas (const char* data) {
 					region->pads[2] = toInt(tuple + 2);
 					region->pads[3] = toInt(tuple + 3);
 
-					if (!readTuple(tuple)) return 0;
+					if (!readTuple(&parser, tuple)) return abortAtlas(self);
 				}
 			}
 
 			region->originalWidth = toInt(tuple);
 			region->originalHeight = toInt(tuple + 1);
 
-			readTuple(tuple);
+			readTuple(&parser, tuple);
 			region->offsetX = (float)toInt(tuple);
 			region->offsetY = (float)toInt(tuple + 1);
 
-			if (!readValue(&str)) return 0;
+			if (!readValue(&parser, &str)) return abortAtlas(self);
 			region->index = toInt(&str);
 		}
 	}
 
+	if (!buildRegionTable((Internal*)self)) return abortAtlas(self);
 	return self;
 }
 
@@ -241,14 +288,11 @@ Atlas* Atlas_readAtlasFile (const char* path) {
 void Atlas_dispose (Atlas* self) {
 	if (self->pages) AtlasPage_dispose(self->pages);
 	if (self->regions) AtlasRegion_dispose(self->regions);
+	FREE(((Internal*)self)->regionTable)
 	FREE(self)
 }
 
 AtlasRegion* Atlas_findRegion (const Atlas* self, const char* name) {
-	AtlasRegion* region = self->regions;
-	while (region) {
-		if (strcmp(region->name, name) == 0) return region;
-		region = region->next;
-	}
-	return 0;
+	const Internal* internal = (const Internal*)self;
+	return internal->regionTable[findRegionIndex(internal, name)];
 }
@@ -10,11 +10,15 @@ void Bone_setYDown (int value) {
 
 Bone* Bone_create (BoneData* data, Bone* parent) {
 	Bone* self = CALLOC(Bone, 1)
+	_Bone_init(self, data, parent);
+	return self;
+}
+
+void _Bone_init (Bone* self, BoneData* data, Bone* parent) {
 	CAST(BoneData*, self->data) = data;
 	CAST(Bone*, self->parent) = parent;
 	self->scaleX = 1;
 	self->scaleY = 1;
-	return self;
 }
 
 void Bone_dispose (Bone* self) {
@@ -63,3 +67,38 @@ void Bone_updateWorldTransform (Bone* self, int flipX, int flipY) {
 		CAST(float, self->m11) = -self->m11;
 	}
 }
+
+void Bone_updateWorldTransforms (Bone* bones, int count, int flipX, int flipY) {
+	/* Negating is exact, so the flips are applied as signs instead of branches per bone. */
+	float signX = flipX ? -1.0f : 1.0f;
+	float signY = !flipY != !yDown ? -1.0f : 1.0f;
+	Bone* end = bones + count;
+	Bone* self;
+	for (self = bones; self != end; ++self) {
+		const Bone* parent = self->parent;
+		float worldRotation, worldScaleX, worldScaleY;
+		if (parent) {
+			CAST(float, self->worldX) = self->x * parent->m00 + self->y * parent->m01 + parent->worldX;
+			CAST(float, self->worldY) = self->x * parent->m10 + self->y * parent->m11 + parent->worldY;
+			worldScaleX = parent->worldScaleX * self->scaleX;
+			worldScaleY = parent->worldScaleY * self->scaleY;
+			worldRotation = parent->worldRotation + self->rotation;
+		} else {
+			CAST(float, self->worldX) = self->x;
+			CAST(float, self->worldY) = self->y;
+			worldScaleX = self->scaleX;
+			worldScaleY = self->scaleY;
+			worldRotation = self->rotation;
+		}
+		CAST(float, self->worldScaleX) = worldScaleX;
+		CAST(float, self->worldScaleY) = worldScaleY;
+		CAST(float, self->worldRotation) = worldRotation;
+		float radians = (float)(worldRotation * 3.1415926535897932385 / 180);
+		float cosine = cosf(radians);
+		float sine = sinf(radians);
+		CAST(float, self->m00) = cosine * worldScaleX * signX;
+		CAST(float, self->m01) = -sine * worldScaleY * signX;
+		CAST(float, self->m10) = sine * worldScaleX * signY;
+		CAST(float, self->m11) = cosine * worldScaleY * signY;
+	}
+}
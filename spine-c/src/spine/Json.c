@@ -31,8 +31,10 @@
 #include <float.h>
 #include <limits.h>
 #include <ctype.h>
+#include <spine/util.h>
 
-static const char* ep;
+/* Per thread, so concurrent parses don't overwrite each other's error. */
+static THREAD_LOCAL const char* ep;
 
 const char* Json_getError (void) {
 	return ep;
@@ -46,20 +48,44 @@ static int Json_strcasecmp (const char* s1, const char* s2) {
 	return tolower(*(const unsigned char*)s1) - tolower(*(const unsigned char*)s2);
 }
 
+/* Objects with at least this many items are indexed when parsed in situ. */
+#define INDEX_MIN_SIZE 8
+
+/* Case insensitive, to match Json_getItem. */
+static unsigned int hashName (const char* name) {
+	unsigned int hash = 2166136261u;
+	while (*name) {
+		hash ^= (unsigned char)tolower(*(const unsigned char*)name++);
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+static int indexSize (int size) {
+	int indexSize = INDEX_MIN_SIZE * 2;
+	while (indexSize < size * 2)
+		indexSize *= 2;
+	return indexSize;
+}
+
 /* Internal constructor. */
 static Json *Json_create_Item (void) {
-	return (Json*)calloc(1, sizeof(Json));
+	return (Json*)_calloc(1, sizeof(Json));
 }
 
 /* Delete a Json structure. */
 void Json_dispose (Json *c) {
+	if (c && c->arena) {
+		Arena_dispose(c->arena);
+		return;
+	}
 	Json *next;
 	while (c) {
 		next = c->next;
 		if (c->child) Json_dispose(c->child);
-		if (c->valuestring) free((char*)c->valuestring);
-		if (c->name) free((char*)c->name);
-		free(c);
+		if (c->valuestring) _free((char*)c->valuestring);
+		if (c->name) _free((char*)c->name);
+		_free(c);
 		c = next;
 	}
 }
@@ -101,7 +127,7 @@ static const char* parse_number (Json *item, const char* num) {
 
 /* Parse the input text into an unescaped cstring, and populate item. */
 static const unsigned char firstByteMark[7] = {0x00, 0x00, 0xC0, 0xE0, 0xF0, 0xF8, 0xFC};
-static const char* parse_string (Json *item, const char* str) {
+static const char* parse_string (Json *item, const char* str, int inSitu) {
 	const char* ptr = str + 1;
 	char* ptr2;
 	char* out;
@@ -115,7 +141,8 @@ static const char* parse_string (Json *item, const char* str) {
 	while (*ptr != '\"' && *ptr && ++len)
 		if (*ptr++ == '\\') ptr++; /* Skip escaped quotes. */
 
-	out = (char*)malloc(len + 1); /* This is how long we need for the string, roughly. */
+	/* Unescaping never makes the string longer, so in situ it is written over itself. */
+	out = inSitu ? (char*)str + 1 : (char*)_malloc(len + 1); /* This is how long we need for the string, roughly. */
 	if (!out) return 0;
 
 	ptr = str + 1;
@@ -186,17 +213,17 @@ static const char* parse_string (Json *item, const char* str) {
 			ptr++;
 		}
 	}
-	*ptr2 = 0;
 	if (*ptr == '\"') ptr++;
+	*ptr2 = 0; /* In situ this may overwrite the closing quote. */
 	item->valuestring = out;
 	item->type = Json_String;
 	return ptr;
 }
 
 /* Predeclare these prototypes. */
-static const char* parse_value (Json *item, const char* value);
-static const char* parse_array (Json *item, const char* value);
-static const char* parse_object (Json *item, const char* value);
+static const char* parse_value (Json *item, const char* value, int inSitu);
+static const char* parse_array (Json *item, const char* value, int inSitu);
+static const char* parse_object (Json *item, const char* value, int inSitu);
 
 /* Utility to jump whitespace and cr/lf */
 static const char* skip (const char* in) {
@@ -212,7 +239,7 @@ Json *Json_create (const char* value) {
 	ep = 0;
 	if (!c) return 0; /* memory fail */
 
-	end = parse_value(c, skip(value));
+	end = parse_value(c, skip(value), 0);
 	if (!end) {
 		Json_dispose(c);
 		return 0;
@@ -221,8 +248,45 @@ Json *Json_create (const char* value) {
 	return c;
 }
 
+/* Parses value in situ with everything allocated from the arena, which the returned root owns. On failure ep is moved to the same
+ * position in input, which value is a copy of, since value may be freed with the arena. */
+static Json* create_in_situ (Arena* arena, char* value, const char* input) {
+	Json *c = 0;
+	ep = 0;
+	Arena* previous = Arena_setCurrent(arena);
+	if (value) {
+		c = Json_create_Item();
+		if (c && !parse_value(c, skip(value), 1)) c = 0; /* parse failure. ep is set. */
+	}
+	Arena_setCurrent(previous);
+	if (!c) {
+		if (ep) ep = input + (ep - value);
+		Arena_dispose(arena);
+		return 0;
+	}
+	c->arena = arena;
+	return c;
+}
+
+Json* Json_createInSitu (char* value) {
+	Arena* arena = Arena_create(0);
+	if (!arena) return 0;
+	return create_in_situ(arena, value, value);
+}
+
+Json* Json_createInArena (const char* value) {
+	Arena* arena = Arena_create(0);
+	if (!arena) return 0;
+	Arena* previous = Arena_setCurrent(arena);
+	size_t length = strlen(value) + 1;
+	char* copy = (char*)_malloc(length);
+	Arena_setCurrent(previous);
+	if (copy) memcpy(copy, value, length);
+	return create_in_situ(arena, copy, value);
+}
+
 /* Parser core - when encountering text, process appropriately. */
-static const char* parse_value (Json *item, const char* value) {
+static const char* parse_value (Json *item, const char* value, int inSitu) {
 	if (!value) return 0; /* Fail on null. */
 	if (!strncmp(value, "null", 4)) {
 		item->type = Json_NULL;
@@ -238,16 +302,16 @@ static const char* parse_value (Json *item, const char* value) {
 		return value + 4;
 	}
 	if (*value == '\"') {
-		return parse_string(item, value);
+		return parse_string(item, value, inSitu);
 	}
 	if (*value == '-' || (*value >= '0' && *value <= '9')) {
 		return parse_number(item, value);
 	}
 	if (*value == '[') {
-		return parse_array(item, value);
+		return parse_array(item, value, inSitu);
 	}
 	if (*value == '{') {
-		return parse_object(item, value);
+		return parse_object(item, value, inSitu);
 	}
 
 	ep = value;
@@ -255,7 +319,7 @@ static const char* parse_value (Json *item, const char* value) {
 }
 
 /* Build an array from input text. */
-static const char* parse_array (Json *item, const char* value) {
+static const char* parse_array (Json *item, const char* value, int inSitu) {
 	Json *child;
 	if (*value != '[') {
 		ep = value;
@@ -268,7 +332,8 @@ static const char* parse_array (Json *item, const char* value) {
 
 	item->child = child = Json_create_Item();
 	if (!item->child) return 0; /* memory fail */
-	value = skip(parse_value(child, skip(value))); /* skip any spacing, get the value. */
+	item->size = 1;
+	value = skip(parse_value(child, skip(value), inSitu)); /* skip any spacing, get the value. */
 	if (!value) return 0;
 
 	while (*value == ',') {
@@ -277,7 +342,8 @@ static const char* parse_array (Json *item, const char* value) {
 		child->next = new_item;
 		new_item->prev = child;
 		child = new_item;
-		value = skip(parse_value(child, skip(value + 1)));
+		item->size++;
+		value = skip(parse_value(child, skip(value + 1), inSitu));
 		if (!value) return 0; /* memory fail */
 	}
 
@@ -287,7 +353,22 @@ static const char* parse_array (Json *item, const char* value) {
 }
 
 /* Build an object from the text. */
-static const char* parse_object (Json *item, const char* value) {
+/* Returns 0 if memory could not be allocated. */
+static int index_object (Json *item) {
+	int mask = indexSize(item->size) - 1;
+	item->index = (Json**)_calloc(mask + 1, sizeof(Json*));
+	if (!item->index) return 0;
+	Json *c = item->child;
+	for (; c; c = c->next) {
+		int i = hashName(c->name) & mask;
+		while (item->index[i] && Json_strcasecmp(item->index[i]->name, c->name))
+			i = (i + 1) & mask;
+		if (!item->index[i]) item->index[i] = c; /* Json_getItem returns the first item with a name. */
+	}
+	return 1;
+}
+
+static const char* parse_object (Json *item, const char* value, int inSitu) {
 	Json *child;
 	if (*value != '{') {
 		ep = value;
@@ -300,7 +381,8 @@ static const char* parse_object (Json *item, const char* value) {
 
 	item->child = child = Json_create_Item();
 	if (!item->child) return 0;
-	value = skip(parse_string(child, skip(value)));
+	item->size = 1;
+	value = skip(parse_string(child, skip(value), inSitu));
 	if (!value) return 0;
 	child->name = child->valuestring;
 	child->valuestring = 0;
@@ -308,7 +390,7 @@ static const char* parse_object (Json *item, const char* value) {
 		ep = value;
 		return 0;
 	} /* fail! */
-	value = skip(parse_value(child, skip(value + 1))); /* skip any spacing, get the value. */
+	value = skip(parse_value(child, skip(value + 1), inSitu)); /* skip any spacing, get the value. */
 	if (!value) return 0;
 
 	while (*value == ',') {
@@ -317,7 +399,8 @@ static const char* parse_object (Json *item, const char* value) {
 		child->next = new_item;
 		new_item->prev = child;
 		child = new_item;
-		value = skip(parse_string(child, skip(value + 1)));
+		item->size++;
+		value = skip(parse_string(child, skip(value + 1), inSitu));
 		if (!value) return 0;
 		child->name = child->valuestring;
 		child->valuestring = 0;
@@ -325,22 +408,21 @@ static const char* parse_object (Json *item, const char* value) {
 			ep = value;
 			return 0;
 		} /* fail! */
-		value = skip(parse_value(child, skip(value + 1))); /* skip any spacing, get the value. */
+		value = skip(parse_value(child, skip(value + 1), inSitu)); /* skip any spacing, get the value. */
 		if (!value) return 0;
 	}
 
-	if (*value == '}') return value + 1; /* end of array */
+	if (*value == '}') {
+		if (inSitu && item->size >= INDEX_MIN_SIZE && !index_object(item)) return 0;
+		return value + 1; /* end of array */
+	}
 	ep = value;
 	return 0; /* malformed. */
 }
 
 /* Get Array size/item / object item. */
 int Json_getSize (Json *array) {
-	Json *c = array->child;
-	int i = 0;
-	while (c)
-		i++, c = c->next;
-	return i;
+	return array->size;
 }
 
 Json *Json_getItemAt (Json *array, int item) {
@@ -351,6 +433,14 @@ Json *Json_getItemAt (Json *array, int item) {
 }
 
 Json *Json_getItem (Json *object, const char* string) {
+	if (object->index) {
+		int mask = indexSize(object->size) - 1;
+		int i = hashName(string) & mask;
+		Json *c;
+		while ((c = object->index[i]) && Json_strcasecmp(c->name, string))
+			i = (i + 1) & mask;
+		return c;
+	}
 	Json *c = object->child;
 	while (c && Json_strcasecmp(c->name, string))
 		c = c->next;
@@ -54,11 +54,22 @@ typedef struct Json {
 	float valuefloat; /* The item's number, if type==Json_Number */
 
 	const char* name; /* The item's name string, if this item is the child of, or is in the list of subitems of an object. */
+
+	int size; /* The number of items in an array or object. */
+	struct Json** index; /* Hash table of the items in a large object, if parsed with Json_createInSitu. */
+	struct Arena* arena; /* Holds the whole tree, set on the root if parsed with Json_createInSitu. */
 } Json;
 
 /* Supply a block of JSON, and this returns a Json object you can interrogate. Call Json_dispose when finished. */
 extern Json* Json_create (const char* value);
 
+/* Like Json_create, but the value is modified and the returned strings point into it, so it must outlive the Json. All items
+ * are allocated from one arena which Json_dispose frees at once, and objects with many items are indexed by name. */
+extern Json* Json_createInSitu (char* value);
+
+/* Like Json_createInSitu, but first copies the value into the arena. */
+extern Json* Json_createInArena (const char* value);
+
 /* Delete a Json entity and all subentities. */
 extern void Json_dispose (Json* json);
 
@@ -74,7 +85,7 @@ extern const char* Json_getString (Json* json, const char* name, const char* def
 extern float Json_getFloat (Json* json, const char* name, float defaultValue);
 extern int Json_getInt (Json* json, const char* name, int defaultValue);
 
-/* For analysing failed parses. This returns a pointer to the parse error. You'll probably need to look a few chars back to make sense of it. Defined when Json_create() returns 0. 0 when Json_create() succeeds. */
+/* For analysing failed parses. This returns a pointer to the parse error. You'll probably need to look a few chars back to make sense of it. Defined when Json_create() returns 0. 0 when Json_create() succeeds. After Json_createInArena() fails it points into the value passed to it. Each thread has its own error. */
 extern const char* Json_getError (void);
 
 #ifdef __cplusplus
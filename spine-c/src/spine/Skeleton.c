@@ -1,59 +1,72 @@
 #include <spine/Skeleton.h>
 #include <spine/util.h>
 
+typedef struct {
+	const BoneData* data;
+	int index;
+} BoneIndex;
+
+static int compareBoneIndex (const void* a, const void* b) {
+	const BoneData* dataA = ((const BoneIndex*)a)->data;
+	const BoneData* dataB = ((const BoneIndex*)b)->data;
+	return dataA < dataB ? -1 : (dataA > dataB ? 1 : 0);
+}
+
+/* Returns -1 if boneData is not in the sorted index. */
+static int findBoneIndex (const BoneIndex* index, int count, const BoneData* boneData) {
+	BoneIndex key = {boneData, 0};
+	const BoneIndex* found = (const BoneIndex*)bsearch(&key, index, count, sizeof(BoneIndex), compareBoneIndex);
+	return found ? found->index : -1;
+}
+
 void _Skeleton_init (Skeleton* self, SkeletonData* data) {
 	CAST(SkeletonData*, self->data) = data;
+	self->boneCount = data->boneCount;
+	self->slotCount = data->slotCount;
 
-	self->boneCount = self->data->boneCount;
-	self->bones = MALLOC(Bone*, self->boneCount)
-	int i, ii;
-	for (i = 0; i < self->boneCount; ++i) {
-		BoneData* boneData = self->data->bones[i];
+	/* The pointer arrays and the bones and slots they point to are a single allocation, with the bones and slots contiguous. */
+	int boneCount = self->boneCount, slotCount = self->slotCount;
+	char* memory = (char*)_calloc(1, sizeof(Bone*) * boneCount + sizeof(Slot*) * slotCount * 2 + sizeof(Bone) * boneCount
+			+ sizeof(Slot) * slotCount);
+	self->bones = (Bone**)memory;
+	self->slots = (Slot**)(self->bones + boneCount);
+	self->drawOrder = self->slots + slotCount;
+	Bone* bones = (Bone*)(self->drawOrder + slotCount);
+	Slot* slots = (Slot*)(bones + boneCount);
+
+	/* Maps bone data to bone index, to find parents and slot bones. */
+	BoneIndex* boneIndex = MALLOC(BoneIndex, boneCount)
+	int i;
+	for (i = 0; i < boneCount; ++i) {
+		boneIndex[i].data = data->bones[i];
+		boneIndex[i].index = i;
+	}
+	qsort(boneIndex, boneCount, sizeof(BoneIndex), compareBoneIndex);
+
+	for (i = 0; i < boneCount; ++i) {
+		BoneData* boneData = data->bones[i];
 		Bone* parent = 0;
 		if (boneData->parent) {
-			/* Find parent bone. */
-			for (ii = 0; ii < self->boneCount; ++ii) {
-				if (data->bones[ii] == boneData->parent) {
-					parent = self->bones[ii];
-					break;
-				}
-			}
+			int parentIndex = findBoneIndex(boneIndex, boneCount, boneData->parent);
+			if (parentIndex != -1) parent = bones + parentIndex;
 		}
-		self->bones[i] = Bone_create(boneData, parent);
+		_Bone_init(bones + i, boneData, parent);
+		self->bones[i] = bones + i;
 	}
 
-	self->slotCount = data->slotCount;
-	self->slots = MALLOC(Slot*, self->slotCount)
-	for (i = 0; i < self->slotCount; ++i) {
+	for (i = 0; i < slotCount; ++i) {
 		SlotData *slotData = data->slots[i];
-
-		/* Find bone for the slotData's boneData. */
-		Bone *bone;
-		for (ii = 0; ii < self->boneCount; ++ii) {
-			if (data->bones[ii] == slotData->boneData) {
-				bone = self->bones[ii];
-				break;
-			}
-		}
-
-		self->slots[i] = Slot_create(slotData, self, bone);
+		int index = findBoneIndex(boneIndex, boneCount, slotData->boneData);
+		_Slot_init(slots + i, slotData, self, index == -1 ? 0 : bones + index);
+		self->slots[i] = slots + i;
+		self->drawOrder[i] = slots + i;
 	}
 
-	self->drawOrder = MALLOC(Slot*, self->slotCount)
-	memcpy(self->drawOrder, self->slots, sizeof(Slot*) * self->slotCount);
+	FREE(boneIndex)
 }
 
 void _Skeleton_deinit (Skeleton* self) {
-	int i;
-	for (i = 0; i < self->boneCount; ++i)
-		Bone_dispose(self->bones[i]);
 	FREE(self->bones)
-
-	for (i = 0; i < self->slotCount; ++i)
-		Slot_dispose(self->slots[i]);
-	FREE(self->slots)
-
-	FREE(self->drawOrder)
 }
 
 void Skeleton_dispose (Skeleton* self) {
@@ -61,9 +74,7 @@ void Skeleton_dispose (Skeleton* self) {
 }
 
 void Skeleton_updateWorldTransform (const Skeleton* self) {
-	int i;
-	for (i = 0; i < self->boneCount; ++i)
-		Bone_updateWorldTransform(self->bones[i], self->flipX, self->flipY);
+	if (self->boneCount) Bone_updateWorldTransforms(self->bones[0], self->boneCount, self->flipX, self->flipY);
 }
 
 void Skeleton_setToBindPose (const Skeleton* self) {
@@ -91,28 +102,28 @@ Bone* Skeleton_getRootBone (const Skeleton* self) {
 Bone* Skeleton_findBone (const Skeleton* self, const char* boneName) {
 	int i;
 	for (i = 0; i < self->boneCount; ++i)
-		if (self->data->bones[i]->name == boneName) return self->bones[i];
+		if (strcmp(self->data->bones[i]->name, boneName) == 0) return self->bones[i];
 	return 0;
 }
 
 int Skeleton_findBoneIndex (const Skeleton* self, const char* boneName) {
 	int i;
 	for (i = 0; i < self->boneCount; ++i)
-		if (self->data->bones[i]->name == boneName) return i;
+		if (strcmp(self->data->bones[i]->name, boneName) == 0) return i;
 	return -1;
 }
 
 Slot* Skeleton_findSlot (const Skeleton* self, const char* slotName) {
 	int i;
 	for (i = 0; i < self->slotCount; ++i)
-		if (self->data->slots[i]->name == slotName) return self->slots[i];
+		if (strcmp(self->data->slots[i]->name, slotName) == 0) return self->slots[i];
 	return 0;
 }
 
 int Skeleton_findSlotIndex (const Skeleton* self, const char* slotName) {
 	int i;
 	for (i = 0; i < self->slotCount; ++i)
-		if (self->data->slots[i]->name == slotName) return i;
+		if (strcmp(self->data->slots[i]->name, slotName) == 0) return i;
 	return -1;
 }
 
@@ -124,18 +135,7 @@ int Skeleton_setSkinByName (Skeleton* self, const char* skinName) {
 }
 
 void Skeleton_setSkin (Skeleton* self, Skin* newSkin) {
-	if (self->skin && newSkin) {
-		/* Attach each attachment in the new skin if the corresponding attachment in the old skin is currently attached. */
-		const SkinEntry *entry = self->skin->entries;
-		while (entry) {
-			Slot *slot = self->slots[entry->slotIndex];
-			if (slot->attachment == entry->attachment) {
-				Attachment *attachment = Skin_getAttachment(newSkin, entry->slotIndex, entry->name);
-				if (attachment) Slot_setAttachment(slot, attachment);
-			}
-			entry = entry->next;
-		}
-	}
+	if (self->skin && newSkin) Skin_attachAll(newSkin, self, self->skin);
 	CAST(Skin*, self->skin) = newSkin;
 }
 
@@ -161,7 +161,7 @@ int Skeleton_setAttachment (Skeleton* self, const char* slotName, const char* at
 	int i;
 	for (i = 0; i < self->slotCount; ++i) {
 		Slot *slot = self->slots[i];
-		if (slot->data->name == slotName) {
+		if (strcmp(slot->data->name, slotName) == 0) {
 			Attachment* attachment = Skeleton_getAttachmentForSlotIndex(self, i, attachmentName);
 			if (!attachment) return 0;
 			Slot_setAttachment(slot, attachment);
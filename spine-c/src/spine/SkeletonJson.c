@@ -70,7 +70,7 @@ SkeletonData* SkeletonJson_readSkeletonData (SkeletonJson* self, const char* jso
 	FREE(self->error)
 	CAST(char*, self->error) = 0;
 
-	Json* root = Json_create(json);
+	Json* root = Json_createInArena(json);
 	if (!root) {
 		_SkeletonJson_setError(self, 0, "Invalid skeleton JSON: ", Json_getError());
 		return 0;
@@ -82,9 +82,8 @@ SkeletonData* SkeletonJson_readSkeletonData (SkeletonJson* self, const char* jso
 	Json* bones = Json_getItem(root, "bones");
 	int boneCount = Json_getSize(bones);
 	skeletonData->bones = MALLOC(BoneData*, boneCount)
-	for (i = 0; i < boneCount; ++i) {
-		Json* boneMap = Json_getItemAt(bones, i);
-
+	Json* boneMap = bones->child;
+	for (i = 0; i < boneCount; ++i, boneMap = boneMap->next) {
 		const char* boneName = Json_getString(boneMap, "name", 0);
 
 		BoneData* parent = 0;
@@ -99,7 +98,7 @@ SkeletonData* SkeletonJson_readSkeletonData (SkeletonJson* self, const char* jso
 		}
 
 		BoneData* boneData = BoneData_create(boneName, parent);
-		boneData->length = Json_getFloat(boneMap, "parent", 0) * self->scale;
+		boneData->length = Json_getFloat(boneMap, "length", 0) * self->scale;
 		boneData->x = Json_getFloat(boneMap, "x", 0) * self->scale;
 		boneData->y = Json_getFloat(boneMap, "y", 0) * self->scale;
 		boneData->rotation = Json_getFloat(boneMap, "rotation", 0);
@@ -114,9 +113,8 @@ SkeletonData* SkeletonJson_readSkeletonData (SkeletonJson* self, const char* jso
 	if (slots) {
 		int slotCount = Json_getSize(slots);
 		skeletonData->slots = MALLOC(SlotData*, slotCount)
-		for (i = 0; i < slotCount; ++i) {
-			Json* slotMap = Json_getItemAt(slots, i);
-
+		Json* slotMap = slots->child;
+		for (i = 0; i < slotCount; ++i, slotMap = slotMap->next) {
 			const char* slotName = Json_getString(slotMap, "name", 0);
 
 			const char* boneName = Json_getString(slotMap, "bone", 0);
@@ -149,8 +147,8 @@ SkeletonData* SkeletonJson_readSkeletonData (SkeletonJson* self, const char* jso
 	if (skinsMap) {
 		int skinCount = Json_getSize(skinsMap);
 		skeletonData->skins = MALLOC(Skin*, skinCount)
-		for (i = 0; i < skinCount; ++i) {
-			Json* slotMap = Json_getItemAt(skinsMap, i);
+		Json* slotMap = skinsMap->child;
+		for (i = 0; i < skinCount; ++i, slotMap = slotMap->next) {
 			const char* skinName = slotMap->name;
 			Skin *skin = Skin_create(skinName);
 			skeletonData->skins[i] = skin;
@@ -158,14 +156,14 @@ SkeletonData* SkeletonJson_readSkeletonData (SkeletonJson* self, const char* jso
 			if (strcmp(skinName, "default") == 0) skeletonData->defaultSkin = skin;
 
 			int slotNameCount = Json_getSize(slotMap);
-			for (ii = 0; ii < slotNameCount; ++ii) {
-				Json* attachmentsMap = Json_getItemAt(slotMap, ii);
+			Json* attachmentsMap = slotMap->child;
+			for (ii = 0; ii < slotNameCount; ++ii, attachmentsMap = attachmentsMap->next) {
 				const char* slotName = attachmentsMap->name;
 				int slotIndex = SkeletonData_findSlotIndex(skeletonData, slotName);
 
 				int attachmentCount = Json_getSize(attachmentsMap);
-				for (iii = 0; iii < attachmentCount; ++iii) {
-					Json* attachmentMap = Json_getItemAt(attachmentsMap, iii);
+				Json* attachmentMap = attachmentsMap->child;
+				for (iii = 0; iii < attachmentCount; ++iii, attachmentMap = attachmentMap->next) {
 					const char* skinAttachmentName = attachmentMap->name;
 					const char* attachmentName = Json_getString(attachmentMap, "name", skinAttachmentName);
 
@@ -200,7 +198,11 @@ SkeletonData* SkeletonJson_readSkeletonData (SkeletonJson* self, const char* jso
 						RegionAttachment_updateOffset(regionAttachment);
 					}
 
-					Skin_addAttachment(skin, slotIndex, skinAttachmentName, attachment);
+					if (!Skin_addAttachment(skin, slotIndex, skinAttachmentName, attachment)) {
+						SkeletonData_dispose(skeletonData);
+						_SkeletonJson_setError(self, root, "Unable to add attachment: ", skinAttachmentName);
+						return 0;
+					}
 				}
 			}
 		}
@@ -236,7 +238,7 @@ Animation* SkeletonJson_readAnimation (SkeletonJson* self, const char* json, con
 	FREE(self->error)
 	CAST(char*, self->error) = 0;
 
-	Json* root = Json_create(json);
+	Json* root = Json_createInArena(json);
 	if (!root) {
 		_SkeletonJson_setError(self, 0, "Invalid animation JSON: ", Json_getError());
 		return 0;
@@ -250,16 +252,18 @@ Animation* SkeletonJson_readAnimation (SkeletonJson* self, const char* json, con
 
 	int timelineCount = 0;
 	int i, ii, iii;
-	for (i = 0; i < boneCount; ++i)
-		timelineCount += Json_getSize(Json_getItemAt(bones, i));
-	for (i = 0; i < slotCount; ++i)
-		timelineCount += Json_getSize(Json_getItemAt(slots, i));
+	Json* map;
+	for (map = bones->child; map; map = map->next)
+		timelineCount += Json_getSize(map);
+	if (slots) {
+		for (map = slots->child; map; map = map->next)
+			timelineCount += Json_getSize(map);
+	}
 	Animation* animation = Animation_create(timelineCount);
 	animation->timelineCount = 0;
 
-	for (i = 0; i < boneCount; ++i) {
-		Json* boneMap = Json_getItemAt(bones, i);
-
+	Json* boneMap = bones->child;
+	for (i = 0; i < boneCount; ++i, boneMap = boneMap->next) {
 		const char* boneName = boneMap->name;
 
 		int boneIndex = SkeletonData_findBoneIndex(skeletonData, boneName);
@@ -270,16 +274,16 @@ Animation* SkeletonJson_readAnimation (SkeletonJson* self, const char* json, con
 		}
 
 		int timelineCount = Json_getSize(boneMap);
-		for (ii = 0; ii < timelineCount; ++ii) {
-			Json* timelineArray = Json_getItemAt(boneMap, ii);
+		Json* timelineArray = boneMap->child;
+		for (ii = 0; ii < timelineCount; ++ii, timelineArray = timelineArray->next) {
 			int frameCount = Json_getSize(timelineArray);
 			const char* timelineType = timelineArray->name;
 
 			if (strcmp(timelineType, "rotate") == 0) {
 				RotateTimeline *timeline = RotateTimeline_create(frameCount);
 				timeline->boneIndex = boneIndex;
-				for (iii = 0; iii < frameCount; ++iii) {
-					Json* frame = Json_getItemAt(timelineArray, iii);
+				Json* frame = timelineArray->child;
+				for (iii = 0; iii < frameCount; ++iii, frame = frame->next) {
 					RotateTimeline_setFrame(timeline, iii, Json_getFloat(frame, "time", 0), Json_getFloat(frame, "angle", 0));
 					readCurve(&timeline->super, iii, frame);
 				}
@@ -292,8 +296,8 @@ Animation* SkeletonJson_readAnimation (SkeletonJson* self, const char* json, con
 					TranslateTimeline *timeline = isScale ? ScaleTimeline_create(frameCount) : TranslateTimeline_create(frameCount);
 					float scale = isScale ? 1 : self->scale;
 					timeline->boneIndex = boneIndex;
-					for (iii = 0; iii < frameCount; ++iii) {
-						Json* frame = Json_getItemAt(timelineArray, iii);
+					Json* frame = timelineArray->child;
+					for (iii = 0; iii < frameCount; ++iii, frame = frame->next) {
 						TranslateTimeline_setFrame(timeline, iii, Json_getFloat(frame, "time", 0), Json_getFloat(frame, "x", 0) * scale,
 								Json_getFloat(frame, "y", 0) * scale);
 						readCurve(&timeline->super, iii, frame);
@@ -302,16 +306,16 @@ Animation* SkeletonJson_readAnimation (SkeletonJson* self, const char* json, con
 					animation->duration = fmaxf(animation->duration, timeline->frames[frameCount * 3 - 3]);
 				} else {
 					Animation_dispose(animation);
-					_SkeletonJson_setError(self, 0, "Invalid timeline type for a bone: ", timelineType);
+					_SkeletonJson_setError(self, root, "Invalid timeline type for a bone: ", timelineType);
 					return 0;
 				}
 			}
 		}
 	}
 
-	if (!slots) {
-		for (i = 0; i < slotCount; ++i) {
-			Json* slotMap = Json_getItemAt(slots, i);
+	if (slots) {
+		Json* slotMap = slots->child;
+		for (i = 0; i < slotCount; ++i, slotMap = slotMap->next) {
 			const char* slotName = slotMap->name;
 
 			int slotIndex = SkeletonData_findSlotIndex(skeletonData, slotName);
@@ -322,16 +326,16 @@ Animation* SkeletonJson_readAnimation (SkeletonJson* self, const char* json, con
 			}
 
 			int timelineCount = Json_getSize(slotMap);
-			for (ii = 0; ii < timelineCount; ++ii) {
-				Json* timelineArray = Json_getItemAt(slotMap, ii);
+			Json* timelineArray = slotMap->child;
+			for (ii = 0; ii < timelineCount; ++ii, timelineArray = timelineArray->next) {
 				int frameCount = Json_getSize(timelineArray);
 				const char* timelineType = timelineArray->name;
 
 				if (strcmp(timelineType, "color") == 0) {
 					ColorTimeline *timeline = ColorTimeline_create(frameCount);
 					timeline->slotIndex = slotIndex;
-					for (iii = 0; iii < frameCount; ++iii) {
-						Json* frame = Json_getItemAt(timelineArray, iii);
+					Json* frame = timelineArray->child;
+					for (iii = 0; iii < frameCount; ++iii, frame = frame->next) {
 						const char* s = Json_getString(frame, "color", 0);
 						ColorTimeline_setFrame(timeline, iii, Json_getFloat(frame, "time", 0), toColor(s, 0), toColor(s, 1),
 								toColor(s, 2), toColor(s, 3));
@@ -343,8 +347,8 @@ Animation* SkeletonJson_readAnimation (SkeletonJson* self, const char* json, con
 				} else if (strcmp(timelineType, "attachment") == 0) {
 					AttachmentTimeline *timeline = AttachmentTimeline_create(frameCount);
 					timeline->slotIndex = slotIndex;
-					for (iii = 0; iii < frameCount; ++iii) {
-						Json* frame = Json_getItemAt(timelineArray, iii);
+					Json* frame = timelineArray->child;
+					for (iii = 0; iii < frameCount; ++iii, frame = frame->next) {
 						Json* name = Json_getItem(frame, "name");
 						AttachmentTimeline_setFrame(timeline, iii, Json_getFloat(frame, "time", 0),
 								name->type == Json_NULL ? 0 : name->valuestring);
@@ -354,12 +358,13 @@ Animation* SkeletonJson_readAnimation (SkeletonJson* self, const char* json, con
 
 				} else {
 					Animation_dispose(animation);
-					_SkeletonJson_setError(self, 0, "Invalid timeline type for a slot: ", timelineType);
+					_SkeletonJson_setError(self, root, "Invalid timeline type for a slot: ", timelineType);
 					return 0;
 				}
 			}
 		}
 	}
 
+	Json_dispose(root);
 	return animation;
 }
@@ -1,52 +1,159 @@
 #include <spine/Skin.h>
+#include <spine/Skeleton.h>
 #include <spine/util.h>
 
-SkinEntry* _SkinEntry_create (int slotIndex, const char* name, Attachment* attachment) {
-	SkinEntry* self = CALLOC(SkinEntry, 1)
-	self->slotIndex = slotIndex;
-	MALLOC_STR(self->name, name)
-	self->attachment = attachment;
-	return self;
+#define INITIAL_BUCKET_COUNT 16
+
+/* Adds the lookup fields to the public entry. The name hash is computed once, when the attachment is added. */
+typedef struct _Entry _Entry;
+struct _Entry {
+	SkinEntry super;
+	unsigned int hash;
+	_Entry* nextInBucket;
+	_Entry* nextWithAttachment;
+};
+
+typedef struct {
+	Skin super;
+	_Entry* lastEntry;
+	int entryCount;
+	/* Power of two. Both tables have this many buckets. */
+	int bucketCount;
+	/* Indexed by the hash of slot index and name. */
+	_Entry** buckets;
+	/* Indexed by the hash of the attachment, so switching skins finds the entry of each slot's attachment directly. */
+	_Entry** attachmentBuckets;
+} Internal;
+
+static unsigned int hashEntry (int slotIndex, unsigned int nameHash) {
+	return nameHash ^ ((unsigned int)slotIndex * 2654435761u);
 }
 
-void _SkinEntry_dispose (SkinEntry* self) {
-	if (self->next) _SkinEntry_dispose((SkinEntry*)self->next);
-	Attachment_dispose(self->attachment);
-	FREE(self->name)
-	FREE(self)
+static unsigned int hashAttachment (const Attachment* attachment) {
+	return (unsigned int)((size_t)attachment >> 4) * 2654435761u;
+}
+
+static const _Entry* findEntry (const Internal* self, int slotIndex, const char* name, unsigned int nameHash) {
+	if (!self->buckets) return 0;
+	const _Entry* entry = self->buckets[hashEntry(slotIndex, nameHash) & (self->bucketCount - 1)];
+	while (entry) {
+		if (entry->hash == nameHash && entry->super.slotIndex == slotIndex && strcmp(entry->super.name, name) == 0) return entry;
+		entry = entry->nextInBucket;
+	}
+	return 0;
+}
+
+static const _Entry* findEntryWithAttachment (const Internal* self, int slotIndex, const Attachment* attachment) {
+	if (!self->attachmentBuckets) return 0;
+	const _Entry* entry = self->attachmentBuckets[hashAttachment(attachment) & (self->bucketCount - 1)];
+	while (entry) {
+		if (entry->super.attachment == attachment && entry->super.slotIndex == slotIndex) return entry;
+		entry = entry->nextWithAttachment;
+	}
+	return 0;
+}
+
+/* Entries are appended to the end of their buckets, so when names repeat the first one added is found, as with a linear scan. */
+static void insertEntry (_Entry** buckets, _Entry** attachmentBuckets, int bucketCount, _Entry* entry) {
+	_Entry** link = &buckets[hashEntry(entry->super.slotIndex, entry->hash) & (bucketCount - 1)];
+	while (*link)
+		link = &(*link)->nextInBucket;
+	*link = entry;
+	entry->nextInBucket = 0;
+
+	link = &attachmentBuckets[hashAttachment(entry->super.attachment) & (bucketCount - 1)];
+	while (*link)
+		link = &(*link)->nextWithAttachment;
+	*link = entry;
+	entry->nextWithAttachment = 0;
+}
+
+static int growBuckets (Internal* self) {
+	int bucketCount = self->bucketCount ? self->bucketCount * 2 : INITIAL_BUCKET_COUNT;
+	_Entry** buckets = CALLOC(_Entry*, bucketCount)
+	if (!buckets) return 0;
+	_Entry** attachmentBuckets = CALLOC(_Entry*, bucketCount)
+	if (!attachmentBuckets) {
+		FREE(buckets)
+		return 0;
+	}
+	const SkinEntry* entry = self->super.entries;
+	while (entry) {
+		insertEntry(buckets, attachmentBuckets, bucketCount, (_Entry*)entry);
+		entry = entry->next;
+	}
+	FREE(self->buckets)
+	FREE(self->attachmentBuckets)
+	self->buckets = buckets;
+	self->attachmentBuckets = attachmentBuckets;
+	self->bucketCount = bucketCount;
+	return 1;
 }
 
 /**/
 
 Skin* Skin_create (const char* name) {
-	Skin* self = CALLOC(Skin, 1)
+	Skin* self = (Skin*)CALLOC(Internal, 1)
 	MALLOC_STR(self->name, name)
 	return self;
 }
 
 void Skin_dispose (Skin* self) {
-	_SkinEntry_dispose((SkinEntry*)self->entries);
+	const SkinEntry* entry = self->entries;
+	while (entry) {
+		const SkinEntry* next = entry->next;
+		Attachment_dispose(entry->attachment);
+		FREE(entry->name)
+		FREE(entry)
+		entry = next;
+	}
+	FREE(((Internal*)self)->buckets)
+	FREE(((Internal*)self)->attachmentBuckets)
 	FREE(self->name)
 	FREE(self)
 }
 
-void Skin_addAttachment (Skin* self, int slotIndex, const char* name, Attachment* attachment) {
-	SkinEntry* newEntry = _SkinEntry_create(slotIndex, name, attachment);
-	SkinEntry* entry = (SkinEntry*)self->entries;
-	if (!entry)
-		CAST(SkinEntry*, self->entries) = newEntry;
-	else {
-		while (entry->next)
-			entry = (SkinEntry*)entry->next;
-		entry->next = newEntry;
+int Skin_addAttachment (Skin* self, int slotIndex, const char* name, Attachment* attachment) {
+	Internal* internal = (Internal*)self;
+	if (internal->entryCount >= internal->bucketCount - (internal->bucketCount >> 2) && !growBuckets(internal)) {
+		Attachment_dispose(attachment);
+		return 0;
 	}
+
+	_Entry* entry = CALLOC(_Entry, 1)
+	if (!entry) {
+		Attachment_dispose(attachment);
+		return 0;
+	}
+	entry->super.slotIndex = slotIndex;
+	MALLOC_STR(entry->super.name, name)
+	entry->super.attachment = attachment;
+	entry->hash = hashString(name);
+
+	if (internal->lastEntry)
+		internal->lastEntry->super.next = &entry->super;
+	else
+		CAST(SkinEntry*, self->entries) = &entry->super;
+	internal->lastEntry = entry;
+	internal->entryCount++;
+
+	insertEntry(internal->buckets, internal->attachmentBuckets, internal->bucketCount, entry);
+	return 1;
 }
 
 Attachment* Skin_getAttachment (const Skin* self, int slotIndex, const char* name) {
-	const SkinEntry* entry = self->entries;
-	while (entry) {
-		if (entry->slotIndex == slotIndex && strcmp(entry->name, name) == 0) return entry->attachment;
-		entry = entry->next;
+	const _Entry* entry = findEntry((const Internal*)self, slotIndex, name, hashString(name));
+	return entry ? entry->super.attachment : 0;
+}
+
+void Skin_attachAll (const Skin* self, struct Skeleton* skeleton, const Skin* oldSkin) {
+	int i;
+	for (i = 0; i < skeleton->slotCount; ++i) {
+		Slot* slot = skeleton->slots[i];
+		if (!slot->attachment) continue;
+		const _Entry* entry = findEntryWithAttachment((const Internal*)oldSkin, i, slot->attachment);
+		if (!entry) continue;
+		const _Entry* newEntry = findEntry((const Internal*)self, i, entry->super.name, entry->hash);
+		if (newEntry) Slot_setAttachment(slot, newEntry->super.attachment);
 	}
-	return 0;
 }
@@ -2,14 +2,13 @@
 #include <spine/util.h>
 #include <spine/Skeleton.h>
 
-typedef struct {
-	Slot slot;
-	float attachmentTime;
-} Internal;
-
 Slot* Slot_create (SlotData* data, Skeleton* skeleton, Bone* bone) {
-	Internal* internal = CALLOC(Internal, 1)
-	Slot* self = &internal->slot;
+	Slot* self = CALLOC(Slot, 1)
+	_Slot_init(self, data, skeleton, bone);
+	return self;
+}
+
+void _Slot_init (Slot* self, SlotData* data, Skeleton* skeleton, Bone* bone) {
 	CAST(SlotData*, self->data) = data;
 	CAST(Skeleton*, self->skeleton) = skeleton;
 	CAST(Bone*, self->bone) = bone;
@@ -17,7 +16,6 @@ Slot* Slot_create (SlotData* data, Skeleton* skeleton, Bone* bone) {
 	self->g = 1;
 	self->b = 1;
 	self->a = 1;
-	return self;
 }
 
 void Slot_dispose (Slot* self) {
@@ -27,15 +25,15 @@ void Slot_dispose (Slot* self) {
 /* @param attachment May be null. */
 void Slot_setAttachment (Slot* self, Attachment* attachment) {
 	CAST(Attachment*, self->attachment) = attachment;
-	((Internal*)self)->attachmentTime = self->skeleton->time;
+	self->_attachmentTime = self->skeleton->time;
 }
 
 void Slot_setAttachmentTime (Slot* self, float time) {
-	((Internal*)self)->attachmentTime = self->skeleton->time - time;
+	self->_attachmentTime = self->skeleton->time - time;
 }
 
 float Slot_getAttachmentTime (const Slot* self) {
-	return self->skeleton->time - ((Internal*)self)->attachmentTime;
+	return self->skeleton->time - self->_attachmentTime;
 }
 
 void Slot_setToBindPose (Slot* self) {
@@ -1,6 +1,55 @@
 #include <spine/util.h>
 #include <stdio.h>
 
+/* Each allocation is preceded by a header that says whether it came from an arena, so _free can tell in constant time. The header
+ * is as large as the arena alignment so the memory after it stays aligned. */
+#define HEADER_SIZE 16
+#define HEAP_BLOCK 0x68656170
+#define ARENA_BLOCK 0x6172656e
+
+static void* (*mallocFunc) (size_t size) = malloc;
+static void (*freeFunc) (void* ptr) = free;
+
+void* _malloc (size_t size) {
+	if (size > (size_t)-1 - HEADER_SIZE) return 0;
+	Arena* arena = Arena_getCurrent();
+	char* block = (char*)(arena ? _Arena_malloc(arena, HEADER_SIZE + size) : mallocFunc(HEADER_SIZE + size));
+	if (!block) return 0;
+	*(unsigned int*)block = arena ? ARENA_BLOCK : HEAP_BLOCK;
+	return block + HEADER_SIZE;
+}
+
+void* _calloc (size_t num, size_t size) {
+	if (num && size > (size_t)-1 / num) return 0;
+	void* ptr = _malloc(num * size);
+	if (ptr) memset(ptr, 0, num * size);
+	return ptr;
+}
+
+void _free (void* ptr) {
+	if (!ptr) return;
+	char* block = (char*)ptr - HEADER_SIZE;
+	if (*(unsigned int*)block == ARENA_BLOCK) return;
+	freeFunc(block);
+}
+
+void _setMalloc (void* (*malloc) (size_t size)) {
+	mallocFunc = malloc;
+}
+
+void _setFree (void (*free) (void* ptr)) {
+	freeFunc = free;
+}
+
+unsigned int hashString (const char* string) {
+	unsigned int hash = 2166136261u;
+	while (*string) {
+		hash ^= (unsigned char)*string++;
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
 const char* readFile (const char* path) {
 	FILE *file = fopen(path, "rb");
 	if (!file) return 0;
@@ -9,7 +58,9 @@ const char* readFile (const char* path) {
 	long length = ftell(file);
 	fseek(file, 0, SEEK_SET);
 
-	char* data = (char*)malloc(length + 1);
+	Arena* arena = Arena_setCurrent(0);
+	char* data = MALLOC(char, length + 1)
+	Arena_setCurrent(arena);
 	fread(data, 1, length, file);
 	fclose(file);
 	data[length] = '\0';
@@ -3,22 +3,41 @@
 
 #include <stdlib.h>
 #include <string.h>
+#include <spine/Arena.h>
 
 #ifdef __cplusplus
 namespace spine {
 extern "C" {
 #endif
 
+#ifdef _MSC_VER
+#define THREAD_LOCAL __declspec(thread)
+#else
+#define THREAD_LOCAL __thread
+#endif
+
 /* Used to cast away const on an lvalue. */
 #define CAST(TYPE,VALUE) *(TYPE*)&VALUE
 
-#define CALLOC(TYPE,COUNT) (TYPE*)calloc(1, sizeof(TYPE) * COUNT);
-#define MALLOC(TYPE,COUNT) (TYPE*)malloc(sizeof(TYPE) * COUNT);
+#define CALLOC(TYPE,COUNT) (TYPE*)_calloc(COUNT, sizeof(TYPE));
+#define MALLOC(TYPE,COUNT) (TYPE*)_malloc(sizeof(TYPE) * COUNT);
+
+#define MALLOC_STR(TO,FROM) strcpy(CAST(char*, TO) = (char*)_malloc(strlen(FROM) + 1), FROM);
+
+#define FREE(E) _free((void*)E);
+
+/* All runtime allocations go through these. They use the current Arena if there is one, else the functions set with _setMalloc
+ * and _setFree. */
+void* _malloc (size_t size);
+void* _calloc (size_t num, size_t size);
+void _free (void* ptr);
 
-#define MALLOC_STR(TO,FROM) strcpy(CAST(char*, TO) = (char*)malloc(strlen(FROM)), FROM);
+void* _Arena_malloc (Arena* arena, size_t size);
 
-#define FREE(E) free((void*)E);
+/* FNV-1a hash of a NUL-terminated string. */
+unsigned int hashString (const char* string);
 
+/* The returned data is temporary, so it is never allocated from an arena. It must be freed with FREE. */
 const char* readFile (const char* path);
 
 #ifdef __cplusplus
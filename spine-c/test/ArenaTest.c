@@ -0,0 +1,154 @@
+/* Checks that the allocation hooks see every allocation made outside of arenas, that spineboy loaded into an arena is released by
+ * disposing the arena, and that each thread has its own current arena.
+ *
+ * The optional argument is the directory containing spineboy-skeleton.json, spineboy-walk.json and spineboy.atlas, by default
+ * data/. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <spine/spine.h>
+#include <spine/Arena.h>
+
+#define MAX_LIVE 65536
+/* Large enough for all of spineboy, so loading into the arena allocates a single chunk. */
+#define ARENA_CHUNK_SIZE (8 * 1024 * 1024)
+
+static int failures;
+
+static void check (int condition, const char* message) {
+	if (condition) return;
+	printf("FAILED: %s\n", message);
+	failures++;
+}
+
+/* The hooks record the memory they return, so freeing memory they didn't allocate can be detected. */
+static pthread_mutex_t hookMutex = PTHREAD_MUTEX_INITIALIZER;
+static void* live[MAX_LIVE];
+static int liveCount, mallocCount, unknownFrees;
+
+static void* hookMalloc (size_t size) {
+	void* ptr = malloc(size);
+	pthread_mutex_lock(&hookMutex);
+	if (liveCount < MAX_LIVE) live[liveCount++] = ptr;
+	mallocCount++;
+	pthread_mutex_unlock(&hookMutex);
+	return ptr;
+}
+
+static void hookFree (void* ptr) {
+	int i;
+	pthread_mutex_lock(&hookMutex);
+	for (i = liveCount - 1; i >= 0; i--)
+		if (live[i] == ptr) break;
+	if (i < 0)
+		unknownFrees++;
+	else
+		live[i] = live[--liveCount];
+	pthread_mutex_unlock(&hookMutex);
+	free(ptr);
+}
+
+typedef struct {
+	const char* dir;
+	Atlas* atlas;
+	SkeletonData* skeletonData;
+	Animation* walk;
+} Spineboy;
+
+static int load (Spineboy* spineboy) {
+	char path[1024];
+	snprintf(path, sizeof(path), "%s%s", spineboy->dir, "spineboy.atlas");
+	spineboy->atlas = Atlas_readAtlasFile(path);
+	if (!spineboy->atlas) return 0;
+	SkeletonJson* json = SkeletonJson_create(spineboy->atlas);
+	snprintf(path, sizeof(path), "%s%s", spineboy->dir, "spineboy-skeleton.json");
+	spineboy->skeletonData = SkeletonJson_readSkeletonDataFile(json, path);
+	snprintf(path, sizeof(path), "%s%s", spineboy->dir, "spineboy-walk.json");
+	spineboy->walk = spineboy->skeletonData ? SkeletonJson_readAnimationFile(json, path, spineboy->skeletonData) : 0;
+	SkeletonJson_dispose(json);
+	return spineboy->walk != 0;
+}
+
+typedef struct {
+	const char* dir;
+	Arena* initial;
+	size_t size;
+	int/*bool*/loaded;
+} ThreadLoad;
+
+/* Loads spineboy into a new arena current only on this thread. */
+static void* loadInArena (void* arg) {
+	ThreadLoad* job = (ThreadLoad*)arg;
+	Spineboy spineboy = {0};
+	spineboy.dir = job->dir;
+	job->initial = Arena_getCurrent();
+	Arena* arena = Arena_create(0);
+	Arena_setCurrent(arena);
+	job->loaded = load(&spineboy);
+	job->size = Arena_getSize(arena);
+	Arena_dispose(arena);
+	return 0;
+}
+
+int main (int argc, char** argv) {
+	_setMalloc(hookMalloc);
+	_setFree(hookFree);
+	Spineboy spineboy = {0};
+	spineboy.dir = argc > 1 ? argv[1] : "data/";
+
+	/* Outside of an arena, everything goes through the hooks and is freed through them. */
+	check(load(&spineboy), "loads spineboy");
+	check(mallocCount > 0 && liveCount > 0, "hooks not used");
+	int skeletonDataCount = liveCount;
+	Skeleton* skeleton = Skeleton_create(spineboy.skeletonData);
+	Skeleton_dispose(skeleton);
+	Animation_dispose(spineboy.walk);
+	Atlas_dispose(spineboy.atlas);
+	check(liveCount > 0 && liveCount < skeletonDataCount, "disposing didn't free through the hooks");
+	check(!unknownFrees, "freed memory the hooks didn't allocate");
+	/* SkeletonData_dispose only frees the SkeletonData itself, so its parts are left out of the counts. */
+	SkeletonData_dispose(spineboy.skeletonData);
+	int baseline = liveCount;
+
+	/* In an arena, only the arena and its chunk are left allocated through the hooks, and disposing the arena frees both. */
+	Arena* arena = Arena_create(ARENA_CHUNK_SIZE);
+	Arena_setCurrent(arena);
+	check(load(&spineboy), "loads spineboy in an arena");
+	size_t loadSize = Arena_getSize(arena);
+	skeleton = Skeleton_create(spineboy.skeletonData);
+	Arena_setCurrent(0);
+	check(liveCount == baseline + 2, "loading in an arena left heap memory");
+	size_t size = Arena_getSize(arena);
+	check(loadSize > 0 && size > loadSize, "nothing allocated from the arena");
+	Skeleton_dispose(skeleton);
+	Animation_dispose(spineboy.walk);
+	check(Arena_getSize(arena) == size && liveCount == baseline + 2, "disposing arena memory freed it");
+	Arena_dispose(arena);
+	check(liveCount == baseline, "disposing the arena didn't free everything");
+	check(!unknownFrees, "freed arena memory through the hooks");
+
+	/* Threads don't see the main thread's arena, and load into their own at the same time. */
+	Arena* mainArena = Arena_create(0);
+	Arena_setCurrent(mainArena);
+	ThreadLoad jobs[2];
+	pthread_t threads[2];
+	int i;
+	for (i = 0; i < 2; i++) {
+		jobs[i].dir = spineboy.dir;
+		pthread_create(&threads[i], 0, loadInArena, &jobs[i]);
+	}
+	for (i = 0; i < 2; i++) {
+		pthread_join(threads[i], 0);
+		check(jobs[i].loaded && !jobs[i].initial, "thread started with another thread's arena");
+		check(jobs[i].size == loadSize, "thread arena has more or less than spineboy");
+	}
+	check(Arena_getCurrent() == mainArena && Arena_getSize(mainArena) == 0, "thread changed or used the main thread's arena");
+	Arena_setCurrent(0);
+	Arena_dispose(mainArena);
+	check(liveCount == baseline && !unknownFrees, "thread arenas left memory");
+
+	if (failures) return 1;
+	printf("OK: allocation hooks, loading into an arena and thread arenas\n");
+	return 0;
+}
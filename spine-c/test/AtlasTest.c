@@ -0,0 +1,165 @@
+/* Checks that Atlas_readAtlasData reads only the given length of an unterminated buffer, that Atlas_findRegion finds every region,
+ * misses names that aren't in the atlas and returns the first of regions with the same name, and that atlases can be read on
+ * several threads at once.
+ *
+ * The optional argument is the directory containing spineboy.atlas, by default data/. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <spine/spine.h>
+#include <spine/util.h>
+
+#define THREAD_COUNT 4
+#define READ_COUNT 100
+#define GENERATED_REGION_COUNT 300
+
+static int failures;
+
+static void check (int condition, const char* message) {
+	if (condition) return;
+	printf("FAILED: %s\n", message);
+	failures++;
+}
+
+static int regionCount (const Atlas* atlas) {
+	int count = 0;
+	const AtlasRegion* region;
+	for (region = atlas->regions; region; region = region->next)
+		count++;
+	return count;
+}
+
+/* Returns true if the atlases have the same regions, in the same order. */
+static int sameRegions (const Atlas* a, const Atlas* b) {
+	const AtlasRegion* regionA = a->regions;
+	const AtlasRegion* regionB = b->regions;
+	for (; regionA && regionB; regionA = regionA->next, regionB = regionB->next) {
+		if (strcmp(regionA->name, regionB->name) || regionA->x != regionB->x || regionA->y != regionB->y
+				|| regionA->width != regionB->width || regionA->height != regionB->height) return 0;
+	}
+	return !regionA && !regionB;
+}
+
+/* Returns true if every region is found by name, or is preceded by a region with the same name that is found instead. */
+static int findsEveryRegion (const Atlas* atlas) {
+	const AtlasRegion* region;
+	for (region = atlas->regions; region; region = region->next) {
+		const AtlasRegion* first = atlas->regions;
+		while (strcmp(first->name, region->name))
+			first = first->next;
+		if (Atlas_findRegion(atlas, region->name) != first) return 0;
+	}
+	return 1;
+}
+
+typedef struct {
+	const char* data;
+	int length;
+	const Atlas* expected;
+	int/*bool*/ok;
+} ReadJob;
+
+static void* readAtlases (void* arg) {
+	ReadJob* job = (ReadJob*)arg;
+	int i;
+	job->ok = 1;
+	for (i = 0; i < READ_COUNT; i++) {
+		Atlas* atlas = Atlas_readAtlasData(job->data, job->length);
+		if (!atlas || !sameRegions(atlas, job->expected) || !findsEveryRegion(atlas)) job->ok = 0;
+		if (atlas) Atlas_dispose(atlas);
+	}
+	return 0;
+}
+
+static const char* duplicateAtlas = "\npage.png\nformat: RGBA8888\nfilter: Linear,Linear\nrepeat: none\n"
+		"dup\n  rotate: false\n  xy: 1, 2\n  size: 3, 4\n  orig: 3, 4\n  offset: 0, 0\n  index: 1\n"
+		"other\n  rotate: false\n  xy: 5, 6\n  size: 7, 8\n  orig: 7, 8\n  offset: 0, 0\n  index: -1\n"
+		"dup\n  rotate: true\n  xy: 9, 10\n  size: 11, 12\n  orig: 11, 12\n  offset: 0, 0\n  index: 2\n";
+
+int main (int argc, char** argv) {
+	const char* dir = argc > 1 ? argv[1] : "data/";
+	char path[1024];
+	snprintf(path, sizeof(path), "%s%s", dir, "spineboy.atlas");
+	const char* text = readFile(path);
+	check(text != 0, "reads spineboy.atlas");
+	if (!text) return 1;
+	int length = strlen(text);
+	Atlas* atlas = Atlas_readAtlas(text);
+	check(atlas && regionCount(atlas) == 23, "Atlas_readAtlas reads 23 regions");
+	if (!atlas) return 1;
+
+	/* An unterminated copy, exactly the length so reading past it is an error for address sanitizers. */
+	char* exact = malloc(length);
+	memcpy(exact, text, length);
+	Atlas* exactAtlas = Atlas_readAtlasData(exact, length);
+	check(exactAtlas && sameRegions(exactAtlas, atlas), "Atlas_readAtlasData reads an unterminated buffer");
+	if (exactAtlas) Atlas_dispose(exactAtlas);
+	free(exact);
+
+	/* An unterminated copy, followed by another region that is past the length. */
+	const char* extra = "\nextra\n  rotate: false\n  xy: 0, 0\n  size: 1, 1\n  orig: 1, 1\n  offset: 0, 0\n  index: -1\n";
+	char* data = malloc(length + strlen(extra));
+	memcpy(data, text, length);
+	memcpy(data + length, extra, strlen(extra));
+	Atlas* unterminated = Atlas_readAtlasData(data, length);
+	check(unterminated && sameRegions(unterminated, atlas), "Atlas_readAtlasData reads only the length");
+	if (unterminated) {
+		check(!Atlas_findRegion(unterminated, "extra"), "Atlas_readAtlasData reads past the length");
+		Atlas_dispose(unterminated);
+	}
+
+	check(findsEveryRegion(atlas), "Atlas_findRegion finds every spineboy region");
+	check(!Atlas_findRegion(atlas, "missing") && !Atlas_findRegion(atlas, "") && !Atlas_findRegion(atlas, "hea")
+			&& !Atlas_findRegion(atlas, "head2"), "Atlas_findRegion finds missing names");
+
+	Atlas* duplicates = Atlas_readAtlas(duplicateAtlas);
+	check(duplicates && regionCount(duplicates) == 3, "reads the atlas with duplicate names");
+	if (duplicates) {
+		AtlasRegion* dup = Atlas_findRegion(duplicates, "dup");
+		check(dup == duplicates->regions && dup->x == 1 && dup->index == 1, "Atlas_findRegion returns the first duplicate");
+		check(Atlas_findRegion(duplicates, "other") == duplicates->regions->next, "Atlas_findRegion after a duplicate");
+		Atlas_dispose(duplicates);
+	}
+
+	/* Enough regions that names collide in the hash table. */
+	int i, generatedLength = 0;
+	char* generated = malloc(GENERATED_REGION_COUNT * 128 + 128);
+	generatedLength += sprintf(generated, "\npage.png\nformat: RGBA8888\nfilter: Linear,Linear\nrepeat: none\n");
+	for (i = 0; i < GENERATED_REGION_COUNT; i++) {
+		generatedLength += sprintf(generated + generatedLength,
+				"region%d\n  rotate: false\n  xy: %d, 0\n  size: 1, 1\n  orig: 1, 1\n  offset: 0, 0\n  index: -1\n", i % 250, i);
+	}
+	Atlas* many = Atlas_readAtlasData(generated, generatedLength);
+	check(many && regionCount(many) == GENERATED_REGION_COUNT, "reads the generated atlas");
+	if (many) {
+		check(findsEveryRegion(many), "Atlas_findRegion finds every generated region");
+		check(Atlas_findRegion(many, "region10")->x == 10, "Atlas_findRegion returns the first generated duplicate");
+		check(!Atlas_findRegion(many, "region250") && !Atlas_findRegion(many, "region"), "Atlas_findRegion finds missing names");
+	}
+
+	/* Each thread reads both atlases many times, from the same buffers. */
+	pthread_t threads[THREAD_COUNT];
+	ReadJob jobs[THREAD_COUNT];
+	for (i = 0; i < THREAD_COUNT; i++) {
+		jobs[i].data = i % 2 ? data : generated;
+		jobs[i].length = i % 2 ? length : generatedLength;
+		jobs[i].expected = i % 2 ? atlas : many;
+		pthread_create(&threads[i], 0, readAtlases, &jobs[i]);
+	}
+	for (i = 0; i < THREAD_COUNT; i++) {
+		pthread_join(threads[i], 0);
+		check(jobs[i].ok, "Atlas_readAtlasData on several threads");
+	}
+
+	if (many) Atlas_dispose(many);
+	free(generated);
+	free(data);
+	Atlas_dispose(atlas);
+	FREE(text)
+
+	if (failures) return 1;
+	printf("OK: Atlas_readAtlasData lengths, Atlas_findRegion and reading on several threads\n");
+	return 0;
+}
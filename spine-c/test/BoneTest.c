@@ -0,0 +1,83 @@
+/* Checks that Bone_updateWorldTransforms produces exactly the world transforms of calling Bone_updateWorldTransform for each bone,
+ * for spineboy in a number of poses with every combination of flipX, flipY and yDown.
+ *
+ * The optional argument is the directory containing spineboy-skeleton.json and spineboy.atlas, by default data/. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <spine/spine.h>
+
+static int failures;
+
+static void check (int condition, const char* message) {
+	if (condition) return;
+	printf("FAILED: %s\n", message);
+	failures++;
+}
+
+static int sameWorldTransform (const Bone* a, const Bone* b) {
+	return a->m00 == b->m00 && a->m01 == b->m01 && a->worldX == b->worldX && a->m10 == b->m10 && a->m11 == b->m11
+			&& a->worldY == b->worldY && a->worldRotation == b->worldRotation && a->worldScaleX == b->worldScaleX
+			&& a->worldScaleY == b->worldScaleY;
+}
+
+int main (int argc, char** argv) {
+	const char* dir = argc > 1 ? argv[1] : "data/";
+	char path[1024];
+	snprintf(path, sizeof(path), "%s%s", dir, "spineboy.atlas");
+	Atlas* atlas = Atlas_readAtlasFile(path);
+	check(atlas != 0, "Atlas_readAtlasFile reads spineboy.atlas");
+	if (!atlas) return 1;
+	SkeletonJson* json = SkeletonJson_create(atlas);
+
+	snprintf(path, sizeof(path), "%s%s", dir, "spineboy-skeleton.json");
+	SkeletonData* skeletonData = SkeletonJson_readSkeletonDataFile(json, path);
+	check(skeletonData != 0, "SkeletonJson reads spineboy-skeleton.json");
+	if (!skeletonData) return 1;
+
+	Skeleton* skeleton = Skeleton_create(skeletonData);
+	Bone* batched = malloc(sizeof(Bone) * skeleton->boneCount);
+	int combination, frame, i, compared = 0;
+	for (combination = 0; combination < 8; combination++) {
+		char message[128];
+		skeleton->flipX = combination & 1;
+		skeleton->flipY = (combination >> 1) & 1;
+		Bone_setYDown((combination >> 2) & 1);
+		for (frame = 0; frame < 10; frame++) {
+			/* Moves, rotates and scales the bones away from the bind pose by different amounts each frame. */
+			Skeleton_setToBindPose(skeleton);
+			for (i = 0; i < skeleton->boneCount; i++) {
+				Bone* bone = skeleton->bones[i];
+				bone->x += 3.5f * frame - i;
+				bone->y -= 1.25f * i * frame;
+				bone->rotation += 37.3f * frame + 11.1f * i;
+				bone->scaleX *= 1 + 0.25f * ((i + frame) % 3);
+				bone->scaleY *= 1 - 0.375f * ((i + frame) % 4);
+			}
+
+			Bone_updateWorldTransforms(skeleton->bones[0], skeleton->boneCount, skeleton->flipX, skeleton->flipY);
+			memcpy(batched, skeleton->bones[0], sizeof(Bone) * skeleton->boneCount);
+			for (i = 0; i < skeleton->boneCount; i++)
+				Bone_updateWorldTransform(skeleton->bones[i], skeleton->flipX, skeleton->flipY);
+
+			for (i = 0; i < skeleton->boneCount; i++, compared++) {
+				if (sameWorldTransform(&batched[i], skeleton->bones[i])) continue;
+				snprintf(message, sizeof(message), "%s differs with flipX %d, flipY %d, yDown %d, frame %d",
+						skeleton->bones[i]->data->name, skeleton->flipX, skeleton->flipY, (combination >> 2) & 1, frame);
+				check(0, message);
+			}
+		}
+	}
+	Bone_setYDown(0);
+
+	free(batched);
+	Skeleton_dispose(skeleton);
+	SkeletonData_dispose(skeletonData);
+	SkeletonJson_dispose(json);
+	Atlas_dispose(atlas);
+
+	if (failures) return 1;
+	printf("OK: %d bone world transforms match Bone_updateWorldTransform\n", compared);
+	return 0;
+}
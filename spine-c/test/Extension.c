@@ -0,0 +1,41 @@
+/* The functions spine/extension.h requires, with no rendering, for the tests and the benchmark. */
+
+#include <spine/spine.h>
+#include <spine/extension.h>
+#include <spine/util.h>
+
+static void _HeadlessAtlasPage_dispose (AtlasPage* self) {
+	_AtlasPage_deinit(self);
+	FREE(self)
+}
+
+AtlasPage* AtlasPage_create (const char* name) {
+	AtlasPage* self = CALLOC(AtlasPage, 1)
+	_AtlasPage_init(self, name);
+	self->_dispose = _HeadlessAtlasPage_dispose;
+	return self;
+}
+
+static void _HeadlessRegionAttachment_dispose (Attachment* self) {
+	_RegionAttachment_deinit((RegionAttachment*)self); /* Frees the attachment. */
+}
+
+RegionAttachment* RegionAttachment_create (const char* name, AtlasRegion* region) {
+	RegionAttachment* self = CALLOC(RegionAttachment, 1)
+	(void)region;
+	_RegionAttachment_init(self, name);
+	self->super._dispose = _HeadlessRegionAttachment_dispose;
+	return self;
+}
+
+static void _HeadlessSkeleton_dispose (Skeleton* self) {
+	_Skeleton_deinit(self);
+	FREE(self)
+}
+
+Skeleton* Skeleton_create (SkeletonData* data) {
+	Skeleton* self = CALLOC(Skeleton, 1)
+	_Skeleton_init(self, data);
+	self->_dispose = _HeadlessSkeleton_dispose;
+	return self;
+}
@@ -0,0 +1,88 @@
+/* Checks that a failed parse reports where it failed, for each way of parsing, that each thread has its own error, and that
+ * SkeletonJson's error message for invalid JSON is readable after the JSON's arena was freed.
+ *
+ * The optional argument is the directory containing spineboy-skeleton.json and spineboy.atlas, by default data/. */
+
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include <spine/spine.h>
+#include <spine/Json.h>
+#include <spine/util.h>
+
+static int failures;
+
+static void check (int condition, const char* message) {
+	if (condition) return;
+	printf("FAILED: %s\n", message);
+	failures++;
+}
+
+/* The error must point into the value that was parsed, at the character that could not be parsed. Parsing in situ may have written
+ * terminators into the value, so its length is passed. */
+static void checkError (const char* value, size_t length, const char* message) {
+	const char* error = Json_getError();
+	check(error && error >= value && error < value + length && *error == '}', message);
+}
+
+/* Parses valid JSON on another thread, which must not see or clear the error of the main thread. */
+static void* parseValid (void* result) {
+	Json* root = Json_create("{\"b\": 1}");
+	*(int*)result = root && !Json_getError();
+	Json_dispose(root);
+	return 0;
+}
+
+int main (int argc, char** argv) {
+	const char* dir = argc > 1 ? argv[1] : "data/";
+	const char* invalid = "{\"a\": [1, 2, }";
+
+	check(!Json_create(invalid), "Json_create parses invalid JSON");
+	checkError(invalid, strlen(invalid), "Json_create error");
+
+	char buffer[32];
+	strcpy(buffer, invalid);
+	check(!Json_createInSitu(buffer), "Json_createInSitu parses invalid JSON");
+	checkError(buffer, strlen(invalid), "Json_createInSitu error");
+
+	check(!Json_createInArena(invalid), "Json_createInArena parses invalid JSON");
+	checkError(invalid, strlen(invalid), "Json_createInArena error");
+
+	Json* root = Json_createInArena("{\"a\": [1, 2]}");
+	check(root && !Json_getError(), "Json_createInArena error after valid JSON");
+	Json_dispose(root);
+
+	check(!Json_create(invalid), "Json_create parses invalid JSON");
+	int threadResult = 0;
+	pthread_t thread;
+	pthread_create(&thread, 0, parseValid, &threadResult);
+	pthread_join(thread, 0);
+	check(threadResult, "Json_create error on another thread");
+	checkError(invalid, strlen(invalid), "Json_create error changed by another thread");
+
+	char path[1024];
+	snprintf(path, sizeof(path), "%s%s", dir, "spineboy.atlas");
+	Atlas* atlas = Atlas_readAtlasFile(path);
+	check(atlas != 0, "Atlas_readAtlasFile reads spineboy.atlas");
+	if (!atlas) return 1;
+	SkeletonJson* json = SkeletonJson_create(atlas);
+
+	check(!SkeletonJson_readSkeletonData(json, invalid), "SkeletonJson reads invalid skeleton JSON");
+	check(json->error && strcmp(json->error, "Invalid skeleton JSON: }") == 0, "SkeletonJson skeleton error");
+
+	snprintf(path, sizeof(path), "%s%s", dir, "spineboy-skeleton.json");
+	SkeletonData* skeletonData = SkeletonJson_readSkeletonDataFile(json, path);
+	check(skeletonData != 0, "SkeletonJson reads spineboy-skeleton.json");
+	if (skeletonData) {
+		check(!SkeletonJson_readAnimation(json, invalid, skeletonData), "SkeletonJson reads invalid animation JSON");
+		check(json->error && strcmp(json->error, "Invalid animation JSON: }") == 0, "SkeletonJson animation error");
+		SkeletonData_dispose(skeletonData);
+	}
+
+	SkeletonJson_dispose(json);
+	Atlas_dispose(atlas);
+
+	if (failures) return 1;
+	printf("OK: JSON parse errors\n");
+	return 0;
+}
@@ -0,0 +1,54 @@
+/* Checks that SkeletonJson reads bone lengths and slot timelines.
+ *
+ * The optional argument is the directory containing spineboy-skeleton.json and spineboy.atlas, by default data/. */
+
+#include <stdio.h>
+#include <math.h>
+#include <spine/spine.h>
+
+static int failures;
+
+static void check (int condition, const char* message) {
+	if (condition) return;
+	printf("FAILED: %s\n", message);
+	failures++;
+}
+
+static const char* slotAnimation = "{\"bones\": {}, \"slots\": {\"torso\": {"
+		"\"color\": [{\"time\": 0, \"color\": \"ff000000\"}, {\"time\": 2, \"color\": \"00ff00ff\"}],"
+		"\"attachment\": [{\"time\": 0, \"name\": null}, {\"time\": 1, \"name\": \"torso\"}]}}}";
+
+int main (int argc, char** argv) {
+	const char* dir = argc > 1 ? argv[1] : "data/";
+	char path[1024];
+	snprintf(path, sizeof(path), "%s%s", dir, "spineboy.atlas");
+	Atlas* atlas = Atlas_readAtlasFile(path);
+	check(atlas != 0, "Atlas_readAtlasFile reads spineboy.atlas");
+	if (!atlas) return 1;
+	SkeletonJson* json = SkeletonJson_create(atlas);
+
+	snprintf(path, sizeof(path), "%s%s", dir, "spineboy-skeleton.json");
+	SkeletonData* skeletonData = SkeletonJson_readSkeletonDataFile(json, path);
+	check(skeletonData != 0, "SkeletonJson reads spineboy-skeleton.json");
+	if (!skeletonData) return 1;
+
+	BoneData* torso = SkeletonData_findBone(skeletonData, "torso");
+	check(torso && fabsf(torso->length - 85.82f) < 0.001f, "torso length");
+	check(SkeletonData_findBone(skeletonData, "root")->length == 0, "root length");
+
+	Animation* animation = SkeletonJson_readAnimation(json, slotAnimation, skeletonData);
+	check(animation != 0, "SkeletonJson reads slot timelines");
+	if (animation) {
+		check(animation->timelineCount == 2, "slot timeline count");
+		check(animation->duration == 2, "slot timeline duration");
+		Animation_dispose(animation);
+	}
+
+	SkeletonData_dispose(skeletonData);
+	SkeletonJson_dispose(json);
+	Atlas_dispose(atlas);
+
+	if (failures) return 1;
+	printf("OK: SkeletonJson bone lengths and slot timelines\n");
+	return 0;
+}
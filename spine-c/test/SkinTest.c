@@ -0,0 +1,169 @@
+/* Checks Skin lookups as the skin grows, Skin_addAttachment's results when memory runs out, that the first of duplicate attachments
+ * is kept, and that Skin_attachAll switches only the attachments that came from the old skin.
+ *
+ * The optional argument is the directory containing spineboy-skeleton.json and spineboy.atlas, by default data/. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <spine/spine.h>
+#include <spine/Arena.h>
+#include <spine/extension.h>
+#include <spine/util.h>
+
+#define SLOT_COUNT 10
+#define NAME_COUNT 100
+
+static int failures;
+
+static void check (int condition, const char* message) {
+	if (condition) return;
+	printf("FAILED: %s\n", message);
+	failures++;
+}
+
+static int/*bool*/failMalloc;
+
+static void* hookMalloc (size_t size) {
+	return failMalloc ? 0 : malloc(size);
+}
+
+static int disposedCount;
+
+static void _TestAttachment_dispose (Attachment* self) {
+	disposedCount++;
+	_Attachment_deinit(self);
+}
+
+static Attachment* createAttachment (const char* name) {
+	Attachment* self = CALLOC(Attachment, 1)
+	_Attachment_init(self, name, ATTACHMENT_REGION);
+	self->_dispose = _TestAttachment_dispose;
+	return self;
+}
+
+static int countEntries (const Skin* skin) {
+	int count = 0;
+	const SkinEntry* entry;
+	for (entry = skin->entries; entry; entry = entry->next)
+		count++;
+	return count;
+}
+
+int main (int argc, char** argv) {
+	_setMalloc(hookMalloc);
+	const char* dir = argc > 1 ? argv[1] : "data/";
+	char name[32];
+	int i, ii;
+
+	/* Lookups hit every attachment and miss other slots and names while the buckets grow. */
+	Skin* skin = Skin_create("skin");
+	check(!Skin_getAttachment(skin, 0, "a0"), "Skin_getAttachment on an empty skin");
+	Attachment* attachments[SLOT_COUNT][NAME_COUNT];
+	int added = 1;
+	for (i = 0; i < NAME_COUNT; i++) {
+		for (ii = 0; ii < SLOT_COUNT; ii++) {
+			snprintf(name, sizeof(name), "a%d", i);
+			attachments[ii][i] = createAttachment(name);
+			added &= Skin_addAttachment(skin, ii, name, attachments[ii][i]);
+		}
+	}
+	check(added, "Skin_addAttachment returns 1");
+	check(countEntries(skin) == SLOT_COUNT * NAME_COUNT, "entry count");
+	int found = 1, missed = 1;
+	for (i = 0; i < NAME_COUNT; i++) {
+		for (ii = 0; ii < SLOT_COUNT; ii++) {
+			snprintf(name, sizeof(name), "a%d", i);
+			found &= Skin_getAttachment(skin, ii, name) == attachments[ii][i];
+		}
+		missed &= !Skin_getAttachment(skin, SLOT_COUNT, name) && !Skin_getAttachment(skin, -1, name);
+		snprintf(name, sizeof(name), "b%d", i);
+		missed &= !Skin_getAttachment(skin, 0, name);
+	}
+	check(found, "Skin_getAttachment finds every attachment");
+	check(missed && !Skin_getAttachment(skin, 0, "a") && !Skin_getAttachment(skin, 0, ""), "Skin_getAttachment misses");
+
+	/* The first attachment added for a slot and name is kept, and both are in the entries. */
+	Attachment* duplicate = createAttachment("a5");
+	check(Skin_addAttachment(skin, 3, "a5", duplicate), "Skin_addAttachment returns 1 for a duplicate");
+	check(Skin_getAttachment(skin, 3, "a5") == attachments[3][5], "the first duplicate is not kept");
+	check(countEntries(skin) == SLOT_COUNT * NAME_COUNT + 1, "duplicate not in the entries");
+	disposedCount = 0;
+	Skin_dispose(skin);
+	check(disposedCount == SLOT_COUNT * NAME_COUNT + 1, "Skin_dispose disposes every attachment");
+
+	/* When memory runs out, the attachment is disposed and the skin is unchanged. */
+	skin = Skin_create("skin");
+	Attachment* attachment = createAttachment("first");
+	disposedCount = 0;
+	failMalloc = 1;
+	check(!Skin_addAttachment(skin, 0, "first", attachment), "Skin_addAttachment returns 0 when the buckets can't be allocated");
+	failMalloc = 0;
+	check(disposedCount == 1 && !skin->entries && !Skin_getAttachment(skin, 0, "first"), "failed add changed the skin");
+	attachment = createAttachment("first");
+	check(Skin_addAttachment(skin, 0, "first", attachment), "Skin_addAttachment returns 1 after a failure");
+	Attachment* second = createAttachment("second");
+	failMalloc = 1;
+	check(!Skin_addAttachment(skin, 0, "second", second), "Skin_addAttachment returns 0 when the entry can't be allocated");
+	failMalloc = 0;
+	check(disposedCount == 2 && countEntries(skin) == 1 && !Skin_getAttachment(skin, 0, "second"), "failed add changed the skin");
+	check(Skin_getAttachment(skin, 0, "first") == attachment, "failed add lost an attachment");
+	Skin_dispose(skin);
+
+	/* Switching skins replaces only attachments from the old skin that the new skin has for the same slot and name. */
+	char path[1024];
+	snprintf(path, sizeof(path), "%s%s", dir, "spineboy.atlas");
+	Atlas* atlas = Atlas_readAtlasFile(path);
+	check(atlas != 0, "Atlas_readAtlasFile reads spineboy.atlas");
+	if (!atlas) return 1;
+	SkeletonJson* json = SkeletonJson_create(atlas);
+	snprintf(path, sizeof(path), "%s%s", dir, "spineboy-skeleton.json");
+	SkeletonData* skeletonData = SkeletonJson_readSkeletonDataFile(json, path);
+	check(skeletonData != 0, "SkeletonJson reads spineboy-skeleton.json");
+	if (!skeletonData) return 1;
+	Skeleton* skeleton = Skeleton_create(skeletonData);
+	check(skeleton->slotCount >= 6, "spineboy slot count");
+
+	Skin* red = Skin_create("red");
+	Skin* blue = Skin_create("blue");
+	Attachment* red0 = createAttachment("part");
+	Attachment* red1 = createAttachment("part");
+	Attachment* red2 = createAttachment("only red");
+	Attachment* blue0 = createAttachment("part");
+	Attachment* blue1 = createAttachment("part");
+	Attachment* other = createAttachment("other");
+	Skin_addAttachment(red, 0, "part", red0);
+	Skin_addAttachment(red, 1, "part", red1);
+	Skin_addAttachment(red, 2, "only red", red2);
+	Skin_addAttachment(blue, 0, "part", blue0);
+	Skin_addAttachment(blue, 1, "part", blue1);
+	for (i = 0; i < skeleton->slotCount; i++)
+		Slot_setAttachment(skeleton->slots[i], 0);
+	Slot_setAttachment(skeleton->slots[0], red0);
+	Slot_setAttachment(skeleton->slots[2], red2);
+	Slot_setAttachment(skeleton->slots[3], other);
+	/* The old skin's attachment for slot 1, attached to another slot. */
+	Slot_setAttachment(skeleton->slots[4], red1);
+
+	Skin_attachAll(blue, skeleton, red);
+	check(skeleton->slots[0]->attachment == blue0, "Skin_attachAll didn't switch an attachment from the old skin");
+	check(!skeleton->slots[1]->attachment, "Skin_attachAll attached to an empty slot");
+	check(skeleton->slots[2]->attachment == red2, "Skin_attachAll changed an attachment the new skin doesn't have");
+	check(skeleton->slots[3]->attachment == other, "Skin_attachAll changed an attachment not from the old skin");
+	check(skeleton->slots[4]->attachment == red1, "Skin_attachAll switched an attachment attached to another slot");
+	check(!skeleton->slots[5]->attachment, "Skin_attachAll attached to an empty slot");
+
+	Skin_attachAll(red, skeleton, blue);
+	check(skeleton->slots[0]->attachment == red0, "Skin_attachAll didn't switch back");
+
+	Skeleton_dispose(skeleton);
+	Skin_dispose(red);
+	Skin_dispose(blue);
+	Attachment_dispose(other);
+	SkeletonData_dispose(skeletonData);
+	SkeletonJson_dispose(json);
+	Atlas_dispose(atlas);
+
+	if (failures) return 1;
+	printf("OK: Skin lookups, adds, duplicates and switching\n");
+	return 0;
+}
@@ -33,29 +33,38 @@ namespace spine {
 
 class AtlasPage: public BaseAtlasPage {
 public:
+	AtlasPage ();
 	~AtlasPage ();
 
 	cocos2d::CCTexture2D *texture;
 	cocos2d::CCTextureAtlas *atlas;
+
+	virtual void addMemoryUsage (MemoryUsage &usage) const;
 };
 
 //
 
 class AtlasRegion: public BaseAtlasRegion {
 public:
-	AtlasPage *page;
+	AtlasPage* getPage () const {
+		return static_cast<AtlasPage*>(page);
+	}
 };
 
 //
 
 class Atlas: public BaseAtlas {
 public:
-	Atlas (const std::string &path);
-	Atlas (std::istream &input);
-	Atlas (const char *begin, const char *end);
+	/** @param deferTextures If true, loadTextures must be called on the cocos2d-x thread before the atlas is used. */
+	Atlas (const std::string &path, bool deferTextures = false);
+	Atlas (std::istream &input, bool deferTextures = false);
+	Atlas (const char *begin, const char *end, bool deferTextures = false);
 
 	AtlasRegion* findRegion (const std::string &name);
 
+protected:
+	virtual void loadTexture (BaseAtlasPage *page);
+
 private:
 	virtual BaseAtlasPage* newAtlasPage (const std::string &name);
 	virtual BaseAtlasRegion* newAtlasRegion (BaseAtlasPage* page);
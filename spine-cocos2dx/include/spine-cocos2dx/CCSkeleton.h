@@ -27,11 +27,17 @@
 #define SPINE_CCSKELETON_H_
 
 #include "cocos2d.h"
+#include <vector>
+#ifdef SPINE_ASYNC_UPDATE
+#include <functional>
+#include <exception>
+#endif
 
 namespace spine {
 
 class SkeletonData;
 class Skeleton;
+class Animation;
 class AnimationState;
 class AnimationStateData;
 
@@ -48,8 +54,72 @@ public:
 	virtual void update (float deltaTime);
 	virtual void draw ();
 
+	/** Sets the skeleton's color from this node's color and opacity. */
+	void updateSkeletonColor ();
+
+#ifdef SPINE_ASYNC_UPDATE
+	/** When true, update advances the animation and computes the quads on a worker thread while the quads from the previous update
+	 * are drawn, so what is drawn is one update behind. While the worker is updating, skeleton and state must not be used by other
+	 * code: call waitForUpdate first, or make changes with runOnUpdate or setAnimation. Asynchronous updates need C++11 threads and
+	 * are compiled in only when SPINE_ASYNC_UPDATE is defined. */
+	void setAsyncUpdate (bool asyncUpdate);
+	bool isAsyncUpdate () const;
+
+	/** Blocks until the worker is done with the update that was last started. Afterward skeleton and state can be used until update
+	 * is next called. Rethrows an exception thrown by the update. */
+	void waitForUpdate ();
+
+	/** Runs the function on this thread when skeleton and state are next safe to change, before the next update is started. Runs it
+	 * immediately when updates aren't asynchronous. */
+	void runOnUpdate (const std::function<void()> &function);
+#endif
+
+	/** Sets the state's animation, using runOnUpdate when updates are asynchronous. */
+	void setAnimation (Animation *animation, bool loop = false);
+
 	// CCBlendProtocol
 	CC_PROPERTY(cocos2d::ccBlendFunc, blendFunc, BlendFunc);
+
+private:
+	friend class CCSkeletonBatchNode;
+
+	/** Reused to draw the bones when updates are synchronous. */
+	std::vector<cocos2d::CCPoint> boneLines;
+
+	/** Writes each bone's world origin followed by the end of its length, for debug drawing. */
+	void computeBoneLines (std::vector<cocos2d::CCPoint> &lines) const;
+
+#ifdef SPINE_ASYNC_UPDATE
+	class UpdateWorker;
+
+	struct QuadBuffer {
+		std::vector<cocos2d::ccV3F_C4B_T2F_Quad> quads;
+		/** The atlas of each quad's page. */
+		std::vector<cocos2d::CCTextureAtlas*> atlases;
+		/** From computeBoneLines, only when debug was true when the update started. */
+		std::vector<cocos2d::CCPoint> boneLines;
+	};
+
+	bool asyncUpdate;
+	/** Set while this skeleton is asynchronous, which keeps the worker alive. */
+	UpdateWorker *worker;
+	/** True from when update starts the worker until it is done. Guarded by the worker's mutex. */
+	bool updating;
+	float updateDelta;
+	/** The value of debug when the update started, so the worker doesn't read debug while it is being changed. */
+	bool updateDebug;
+	std::exception_ptr updateError;
+	/** The quads being drawn are in quadBuffers[frontBuffer], the worker writes the other buffer. */
+	QuadBuffer quadBuffers[2];
+	int frontBuffer;
+	std::vector<std::function<void()> > pendingFunctions;
+
+	void runPendingFunctions ();
+	void computeQuads (QuadBuffer &buffer) const;
+	void drawQuads (const QuadBuffer &buffer);
+#endif
+
+	void updateSkeleton (float deltaTime);
 };
 
 } /* namespace spine */
@@ -0,0 +1,69 @@
+/*******************************************************************************
+ * Copyright (c) 2013, Esoteric Software
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ******************************************************************************/
+
+#ifndef SPINE_CCSKELETONBATCHNODE_H_
+#define SPINE_CCSKELETONBATCHNODE_H_
+
+#include "cocos2d.h"
+#include <vector>
+
+namespace spine {
+
+/** Draws all of its CCSkeleton children with one draw call per atlas page, like CCSpriteBatchNode does for sprites. Only
+ * CCSkeletons can be added. Children are not visited, so they can't have children of their own, and quads are grouped by page,
+ * so draw order is only kept between attachments on the same page. Only RegionAttachments are drawn, as they are the only
+ * attachments with a quad. The children's debug drawing is not done. */
+class CCSkeletonBatchNode: public cocos2d::CCNode, public cocos2d::CCBlendProtocol {
+public:
+	static CCSkeletonBatchNode* create ();
+	CCSkeletonBatchNode ();
+	virtual ~CCSkeletonBatchNode ();
+
+	using cocos2d::CCNode::addChild;
+	virtual void addChild (cocos2d::CCNode *child, int zOrder, int tag);
+	virtual void visit ();
+	virtual void draw ();
+
+	// CCBlendProtocol
+	CC_PROPERTY(cocos2d::ccBlendFunc, blendFunc, BlendFunc);
+
+private:
+	struct Page {
+		/** The atlas of the attachments' page, which provides the texture. */
+		cocos2d::CCTextureAtlas *source;
+		/** Holds this node's quads for the page. */
+		cocos2d::CCTextureAtlas *atlas;
+		unsigned int quadCount;
+	};
+
+	std::vector<Page> pages;
+	/** Each page's atlas holds this many quads, enough for every slot of every child. */
+	unsigned int quadCapacity;
+
+	Page& getPage (cocos2d::CCTextureAtlas *source);
+};
+
+} /* namespace spine */
+#endif /* SPINE_CCSKELETONBATCHNODE_H_ */
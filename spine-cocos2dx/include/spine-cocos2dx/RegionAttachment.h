@@ -43,6 +43,11 @@ public:
 
 	virtual void updateWorldVertices (Bone *bone);
 	virtual void draw (Slot *slot);
+
+	/** Writes this attachment's quad for the slot, with the skeleton and slot color and the bone's world transform. */
+	void updateQuad (Slot *slot, cocos2d::ccV3F_C4B_T2F_Quad *quad) const;
+
+	virtual void addMemoryUsage (MemoryUsage &usage) const;
 };
 
 } /* namespace spine */
@@ -42,6 +42,8 @@ public:
 
 	void addQuad (cocos2d::CCTextureAtlas *atlas, cocos2d::ccV3F_C4B_T2F_Quad &quad);
 	virtual void draw ();
+
+	virtual SkeletonMemoryUsage memoryUsage () const;
 };
 
 } /* namespace spine */
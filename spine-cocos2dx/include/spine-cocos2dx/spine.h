@@ -43,5 +43,6 @@
 #include <spine-cocos2dx/SkeletonJson.h>
 #include <spine-cocos2dx/Skeleton.h>
 #include <spine-cocos2dx/CCSkeleton.h>
+#include <spine-cocos2dx/CCSkeletonBatchNode.h>
 
 #endif /* SF_SPINE_H_ */
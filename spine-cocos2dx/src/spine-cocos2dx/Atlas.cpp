@@ -30,42 +30,61 @@ USING_NS_CC;
 
 namespace spine {
 
+AtlasPage::AtlasPage () :
+				texture(0),
+				atlas(0) {
+}
+
 AtlasPage::~AtlasPage () {
 	CC_SAFE_RELEASE_NULL(texture);
 	CC_SAFE_RELEASE_NULL(atlas);
 }
 
+void AtlasPage::addMemoryUsage (MemoryUsage &usage) const {
+	usage.add(objectMemory, sizeof(AtlasPage));
+	usage.addCharacters(name);
+	// The texture atlas keeps a copy of the quads in client memory.
+	if (atlas) usage.add(arrayMemory, atlas->getCapacity() * sizeof(cocos2d::ccV3F_C4B_T2F_Quad));
+}
+
 //
 
-Atlas::Atlas (const std::string &path) {
+Atlas::Atlas (const std::string &path, bool deferTextures) :
+				BaseAtlas(deferTextures) {
 	unsigned long size;
 	char *data = reinterpret_cast<char*>(CCFileUtils::sharedFileUtils()->getFileData(
-			CCFileUtils::sharedFileUtils()->fullPathForFilename(path.c_str()).c_str(), "r", &size));
+			CCFileUtils::sharedFileUtils()->fullPathForFilename(path.c_str()).c_str(), "rb", &size));
 	if (!data) throw std::runtime_error("Error reading atlas file: " + path);
 	load(data, data + size);
 }
 
-Atlas::Atlas (std::istream &input) {
+Atlas::Atlas (std::istream &input, bool deferTextures) :
+				BaseAtlas(deferTextures) {
 	load(input);
 }
 
-Atlas::Atlas (const char *begin, const char *end) {
+Atlas::Atlas (const char *begin, const char *end, bool deferTextures) :
+				BaseAtlas(deferTextures) {
 	load(begin, end);
 }
 
 BaseAtlasPage* Atlas::newAtlasPage (const std::string &name) {
-	AtlasPage *page = new AtlasPage();
-	page->texture = CCTextureCache::sharedTextureCache()->addImage(name.c_str());
+	return new AtlasPage();
+}
+
+void Atlas::loadTexture (BaseAtlasPage *basePage) {
+	AtlasPage *page = static_cast<AtlasPage*>(basePage);
+	page->texture = CCTextureCache::sharedTextureCache()->addImage(page->name.c_str());
 	page->texture->retain();
+	const CCSize &size = page->texture->getContentSizeInPixels();
+	page->width = (int)size.width;
+	page->height = (int)size.height;
 	page->atlas = CCTextureAtlas::createWithTexture(page->texture, 4);
 	page->atlas->retain();
-	return page;
 }
 
 BaseAtlasRegion* Atlas::newAtlasRegion (BaseAtlasPage* page) {
-	AtlasRegion *region = new AtlasRegion();
-	region->page = reinterpret_cast<AtlasPage*>(page);
-	return region;
+	return new AtlasRegion();
 }
 
 AtlasRegion* Atlas::findRegion (const std::string &name) {
@@ -25,6 +25,14 @@
 
 #include <spine-cocos2dx/CCSkeleton.h>
 #include <stdexcept>
+#ifdef SPINE_ASYNC_UPDATE
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#endif
 #include <spine-cocos2dx/Skeleton.h>
 #include <spine-cocos2dx/RegionAttachment.h>
 #include <spine/SkeletonData.h>
@@ -33,10 +41,129 @@
 #include <spine/Slot.h>
 #include <spine/BoneData.h>
 #include <spine/Bone.h>
+#include <spine/Instrumentation.h>
 
 using namespace spine;
 USING_NS_CC;
 
+#ifdef SPINE_ASYNC_UPDATE
+/** Runs the updates of asynchronous skeletons. The threads are started when a skeleton is made asynchronous and there is no worker,
+ * and stopped when no skeleton is asynchronous any more. Asynchronous skeletons keep the worker alive, so it isn't destroyed before
+ * skeletons that are still referenced at exit. */
+class CCSkeleton::UpdateWorker {
+public:
+	/** Called on the main thread. */
+	static UpdateWorker* acquire () {
+		if (!instance) instance = new UpdateWorker();
+		instance->references++;
+		return instance;
+	}
+
+	/** Called on the main thread. */
+	void release () {
+		if (--references) return;
+		instance = 0;
+		delete this;
+	}
+
+	void start (CCSkeleton *skeleton) {
+		std::lock_guard<std::mutex> lock(mutex);
+		skeleton->updating = true;
+		queue.push_back(skeleton);
+		workCondition.notify_one();
+	}
+
+	void wait (CCSkeleton *skeleton) {
+		std::unique_lock<std::mutex> lock(mutex);
+		while (skeleton->updating)
+			doneCondition.wait(lock);
+	}
+
+private:
+	static UpdateWorker *instance;
+
+	int references;
+	std::vector<std::thread> threads;
+	std::deque<CCSkeleton*> queue;
+	std::mutex mutex;
+	std::condition_variable workCondition;
+	std::condition_variable doneCondition;
+	bool stopping;
+
+	UpdateWorker () :
+					references(0), stopping(false) {
+		// Leave a core for the main thread.
+		int threadCount = std::max(1, (int)std::thread::hardware_concurrency() - 1);
+		for (int i = 0; i < threadCount; i++)
+			threads.push_back(std::thread(&UpdateWorker::run, this));
+	}
+
+	~UpdateWorker () {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stopping = true;
+		}
+		workCondition.notify_all();
+		for (int i = 0, n = threads.size(); i < n; i++)
+			threads[i].join();
+	}
+
+	void run () {
+		std::unique_lock<std::mutex> lock(mutex);
+		while (true) {
+			while (queue.empty() && !stopping)
+				workCondition.wait(lock);
+			if (queue.empty()) return;
+			CCSkeleton *skeleton = queue.front();
+			queue.pop_front();
+			lock.unlock();
+
+			QuadBuffer &buffer = skeleton->quadBuffers[1 - skeleton->frontBuffer];
+			try {
+				skeleton->updateSkeleton(skeleton->updateDelta);
+				skeleton->computeQuads(buffer);
+				buffer.boneLines.clear();
+				if (skeleton->updateDebug) skeleton->computeBoneLines(buffer.boneLines);
+			} catch (...) {
+				skeleton->updateError = std::current_exception();
+			}
+
+			lock.lock();
+			skeleton->updating = false;
+			doneCondition.notify_all();
+		}
+	}
+};
+
+CCSkeleton::UpdateWorker *CCSkeleton::UpdateWorker::instance;
+#endif
+
+static void drawQuadOutline (const ccV3F_C4B_T2F_Quad &quad) {
+	CCPoint points[4];
+	points[0] = ccp(quad.bl.vertices.x, quad.bl.vertices.y);
+	points[1] = ccp(quad.br.vertices.x, quad.br.vertices.y);
+	points[2] = ccp(quad.tr.vertices.x, quad.tr.vertices.y);
+	points[3] = ccp(quad.tl.vertices.x, quad.tl.vertices.y);
+	ccDrawPoly(points, 4, true);
+}
+
+static void drawBoneLines (const std::vector<CCPoint> &lines) {
+	// Bone lengths.
+	glLineWidth(2);
+	ccDrawColor4B(255, 0, 0, 255);
+	for (int i = 0, n = lines.size(); i < n; i += 2)
+		ccDrawLine(lines[i], lines[i + 1]);
+	// Bone origins.
+	ccPointSize(4);
+	ccDrawColor4B(0, 0, 255, 255); // Root bone is blue.
+	for (int i = 0, n = lines.size(); i < n; i += 2) {
+		ccDrawPoint(lines[i]);
+		if (i == 0) ccDrawColor4B(0, 255, 0, 255);
+	}
+}
+
+/**/
+
 CCSkeleton* CCSkeleton::create (SkeletonData* skeletonData) {
 	CCSkeleton* skeleton = new CCSkeleton(skeletonData);
 	skeleton->autorelease();
@@ -44,7 +171,16 @@ CCSkeleton* CCSkeleton::create (SkeletonData* skeletonData) {
 }
 
 CCSkeleton::CCSkeleton (SkeletonData *skeletonData, AnimationStateData *stateData) :
-				debug(false) {
+				debug(false)
+#ifdef SPINE_ASYNC_UPDATE
+				, asyncUpdate(false),
+				worker(0),
+				updating(false),
+				updateDelta(0),
+				updateDebug(false),
+				frontBuffer(0)
+#endif
+{
 	if (!skeletonData) throw std::invalid_argument("skeletonData cannot be null.");
 	skeleton = new Skeleton(skeletonData);
 	state = new AnimationState(stateData);
@@ -57,11 +193,36 @@ CCSkeleton::CCSkeleton (SkeletonData *skeletonData, AnimationStateData *stateDat
 }
 
 CCSkeleton::~CCSkeleton () {
+#ifdef SPINE_ASYNC_UPDATE
+	try {
+		waitForUpdate();
+	} catch (...) {
+	}
+	if (worker) worker->release();
+#endif
 	delete skeleton;
 	delete state;
 }
 
 void CCSkeleton::update (float deltaTime) {
+#ifdef SPINE_ASYNC_UPDATE
+	if (asyncUpdate) {
+		// The quads the worker computed for the last update are drawn until the next update.
+		waitForUpdate();
+		frontBuffer = 1 - frontBuffer;
+		runPendingFunctions();
+		updateSkeletonColor();
+		updateDelta = deltaTime;
+		updateDebug = debug;
+		worker->start(this);
+		return;
+	}
+#endif
+	updateSkeleton(deltaTime);
+}
+
+void CCSkeleton::updateSkeleton (float deltaTime) {
+	SPINE_SCOPE("CCSkeleton::updateSkeleton");
 	skeleton->update(deltaTime);
 	state->update(deltaTime);
 	state->apply(skeleton);
@@ -69,49 +230,157 @@ void CCSkeleton::update (float deltaTime) {
 }
 
 void CCSkeleton::draw () {
+	SPINE_SCOPE("CCSkeleton::draw");
 	CC_NODE_DRAW_SETUP();
 
 	ccGLBlendFunc(blendFunc.src, blendFunc.dst);
-	ccColor3B color = getColor();
-	skeleton->r = color.r / (float)255;
-	skeleton->g = color.g / (float)255;
-	skeleton->b = color.b / (float)255;
-	skeleton->a = getOpacity() / (float)255;
+#ifdef SPINE_ASYNC_UPDATE
+	if (asyncUpdate) {
+		// Everything is drawn from the buffer of the last update, as the worker may be changing the skeleton.
+		const QuadBuffer &buffer = quadBuffers[frontBuffer];
+		drawQuads(buffer);
+		if (debug) {
+			// Slots.
+			ccDrawColor4B(0, 0, 255, 10);
+			glLineWidth(1);
+			for (int i = 0, n = buffer.quads.size(); i < n; i++)
+				drawQuadOutline(buffer.quads[i]);
+			drawBoneLines(buffer.boneLines);
+		}
+		return;
+	}
+#endif
+	updateSkeletonColor();
 	skeleton->draw();
 
 	if (debug) {
 		// Slots.
 		ccDrawColor4B(0, 0, 255, 10);
 		glLineWidth(1);
-		CCPoint points[4];
 		for (int i = 0, n = skeleton->slots.size(); i < n; i++) {
-			if (!skeleton->slots[i]->attachment) continue;
-			ccV3F_C4B_T2F_Quad quad = ((RegionAttachment*)skeleton->slots[i]->attachment)->quad;
-			points[0] = ccp(quad.bl.vertices.x, quad.bl.vertices.y);
-			points[1] = ccp(quad.br.vertices.x, quad.br.vertices.y);
-			points[2] = ccp(quad.tr.vertices.x, quad.tr.vertices.y);
-			points[3] = ccp(quad.tl.vertices.x, quad.tl.vertices.y);
-			ccDrawPoly(points, 4, true);
+			RegionAttachment *attachment = dynamic_cast<RegionAttachment*>(skeleton->slots[i]->attachment);
+			if (attachment) drawQuadOutline(attachment->quad);
 		}
-		// Bone lengths.
-		glLineWidth(2);
-		ccDrawColor4B(255, 0, 0, 255);
-		for (int i = 0, n = skeleton->bones.size(); i < n; i++) {
-			Bone *bone = skeleton->bones[i];
-			float x = bone->data->length * bone->m00 + bone->worldX;
-			float y = bone->data->length * bone->m10 + bone->worldY;
-			ccDrawLine(ccp(bone->worldX, bone->worldY), ccp(x, y));
-		}
-		// Bone origins.
-		ccPointSize(4);
-		ccDrawColor4B(0, 0, 255, 255); // Root bone is blue.
-		for (int i = 0, n = skeleton->bones.size(); i < n; i++) {
-			Bone *bone = skeleton->bones[i];
-			ccDrawPoint(ccp(bone->worldX, bone->worldY));
-			if (i == 0) ccDrawColor4B(0, 255, 0, 255);
+		computeBoneLines(boneLines);
+		drawBoneLines(boneLines);
+	}
+}
+
+void CCSkeleton::computeBoneLines (std::vector<CCPoint> &lines) const {
+	lines.clear();
+	for (int i = 0, n = skeleton->bones.size(); i < n; i++) {
+		Bone *bone = skeleton->bones[i];
+		float x = bone->data->length * bone->m00 + bone->worldX;
+		float y = bone->data->length * bone->m10 + bone->worldY;
+		lines.push_back(ccp(bone->worldX, bone->worldY));
+		lines.push_back(ccp(x, y));
+	}
+}
+
+void CCSkeleton::updateSkeletonColor () {
+	ccColor3B color = getColor();
+	skeleton->r = color.r / (float)255;
+	skeleton->g = color.g / (float)255;
+	skeleton->b = color.b / (float)255;
+	skeleton->a = getOpacity() / (float)255;
+}
+
+void CCSkeleton::setAnimation (Animation *animation, bool loop) {
+#ifdef SPINE_ASYNC_UPDATE
+	if (asyncUpdate) {
+		AnimationState *state = this->state;
+		runOnUpdate([=] () {
+			state->setAnimation(animation, loop);
+		});
+		return;
+	}
+#endif
+	state->setAnimation(animation, loop);
+}
+
+#ifdef SPINE_ASYNC_UPDATE
+void CCSkeleton::setAsyncUpdate (bool asyncUpdate) {
+	if (this->asyncUpdate == asyncUpdate) return;
+	if (asyncUpdate) {
+		// Both buffers start with the current pose, so drawing before the first update finishes shows it.
+		for (int i = 0; i < 2; i++) {
+			quadBuffers[i].quads.reserve(skeleton->slots.size());
+			quadBuffers[i].atlases.reserve(skeleton->slots.size());
 		}
+		updateSkeletonColor();
+		computeQuads(quadBuffers[frontBuffer]);
+		computeBoneLines(quadBuffers[frontBuffer].boneLines);
+		quadBuffers[1 - frontBuffer] = quadBuffers[frontBuffer];
+		worker = UpdateWorker::acquire();
+	} else {
+		waitForUpdate();
+		runPendingFunctions();
+		worker->release();
+		worker = 0;
+	}
+	this->asyncUpdate = asyncUpdate;
+}
+
+bool CCSkeleton::isAsyncUpdate () const {
+	return asyncUpdate;
+}
+
+void CCSkeleton::waitForUpdate () {
+	if (!asyncUpdate) return;
+	worker->wait(this);
+	if (updateError) {
+		std::exception_ptr error = updateError;
+		updateError = std::exception_ptr();
+		std::rethrow_exception(error);
+	}
+}
+
+void CCSkeleton::runOnUpdate (const std::function<void()> &function) {
+	if (asyncUpdate)
+		pendingFunctions.push_back(function);
+	else
+		function();
+}
+
+void CCSkeleton::runPendingFunctions () {
+	// Functions queued while running are run next time.
+	std::vector<std::function<void()> > functions;
+	functions.swap(pendingFunctions);
+	for (int i = 0, n = functions.size(); i < n; i++)
+		functions[i]();
+}
+
+void CCSkeleton::computeQuads (QuadBuffer &buffer) const {
+	buffer.quads.clear();
+	buffer.atlases.clear();
+	for (int i = 0, n = skeleton->drawOrder.size(); i < n; i++) {
+		Slot *slot = skeleton->drawOrder[i];
+		// Only RegionAttachments have a quad.
+		RegionAttachment *attachment = dynamic_cast<RegionAttachment*>(slot->attachment);
+		if (!attachment) continue;
+		buffer.quads.resize(buffer.quads.size() + 1);
+		attachment->updateQuad(slot, &buffer.quads.back());
+		buffer.atlases.push_back(attachment->atlas);
+	}
+}
+
+void CCSkeleton::drawQuads (const QuadBuffer &buffer) {
+	// Each run of quads on the same page is copied into the page's atlas and drawn, like Skeleton::draw does.
+	for (int start = 0, count = buffer.quads.size(); start < count;) {
+		CCTextureAtlas *atlas = buffer.atlases[start];
+		int end = start + 1;
+		while (end < count && buffer.atlases[end] == atlas)
+			end++;
+		unsigned int runCount = end - start;
+		if (atlas->getCapacity() < runCount && !atlas->resizeCapacity(runCount)) return;
+		memcpy(atlas->getQuads(), &buffer.quads[start], sizeof(ccV3F_C4B_T2F_Quad) * runCount);
+		atlas->setDirty(true);
+		atlas->drawNumberOfQuads(runCount, 0);
+		SPINE_COUNT(quadsEmitted, runCount);
+		start = end;
 	}
 }
+#endif
 
 // CCBlendProtocol
 
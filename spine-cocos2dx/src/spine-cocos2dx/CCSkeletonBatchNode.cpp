@@ -0,0 +1,158 @@
+/*******************************************************************************
+ * Copyright (c) 2013, Esoteric Software
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ******************************************************************************/
+
+#include <spine-cocos2dx/CCSkeletonBatchNode.h>
+#include <spine-cocos2dx/CCSkeleton.h>
+#include <spine-cocos2dx/Skeleton.h>
+#include <spine-cocos2dx/RegionAttachment.h>
+#include <spine/Slot.h>
+#include <spine/Instrumentation.h>
+
+using namespace spine;
+USING_NS_CC;
+
+static void transformQuad (ccV3F_C4B_T2F_Quad *quad, const CCAffineTransform &transform) {
+	ccVertex3F *vertices[] = {&quad->bl.vertices, &quad->tl.vertices, &quad->tr.vertices, &quad->br.vertices};
+	for (int i = 0; i < 4; i++) {
+		float x = vertices[i]->x, y = vertices[i]->y;
+		vertices[i]->x = transform.a * x + transform.c * y + transform.tx;
+		vertices[i]->y = transform.b * x + transform.d * y + transform.ty;
+	}
+}
+
+CCSkeletonBatchNode* CCSkeletonBatchNode::create () {
+	CCSkeletonBatchNode* batchNode = new CCSkeletonBatchNode();
+	batchNode->autorelease();
+	return batchNode;
+}
+
+CCSkeletonBatchNode::CCSkeletonBatchNode () :
+				quadCapacity(0) {
+	blendFunc.src = GL_SRC_ALPHA;
+	blendFunc.dst = GL_ONE_MINUS_SRC_ALPHA;
+
+	setShaderProgram(CCShaderCache::sharedShaderCache()->programForKey(kCCShader_PositionTextureColor));
+}
+
+CCSkeletonBatchNode::~CCSkeletonBatchNode () {
+	for (int i = 0, n = pages.size(); i < n; i++)
+		pages[i].atlas->release();
+}
+
+void CCSkeletonBatchNode::addChild (CCNode *child, int zOrder, int tag) {
+	CCSkeleton *skeletonNode = dynamic_cast<CCSkeleton*>(child);
+	CCAssert(skeletonNode, "CCSkeletonBatchNode only supports CCSkeletons as children.");
+	if (!skeletonNode) return;
+
+	// Grow up front, so drawing never has to.
+	quadCapacity += skeletonNode->skeleton->slots.size();
+	for (int i = 0, n = pages.size(); i < n; i++)
+		if (pages[i].atlas->getCapacity() < quadCapacity) pages[i].atlas->resizeCapacity(quadCapacity);
+
+	CCNode::addChild(child, zOrder, tag);
+}
+
+CCSkeletonBatchNode::Page& CCSkeletonBatchNode::getPage (CCTextureAtlas *source) {
+	for (int i = 0, n = pages.size(); i < n; i++)
+		if (pages[i].source == source) return pages[i];
+	Page page;
+	page.source = source;
+	page.atlas = CCTextureAtlas::createWithTexture(source->getTexture(), quadCapacity);
+	page.atlas->retain();
+	page.quadCount = 0;
+	pages.push_back(page);
+	return pages.back();
+}
+
+void CCSkeletonBatchNode::visit () {
+	// The children are drawn by draw, not visited.
+	if (!isVisible()) return;
+	kmGLPushMatrix();
+	transform();
+	draw();
+	kmGLPopMatrix();
+}
+
+void CCSkeletonBatchNode::draw () {
+	SPINE_SCOPE("CCSkeletonBatchNode::draw");
+	for (int i = 0, n = pages.size(); i < n; i++)
+		pages[i].quadCount = 0;
+
+	sortAllChildren();
+	CCArray *children = getChildren();
+	Page *page = 0;
+	for (unsigned int i = 0, n = children ? children->count() : 0; i < n; i++) {
+		CCSkeleton *skeletonNode = static_cast<CCSkeleton*>(children->objectAtIndex(i));
+		if (!skeletonNode->isVisible()) continue;
+		// Quads are written in this node's space, so the child's transform is applied here instead of by the GL matrix.
+		CCAffineTransform transform = skeletonNode->nodeToParentTransform();
+
+#ifdef SPINE_ASYNC_UPDATE
+		if (skeletonNode->asyncUpdate) {
+			// The worker may be changing the skeleton, so the quads from the child's last update are used.
+			const CCSkeleton::QuadBuffer &buffer = skeletonNode->quadBuffers[skeletonNode->frontBuffer];
+			for (int ii = 0, nn = buffer.quads.size(); ii < nn; ii++) {
+				if (!page || page->source != buffer.atlases[ii]) page = &getPage(buffer.atlases[ii]);
+				ccV3F_C4B_T2F_Quad *quad = page->atlas->getQuads() + page->quadCount++;
+				*quad = buffer.quads[ii];
+				transformQuad(quad, transform);
+			}
+			continue;
+		}
+#endif
+
+		skeletonNode->updateSkeletonColor();
+		Skeleton *skeleton = skeletonNode->skeleton;
+		for (int ii = 0, nn = skeleton->drawOrder.size(); ii < nn; ii++) {
+			Slot *slot = skeleton->drawOrder[ii];
+			RegionAttachment *attachment = dynamic_cast<RegionAttachment*>(slot->attachment);
+			if (!attachment) continue;
+			if (!page || page->source != attachment->atlas) page = &getPage(attachment->atlas);
+
+			ccV3F_C4B_T2F_Quad *quad = page->atlas->getQuads() + page->quadCount++;
+			attachment->updateQuad(slot, quad);
+			transformQuad(quad, transform);
+		}
+	}
+
+	CC_NODE_DRAW_SETUP();
+	ccGLBlendFunc(blendFunc.src, blendFunc.dst);
+	for (int i = 0, n = pages.size(); i < n; i++) {
+		if (!pages[i].quadCount) continue;
+		pages[i].atlas->setDirty(true);
+		pages[i].atlas->drawNumberOfQuads(pages[i].quadCount, 0);
+		SPINE_COUNT(quadsEmitted, pages[i].quadCount);
+	}
+}
+
+// CCBlendProtocol
+
+ccBlendFunc CCSkeletonBatchNode::getBlendFunc () {
+	return blendFunc;
+}
+
+void CCSkeletonBatchNode::setBlendFunc (ccBlendFunc blendFunc) {
+	this->blendFunc = blendFunc;
+}
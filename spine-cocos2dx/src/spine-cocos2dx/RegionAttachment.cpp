@@ -35,12 +35,11 @@ USING_NS_CC;
 namespace spine {
 
 RegionAttachment::RegionAttachment (AtlasRegion *region) {
-	atlas = region->page->atlas;
-	const CCSize &size = region->page->texture->getContentSizeInPixels();
-	float u = region->x / size.width;
-	float u2 = (region->x + region->width) / size.width;
-	float v = region->y / size.height;
-	float v2 = (region->y + region->height) / size.height;
+	atlas = region->getPage()->atlas;
+	float u = region->u;
+	float u2 = region->u2;
+	float v = region->v;
+	float v2 = region->v2;
 	if (region->rotate) {
 		quad.tl.texCoords.u = u;
 		quad.tl.texCoords.v = v2;
@@ -68,35 +67,44 @@ RegionAttachment::RegionAttachment (AtlasRegion *region) {
 }
 
 void RegionAttachment::draw (Slot *slot) {
-	Skeleton* skeleton = (Skeleton*)slot->skeleton;
-
-	GLubyte r = skeleton->r * slot->r * 255;
-	GLubyte g = skeleton->g * slot->g * 255;
-	GLubyte b = skeleton->b * slot->b * 255;
-	GLubyte a = skeleton->a * slot->a * 255;
-	quad.bl.colors.r = r;
-	quad.bl.colors.g = g;
-	quad.bl.colors.b = b;
-	quad.bl.colors.a = a;
-	quad.tl.colors.r = r;
-	quad.tl.colors.g = g;
-	quad.tl.colors.b = b;
-	quad.tl.colors.a = a;
-	quad.tr.colors.r = r;
-	quad.tr.colors.g = g;
-	quad.tr.colors.b = b;
-	quad.tr.colors.a = a;
-	quad.br.colors.r = r;
-	quad.br.colors.g = g;
-	quad.br.colors.b = b;
-	quad.br.colors.a = a;
-
-	updateWorldVertices(slot->bone);
+	updateQuad(slot, &quad);
 
 	// cocos2dx doesn't handle batching for us, so we'll just force a single texture per skeleton.
+	Skeleton* skeleton = (Skeleton*)slot->skeleton;
 	skeleton->addQuad(atlas, quad);
 }
 
+void RegionAttachment::updateQuad (Slot *slot, ccV3F_C4B_T2F_Quad *quad) const {
+	const BaseSkeleton* skeleton = slot->skeleton;
+	ccColor4B color;
+	color.r = skeleton->r * slot->r * 255;
+	color.g = skeleton->g * slot->g * 255;
+	color.b = skeleton->b * slot->b * 255;
+	color.a = skeleton->a * slot->a * 255;
+
+	const Bone *bone = slot->bone;
+	quad->bl.vertices.x = offset[0] * bone->m00 + offset[1] * bone->m01 + bone->worldX;
+	quad->bl.vertices.y = offset[0] * bone->m10 + offset[1] * bone->m11 + bone->worldY;
+	quad->bl.vertices.z = 0;
+	quad->bl.colors = color;
+	quad->bl.texCoords = this->quad.bl.texCoords;
+	quad->tl.vertices.x = offset[2] * bone->m00 + offset[3] * bone->m01 + bone->worldX;
+	quad->tl.vertices.y = offset[2] * bone->m10 + offset[3] * bone->m11 + bone->worldY;
+	quad->tl.vertices.z = 0;
+	quad->tl.colors = color;
+	quad->tl.texCoords = this->quad.tl.texCoords;
+	quad->tr.vertices.x = offset[4] * bone->m00 + offset[5] * bone->m01 + bone->worldX;
+	quad->tr.vertices.y = offset[4] * bone->m10 + offset[5] * bone->m11 + bone->worldY;
+	quad->tr.vertices.z = 0;
+	quad->tr.colors = color;
+	quad->tr.texCoords = this->quad.tr.texCoords;
+	quad->br.vertices.x = offset[6] * bone->m00 + offset[7] * bone->m01 + bone->worldX;
+	quad->br.vertices.y = offset[6] * bone->m10 + offset[7] * bone->m11 + bone->worldY;
+	quad->br.vertices.z = 0;
+	quad->br.colors = color;
+	quad->br.texCoords = this->quad.br.texCoords;
+}
+
 void RegionAttachment::updateWorldVertices (spine::Bone *bone) {
 	quad.bl.vertices.x = offset[0] * bone->m00 + offset[1] * bone->m01 + bone->worldX;
 	quad.bl.vertices.y = offset[0] * bone->m10 + offset[1] * bone->m11 + bone->worldY;
@@ -108,4 +116,9 @@ void RegionAttachment::updateWorldVertices (spine::Bone *bone) {
 	quad.br.vertices.y = offset[6] * bone->m10 + offset[7] * bone->m11 + bone->worldY;
 }
 
+void RegionAttachment::addMemoryUsage (MemoryUsage &usage) const {
+	usage.add(objectMemory, sizeof(RegionAttachment));
+	usage.addCharacters(name);
+}
+
 } /* namespace spine */
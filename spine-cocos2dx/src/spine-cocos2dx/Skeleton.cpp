@@ -28,6 +28,7 @@
 #include <spine/SkeletonData.h>
 #include <spine/Slot.h>
 #include <spine/Attachment.h>
+#include <spine/Instrumentation.h>
 
 USING_NS_CC;
 
@@ -48,10 +49,18 @@ void Skeleton::addQuad (cocos2d::CCTextureAtlas *atlas, cocos2d::ccV3F_C4B_T2F_Q
 }
 
 void Skeleton::draw () {
+	SPINE_SCOPE("Skeleton::draw");
 	quadCount = 0;
 	for (int i = 0, n = slots.size(); i < n; i++)
 		if (slots[i]->attachment) slots[i]->attachment->draw(slots[i]);
 	if (atlas) atlas->drawNumberOfQuads(quadCount);
+	SPINE_COUNT(quadsEmitted, quadCount);
+}
+
+SkeletonMemoryUsage Skeleton::memoryUsage () const {
+	SkeletonMemoryUsage usage = BaseSkeleton::memoryUsage();
+	usage.instance.add(objectMemory, sizeof(Skeleton) - sizeof(BaseSkeleton));
+	return usage;
 }
 
 } /* namespace spine */
@@ -0,0 +1,236 @@
+/*******************************************************************************
+ * Copyright (c) 2013, Esoteric Software
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ******************************************************************************/
+
+/* Measures the runtime's hot paths on the spineboy data and on a generated large rig. Prints one JSON object per line:
+ *
+ * {"name": "skeleton.updateWorldTransform/spineboy", "iterations": 4194304, "nsPerOp": 143.2, "allocsPerOp": 0, "bytesPerOp": 0}
+ *
+ * Allocations count both runtime allocations, by tag, and global operator new, which catches std::string and other standard
+ * library allocations. bytesPerOp counts only operator new, as the runtime counts live bytes rather than allocated bytes.
+ *
+ * Usage: spine-cpp-benchmark [dataDirectory] [nameFilter] [secondsPerBenchmark]
+ * An empty data directory uses the default.
+ * The data directory must contain spineboy-skeleton.json, spineboy-walk.json and spineboy.atlas. Only benchmarks whose name contains
+ * the filter are run. */
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <sstream>
+#include <chrono>
+#include <spine/Animation.h>
+#include <spine/AnimationState.h>
+#include <spine/AnimationStateData.h>
+#include <spine/BaseSkeletonJson.h>
+#include <spine/HeadlessAtlas.h>
+#include <spine/HeadlessAttachmentLoader.h>
+#include <spine/HeadlessSkeleton.h>
+#include <spine/SkeletonData.h>
+#include <spine/Skin.h>
+#include "CountingNew.h"
+#include "RigGenerator.h"
+#include "RigLoader.h"
+
+#ifndef SPINE_BENCHMARK_DATA
+#define SPINE_BENCHMARK_DATA "../spine-sfml/data/"
+#endif
+
+using namespace spine;
+
+static size_t getTotalAllocationCount () {
+	size_t count = getNewCount();
+	for (int i = 0; i < allocationTagCount; i++)
+		count += getAllocationCount((AllocationTag)i);
+	return count;
+}
+
+static std::string filter;
+static double secondsPerBenchmark = 0.25;
+
+/** Runs op in batches that double in size until a batch takes secondsPerBenchmark, then reports the last batch. op receives the
+ * index of the iteration. */
+template<class Op>
+static void run (const std::string &name, Op op) {
+	if (name.find(filter) == std::string::npos) return;
+	op(0);
+	for (long iterations = 1;; iterations *= 2) {
+		size_t allocations = getTotalAllocationCount();
+		size_t bytes = getNewBytes();
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		for (long i = 0; i < iterations; i++)
+			op(i);
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		if (seconds < secondsPerBenchmark && iterations < (1L << 40)) continue;
+		printf("{\"name\": \"%s\", \"iterations\": %ld, \"nsPerOp\": %.2f, \"allocsPerOp\": %.3f, \"bytesPerOp\": %.1f}\n",
+				name.c_str(), iterations, seconds * 1e9 / iterations, (getTotalAllocationCount() - allocations) / (double)iterations,
+				(getNewBytes() - bytes) / (double)iterations);
+		fflush(stdout);
+		return;
+	}
+}
+
+static std::string readData (const std::string &path) {
+	std::string text = readFile(path);
+	if (text.empty()) {
+		fprintf(stderr, "Unable to read: %s\n", path.c_str());
+		exit(1);
+	}
+	return text;
+}
+
+template<class T>
+static void benchmarkTimelines (const std::string &name, const Animation *animation, BaseSkeleton *skeleton) {
+	std::vector<const Timeline*> timelines;
+	for (int i = 0, n = animation->timelines.size(); i < n; i++)
+		if (dynamic_cast<const T*>(animation->timelines[i])) timelines.push_back(animation->timelines[i]);
+	if (timelines.empty()) return;
+	float duration = animation->duration;
+	int count = timelines.size();
+	run(name, [=] (long i) {
+		timelines[i % count]->apply(skeleton, (i % 97) / 97.f * duration, 1);
+	});
+}
+
+/** Benchmarks applying each timeline type. ScaleTimeline extends TranslateTimeline, so translate includes scale timelines. */
+static void benchmarkTimelineTypes (const std::string &suffix, const Animation *animation, BaseSkeleton *skeleton) {
+	benchmarkTimelines<RotateTimeline>("timeline.rotate.apply/" + suffix, animation, skeleton);
+	benchmarkTimelines<TranslateTimeline>("timeline.translate.apply/" + suffix, animation, skeleton);
+	benchmarkTimelines<ScaleTimeline>("timeline.scale.apply/" + suffix, animation, skeleton);
+	benchmarkTimelines<ColorTimeline>("timeline.color.apply/" + suffix, animation, skeleton);
+	benchmarkTimelines<AttachmentTimeline>("timeline.attachment.apply/" + suffix, animation, skeleton);
+}
+
+static void benchmarkRig (const std::string &suffix, const BaseSkeletonJson &json, const std::string &skeletonJson,
+		const std::string &animationJson, const std::string &animationJson2) {
+	const char *skeletonBegin = skeletonJson.data(), *skeletonEnd = skeletonBegin + skeletonJson.size();
+	const char *animationBegin = animationJson.data(), *animationEnd = animationBegin + animationJson.size();
+
+	SkeletonData *skeletonData = json.readSkeletonData(skeletonBegin, skeletonEnd);
+	Animation *animation = json.readAnimation(animationBegin, animationEnd, skeletonData);
+	Animation *animation2 = json.readAnimation(animationJson2.data(), animationJson2.data() + animationJson2.size(), skeletonData);
+	HeadlessSkeleton skeleton(skeletonData);
+	skeleton.updateWorldTransform();
+
+	run("json.readSkeletonData/" + suffix, [&] (long) {
+		delete json.readSkeletonData(skeletonBegin, skeletonEnd);
+	});
+	run("json.readAnimation/" + suffix, [&] (long) {
+		delete json.readAnimation(animationBegin, animationEnd, skeletonData);
+	});
+
+	benchmarkTimelineTypes(suffix, animation, &skeleton);
+
+	float duration = animation->duration;
+	run("animation.apply/" + suffix, [&] (long i) {
+		animation->apply(&skeleton, (i % 97) / 97.f * duration, true);
+	});
+	run("animation.mix/" + suffix, [&] (long i) {
+		animation->mix(&skeleton, (i % 97) / 97.f * duration, true, 0.5f);
+	});
+
+	AnimationStateData stateData;
+	stateData.setMixing(animation, animation2, 0.25f);
+	stateData.setMixing(animation2, animation, 0.25f);
+	AnimationState state(&stateData);
+	state.setAnimation(animation, true);
+	// Switches animation every 30 frames, so most frames are spent in a crossfade.
+	run("animationState.crossfade/" + suffix, [&] (long i) {
+		if (i % 30 == 0) state.setAnimation(state.animation == animation ? animation2 : animation, true);
+		state.update(1 / 60.f);
+		state.apply(&skeleton);
+	});
+
+	run("skeleton.updateWorldTransform/" + suffix, [&] (long) {
+		skeleton.updateWorldTransform();
+	});
+	run("skeleton.draw/" + suffix, [&] (long) {
+		skeleton.draw();
+	});
+
+	const Skin *red = skeletonData->findSkin("red");
+	const Skin *blue = skeletonData->findSkin("blue");
+	if (red && blue) {
+		skeleton.setSkin(red);
+		skeleton.setSlotsToBindPose();
+		run("skeleton.setSkin/" + suffix, [&] (long i) {
+			skeleton.setSkin(i % 2 ? red : blue);
+		});
+	}
+
+	delete animation;
+	delete animation2;
+	delete skeletonData;
+}
+
+static void benchmarkAtlas (const std::string &suffix, const std::string &atlasText) {
+	const char *begin = atlasText.data(), *end = begin + atlasText.size();
+	run("atlas.load/" + suffix, [&] (long) {
+		HeadlessAtlas atlas(begin, end);
+	});
+
+	HeadlessAtlas atlas(begin, end);
+	std::vector<std::pair<int, int> > pageSizes(atlas.pages.size(), std::make_pair(2048, 2048));
+	std::ostringstream output;
+	BaseAtlas::convertToBinary(begin, end, pageSizes, output);
+	std::string binary = output.str();
+	run("atlas.loadBinary/" + suffix, [&] (long) {
+		HeadlessAtlas atlas(binary.data(), binary.data() + binary.size());
+	});
+
+	std::vector<std::string> names;
+	for (int i = 0, n = atlas.regions.size(); i < n; i++)
+		names.push_back(atlas.regions[i]->name.str());
+	int count = names.size();
+	run("atlas.findRegion/" + suffix, [&] (long i) {
+		atlas.findRegion(names[i % count]);
+	});
+}
+
+int main (int argc, char **argv) {
+	std::string dir = argc > 1 && argv[1][0] ? argv[1] : SPINE_BENCHMARK_DATA;
+	if (dir[dir.size() - 1] != '/') dir += '/';
+	if (argc > 2) filter = argv[2];
+	if (argc > 3) secondsPerBenchmark = atof(argv[3]);
+
+	BaseSkeletonJson json(new HeadlessAttachmentLoader());
+
+	RotateTimeline curves(64);
+	for (int i = 0; i < 64; i++) {
+		curves.setKeyframe(i, i / 30.f, i * 5.f);
+		if (i < 63) curves.setCurve(i, 0.25f, 0.1f, 0.75f, 0.9f);
+	}
+	run("curveTimeline.getCurvePercent", [&] (long i) {
+		curves.getCurvePercent(i % 63, (i % 101) / 101.f);
+	});
+
+	std::string walk = readData(dir + "spineboy-walk.json");
+	benchmarkRig("spineboy", json, readData(dir + "spineboy-skeleton.json"), walk, walk);
+	benchmarkRig("generated-255", json, generateSkeleton(255), generateAnimation(255, 60, 0), generateAnimation(255, 60, 1));
+
+	benchmarkAtlas("spineboy", readData(dir + "spineboy.atlas"));
+	benchmarkAtlas("generated-2000", generateAtlas(2000));
+	return 0;
+}
@@ -0,0 +1,357 @@
+/*******************************************************************************
+ * Copyright (c) 2013, Esoteric Software
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ******************************************************************************/
+
+/* Updates a crowd of headless skeletons for a number of frames with different thread counts, as a game or simulation server would:
+ * update, AnimationState update and apply with crossfades, world transform and vertex generation. The crowd mixes spineboy and
+ * generated rigs of several sizes, with different animations, skins and crossfade intervals.
+ *
+ * Prints one JSON object per line: first the crowd's memory, then for each thread count the frame time percentiles in milliseconds,
+ * skeleton updates per second and the speedup over the first thread count, eg:
+ *
+ * {"skeletons": 10000, "bytesPerSkeleton": 5210.4, "sharedBytes": 4101223}
+ * {"threads": 4, "frames": 300, "p50Ms": 3.91, "p90Ms": 4.20, "p99Ms": 5.01, "maxMs": 5.33, "updatesPerSecond": 2512345, "speedup": 3.71}
+ *
+ * Usage: spine-cpp-crowd-benchmark [--skeletons n] [--frames n] [--threads 1,2,4] [--data directory] [--histograms file]
+ * [--trace file]
+ * By default the thread counts double up to the number of cores. The data directory must contain spineboy-skeleton.json and
+ * spineboy-walk.json.
+ *
+ * When built with SPINE_INSTRUMENTATION, --histograms file and --trace file write the scope histograms and a Chrome trace of the
+ * timed frames. Recording slows the frames, so the times printed are then not comparable to an uninstrumented build. */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <spine/Animation.h>
+#include <spine/AnimationState.h>
+#include <spine/AnimationStateData.h>
+#include <spine/BaseSkeletonJson.h>
+#include <spine/HeadlessAttachmentLoader.h>
+#include <spine/HeadlessSkeleton.h>
+#include <spine/SkeletonData.h>
+#include <spine/Skin.h>
+#include <spine/Instrumentation.h>
+#include "RigGenerator.h"
+#include "RigLoader.h"
+
+#ifndef SPINE_BENCHMARK_DATA
+#define SPINE_BENCHMARK_DATA "../spine-sfml/data/"
+#endif
+
+using namespace spine;
+
+struct Instance {
+	HeadlessSkeleton *skeleton;
+	AnimationState *state;
+	const Rig *rig;
+	/** Frames between animation changes. */
+	int changeInterval;
+	int animationIndex;
+};
+
+/** Runs a function over ranges of the instances on persistent threads, one frame at a time. */
+class FrameThreads {
+public:
+	FrameThreads (int threadCount) :
+					generation(0),
+					remaining(0),
+					stopping(false) {
+		for (int i = 1; i < threadCount; i++)
+			threads.push_back(std::thread(&FrameThreads::run, this, i));
+	}
+
+	~FrameThreads () {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stopping = true;
+		}
+		startCondition.notify_all();
+		for (int i = 0, n = threads.size(); i < n; i++)
+			threads[i].join();
+	}
+
+	/** Calls work(threadIndex, threadCount) on every thread, including this one, and returns when all are done. */
+	template<class Work>
+	void runFrame (Work work) {
+		int threadCount = threads.size() + 1;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			this->work = [&work, threadCount] (int index) {
+				work(index, threadCount);
+			};
+			remaining = threads.size();
+			generation++;
+		}
+		startCondition.notify_all();
+		work(0, threadCount);
+		std::unique_lock<std::mutex> lock(mutex);
+		while (remaining)
+			doneCondition.wait(lock);
+	}
+
+private:
+	std::vector<std::thread> threads;
+	std::mutex mutex;
+	std::condition_variable startCondition;
+	std::condition_variable doneCondition;
+	std::function<void(int)> work;
+	long generation;
+	int remaining;
+	bool stopping;
+
+	void run (int index) {
+		long seen = 0;
+		std::unique_lock<std::mutex> lock(mutex);
+		while (true) {
+			while (generation == seen && !stopping)
+				startCondition.wait(lock);
+			if (stopping) return;
+			seen = generation;
+			lock.unlock();
+			work(index);
+			lock.lock();
+			if (--remaining == 0) doneCondition.notify_one();
+		}
+	}
+};
+
+static std::string readData (const std::string &path) {
+	std::string text = readFile(path);
+	if (text.empty()) {
+		fprintf(stderr, "Unable to read: %s\n", path.c_str());
+		exit(1);
+	}
+	return text;
+}
+
+/** Loads a rig whose mix times between pairs of animations vary from 0.1 to 0.3 seconds. */
+static Rig* loadCrowdRig (const BaseSkeletonJson &json, const std::string &name, const std::string &skeletonJson,
+		const std::vector<std::string> &animationJsons) {
+	Rig *rig = loadRig(json, name, skeletonJson, animationJsons, 0.1f);
+	for (int i = 0, n = rig->animations.size(); i < n; i++)
+		for (int ii = 0; ii < n; ii++)
+			if (i != ii) rig->stateData->setMixing(rig->animations[i], rig->animations[ii], 0.1f + (i + ii) % 3 * 0.1f);
+	return rig;
+}
+
+static size_t getRuntimeBytes () {
+	size_t bytes = 0;
+	for (int i = 0; i < allocationTagCount; i++)
+		bytes += getAllocatedBytes((AllocationTag)i);
+	return bytes;
+}
+
+static void updateInstance (Instance &instance, int frame, float delta) {
+	if (frame % instance.changeInterval == 0) {
+		const std::vector<Animation*> &animations = instance.rig->animations;
+		instance.animationIndex = (instance.animationIndex + 1) % animations.size();
+		instance.state->setAnimation(animations[instance.animationIndex], true);
+	}
+	instance.skeleton->update(delta);
+	instance.state->update(delta);
+	instance.state->apply(instance.skeleton);
+	instance.skeleton->updateWorldTransform();
+	instance.skeleton->draw();
+}
+
+static double percentile (const std::vector<double> &sorted, double percent) {
+	int index = (int)(percent / 100 * (sorted.size() - 1) + 0.5);
+	return sorted[index];
+}
+
+#ifdef SPINE_INSTRUMENTATION
+/** Forwards to the histogram and trace sinks, so both can record the same run. */
+class BenchmarkSink: public InstrumentationSink {
+public:
+	HistogramSink histograms;
+	ChromeTraceSink trace;
+	bool recordHistograms, recordTrace;
+
+	BenchmarkSink () :
+					recordHistograms(false),
+					recordTrace(false) {
+	}
+
+	virtual void scope (const char *name, long long start, long long duration) {
+		if (recordHistograms) histograms.scope(name, start, duration);
+		if (recordTrace) trace.scope(name, start, duration);
+	}
+
+	virtual void count (Counter counter, int amount) {
+		if (recordHistograms) histograms.count(counter, amount);
+		if (recordTrace) trace.count(counter, amount);
+	}
+};
+#endif
+
+int main (int argc, char **argv) {
+	int skeletonCount = 10000;
+	int frameCount = 300;
+	std::vector<int> threadCounts;
+	std::string dir = SPINE_BENCHMARK_DATA;
+	std::string histogramsPath, tracePath;
+	for (int i = 1; i + 1 < argc; i += 2) {
+		if (!strcmp(argv[i], "--skeletons"))
+			skeletonCount = atoi(argv[i + 1]);
+		else if (!strcmp(argv[i], "--frames"))
+			frameCount = atoi(argv[i + 1]);
+		else if (!strcmp(argv[i], "--data"))
+			dir = argv[i + 1];
+		else if (!strcmp(argv[i], "--threads")) {
+			std::stringstream list(argv[i + 1]);
+			std::string value;
+			while (std::getline(list, value, ','))
+				threadCounts.push_back(std::max(1, atoi(value.c_str())));
+		} else if (!strcmp(argv[i], "--histograms"))
+			histogramsPath = argv[i + 1];
+		else if (!strcmp(argv[i], "--trace"))
+			tracePath = argv[i + 1];
+		else {
+			fprintf(stderr, "Unknown option: %s\n", argv[i]);
+			return 1;
+		}
+	}
+	if (skeletonCount < 1 || frameCount < 1) {
+		fprintf(stderr, "--skeletons and --frames must be > 0.\n");
+		return 1;
+	}
+	if (threadCounts.empty()) {
+		int cores = std::max(1u, std::thread::hardware_concurrency());
+		for (int count = 1; count < cores; count *= 2)
+			threadCounts.push_back(count);
+		threadCounts.push_back(cores);
+	}
+	if (dir[dir.size() - 1] != '/') dir += '/';
+#ifndef SPINE_INSTRUMENTATION
+	if (!histogramsPath.empty() || !tracePath.empty()) {
+		fprintf(stderr, "--histograms and --trace require a build with SPINE_INSTRUMENTATION.\n");
+		return 1;
+	}
+#endif
+
+	BaseSkeletonJson json(new HeadlessAttachmentLoader());
+	std::vector<Rig*> rigs;
+	std::vector<std::string> animations;
+	animations.push_back(readData(dir + "spineboy-walk.json"));
+	rigs.push_back(loadCrowdRig(json, "spineboy", readData(dir + "spineboy-skeleton.json"), animations));
+	const int boneCounts[] = {15, 40, 100};
+	for (int i = 0; i < 3; i++) {
+		animations.clear();
+		for (int seed = 0; seed < 4; seed++)
+			animations.push_back(generateAnimation(boneCounts[i], 40, seed));
+		std::ostringstream name;
+		name << "generated-" << boneCounts[i];
+		rigs.push_back(loadCrowdRig(json, name.str(), generateSkeleton(boneCounts[i]), animations));
+	}
+	size_t sharedBytes = getRuntimeBytes();
+
+	std::vector<Instance> instances(skeletonCount);
+	for (int i = 0; i < skeletonCount; i++) {
+		Instance &instance = instances[i];
+		// Mostly small rigs, as in a typical crowd.
+		instance.rig = rigs[i % 10 < 4 ? 0 : i % 10 < 7 ? 1 : i % 10 < 9 ? 2 : 3];
+		instance.skeleton = new HeadlessSkeleton(instance.rig->skeletonData);
+		if (!instance.rig->skins.empty()) {
+			instance.skeleton->setSkin(instance.rig->skins[i % instance.rig->skins.size()]);
+			instance.skeleton->setSlotsToBindPose();
+		}
+		instance.state = new AnimationState(instance.rig->stateData);
+		instance.changeInterval = 60 + i % 7 * 20;
+		instance.animationIndex = i % instance.rig->animations.size();
+		instance.state->setAnimation(instance.rig->animations[instance.animationIndex], true);
+		// Spread the instances over the animation so they don't all sample the same time.
+		updateInstance(instance, 1, i % 97 / 60.f);
+	}
+	printf("{\"skeletons\": %d, \"bytesPerSkeleton\": %.1f, \"sharedBytes\": %lu}\n", skeletonCount,
+			(getRuntimeBytes() - sharedBytes) / (double)skeletonCount, (unsigned long)sharedBytes);
+	fflush(stdout);
+
+#ifdef SPINE_INSTRUMENTATION
+	BenchmarkSink sink;
+	sink.recordHistograms = !histogramsPath.empty();
+	sink.recordTrace = !tracePath.empty();
+	if (sink.recordHistograms || sink.recordTrace) setInstrumentationSink(&sink);
+#endif
+
+	double firstUpdatesPerSecond = 0;
+	for (int t = 0, tn = threadCounts.size(); t < tn; t++) {
+		FrameThreads threads(threadCounts[t]);
+		std::vector<double> frameTimes;
+		frameTimes.reserve(frameCount);
+		double totalSeconds = 0;
+		for (int frame = 0; frame < frameCount; frame++) {
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			threads.runFrame([&] (int index, int count) {
+				int begin = (long)skeletonCount * index / count, end = (long)skeletonCount * (index + 1) / count;
+				for (int i = begin; i < end; i++)
+					updateInstance(instances[i], frame, 1 / 60.f);
+			});
+			double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+			frameTimes.push_back(seconds * 1000);
+			totalSeconds += seconds;
+		}
+		std::sort(frameTimes.begin(), frameTimes.end());
+		double updatesPerSecond = (double)skeletonCount * frameCount / totalSeconds;
+		if (t == 0) firstUpdatesPerSecond = updatesPerSecond;
+		printf("{\"threads\": %d, \"frames\": %d, \"p50Ms\": %.3f, \"p90Ms\": %.3f, \"p99Ms\": %.3f, \"maxMs\": %.3f, "
+				"\"updatesPerSecond\": %.0f, \"speedup\": %.2f}\n", threadCounts[t], frameCount, percentile(frameTimes, 50),
+				percentile(frameTimes, 90), percentile(frameTimes, 99), frameTimes.back(), updatesPerSecond,
+				updatesPerSecond / firstUpdatesPerSecond);
+		fflush(stdout);
+	}
+
+#ifdef SPINE_INSTRUMENTATION
+	setInstrumentationSink(0);
+	if (sink.recordHistograms) {
+		std::ofstream file(histogramsPath.c_str());
+		sink.histograms.write(file);
+	}
+	if (sink.recordTrace) {
+		std::ofstream file(tracePath.c_str());
+		sink.trace.write(file);
+		if (sink.trace.getDroppedEventCount())
+			fprintf(stderr, "Trace is missing %lu events past the first %lu.\n", (unsigned long)sink.trace.getDroppedEventCount(),
+					(unsigned long)sink.trace.getEventCount());
+	}
+#endif
+
+	for (int i = 0; i < skeletonCount; i++) {
+		delete instances[i].skeleton;
+		delete instances[i].state;
+	}
+	for (int i = 0, n = rigs.size(); i < n; i++)
+		disposeRig(rigs[i]);
+	return 0;
+}
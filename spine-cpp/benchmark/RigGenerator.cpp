@@ -0,0 +1,96 @@
+/*******************************************************************************
+ * Copyright (c) 2013, Esoteric Software
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ******************************************************************************/
+
+#include <sstream>
+#include "RigGenerator.h"
+
+std::string generateSkeleton (int boneCount) {
+	std::ostringstream json;
+	json << "{\n\"bones\": [\n\t{ \"name\": \"b0\" }";
+	for (int i = 1; i < boneCount; i++)
+		json << ",\n\t{ \"name\": \"b" << i << "\", \"parent\": \"b" << (i - 1) / 2 << "\", \"length\": 20, \"x\": " << i % 7
+				<< ", \"y\": 10, \"rotation\": " << (i * 37) % 360 << " }";
+	json << "\n],\n\"slots\": [\n";
+	for (int i = 0; i < boneCount; i++)
+		json << (i ? ",\n" : "") << "\t{ \"name\": \"s" << i << "\", \"bone\": \"b" << i << "\", \"attachment\": \"part\" }";
+	json << "\n],\n\"skins\": {\n";
+	const char *skins[] = {"default", "red", "blue"};
+	for (int skin = 0; skin < 3; skin++) {
+		json << (skin ? ",\n" : "") << "\t\"" << skins[skin] << "\": {\n";
+		for (int i = 0; i < boneCount; i++)
+			json << (i ? ",\n" : "") << "\t\t\"s" << i << "\": { \"part\": { \"name\": \"" << skins[skin] << i
+					<< "\", \"x\": 5, \"rotation\": 10, \"width\": 16, \"height\": 24 } }";
+		json << "\n\t}";
+	}
+	json << "\n}\n}\n";
+	return json.str();
+}
+
+std::string generateAnimation (int boneCount, int keyCount, int seed) {
+	std::ostringstream json;
+	json << "{\n\"bones\": {\n";
+	for (int i = 0; i < boneCount; i++) {
+		json << (i ? ",\n" : "") << "\t\"b" << i << "\": {\n";
+		const char *types[] = {"rotate", "translate", "scale"};
+		for (int type = 0; type < 3; type++) {
+			json << (type ? ",\n" : "") << "\t\t\"" << types[type] << "\": [";
+			for (int key = 0; key < keyCount; key++) {
+				int value = (i * 31 + key * 17 + seed * 7) % 90;
+				json << (key ? ", " : "") << "{ \"time\": " << key / 30.0;
+				if (type == 0)
+					json << ", \"angle\": " << value;
+				else if (type == 1)
+					json << ", \"x\": " << value << ", \"y\": " << -value;
+				else
+					json << ", \"x\": " << 1 + value / 90.0 << ", \"y\": " << 1 - value / 180.0;
+				if (key % 2 && key < keyCount - 1) json << ", \"curve\": [ 0.25, 0.1, 0.75, 0.9 ]";
+				json << " }";
+			}
+			json << "]";
+		}
+		json << "\n\t}";
+	}
+	json << "\n},\n\"slots\": {\n";
+	for (int i = 0; i < boneCount; i++) {
+		json << (i ? ",\n" : "") << "\t\"s" << i << "\": {\n\t\t\"color\": [";
+		for (int key = 0; key < keyCount; key++)
+			json << (key ? ", " : "") << "{ \"time\": " << key / 30.0 << ", \"color\": \"" << (key % 2 ? "ffffffff" : "ff0000a0") << "\" }";
+		json << "],\n\t\t\"attachment\": [";
+		for (int key = 0; key < keyCount; key += 4)
+			json << (key ? ", " : "") << "{ \"time\": " << key / 30.0 << ", \"name\": " << (key % 8 ? "null" : "\"part\"") << " }";
+		json << "]\n\t}";
+	}
+	json << "\n}\n}\n";
+	return json.str();
+}
+
+std::string generateAtlas (int regionCount) {
+	std::ostringstream atlas;
+	atlas << "\ngenerated.png\nformat: RGBA8888\nfilter: Linear,Linear\nrepeat: none\n";
+	for (int i = 0; i < regionCount; i++)
+		atlas << "region" << i << "\n  rotate: " << (i % 3 ? "false" : "true") << "\n  xy: " << (i % 64) * 32 << ", " << (i / 64) * 32
+				<< "\n  size: 30, 30\n  orig: 30, 30\n  offset: 0, 0\n  index: -1\n";
+	return atlas.str();
+}
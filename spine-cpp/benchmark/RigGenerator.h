@@ -0,0 +1,44 @@
+/*******************************************************************************
+ * Copyright (c) 2013, Esoteric Software
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ******************************************************************************/
+
+#ifndef SPINE_RIGGENERATOR_H_
+#define SPINE_RIGGENERATOR_H_
+
+#include <string>
+
+/* Generates skeleton, animation and atlas data of any size for the benchmarks. */
+
+/** A skeleton of boneCount bones in a binary tree, with a slot per bone and skins "red" and "blue" that both have an attachment
+ * "part" for each slot. */
+std::string generateSkeleton (int boneCount);
+
+/** An animation with rotate, translate and scale timelines for every bone and color and attachment timelines for every slot, each
+ * with keyCount keys. Half the keys are curved. The last key has no curve, as there is nothing to transition to. */
+std::string generateAnimation (int boneCount, int keyCount, int seed);
+
+/** An atlas with one page and regionCount regions. */
+std::string generateAtlas (int regionCount);
+
+#endif /* SPINE_RIGGENERATOR_H_ */
@@ -0,0 +1,67 @@
+/*******************************************************************************
+ * Copyright (c) 2013, Esoteric Software
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ******************************************************************************/
+
+#include <cstdio>
+#include "RigLoader.h"
+
+using namespace spine;
+
+std::string readFile (const std::string &path) {
+	std::string text;
+	FILE *file = fopen(path.c_str(), "rb");
+	if (!file) return text;
+	char buffer[4096];
+	size_t count;
+	while ((count = fread(buffer, 1, sizeof(buffer), file)) > 0)
+		text.append(buffer, count);
+	fclose(file);
+	return text;
+}
+
+Rig* loadRig (const BaseSkeletonJson &json, const std::string &name, const std::string &skeleton,
+		const std::vector<std::string> &animations, float mixDuration) {
+	Rig *rig = new Rig();
+	rig->name = name;
+	rig->skeletonData = json.readSkeletonData(skeleton.data(), skeleton.data() + skeleton.length());
+	for (int i = 0, n = animations.size(); i < n; i++) {
+		const std::string &animation = animations[i];
+		rig->animations.push_back(json.readAnimation(animation.data(), animation.data() + animation.length(), rig->skeletonData));
+	}
+	rig->stateData = new AnimationStateData();
+	for (int i = 0, n = rig->animations.size(); i < n; i++)
+		for (int ii = 0; ii < n; ii++)
+			if (i != ii) rig->stateData->setMixing(rig->animations[i], rig->animations[ii], mixDuration);
+	for (int i = 0, n = rig->skeletonData->skins.size(); i < n; i++)
+		if (rig->skeletonData->skins[i] != rig->skeletonData->defaultSkin) rig->skins.push_back(rig->skeletonData->skins[i]);
+	return rig;
+}
+
+void disposeRig (Rig *rig) {
+	for (int i = 0, n = rig->animations.size(); i < n; i++)
+		delete rig->animations[i];
+	delete rig->stateData;
+	delete rig->skeletonData;
+	delete rig;
+}
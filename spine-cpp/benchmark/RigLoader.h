@@ -0,0 +1,59 @@
+/*******************************************************************************
+ * Copyright (c) 2013, Esoteric Software
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ******************************************************************************/
+
+#ifndef SPINE_RIGLOADER_H_
+#define SPINE_RIGLOADER_H_
+
+#include <string>
+#include <vector>
+#include <spine/Animation.h>
+#include <spine/AnimationStateData.h>
+#include <spine/BaseSkeletonJson.h>
+#include <spine/SkeletonData.h>
+#include <spine/Skin.h>
+
+/* Loads the data shared by the skeletons of the benchmarks and tests. */
+
+/** Returns the contents of the file, or an empty string if it can't be read. */
+std::string readFile (const std::string &path);
+
+/** A skeleton type: its data and animations, with a mix time between every pair of animations. */
+struct Rig {
+	std::string name;
+	spine::SkeletonData *skeletonData;
+	std::vector<spine::Animation*> animations;
+	spine::AnimationStateData *stateData;
+	/** The skins other than the default skin. */
+	std::vector<const spine::Skin*> skins;
+};
+
+/** Reads the skeleton and animations JSON and mixes every pair of animations over mixDuration. */
+Rig* loadRig (const spine::BaseSkeletonJson &json, const std::string &name, const std::string &skeleton,
+		const std::vector<std::string> &animations, float mixDuration);
+
+/** Deletes the rig and everything it loaded. */
+void disposeRig (Rig *rig);
+
+#endif /* SPINE_RIGLOADER_H_ */
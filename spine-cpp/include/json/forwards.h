@@ -22,6 +22,7 @@ namespace Json {
    class Path;
    class PathArgument;
    class Value;
+   class ValueArena;
    class ValueIteratorBase;
    class ValueIterator;
    class ValueConstIterator;
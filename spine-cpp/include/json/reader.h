@@ -6,6 +6,7 @@
 # include <deque>
 # include <stack>
 # include <string>
+# include <vector>
 # include <iostream>
 
 namespace Json {
@@ -57,6 +58,22 @@ namespace Json {
                   Value &root,
                   bool collectComments = true );
 
+      /** \brief Read a Value from a <a HREF="http://www.json.org">JSON</a> document into an arena.
+       *
+       * Arrays, objects and strings are stored in \c arena, see ValueArena. Member names are
+       * not copied unless they contain escape sequences, so the document must stay valid
+       * as long as \c root is used. Comments are discarded.
+       * \param beginDoc Pointer on the beginning of the UTF-8 encoded string of the document to read.
+       * \param endDoc Pointer on the end of the UTF-8 encoded string of the document to read.
+       * \param arena Owns the values read, until it is cleared or destroyed.
+       * \param root [out] Contains the root value of the document if it was
+       *             successfully parsed.
+       * \return \c true if the document was successfully parsed, \c false if an error occurred.
+       */
+      bool parse( const char *beginDoc, const char *endDoc, 
+                  ValueArena &arena,
+                  Value &root );
+
       /// \brief Parse from input stream.
       /// \see Json::operator>>(std::istream&, Json::Value&).
       bool parse( std::istream &is,
@@ -107,6 +124,8 @@ namespace Json {
 
       typedef std::deque<ErrorInfo> Errors;
 
+      bool readDocument( const char *beginDoc, const char *endDoc, 
+                         Value &root );
       bool expectToken( TokenType type, Token &token, const char *message );
       bool readToken( Token &token );
       void skipSpaces();
@@ -120,6 +139,11 @@ namespace Json {
       bool readValue();
       bool readObject( Token &token );
       bool readArray( Token &token );
+      bool decodeArenaMemberName( Token &token, Value::ArenaMember &member );
+      void endArenaObject( size_t firstMember );
+      void endArenaArray( size_t firstValue );
+      static bool lessArenaMember( const Value::ArenaMember *member, 
+                                   const Value::ArenaMember *other );
       bool decodeNumber( Token &token );
       bool decodeString( Token &token );
       bool decodeString( Token &token, std::string &decoded );
@@ -163,6 +187,12 @@ namespace Json {
       std::string commentsBefore_;
       Features features_;
       bool collectComments_;
+      // Set while parsing into an arena. The members and values of the objects and arrays
+      // being read are stacked until the container ends and is copied to the arena.
+      ValueArena *arena_;
+      std::vector<Value::ArenaMember> arenaMembers_;
+      std::vector<const Value::ArenaMember *> arenaOrder_;
+      std::vector<Value> arenaValues_;
    };
 
    /** \brief Read from 'sin' into 'root'.
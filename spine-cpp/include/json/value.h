@@ -111,6 +111,8 @@ namespace Json {
    class JSON_API Value 
    {
       friend class ValueIteratorBase;
+      friend class ValueArena;
+      friend class Reader;
 # ifdef JSON_VALUE_USE_INTERNAL_MAP
       friend class ValueInternalLink;
       friend class ValueInternalMap;
@@ -163,6 +165,17 @@ namespace Json {
       typedef CppTL::SmallMap<CZString, Value> ObjectValues;
 #  endif // ifndef JSON_USE_CPPTL_SMALLMAP
 # endif // ifndef JSON_VALUE_USE_INTERNAL_MAP
+
+      struct ArenaMember;
+
+      /// An array or object stored in a ValueArena: a flat array of values, or of
+      /// members sorted by name.
+      struct ArenaContainer
+      {
+         UInt size_;
+         ArenaMember *members_; // objectValue
+         Value *values_;        // arrayValue
+      };
 #endif // ifndef JSONCPP_DOC_EXCLUDE_IMPLEMENTATION
 
    public:
@@ -380,6 +393,17 @@ namespace Json {
       Value &resolveReference( const char *key, 
                                bool isStatic );
 
+      bool isArenaContainer() const
+      {
+         return inArena_  &&  ( type_ == arrayValue  ||  type_ == objectValue );
+      }
+
+      const ArenaMember *findArenaMember( const char *key ) const;
+
+      /// Orders member names like strcmp(), without requiring them to be null terminated.
+      static int compareMemberNames( const char *name, UInt length,
+                                     const char *other, UInt otherLength );
+
 # ifdef JSON_VALUE_USE_INTERNAL_MAP
       inline bool isItemAvailable() const
       {
@@ -435,9 +459,11 @@ namespace Json {
 #else
          ObjectValues *map_;
 # endif
+         ArenaContainer *arena_;
       } value_;
       ValueType type_ : 8;
       int allocated_ : 1;     // Notes: if declared as bool, bitfield is useless.
+      unsigned int inArena_ : 1; // string or container owned by a ValueArena, shared by copies.
 # ifdef JSON_VALUE_USE_INTERNAL_MAP
       unsigned int itemIsUsed_ : 1;      // used by the ValueInternalMap container.
       int memberNameIsStatic_ : 1;       // used by the ValueInternalMap container.
@@ -446,6 +472,76 @@ namespace Json {
    };
 
 
+   /// A member of an object stored in a ValueArena. The name is not null terminated.
+   struct Value::ArenaMember
+   {
+      const char *name_;
+      UInt nameLength_;
+      Value value_;
+   };
+
+
+   /** \brief Owns the arrays, objects and strings of documents read with
+    * Reader::parse( beginDoc, endDoc, arena, root ).
+    *
+    * Objects are flat arrays of members sorted by name instead of maps, and member
+    * names without escapes point into the parsed document instead of being copied.
+    * Everything is freed at once when the arena is destroyed or cleared, so the
+    * document and the arena must both outlive the values read into it.
+    *
+    * Copying a value stored in an arena shares its storage instead of duplicating it.
+    * Such values are read-only: operations that would add or remove array elements or
+    * object members throw, and members must not be assigned values that own memory.
+    * ValueIteratorBase::memberName() is not available for their members, use key().
+    */
+   class JSON_API ValueArena
+   {
+   public:
+      /// \param blockSize Size of the first block. Each following block is twice as
+      ///                  large, up to 1 MB.
+      explicit ValueArena( size_t blockSize = 4096 );
+      ~ValueArena();
+
+      /// Frees all blocks. Values read into the arena must no longer be used.
+      void clear();
+
+      /// Bytes requested from the system for all blocks.
+      size_t getAllocatedBytes() const;
+      /// Bytes handed out from the blocks.
+      size_t getUsedBytes() const;
+
+   private:
+      friend class Reader;
+
+      struct Block
+      {
+         Block *next_;
+         size_t size_;
+      };
+
+      ValueArena( const ValueArena & );
+      ValueArena &operator =( const ValueArena & );
+
+      /// Returns memory aligned for a Value. Never returns null.
+      void *allocate( size_t size );
+      /// Copies the characters and a null terminator.
+      char *duplicate( const char *begin, size_t length );
+      Value makeString( const char *begin, size_t length );
+      /// Copies the values to the arena.
+      Value makeArray( const Value *values, UInt size );
+      /// Copies the members to the arena. They must be sorted by name, without duplicates.
+      Value makeObject( const Value::ArenaMember *const *members, UInt size );
+
+      Block *blocks_;
+      char *current_;
+      char *end_;
+      size_t firstBlockSize_;
+      size_t blockSize_;
+      size_t allocatedBytes_;
+      size_t usedBytes_;
+   };
+
+
    /** \brief Experimental and untested: represents an element of the "path" to access a node.
     */
    class PathArgument
@@ -890,6 +986,7 @@ public: // overridden from ValueArrayAllocator
       ValueIteratorBase( const ValueInternalArray::IteratorState &state );
       ValueIteratorBase( const ValueInternalMap::IteratorState &state );
 #endif
+      ValueIteratorBase( Value::ArenaContainer *arena, UInt index );
 
       bool operator ==( const SelfType &other ) const
       {
@@ -941,6 +1038,9 @@ public: // overridden from ValueArrayAllocator
       } iterator_;
       bool isArray_;
 #endif
+      // Set when iterating over an array or object stored in a ValueArena.
+      Value::ArenaContainer *arena_;
+      UInt arenaIndex_;
    };
 
    /** \brief const iterator for object and array value.
@@ -966,6 +1066,7 @@ public: // overridden from ValueArrayAllocator
       ValueConstIterator( const ValueInternalArray::IteratorState &state );
       ValueConstIterator( const ValueInternalMap::IteratorState &state );
 #endif
+      ValueConstIterator( Value::ArenaContainer *arena, UInt index );
    public:
       SelfType &operator =( const ValueIteratorBase &other );
 
@@ -1026,6 +1127,7 @@ public: // overridden from ValueArrayAllocator
       ValueIterator( const ValueInternalArray::IteratorState &state );
       ValueIterator( const ValueInternalMap::IteratorState &state );
 #endif
+      ValueIterator( Value::ArenaContainer *arena, UInt index );
    public:
 
       SelfType &operator =( const SelfType &other );
@@ -0,0 +1,320 @@
+/*******************************************************************************
+ * Copyright (c) 2013, Esoteric Software
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ******************************************************************************/
+
+#ifndef SPINE_ALLOCATOR_H_
+#define SPINE_ALLOCATOR_H_
+
+#include <cstddef>
+#include <new>
+#include <ostream>
+#include <string>
+
+namespace spine {
+
+/** What an allocation is for, so an allocator can route it to a heap and so bytes can be counted per tag. */
+enum AllocationTag {
+	/** SkeletonData, bone, slot and skin data, including skin attachment maps. */
+	skeletonDataTag,
+	/** Skeletons, bones, slots and animation states. */
+	skeletonTag,
+	/** Animations, timelines and their keyframes. */
+	animationTag,
+	attachmentTag,
+	/** Atlases, pages and regions. */
+	atlasTag,
+	/** Names and other strings. */
+	stringTag,
+	allocationTagCount
+};
+
+class Allocator {
+public:
+	virtual ~Allocator () {
+	}
+
+	/** Returns memory aligned to at least 16 bytes, or 0 if out of memory. */
+	virtual void* allocate (size_t size, AllocationTag tag) = 0;
+	/** @param size The size that was passed to allocate. */
+	virtual void deallocate (void *memory, size_t size, AllocationTag tag) = 0;
+};
+
+/** Sets the allocator used when no AllocatorScope is active on the calling thread.
+ * @param allocator May be null to use malloc and free. Must outlive everything it allocates. */
+void setDefaultAllocator (Allocator *allocator);
+
+/** Returns the allocator used by allocations on the calling thread, or null for malloc and free. */
+Allocator* getAllocator ();
+
+/** Routes all runtime allocations on the calling thread to an allocator while the scope exists. Memory is always returned to the
+ * allocator it came from, so objects may be deleted outside the scope. To give a SkeletonData or a skeleton its own allocator,
+ * create it inside a scope, eg:
+ *
+ * {
+ *    AllocatorScope scope(&levelHeap);
+ *    skeletonData = json.readSkeletonData(path);
+ * } */
+class AllocatorScope {
+public:
+	/** @param allocator May be null to use malloc and free. */
+	AllocatorScope (Allocator *allocator);
+	~AllocatorScope ();
+
+private:
+	Allocator *previous;
+	bool previousSet;
+
+	AllocatorScope (const AllocatorScope&);
+	AllocatorScope& operator= (const AllocatorScope&);
+};
+
+/** Allocates through the current allocator and counts the bytes for the tag. Throws std::bad_alloc if out of memory. */
+void* allocate (size_t size, AllocationTag tag);
+/** Frees memory from allocate. Memory may be null. */
+void deallocate (void *memory);
+
+/** Returns the bytes currently allocated with the tag. */
+size_t getAllocatedBytes (AllocationTag tag);
+/** Returns the number of allocations made with the tag since the program started. */
+size_t getAllocationCount (AllocationTag tag);
+
+/** Counts the allocations made on the calling thread while it exists, grouped into named phases, eg to check that the frames of a
+ * game loop don't allocate once warmed up. Allocations through allocate are always counted. Other heap allocations, such as the
+ * characters of a std::string, are only counted if the program passes them to recordAllocation, eg from a replaced global
+ * operator new:
+ *
+ * void* operator new (size_t size) {
+ *    spine::recordAllocation(size);
+ *    ...
+ * }
+ *
+ * Only one audit may exist on a thread at a time. Counting doesn't allocate. An Allocator that itself uses the replaced operator
+ * new has its allocations counted twice. */
+class AllocationAudit {
+public:
+	static const int MAX_PHASES = 16;
+
+	/** Starts counting for the phase "". Throws std::logic_error if the thread already has an audit. */
+	AllocationAudit ();
+	~AllocationAudit ();
+
+	/** Counts the following allocations for the phase, until the next setPhase.
+	 * @param name Must outlive the audit, eg a string literal. Phases with equal names are counted together. */
+	void setPhase (const char *name);
+
+	size_t getAllocationCount (const char *phase) const;
+	size_t getAllocatedBytes (const char *phase) const;
+	/** Returns the allocations counted for all phases. */
+	size_t getAllocationCount () const;
+
+	/** Sets the counts of all phases to 0, eg after warming up. */
+	void reset ();
+
+	/** Writes the allocation count and bytes of each phase as a JSON object. */
+	void write (std::ostream &output) const;
+
+private:
+	struct Phase {
+		const char *name;
+		size_t count;
+		size_t bytes;
+	};
+
+	Phase phases[MAX_PHASES];
+	int phaseCount;
+	int current;
+
+	AllocationAudit (const AllocationAudit&);
+	AllocationAudit& operator= (const AllocationAudit&);
+
+	const Phase* findPhase (const char *name) const;
+	void record (size_t size);
+
+	friend void recordAllocation (size_t size);
+};
+
+/** Counts an allocation for the calling thread's AllocationAudit, if it has one. Does not allocate. */
+void recordAllocation (size_t size);
+
+/** Base class whose instances are allocated through the current allocator. */
+template<AllocationTag tag>
+class Allocated {
+public:
+	static void* operator new (size_t size) {
+		return allocate(size, tag);
+	}
+
+	static void* operator new (size_t size, void *place) {
+		return place;
+	}
+
+	static void operator delete (void *memory) {
+		deallocate(memory);
+	}
+
+	static void operator delete (void *memory, void *place) {
+	}
+};
+
+/** Standard library allocator that allocates through the current allocator. It has no state, so all instances are equal. */
+template<class T, AllocationTag tag>
+class StlAllocator {
+public:
+	typedef T value_type;
+	typedef T* pointer;
+	typedef const T* const_pointer;
+	typedef T& reference;
+	typedef const T& const_reference;
+	typedef size_t size_type;
+	typedef ptrdiff_t difference_type;
+
+	template<class U>
+	struct rebind {
+		typedef StlAllocator<U, tag> other;
+	};
+
+	StlAllocator () {
+	}
+
+	template<class U>
+	StlAllocator (const StlAllocator<U, tag>&) {
+	}
+
+	pointer address (reference value) const {
+		return &value;
+	}
+
+	const_pointer address (const_reference value) const {
+		return &value;
+	}
+
+	pointer allocate (size_type count, const void* = 0) {
+		return static_cast<pointer>(spine::allocate(count * sizeof(T), tag));
+	}
+
+	void deallocate (pointer memory, size_type) {
+		spine::deallocate(memory);
+	}
+
+	size_type max_size () const {
+		return (size_type)-1 / sizeof(T);
+	}
+
+	void construct (pointer place, const T &value) {
+		new (place) T(value);
+	}
+
+	void destroy (pointer place) {
+		place->~T();
+	}
+
+	template<class U>
+	bool operator== (const StlAllocator<U, tag>&) const {
+		return true;
+	}
+
+	template<class U>
+	bool operator!= (const StlAllocator<U, tag>&) const {
+		return false;
+	}
+};
+
+//
+
+typedef std::basic_string<char, std::char_traits<char>, StlAllocator<char, stringTag> > StringBase;
+
+/** A string whose characters are allocated through the current allocator, used for the names in loaded data. A String created
+ * with new is also allocated through the current allocator, so it can be deleted by whoever owns it. */
+class String: public StringBase, public Allocated<stringTag> {
+public:
+	String () {
+	}
+
+	String (const char *value) :
+					StringBase(value) {
+	}
+
+	String (const char *value, size_t length) :
+					StringBase(value, length) {
+	}
+
+	String (const std::string &value) :
+					StringBase(value.data(), value.length()) {
+	}
+
+	String (const String &value) :
+					StringBase(value) {
+	}
+
+	String& operator= (const String &value) {
+		StringBase::operator=(value);
+		return *this;
+	}
+
+	String& operator= (const std::string &value) {
+		assign(value.data(), value.length());
+		return *this;
+	}
+
+	String& operator= (const char *value) {
+		StringBase::operator=(value);
+		return *this;
+	}
+
+	/** Returns a copy on the global heap. */
+	std::string str () const {
+		return std::string(data(), length());
+	}
+};
+
+inline bool operator== (const String &a, const std::string &b) {
+	return a.length() == b.length() && a.compare(0, a.length(), b.data(), b.length()) == 0;
+}
+
+inline bool operator== (const std::string &a, const String &b) {
+	return b == a;
+}
+
+inline bool operator!= (const String &a, const std::string &b) {
+	return !(a == b);
+}
+
+inline bool operator!= (const std::string &a, const String &b) {
+	return !(b == a);
+}
+
+inline bool operator< (const String &a, const std::string &b) {
+	return a.compare(0, a.length(), b.data(), b.length()) < 0;
+}
+
+inline bool operator< (const std::string &a, const String &b) {
+	return b.compare(0, b.length(), a.data(), a.length()) > 0;
+}
+
+inline std::ostream& operator<< (std::ostream &output, const String &value) {
+	return output.write(value.data(), value.length());
+}
+
+} /* namespace spine */
+#endif /* SPINE_ALLOCATOR_H_ */
@@ -28,15 +28,19 @@
 
 #include <string>
 #include <vector>
+#include <spine/Allocator.h>
+#include <spine/MemoryUsage.h>
 
 namespace spine {
 
 class BaseSkeleton;
 class Timeline;
 
-class Animation {
+/** Applying an animation only writes to the skeleton, so one animation may be applied to different skeletons on different threads
+ * at the same time. */
+class Animation: public Allocated<animationTag> {
 public:
-	std::vector<Timeline*> timelines;
+	std::vector<Timeline*, StlAllocator<Timeline*, animationTag> > timelines;
 	float duration;
 
 	Animation (const std::vector<Timeline*> &timelines, float duration);
@@ -44,16 +48,22 @@ public:
 
 	void apply (BaseSkeleton *skeleton, float time, bool loop = false) const;
 	void mix (BaseSkeleton *skeleton, float time, bool loop, float alpha) const;
+
+	/** Returns the bytes used by the animation and its timelines. */
+	MemoryUsage memoryUsage () const;
 };
 
 //
 
-class Timeline {
+class Timeline: public Allocated<animationTag> {
 public:
 	virtual ~Timeline () {
 	}
 
 	virtual void apply (BaseSkeleton *skeleton, float time, float alpha = 1) const = 0;
+
+	/** Adds the bytes used by the timeline. Subclasses with more fields or keyframes should override this. */
+	virtual void addMemoryUsage (MemoryUsage &usage) const;
 };
 
 //
@@ -89,6 +99,7 @@ public:
 	virtual ~RotateTimeline ();
 
 	virtual void apply (BaseSkeleton *skeleton, float time, float alpha = 1) const;
+	virtual void addMemoryUsage (MemoryUsage &usage) const;
 
 	void setKeyframe (int keyframeIndex, float time, float value);
 };
@@ -105,6 +116,7 @@ public:
 	virtual ~TranslateTimeline ();
 
 	virtual void apply (BaseSkeleton *skeleton, float time, float alpha = 1) const;
+	virtual void addMemoryUsage (MemoryUsage &usage) const;
 
 	void setKeyframe (int keyframeIndex, float time, float x, float y);
 };
@@ -130,6 +142,7 @@ public:
 	virtual ~ColorTimeline ();
 
 	virtual void apply (BaseSkeleton *skeleton, float time, float alpha = 1) const;
+	virtual void addMemoryUsage (MemoryUsage &usage) const;
 
 	void setKeyframe (int keyframeIndex, float time, float r, float g, float b, float a);
 };
@@ -140,17 +153,19 @@ class AttachmentTimeline: public Timeline {
 public:
 	int framesLength;
 	float *frames; // time, ...
-	std::string **attachmentNames;
+	/** Owned by the timeline. */
+	String **attachmentNames;
 	int slotIndex;
 
 	AttachmentTimeline (int keyframeCount);
 	virtual ~AttachmentTimeline ();
 
 	virtual void apply (BaseSkeleton *skeleton, float time, float alpha = 1) const;
+	virtual void addMemoryUsage (MemoryUsage &usage) const;
 
 	/** The AttachmentTimeline owns the attachmentName.
 	 * @param attachmentName May be null to clear the image for a slot. */
-	void setKeyframe (int keyframeIndex, float time, std::string *attachmentName);
+	void setKeyframe (int keyframeIndex, float time, String *attachmentName);
 };
 
 } /* namespace spine */
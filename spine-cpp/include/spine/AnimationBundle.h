@@ -0,0 +1,105 @@
+/*******************************************************************************
+ * Copyright (c) 2013, Esoteric Software
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ******************************************************************************/
+
+#ifndef SPINE_ANIMATIONBUNDLE_H_
+#define SPINE_ANIMATIONBUNDLE_H_
+
+#include <string>
+#include <vector>
+#include <map>
+#include <ostream>
+
+namespace spine {
+
+class Animation;
+class BaseSkeletonJson;
+class SkeletonData;
+
+/** Holds the JSON of many animations for one SkeletonData in a single file, indexed by name. An animation is only decoded the
+ * first time it is requested and can be evicted again to stay within a memory budget. */
+class AnimationBundle {
+public:
+	/** Reads only the index. Animation data is read from the file when an animation is first requested.
+	 * @param json Used to decode animations. Must outlive the bundle.
+	 * @param skeletonData Must outlive the bundle. */
+	AnimationBundle (const std::string &path, const BaseSkeletonJson *json, const SkeletonData *skeletonData);
+	/** Decodes animations directly from the data, which must remain valid for the lifetime of the bundle (eg a memory mapped
+	 * file). */
+	AnimationBundle (const char *begin, const char *end, const BaseSkeletonJson *json, const SkeletonData *skeletonData);
+	/** Deletes all decoded animations. */
+	~AnimationBundle ();
+
+	int getAnimationCount () const;
+	const std::string& getAnimationName (int index) const;
+	bool hasAnimation (const std::string &name) const;
+
+	/** Returns the animation, decoding it if needed, or 0 if the bundle does not contain it. The bundle owns the animation. */
+	Animation* getAnimation (const std::string &name);
+	bool isDecoded (const std::string &name) const;
+
+	/** A pinned animation is never evicted by trim. */
+	void setPinned (const std::string &name, bool pinned);
+
+	/** Deletes a decoded animation. It must no longer be in use, eg by an AnimationState. */
+	void evict (const std::string &name);
+	/** Evicts the least recently requested unpinned animations until the decoded animations use at most byteBudget bytes.
+	 * @return The number of bytes still used by decoded animations. */
+	size_t trim (size_t byteBudget);
+
+	/** Returns the approximate number of bytes used by decoded animations. */
+	size_t getDecodedBytes () const;
+
+	/** Writes a bundle containing the animation JSON files at the specified paths. */
+	static void write (std::ostream &output, const std::vector<std::string> &names, const std::vector<std::string> &paths);
+
+private:
+	struct Entry {
+		std::string name;
+		unsigned int offset, length;
+		Animation *animation;
+		size_t bytes;
+		unsigned long lastUse;
+		bool pinned;
+	};
+
+	std::string path;
+	const char *data;
+	const BaseSkeletonJson *json;
+	const SkeletonData *skeletonData;
+	std::vector<Entry> entries;
+	std::map<std::string, int> nameToEntry;
+	size_t decodedBytes;
+	unsigned long useCount;
+
+	AnimationBundle (const AnimationBundle&);
+	AnimationBundle& operator= (const AnimationBundle&);
+
+	void readIndex (const char *begin, const char *end, size_t dataLength);
+	Entry* findEntry (const std::string &name);
+	void evict (Entry &entry);
+};
+
+} /* namespace spine */
+#endif /* SPINE_ANIMATIONBUNDLE_H_ */
@@ -27,6 +27,7 @@
 #define SPINE_ANIMATIONSTATE_H_
 
 #include <map>
+#include <spine/Allocator.h>
 
 namespace spine {
 
@@ -34,7 +35,7 @@ class Animation;
 class AnimationStateData;
 class BaseSkeleton;
 
-class AnimationState {
+class AnimationState: public Allocated<skeletonTag> {
 private:
 	Animation *previous;
 	float previousTime;
@@ -27,19 +27,21 @@
 #define SPINE_ANIMATIONSTATEDATA_H_
 
 #include <map>
+#include <spine/Allocator.h>
 
 namespace spine {
 
 class Animation;
 
-class AnimationStateData {
+class AnimationStateData: public Allocated<animationTag> {
 private:
-	std::map<std::pair<Animation*, Animation*>, float> animationToMixTime;
+	std::map<std::pair<Animation*, Animation*>, float, std::less<std::pair<Animation*, Animation*> >,
+			StlAllocator<std::pair<const std::pair<Animation*, Animation*>, float>, animationTag> > animationToMixTime;
 
 public:
 	/** Set the mixing duration between two animations. */
 	void setMixing (Animation *from, Animation *to, float duration);
-	float getMixing (Animation *from, Animation *to);
+	float getMixing (Animation *from, Animation *to) const;
 };
 
 } /* namespace spine */
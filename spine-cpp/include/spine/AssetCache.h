@@ -0,0 +1,204 @@
+/*******************************************************************************
+ * Copyright (c) 2013, Esoteric Software
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ******************************************************************************/
+
+#ifndef SPINE_ASSETCACHE_H_
+#define SPINE_ASSETCACHE_H_
+
+#include <string>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+namespace spine {
+
+class BaseSkeletonJson;
+class SkeletonData;
+class Animation;
+
+/** Shares loaded skeleton data, animations and atlases between all users of the same file. Assets are keyed by type, path and
+ * scale. Concurrent requests for an asset that is still loading wait for the single load instead of parsing the file again.
+ *
+ * Looking up a loaded asset takes no lock. Assets are reference counted through Handle; an asset that is no longer referenced
+ * stays cached until the cache exceeds its byte budget, then the least recently used ones are deleted. The budget is measured in
+ * the memoryUsage totals of the loaded assets, so textures are not included. All methods may be called from any thread. */
+class AssetCache {
+private:
+	class Entry;
+
+public:
+	/** Keeps an asset alive. Copying a handle adds a reference, destroying it releases one. */
+	template<class T>
+	class Handle {
+	public:
+		Handle () :
+						cache(0),
+						entry(0),
+						asset(0) {
+		}
+
+		Handle (const Handle &other) :
+						cache(other.cache),
+						entry(other.entry),
+						asset(other.asset) {
+			if (entry) cache->retain(entry);
+		}
+
+		~Handle () {
+			if (entry) cache->release(entry);
+		}
+
+		Handle& operator= (const Handle &other) {
+			if (other.entry) other.cache->retain(other.entry);
+			if (entry) cache->release(entry);
+			cache = other.cache;
+			entry = other.entry;
+			asset = other.asset;
+			return *this;
+		}
+
+		T* get () const {
+			return asset;
+		}
+
+		T* operator-> () const {
+			return asset;
+		}
+
+		operator bool () const {
+			return asset != 0;
+		}
+
+	private:
+		friend class AssetCache;
+
+		AssetCache *cache;
+		Entry *entry;
+		T *asset;
+
+		Handle (AssetCache *cache, Entry *entry, void *asset) :
+						cache(cache),
+						entry(entry),
+						asset(static_cast<T*>(asset)) {
+		}
+	};
+
+	struct Stats {
+		/** Requests served by an already loaded or loading asset. */
+		unsigned long hits;
+		/** Requests that had to load the asset. */
+		unsigned long misses;
+		unsigned long evictions;
+		/** The memoryUsage total of the currently loaded assets. */
+		size_t bytes;
+	};
+
+	/** @param byteBudget Unreferenced assets are evicted while the loaded assets use more than this. */
+	AssetCache (size_t byteBudget);
+	/** All handles must have been destroyed. Deletes all cached assets. */
+	~AssetCache ();
+
+	/** The key's scale is the json's scale. The json must not be used with a different atlas for the same path. */
+	Handle<SkeletonData> getSkeletonData (const BaseSkeletonJson *json, const std::string &path);
+
+	/** The key's scale is the json's scale. An animation path must always be requested with the same skeleton data, which must
+	 * outlive the cached animation. */
+	Handle<Animation> getAnimation (const BaseSkeletonJson *json, const std::string &path, const SkeletonData *skeletonData);
+
+	/** AtlasType must be a BaseAtlas with a constructor taking the path. Each path must always be requested with the same
+	 * AtlasType. */
+	template<class AtlasType>
+	Handle<AtlasType> getAtlas (const std::string &path);
+
+	/** Evicts unreferenced assets until the budget is met. */
+	void setByteBudget (size_t byteBudget);
+	size_t getByteBudget () const;
+
+	Stats getStats () const;
+
+private:
+	enum AssetType {
+		skeletonDataAsset, animationAsset, atlasAsset
+	};
+
+	/** Open addressed hash table of entries. Replaced rather than resized so lookups never see it change. */
+	struct Table {
+		std::atomic<Entry*> *buckets;
+		unsigned int mask;
+		int entryCount;
+
+		Table (unsigned int size);
+		~Table ();
+	};
+
+	std::atomic<Table*> table;
+	/** Tables that were replaced, kept until the cache is deleted since lookups may still be reading them. */
+	std::vector<Table*> oldTables;
+	/** Held while loading state changes, for growing the table and for eviction. */
+	std::mutex mutex;
+	std::condition_variable loaded;
+	std::atomic<size_t> byteBudget;
+	std::atomic<unsigned long> useCount;
+	std::atomic<unsigned long> hits, misses, evictions;
+	std::atomic<size_t> bytes;
+
+	AssetCache (const AssetCache&);
+	AssetCache& operator= (const AssetCache&);
+
+	/** @param load Returns the new asset and sets its size in bytes. Throws on failure.
+	 * @param destroy Deletes the asset. */
+	void* get (AssetType type, const std::string &path, float scale, const std::function<void*(size_t&)> &load,
+			void (*destroy) (void*), Entry *&entry);
+	Entry* find (const Table *table, unsigned int hash, AssetType type, const std::string &path, float scale) const;
+	bool acquire (Entry *entry);
+	void insert (Entry *entry);
+	void retain (Entry *entry);
+	void release (Entry *entry);
+	/** The mutex must be held. */
+	void trim ();
+
+	template<class AtlasType>
+	static void deleteAtlas (void *atlas);
+};
+
+template<class AtlasType>
+void AssetCache::deleteAtlas (void *atlas) {
+	delete static_cast<AtlasType*>(atlas);
+}
+
+template<class AtlasType>
+AssetCache::Handle<AtlasType> AssetCache::getAtlas (const std::string &path) {
+	Entry *entry;
+	void *atlas = get(atlasAsset, path, 1, [&] (size_t &size) -> void* {
+		AtlasType *atlas = new AtlasType(path);
+		size = atlas->memoryUsage().getTotalBytes();
+		return atlas;
+	}, &deleteAtlas<AtlasType>, entry);
+	return Handle<AtlasType>(this, entry, atlas);
+}
+
+} /* namespace spine */
+#endif /* SPINE_ASSETCACHE_H_ */
@@ -0,0 +1,191 @@
+/*******************************************************************************
+ * Copyright (c) 2013, Esoteric Software
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ******************************************************************************/
+
+#ifndef SPINE_ASYNCLOADER_H_
+#define SPINE_ASYNCLOADER_H_
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <future>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <exception>
+
+namespace spine {
+
+class BaseSkeletonJson;
+class SkeletonData;
+class Animation;
+
+/** Reads and parses atlases, skeletons and animations on worker threads. Work that must happen on the rendering thread, such as
+ * texture creation, and all completion callbacks are queued until update is called. The returned futures also only become ready
+ * during update, so the thread calling update must not wait on them. The caller owns the loaded objects.
+ *
+ * BaseSkeletonJson is only used through its const methods, so one instance may be shared by many concurrent loads. The atlas used
+ * by its attachment loader must have its textures loaded before a skeleton that references it is loaded. */
+class AsyncLoader {
+public:
+	/** @param threadCount The number of worker threads, at least 1. */
+	AsyncLoader (int threadCount = 2);
+	/** Waits for queued worker tasks to finish. Queued rendering thread tasks are not run: the objects they would have delivered are
+	 * deleted, their futures throw std::runtime_error and their callbacks are not called. */
+	virtual ~AsyncLoader ();
+
+	/** @param callback Called from update with the skeleton data, or 0 if loading failed. May be empty. */
+	std::shared_future<SkeletonData*> loadSkeletonData (const BaseSkeletonJson *json, const std::string &path,
+			const std::function<void(SkeletonData*)> &callback = std::function<void(SkeletonData*)>());
+
+	/** @param callback Called from update with the animation, or 0 if loading failed. May be empty. */
+	std::shared_future<Animation*> loadAnimation (const BaseSkeletonJson *json, const std::string &path,
+			const SkeletonData *skeletonData,
+			const std::function<void(Animation*)> &callback = std::function<void(Animation*)>());
+
+	/** Loads each animation as a separate task so they are parsed in parallel. */
+	std::vector<std::shared_future<Animation*> > loadAnimations (const BaseSkeletonJson *json,
+			const std::vector<std::string> &paths, const SkeletonData *skeletonData);
+
+	/** The atlas is parsed on a worker, then its textures are loaded during update. AtlasType must have a constructor taking
+	 * (const char *begin, const char *end, bool deferTextures).
+	 * @param callback Called from update with the atlas, or 0 if loading failed. May be empty. */
+	template<class AtlasType>
+	std::shared_future<AtlasType*> loadAtlas (const std::string &path,
+			const std::function<void(AtlasType*)> &callback = std::function<void(AtlasType*)>());
+
+	/** Runs the queued rendering thread tasks and completion callbacks on the calling thread.
+	 * @return The number of tasks run. */
+	int update ();
+
+	/** Returns the number of loads that have not yet completed, including their callbacks. */
+	int getPendingCount ();
+
+protected:
+	/** Reads a whole file. Called on a worker thread. Throws if the file cannot be read. A subclass that overrides this must call
+	 * stop in its destructor, so no worker calls it while the subclass is destroyed. */
+	virtual void readFile (const std::string &path, std::string &data);
+
+	/** Waits for queued worker tasks to finish and stops the workers, then discards the queued rendering thread tasks as the
+	 * destructor describes. Loads must not be started afterward. Called by the destructor; calling it again does nothing. */
+	void stop ();
+
+private:
+	/** A rendering thread task and what to do instead if the loader is destroyed before it runs. */
+	struct MainTask {
+		std::function<void()> run;
+		std::function<void()> discard;
+	};
+
+	std::vector<std::thread> workers;
+	std::deque<std::function<void()> > workerTasks;
+	std::deque<MainTask> mainTasks;
+	std::mutex workerMutex;
+	std::mutex mainMutex;
+	std::condition_variable workerCondition;
+	bool stopping;
+	std::atomic<int> pendingCount;
+
+	AsyncLoader (const AsyncLoader&);
+	AsyncLoader& operator= (const AsyncLoader&);
+
+	void run ();
+	/** Queues a worker task for a new load. The load is pending until its final rendering thread task has run. */
+	void submit (const std::function<void()> &task);
+	void post (const std::function<void()> &task, const std::function<void()> &discard);
+	/** The error set on the promises of loads discarded by the destructor. */
+	static std::exception_ptr destroyedError ();
+
+	template<class T>
+	void complete (const std::shared_ptr<std::promise<T*> > &promise, const std::function<void(T*)> &callback, T *value);
+	template<class T>
+	void fail (const std::shared_ptr<std::promise<T*> > &promise, const std::function<void(T*)> &callback,
+			std::exception_ptr error);
+};
+
+template<class T>
+void AsyncLoader::complete (const std::shared_ptr<std::promise<T*> > &promise, const std::function<void(T*)> &callback, T *value) {
+	post([=] () {
+		promise->set_value(value);
+		pendingCount--;
+		if (callback) callback(value);
+	}, [=] () {
+		delete value;
+		promise->set_exception(destroyedError());
+	});
+}
+
+template<class T>
+void AsyncLoader::fail (const std::shared_ptr<std::promise<T*> > &promise, const std::function<void(T*)> &callback,
+		std::exception_ptr error) {
+	post([=] () {
+		promise->set_exception(error);
+		pendingCount--;
+		if (callback) callback(0);
+	}, [=] () {
+		promise->set_exception(error);
+	});
+}
+
+template<class AtlasType>
+std::shared_future<AtlasType*> AsyncLoader::loadAtlas (const std::string &path, const std::function<void(AtlasType*)> &callback) {
+	std::shared_ptr<std::promise<AtlasType*> > promise(new std::promise<AtlasType*>());
+	std::shared_future<AtlasType*> future = promise->get_future().share();
+	submit([=] () {
+		AtlasType *atlas = 0;
+		try {
+			std::string data;
+			readFile(path, data);
+			atlas = new AtlasType(data.data(), data.data() + data.length(), true);
+			post([=] () {
+				try {
+					atlas->loadTextures();
+				} catch (...) {
+					delete atlas;
+					promise->set_exception(std::current_exception());
+					pendingCount--;
+					if (callback) callback(0);
+					return;
+				}
+				promise->set_value(atlas);
+				pendingCount--;
+				if (callback) callback(atlas);
+			}, [=] () {
+				delete atlas;
+				promise->set_exception(destroyedError());
+			});
+		} catch (...) {
+			// If post threw, the atlas was not queued.
+			delete atlas;
+			fail(promise, callback, std::current_exception());
+		}
+	});
+	return future;
+}
+
+} /* namespace spine */
+#endif /* SPINE_ASYNCLOADER_H_ */
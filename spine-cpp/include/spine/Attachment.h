@@ -27,20 +27,28 @@
 #define SPINE_ATTACHMENT_H_
 
 #include <string>
+#include <spine/Allocator.h>
+#include <spine/MemoryUsage.h>
 
 namespace spine {
 
 class BaseSkeleton;
 class Slot;
 
-class Attachment {
+class Attachment: public Allocated<attachmentTag> {
 public:
-	std::string name;
+	String name;
 
 	virtual ~Attachment () {
 	}
 
 	virtual void draw (Slot *slot) = 0;
+
+	/** Adds the bytes used by the attachment. Subclasses should override this to add their own size. */
+	virtual void addMemoryUsage (MemoryUsage &usage) const {
+		usage.add(objectMemory, sizeof(Attachment));
+		usage.addCharacters(name);
+	}
 };
 
 } /* namespace spine */
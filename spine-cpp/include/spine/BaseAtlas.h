@@ -27,29 +27,75 @@
 #define SPINE_BASEATLAS_H_
 
 #include <istream>
+#include <ostream>
 #include <string>
 #include <vector>
+#include <utility>
+#include <spine/Allocator.h>
+#include <spine/MemoryUsage.h>
 
 namespace spine {
 
 class BaseAtlasPage;
 class BaseAtlasRegion;
 
-class BaseAtlas {
+class BaseAtlas: public Allocated<atlasTag> {
 public:
-	std::vector<BaseAtlasPage*> pages;
-	std::vector<BaseAtlasRegion*> regions;
+	std::vector<BaseAtlasPage*, StlAllocator<BaseAtlasPage*, atlasTag> > pages;
+	std::vector<BaseAtlasRegion*, StlAllocator<BaseAtlasRegion*, atlasTag> > regions;
 
 	virtual BaseAtlasRegion* findRegion (const std::string &name);
 
+	/** Writes this atlas in the binary atlas format. Each page's width and height must be set so the normalized UVs can be
+	 * stored. */
+	void writeBinary (std::ostream &output) const;
+
+	/** Converts text atlas data to the binary atlas format without loading any textures.
+	 * @param pageSizes The texture width and height of each page, in the order the pages appear in the atlas. */
+	static void convertToBinary (const char *begin, const char *end, const std::vector<std::pair<int, int> > &pageSizes,
+			std::ostream &output);
+
+	/** Creates the textures for pages that were loaded with deferTextures. Must be called on the thread that owns the rendering
+	 * context. */
+	void loadTextures ();
+
+	/** Creates the texture for the next page that doesn't have one, so texture creation can be spread over several frames.
+	 * @return False if all pages already had textures. */
+	bool loadNextTexture ();
+
+	/** Returns the number of pages whose textures have not been created yet. */
+	int getPendingTextureCount () const;
+
+	/** Returns the bytes used by the atlas, its pages and its regions. The textures are not included. */
+	MemoryUsage memoryUsage () const;
+
 protected:
+	/** @param deferTextures If true, load only parses the atlas and loadTextures must be called before the atlas is used for
+	 *           rendering. This allows the atlas to be parsed on a thread without a rendering context. */
+	BaseAtlas (bool deferTextures = false);
 	virtual ~BaseAtlas ();
 
+	/** Loads either the text or the binary atlas format. */
 	void load (std::istream &input);
 	void load (const std::string &path);
 	void load (const char *begin, const char *end);
 
+	/** Creates the texture for a page and sets the page's width and height. The UVs of the page's regions are recomputed if this
+	 * changes the page's size, which is always the case for pages from text atlases. */
+	virtual void loadTexture (BaseAtlasPage *page);
+
 private:
+	bool deferTextures;
+	int texturePageCount;
+	/** Open addressed hash table of region index + 1, 0 for an empty bucket. */
+	std::vector<unsigned int, StlAllocator<unsigned int, atlasTag> > regionTable;
+
+	void loadText (const char *begin, const char *end);
+	void loadBinary (const char *begin, const char *end);
+	void indexRegions ();
+	/** Returns true if the region table from the binary data finds every region it holds, so it can be used without rebuilding. */
+	bool isValidRegionTable () const;
+
 	virtual BaseAtlasPage* newAtlasPage (const std::string &name) = 0;
 	virtual BaseAtlasRegion* newAtlasRegion (BaseAtlasPage *page) = 0;
 };
@@ -70,22 +116,29 @@ enum TextureWrap {
 
 //
 
-class BaseAtlasPage {
+class BaseAtlasPage: public Allocated<atlasTag> {
 public:
-	std::string name;
+	String name;
 	Format format;
 	TextureFilter minFilter, magFilter;
 	TextureWrap uWrap, vWrap;
+	/** The size of the page's texture in pixels, or 0 if unknown. Region UVs are only computed when the size is known. */
+	int width, height;
 
+	BaseAtlasPage ();
 	virtual ~BaseAtlasPage () {
 	}
+
+	/** Adds the bytes used by the page. Subclasses should override this to add their own size. */
+	virtual void addMemoryUsage (MemoryUsage &usage) const;
 };
 
 //
 
-class BaseAtlasRegion {
+class BaseAtlasRegion: public Allocated<atlasTag> {
 public:
-	std::string name;
+	BaseAtlasPage *page;
+	String name;
 	int x, y, width, height;
 	float offsetX, offsetY;
 	int originalWidth, originalHeight;
@@ -94,9 +147,18 @@ public:
 	bool flip;
 	int *splits;
 	int *pads;
+	/** Normalized texture coordinates with rotation already applied. Only valid if the page's size is known. */
+	float u, v, u2, v2;
 
 	BaseAtlasRegion ();
+
+	/** Computes the normalized texture coordinates from x, y, width, height and rotate. A rotated region occupies height by width
+	 * pixels in the page, as in libgdx, so its u2 and v2 use the swapped size. */
+	void updateUVs (int pageWidth, int pageHeight);
 	virtual ~BaseAtlasRegion ();
+
+	/** Adds the bytes used by the region. Subclasses with more fields should override this. */
+	virtual void addMemoryUsage (MemoryUsage &usage) const;
 };
 
 } /* namespace spine */
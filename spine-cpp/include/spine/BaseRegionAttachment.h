@@ -43,6 +43,8 @@ public:
 	void updateOffset ();
 
 	virtual void updateWorldVertices (Bone *bone) = 0;
+
+	virtual void addMemoryUsage (MemoryUsage &usage) const;
 };
 
 } /* namespace spine */
@@ -28,6 +28,8 @@
 
 #include <string>
 #include <vector>
+#include <spine/Allocator.h>
+#include <spine/MemoryUsage.h>
 
 namespace spine {
 
@@ -37,19 +39,20 @@ class Slot;
 class Bone;
 class Attachment;
 
-class BaseSkeleton {
+class BaseSkeleton: public Allocated<skeletonTag> {
 public:
-	SkeletonData *data;
-	std::vector<Bone*> bones;
-	std::vector<Slot*> slots;
-	std::vector<Slot*> drawOrder;
-	Skin *skin;
+	const SkeletonData *data;
+	std::vector<Bone*, StlAllocator<Bone*, skeletonTag> > bones;
+	std::vector<Slot*, StlAllocator<Slot*, skeletonTag> > slots;
+	std::vector<Slot*, StlAllocator<Slot*, skeletonTag> > drawOrder;
+	const Skin *skin;
 	float r, g, b, a;
 	float time;
 	bool flipX, flipY;
 
-	/** The BaseSkeleton owns the SkeletonData. */
-	BaseSkeleton (SkeletonData *data);
+	/** The SkeletonData is not owned and is only read, so it may be shared by skeletons updated on different threads. It must
+	 * outlive the skeleton. */
+	BaseSkeleton (const SkeletonData *data);
 	virtual ~BaseSkeleton ();
 
 	void updateWorldTransform ();
@@ -67,13 +70,18 @@ public:
 
 	void setSkin (const std::string &skinName);
 	/** @param skin May be null. */
-	void setSkin (Skin *skin);
+	void setSkin (const Skin *skin);
 
 	Attachment* getAttachment (const std::string &slotName, const std::string &attachmentName) const;
 	Attachment* getAttachment (int slotIndex, const std::string &attachmentName) const;
+	Attachment* getAttachment (int slotIndex, const String &attachmentName) const;
 	void setAttachment (const std::string &slotName, const std::string &attachmentName);
 
 	void update (float deltaTime);
+
+	/** Returns the bytes used by the skeleton, its bones and slots as instance memory, and the bytes used by its SkeletonData as
+	 * shared memory. Subclasses with more fields should override this. */
+	virtual SkeletonMemoryUsage memoryUsage () const;
 };
 
 } /* namespace spine */
@@ -27,12 +27,21 @@
 #define SPINE_BASESKELETONJSON_H_
 
 #include <istream>
+#include <string>
+
+namespace Json {
+class Value;
+}
 
 namespace spine {
 
 class BaseAttachmentLoader;
 class SkeletonData;
+class BoneData;
+class SlotData;
+class Attachment;
 class Animation;
+class Timeline;
 
 class BaseSkeletonJson {
 public:
@@ -51,6 +60,18 @@ public:
 	Animation* readAnimation (const std::string &path, const SkeletonData *skeletonData) const;
 	Animation* readAnimation (std::istream &input, const SkeletonData *skeletonData) const;
 	Animation* readAnimation (const char *begin, const char *end, const SkeletonData *skeletonData) const;
+
+private:
+	friend class IncrementalLoader;
+
+	BoneData* readBone (const SkeletonData *skeletonData, const Json::Value &boneMap) const;
+	SlotData* readSlot (const SkeletonData *skeletonData, const Json::Value &slotMap) const;
+	Attachment* readAttachment (const std::string &attachmentName, const Json::Value &attachmentMap) const;
+	/** @param duration Set to the time of the last keyframe if it is larger. */
+	Timeline* readBoneTimeline (int boneIndex, const std::string &boneName, const std::string &timelineName,
+			const Json::Value &values, float &duration) const;
+	Timeline* readSlotTimeline (int slotIndex, const std::string &slotName, const std::string &timelineName,
+			const Json::Value &values, float &duration) const;
 };
 
 } /* namespace spine */
@@ -26,13 +26,15 @@
 #ifndef SPINE_BONE_H_
 #define SPINE_BONE_H_
 
+#include <spine/Allocator.h>
+
 namespace spine {
 
 class BoneData;
 
-class Bone {
+class Bone: public Allocated<skeletonTag> {
 public:
-	BoneData *data;
+	const BoneData *data;
 	/** May be null. */
 	Bone *parent;
 	float x, y;
@@ -44,7 +46,7 @@ public:
 	float worldRotation;
 	float worldScaleX, worldScaleY;
 
-	Bone (BoneData *data);
+	Bone (const BoneData *data);
 
 	void setToBindPose ();
 
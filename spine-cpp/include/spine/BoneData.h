@@ -27,12 +27,13 @@
 #define SPINE_BONEDATA_H_
 
 #include <string>
+#include <spine/Allocator.h>
 
 namespace spine {
 
-class BoneData {
+class BoneData: public Allocated<skeletonDataTag> {
 public:
-	std::string name;
+	String name;
 	BoneData* parent;
 	float length;
 	float x, y;
@@ -0,0 +1,52 @@
+/*******************************************************************************
+ * Copyright (c) 2013, Esoteric Software
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ******************************************************************************/
+
+#ifndef SPINE_BYTEORDER_H_
+#define SPINE_BYTEORDER_H_
+
+#include <algorithm>
+#include <cstddef>
+
+namespace spine {
+
+/** Binary formats store their fields little endian. These convert between that and the host order. */
+
+inline bool isBigEndian () {
+	const unsigned int one = 1;
+	return *reinterpret_cast<const unsigned char*>(&one) == 0;
+}
+
+/** Converts count 4 byte words between little endian and the host order. */
+inline void swapWords (void *words, size_t count) {
+	if (!isBigEndian()) return;
+	unsigned char *bytes = static_cast<unsigned char*>(words);
+	for (size_t i = 0; i < count; i++, bytes += 4) {
+		std::swap(bytes[0], bytes[3]);
+		std::swap(bytes[1], bytes[2]);
+	}
+}
+
+} /* namespace spine */
+#endif /* SPINE_BYTEORDER_H_ */
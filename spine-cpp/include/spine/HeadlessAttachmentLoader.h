@@ -0,0 +1,48 @@
+/*******************************************************************************
+ * Copyright (c) 2013, Esoteric Software
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ******************************************************************************/
+
+#ifndef SPINE_HEADLESSATTACHMENTLOADER_H_
+#define SPINE_HEADLESSATTACHMENTLOADER_H_
+
+#include <spine/BaseAttachmentLoader.h>
+
+namespace spine {
+
+class BaseAtlas;
+
+/** Creates HeadlessRegionAttachments, so skeleton data can be loaded without a rendering backend. */
+class HeadlessAttachmentLoader: public BaseAttachmentLoader {
+public:
+	/** May be null, in which case attachments have no UVs and no atlas file is needed. */
+	BaseAtlas *atlas;
+
+	/** @param atlas May be null. If not, a region must exist for each attachment. */
+	HeadlessAttachmentLoader (BaseAtlas *atlas = 0);
+
+	virtual Attachment* newAttachment (AttachmentType type, const std::string &name);
+};
+
+} /* namespace spine */
+#endif /* SPINE_HEADLESSATTACHMENTLOADER_H_ */
@@ -0,0 +1,57 @@
+/*******************************************************************************
+ * Copyright (c) 2013, Esoteric Software
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ******************************************************************************/
+
+#ifndef SPINE_HEADLESSREGIONATTACHMENT_H_
+#define SPINE_HEADLESSREGIONATTACHMENT_H_
+
+#include <spine/BaseRegionAttachment.h>
+
+namespace spine {
+
+class BaseAtlasRegion;
+
+/** A region attachment that computes world vertices into plain float buffers instead of drawing. */
+class HeadlessRegionAttachment: public BaseRegionAttachment {
+public:
+	/** The world vertices from the last updateWorldVertices or draw, as x,y pairs for the corners in the same order as offset. */
+	float vertices[8];
+	/** The texture coordinates of the corners, in the same order as vertices. All 0 when the region's UVs are not known. */
+	float uvs[8];
+
+	/** @param region May be null when there is no atlas. */
+	HeadlessRegionAttachment (const BaseAtlasRegion *region = 0);
+
+	/** Writes the 8 world vertex coordinates for the bone's world transform. */
+	void computeWorldVertices (const Bone *bone, float *worldVertices) const;
+
+	virtual void updateWorldVertices (Bone *bone);
+	/** Updates vertices for the slot's bone. */
+	virtual void draw (Slot *slot);
+
+	virtual void addMemoryUsage (MemoryUsage &usage) const;
+};
+
+} /* namespace spine */
+#endif /* SPINE_HEADLESSREGIONATTACHMENT_H_ */
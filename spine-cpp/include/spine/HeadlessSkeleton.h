@@ -0,0 +1,53 @@
+/*******************************************************************************
+ * Copyright (c) 2013, Esoteric Software
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ******************************************************************************/
+
+#ifndef SPINE_HEADLESSSKELETON_H_
+#define SPINE_HEADLESSSKELETON_H_
+
+#include <vector>
+#include <spine/BaseSkeleton.h>
+
+namespace spine {
+
+/** A skeleton that computes world vertices into a plain buffer instead of drawing, for simulation servers and benchmarks. Only
+ * HeadlessRegionAttachments, eg loaded with HeadlessAttachmentLoader, are computed; other attachments are skipped. */
+class HeadlessSkeleton: public BaseSkeleton {
+public:
+	/** After draw, 8 world vertex coordinates for each slot with a HeadlessRegionAttachment, in draw order. */
+	std::vector<float, StlAllocator<float, skeletonTag> > vertices;
+
+	HeadlessSkeleton (const SkeletonData *data);
+
+	/** Computes the world vertices of all attachments into vertices. Does not allocate. */
+	void draw ();
+
+	/** Returns the number of attachments in vertices. */
+	int getQuadCount () const;
+
+	virtual SkeletonMemoryUsage memoryUsage () const;
+};
+
+} /* namespace spine */
+#endif /* SPINE_HEADLESSSKELETON_H_ */
@@ -0,0 +1,113 @@
+/*******************************************************************************
+ * Copyright (c) 2013, Esoteric Software
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ******************************************************************************/
+
+#ifndef SPINE_INCREMENTALLOADER_H_
+#define SPINE_INCREMENTALLOADER_H_
+
+#include <string>
+#include <deque>
+#include <functional>
+#include <exception>
+
+namespace spine {
+
+class BaseAtlas;
+class BaseSkeletonJson;
+class SkeletonData;
+class Animation;
+
+/** Loads atlases, skeletons and animations on the calling thread in small units of work, so loading can be interleaved with
+ * rendering where threads are not available. Loads run one after another in the order they were queued. A unit of work is reading
+ * one block of a file, parsing the JSON of one file, reading one bone, slot, skin attachment or timeline, or creating the texture
+ * for one atlas page. Parsing a file's JSON can't be split, so large animations are best kept in separate files. The caller owns
+ * the loaded objects.
+ *
+ * A callback may queue further loads, eg an animation load after its skeleton data has loaded. */
+class IncrementalLoader {
+public:
+	IncrementalLoader ();
+	/** Discards unfinished loads without calling their callbacks. */
+	virtual ~IncrementalLoader ();
+
+	/** @param callback Called from step with the skeleton data, or with 0 and the exception that made loading fail. May be empty. */
+	void loadSkeletonData (const BaseSkeletonJson *json, const std::string &path,
+			const std::function<void(SkeletonData*, std::exception_ptr)> &callback =
+					std::function<void(SkeletonData*, std::exception_ptr)>());
+
+	/** @param callback Called from step with the animation, or with 0 and the exception that made loading fail. May be empty. */
+	void loadAnimation (const BaseSkeletonJson *json, const std::string &path, const SkeletonData *skeletonData,
+			const std::function<void(Animation*, std::exception_ptr)> &callback =
+					std::function<void(Animation*, std::exception_ptr)>());
+
+	/** Textures are created one page per unit of work, so step must be called on the thread that owns the rendering context.
+	 * AtlasType must have a constructor taking (const char *begin, const char *end, bool deferTextures).
+	 * @param callback Called from step with the atlas, or with 0 and the exception that made loading fail. May be empty. */
+	template<class AtlasType>
+	void loadAtlas (const std::string &path,
+			const std::function<void(AtlasType*, std::exception_ptr)> &callback = std::function<void(AtlasType*, std::exception_ptr)>());
+
+	/** Runs units of work until the budget is spent or no loads remain. At least one unit is run, so loading always advances.
+	 * @return True if no loads remain. */
+	bool step (int microseconds);
+
+	/** Returns the number of queued loads that have not completed. */
+	int getPendingCount () const;
+
+	/** Returns the approximate progress of the loads queued since the loader was last idle, from 0 to 1. It can go down when a
+	 * callback queues another load. */
+	float getProgress () const;
+
+private:
+	class Load;
+	class FileLoad;
+	class SkeletonDataLoad;
+	class AnimationLoad;
+	class AtlasLoad;
+
+	std::deque<Load*> loads;
+	int completedCount;
+
+	IncrementalLoader (const IncrementalLoader&);
+	IncrementalLoader& operator= (const IncrementalLoader&);
+
+	void queue (Load *load);
+	/** BaseAtlas can't be deleted directly, so destroy deletes it as the concrete type on failure. */
+	void loadAtlas (const std::string &path, const std::function<BaseAtlas*(const char*, const char*)> &create,
+			const std::function<void(BaseAtlas*)> &destroy, const std::function<void(BaseAtlas*, std::exception_ptr)> &callback);
+};
+
+template<class AtlasType>
+void IncrementalLoader::loadAtlas (const std::string &path, const std::function<void(AtlasType*, std::exception_ptr)> &callback) {
+	loadAtlas(path, [] (const char *begin, const char *end) -> BaseAtlas* {
+		return new AtlasType(begin, end, true);
+	}, [] (BaseAtlas *atlas) {
+		delete static_cast<AtlasType*>(atlas);
+	}, [=] (BaseAtlas *atlas, std::exception_ptr error) {
+		if (callback) callback(static_cast<AtlasType*>(atlas), error);
+	});
+}
+
+} /* namespace spine */
+#endif /* SPINE_INCREMENTALLOADER_H_ */
@@ -0,0 +1,194 @@
+/*******************************************************************************
+ * Copyright (c) 2013, Esoteric Software
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ******************************************************************************/
+
+#ifndef SPINE_INSTRUMENTATION_H_
+#define SPINE_INSTRUMENTATION_H_
+
+/** Timing scopes and counters for the hot paths of the runtime. They are compiled in only when SPINE_INSTRUMENTATION is defined;
+ * otherwise SPINE_SCOPE and SPINE_COUNT expand to nothing and the runtime is built exactly as without them.
+ *
+ * When compiled in, nothing is recorded until a sink is set with setInstrumentationSink, and each scope or counter then costs one
+ * atomic load. */
+
+#ifdef SPINE_INSTRUMENTATION
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace spine {
+
+enum Counter {
+	timelinesApplied, bonesUpdated, attachmentSwaps, quadsEmitted, counterCount
+};
+
+const char* getCounterName (Counter counter);
+
+/** Receives the scopes and counters of all threads, so implementations must be thread safe. */
+class InstrumentationSink {
+public:
+	virtual ~InstrumentationSink () {
+	}
+
+	/** Called when a scope ends. Times are in nanoseconds, from the same steady clock as getInstrumentationTime.
+	 * @param name A string literal, which may be compared by address. */
+	virtual void scope (const char *name, long long start, long long duration) = 0;
+	virtual void count (Counter counter, int amount) = 0;
+};
+
+/** Sets the sink that receives all scopes and counters, or 0 to stop recording. The sink must outlive any scope that was started
+ * while it was set. */
+void setInstrumentationSink (InstrumentationSink *sink);
+InstrumentationSink* getInstrumentationSink ();
+
+/** Returns the current time of a steady clock, in nanoseconds. */
+long long getInstrumentationTime ();
+
+inline void instrumentationCount (Counter counter, int amount) {
+	InstrumentationSink *sink = getInstrumentationSink();
+	if (sink) sink->count(counter, amount);
+}
+
+class InstrumentationScope {
+public:
+	explicit InstrumentationScope (const char *name) :
+					name(name),
+					sink(getInstrumentationSink()),
+					start(sink ? getInstrumentationTime() : 0) {
+	}
+
+	~InstrumentationScope () {
+		if (sink) sink->scope(name, start, getInstrumentationTime() - start);
+	}
+
+private:
+	const char *name;
+	InstrumentationSink *sink;
+	long long start;
+
+	InstrumentationScope (const InstrumentationScope&);
+	InstrumentationScope& operator= (const InstrumentationScope&);
+};
+
+/** Aggregates scope durations into power of two histograms and sums the counters. */
+class HistogramSink: public InstrumentationSink {
+public:
+	static const int BUCKET_COUNT = 40;
+
+	struct Histogram {
+		long long count;
+		long long total;
+		long long min;
+		long long max;
+		/** Bucket i counts the durations from 2^i up to 2^(i+1) nanoseconds, bucket 0 also those below 1. */
+		long long buckets[BUCKET_COUNT];
+
+		Histogram ();
+		void add (long long duration);
+		void add (const Histogram &histogram);
+		/** Returns the upper bound of the bucket that holds the given fraction of the durations, clamped to max. */
+		long long getPercentile (float fraction) const;
+	};
+
+	HistogramSink ();
+
+	virtual void scope (const char *name, long long start, long long duration);
+	virtual void count (Counter counter, int amount);
+
+	/** Returns the histogram for all scopes with the name, which is empty if there were none. */
+	Histogram getHistogram (const std::string &name) const;
+	long long getCount (Counter counter) const;
+	void reset ();
+
+	/** Writes the histograms and counter totals as a JSON object. Durations are in nanoseconds. */
+	void write (std::ostream &output) const;
+
+private:
+	mutable std::mutex mutex;
+	/** Keyed by the address of the name, merged by content when read. */
+	std::map<const char*, Histogram> histograms;
+	std::atomic<long long> counts[counterCount];
+
+	std::map<std::string, Histogram> mergeHistograms () const;
+};
+
+/** Records every scope and counter change as an event, written in the Chrome trace event format that chrome://tracing and
+ * Perfetto open. Counters are written as running totals. */
+class ChromeTraceSink: public InstrumentationSink {
+public:
+	/** @param maxEvents Events past this many are dropped and counted by getDroppedEventCount. */
+	explicit ChromeTraceSink (size_t maxEvents = 1 << 20);
+
+	virtual void scope (const char *name, long long start, long long duration);
+	virtual void count (Counter counter, int amount);
+
+	size_t getEventCount () const;
+	size_t getDroppedEventCount () const;
+	void clear ();
+
+	/** Writes the events as a JSON trace, with times relative to the first event. */
+	void write (std::ostream &output) const;
+
+private:
+	struct Event {
+		const char *name;
+		long long time;
+		/** The scope duration, or the counter total for counter events. */
+		long long value;
+		int thread;
+		bool isCounter;
+	};
+
+	mutable std::mutex mutex;
+	std::vector<Event> events;
+	size_t maxEvents;
+	size_t droppedEvents;
+	long long totals[counterCount];
+	std::map<std::thread::id, int> threads;
+
+	int getThread ();
+	void addEvent (const Event &event);
+};
+
+} /* namespace spine */
+
+#define SPINE_SCOPE_VARIABLE_(line) spineInstrumentationScope##line
+#define SPINE_SCOPE_VARIABLE(line) SPINE_SCOPE_VARIABLE_(line)
+/** Times the rest of the enclosing block. */
+#define SPINE_SCOPE(name) spine::InstrumentationScope SPINE_SCOPE_VARIABLE(__LINE__)(name)
+#define SPINE_COUNT(counter, amount) spine::instrumentationCount(spine::counter, amount)
+
+#else
+
+#define SPINE_SCOPE(name)
+#define SPINE_COUNT(counter, amount)
+
+#endif /* SPINE_INSTRUMENTATION */
+
+#endif /* SPINE_INSTRUMENTATION_H_ */
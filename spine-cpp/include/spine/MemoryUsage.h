@@ -0,0 +1,92 @@
+/*******************************************************************************
+ * Copyright (c) 2013, Esoteric Software
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ******************************************************************************/
+
+#ifndef SPINE_MEMORYUSAGE_H_
+#define SPINE_MEMORYUSAGE_H_
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+
+namespace spine {
+
+class String;
+
+enum MemoryCategory {
+	/** The objects themselves, eg bones, slots, timelines, attachments and atlas regions. */
+	objectMemory,
+	/** Timeline keyframe times and values. */
+	keyframeMemory,
+	/** Timeline bezier curves. */
+	curveMemory,
+	/** Names and other strings, including the characters they allocate. */
+	stringMemory,
+	/** Map nodes, eg one for each resident chunk of a StreamingAnimation. */
+	mapMemory,
+	/** Vectors and other arrays, by capacity. */
+	arrayMemory,
+	memoryCategoryCount
+};
+
+const char* getMemoryCategoryName (MemoryCategory category);
+
+/** Bytes by category. The bytes are what the runtime and the standard library containers request, without the overhead of the
+ * heap itself. Textures, and the JSON documents the loaders parse and free before returning, are not included. */
+class MemoryUsage {
+public:
+	size_t bytes[memoryCategoryCount];
+
+	MemoryUsage ();
+
+	void add (MemoryCategory category, size_t bytes);
+	/** Adds the characters the string allocated, if it doesn't store them inline. The string object itself is not added. */
+	void addCharacters (const std::string &value);
+	void addCharacters (const String &value);
+	/** Adds a String created with new and its characters. Value may be null. */
+	void addString (const String *value);
+	/** Adds a map node holding a value of the given size. */
+	void addMapNode (size_t valueSize);
+
+	size_t getTotalBytes () const;
+
+	MemoryUsage& operator+= (const MemoryUsage &usage);
+
+	/** Writes the bytes for each category and the total as a JSON object. */
+	void write (std::ostream &output) const;
+};
+
+/** The memory of a skeleton: what it owns, and the SkeletonData, skins and attachments it uses, which may be shared with other
+ * skeletons. */
+class SkeletonMemoryUsage {
+public:
+	MemoryUsage instance;
+	MemoryUsage shared;
+
+	/** Writes the instance and shared usage as a JSON object. */
+	void write (std::ostream &output) const;
+};
+
+} /* namespace spine */
+#endif /* SPINE_MEMORYUSAGE_H_ */
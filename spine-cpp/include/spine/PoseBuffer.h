@@ -0,0 +1,73 @@
+/*******************************************************************************
+ * Copyright (c) 2013, Esoteric Software
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ******************************************************************************/
+
+#ifndef SPINE_POSEBUFFER_H_
+#define SPINE_POSEBUFFER_H_
+
+#include <atomic>
+#include <spine/SkeletonPose.h>
+
+namespace spine {
+
+class BaseSkeleton;
+
+/** Passes skeleton poses from an update thread to a render thread without locks. Each side owns one of three poses and the third
+ * is exchanged atomically, so neither side waits and the render thread never sees a pose while it is written. If the update thread
+ * publishes faster than the render thread acquires, the poses in between are skipped.
+ *
+ * Only one thread may write and only one thread may read. */
+class PoseBuffer: public Allocated<skeletonTag> {
+public:
+	PoseBuffer ();
+
+	/** Update thread: returns the pose to fill before calling publish. */
+	SkeletonPose& getWritePose ();
+	/** Update thread: makes the write pose the latest pose. The write pose is then a different one. */
+	void publish ();
+	/** Update thread: captures the skeleton into the write pose and publishes it. */
+	void publish (const BaseSkeleton *skeleton);
+
+	/** Render thread: makes the latest published pose the read pose.
+	 * @return False if nothing was published since the last acquire, in which case the read pose is unchanged. */
+	bool acquire ();
+	/** Render thread: returns the pose from the last acquire. Until something is acquired, it is empty. */
+	const SkeletonPose& getReadPose () const;
+
+private:
+	static const int INDEX_MASK = 3;
+	static const int FRESH = 4;
+
+	SkeletonPose poses[3];
+	int writeIndex;
+	int readIndex;
+	/** The index of the pose neither side owns, with FRESH set if it was published and not yet acquired. */
+	std::atomic<int> middle;
+
+	PoseBuffer (const PoseBuffer&);
+	PoseBuffer& operator= (const PoseBuffer&);
+};
+
+} /* namespace spine */
+#endif /* SPINE_POSEBUFFER_H_ */
@@ -0,0 +1,124 @@
+/*******************************************************************************
+ * Copyright (c) 2013, Esoteric Software
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ******************************************************************************/
+
+#ifndef SPINE_REFERENCEPOSE_H_
+#define SPINE_REFERENCEPOSE_H_
+
+#include <string>
+#include <vector>
+
+namespace spine {
+
+class SkeletonData;
+class Skin;
+class Attachment;
+class Animation;
+class BaseSkeleton;
+class SkeletonPose;
+class String;
+
+/** The largest differences between a skeleton and a ReferencePose. */
+class PoseDeviation {
+public:
+	/** The largest difference of a bone world position coordinate. */
+	double position;
+	/** The largest difference of a bone world transform matrix entry. */
+	double matrix;
+	/** The largest difference of a slot color channel. */
+	double color;
+	/** The number of slots with a different attachment. */
+	int attachments;
+	/** The bone with the largest position difference and the slot with the largest color difference, or -1. */
+	int bone, slot;
+
+	PoseDeviation ();
+
+	/** Keeps the larger of each difference and adds the attachment differences. */
+	void add (const PoseDeviation &deviation);
+
+	/** Returns true if any difference is larger than its epsilon or any attachment differs. */
+	bool exceeds (double positionEpsilon, double matrixEpsilon, double colorEpsilon) const;
+};
+
+/** Evaluates animations the plain way, in double precision, to check optimized evaluation against. It follows the rules of
+ * Timeline::apply and Bone::updateWorldTransform but shares no code with them: keyframes are found with a linear search and curves
+ * are evaluated from their bezier control points rather than by forward differencing. Like the runtime, a curve is linear between
+ * the points at 10 even steps of the bezier parameter.
+ *
+ * Supports the rotate, translate, scale, color and attachment timelines. Animations made of other timelines, such as a
+ * StreamingAnimation, can't be evaluated, but can be compared against the Animation they were made from. */
+class ReferencePose {
+public:
+	struct BonePose {
+		double x, y, rotation, scaleX, scaleY;
+		double m00, m01, worldX;
+		double m10, m11, worldY;
+		double worldRotation, worldScaleX, worldScaleY;
+	};
+
+	struct SlotPose {
+		double r, g, b, a;
+		/** May be null. */
+		const Attachment *attachment;
+	};
+
+	const SkeletonData *data;
+	/** In the same order as the skeleton data's bones and slots. */
+	std::vector<BonePose> bones;
+	std::vector<SlotPose> slots;
+	/** Attachments are found in this skin, or in the default skin if it is null, like BaseSkeleton::getAttachment. */
+	const Skin *skin;
+	bool flipX, flipY;
+
+	/** Starts in the bind pose. The data must outlive the pose. */
+	ReferencePose (const SkeletonData *data);
+
+	void setToBindPose ();
+
+	/** Applies the animation like Animation::apply with alpha 1, or like Animation::mix otherwise.
+	 * @throws std::invalid_argument If the animation has a timeline type that isn't supported. */
+	void apply (const Animation *animation, float time, bool loop, float alpha = 1);
+
+	void updateWorldTransform ();
+
+	/** Compares the skeleton's bone world transforms and slot colors and attachments to this pose. The skeleton must have the same
+	 * skeleton data. */
+	PoseDeviation compare (const BaseSkeleton *skeleton) const;
+	/** Compares a pose captured from a skeleton with the same skeleton data. */
+	PoseDeviation compare (const SkeletonPose &pose) const;
+
+private:
+	std::vector<int> parents;
+
+	/** @param name May be null. */
+	const Attachment* getAttachment (int slotIndex, const String *name) const;
+	void compareBone (PoseDeviation &deviation, int boneIndex, double m00, double m01, double worldX, double m10, double m11,
+			double worldY) const;
+	void compareSlot (PoseDeviation &deviation, int slotIndex, double r, double g, double b, double a,
+			const Attachment *attachment) const;
+};
+
+} /* namespace spine */
+#endif /* SPINE_REFERENCEPOSE_H_ */
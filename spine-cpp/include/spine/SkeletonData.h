@@ -28,6 +28,8 @@
 
 #include <string>
 #include <vector>
+#include <spine/Allocator.h>
+#include <spine/MemoryUsage.h>
 
 namespace spine {
 
@@ -35,14 +37,16 @@ class BoneData;
 class SlotData;
 class Skin;
 
-class SkeletonData {
+/** Not modified after loading. Skeletons only read it, so one SkeletonData may be shared by skeletons that are updated on
+ * different threads at the same time. */
+class SkeletonData: public Allocated<skeletonDataTag> {
 public:
 	/** The SkeletonData owns the bones. */
-	std::vector<BoneData*> bones;
+	std::vector<BoneData*, StlAllocator<BoneData*, skeletonDataTag> > bones;
 	/** The SkeletonData owns the slots. */
-	std::vector<SlotData*> slots;
+	std::vector<SlotData*, StlAllocator<SlotData*, skeletonDataTag> > slots;
 	/** The SkeletonData owns the skins. */
-	std::vector<Skin*> skins;
+	std::vector<Skin*, StlAllocator<Skin*, skeletonDataTag> > skins;
 	/** May be null. */
 	Skin *defaultSkin;
 
@@ -56,6 +60,9 @@ public:
 	int findSlotIndex (const std::string &slotName) const;
 
 	Skin* findSkin (const std::string &skinName) const;
+
+	/** Returns the bytes used by the bones, slots, skins and attachments. */
+	MemoryUsage memoryUsage () const;
 };
 
 } /* namespace spine */
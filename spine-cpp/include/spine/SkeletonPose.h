@@ -0,0 +1,87 @@
+/*******************************************************************************
+ * Copyright (c) 2013, Esoteric Software
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ******************************************************************************/
+
+#ifndef SPINE_SKELETONPOSE_H_
+#define SPINE_SKELETONPOSE_H_
+
+#include <vector>
+#include <utility>
+#include <spine/Allocator.h>
+
+namespace spine {
+
+class BaseSkeleton;
+class Attachment;
+class Bone;
+class Slot;
+
+/** A copy of what is needed to render a skeleton: the world transform of each bone and, in draw order, the bone, color and
+ * attachment of each slot. It holds no pointers into the skeleton, so it can be read on another thread while the skeleton is
+ * updated. */
+class SkeletonPose: public Allocated<skeletonTag> {
+public:
+	struct BonePose {
+		float m00, m01, worldX;
+		float m10, m11, worldY;
+	};
+
+	struct SlotPose {
+		/** Index into the skeleton's slots. */
+		int slotIndex;
+		/** Index into bones. */
+		int boneIndex;
+		float r, g, b, a;
+		/** May be null. Attachments belong to the skeleton data, so they stay valid as long as it does. */
+		const Attachment *attachment;
+	};
+
+	/** In the same order as the skeleton's bones. */
+	std::vector<BonePose, StlAllocator<BonePose, skeletonTag> > bones;
+	/** In the skeleton's draw order. */
+	std::vector<SlotPose, StlAllocator<SlotPose, skeletonTag> > drawOrder;
+	float r, g, b, a;
+
+	SkeletonPose ();
+
+	/** Copies the skeleton's pose. After the first capture of a skeleton, this does not allocate unless the skeleton changes. Throws
+	 * if a slot's bone isn't one of the skeleton's bones or a draw order slot isn't one of its slots. */
+	void capture (const BaseSkeleton *skeleton);
+
+private:
+	/** The skeleton and slots the indices below were built for. A skeleton at the address of a deleted one doesn't have the same
+	 * slots, so the slots are compared before the indices are reused. */
+	const BaseSkeleton *indexedSkeleton;
+	std::vector<const Slot*, StlAllocator<const Slot*, skeletonTag> > indexedSlots;
+	/** Slots sorted by address, to find the index of each draw order entry. */
+	std::vector<std::pair<const Slot*, int>, StlAllocator<std::pair<const Slot*, int>, skeletonTag> > slotIndices;
+	/** The index of each slot's bone, by slot index. */
+	std::vector<int, StlAllocator<int, skeletonTag> > slotBoneIndices;
+
+	bool isIndexed (const BaseSkeleton *skeleton) const;
+	void buildIndices (const BaseSkeleton *skeleton);
+};
+
+} /* namespace spine */
+#endif /* SPINE_SKELETONPOSE_H_ */
@@ -27,33 +27,38 @@
 #define SPINE_SKIN_H_
 
 #include <string>
-#include <map>
+#include <vector>
+#include <spine/Allocator.h>
+#include <spine/MemoryUsage.h>
 
 namespace spine {
 
 class BaseSkeleton;
 class Attachment;
 
-class Skin {
+/** Immutable once loaded, so it can be shared by skeletons that are updated on different threads. */
+class Skin: public Allocated<skeletonDataTag> {
 	friend class BaseSkeleton;
 
 private:
-	struct Key {
+	struct Entry {
 		int slotIndex;
-		std::string name;
-
-		friend bool operator< (const Key &key1, const Key &key2) {
-			if (key1.slotIndex == key2.slotIndex) return key1.name < key2.name;
-			return key1.slotIndex < key2.slotIndex;
-		}
+		String name;
+		Attachment *attachment;
 	};
-	std::map<Key, Attachment*> attachments;
+	/** Sorted by slot index, then name, so lookups are a binary search that compares with the name passed in and never copies
+	 * it. */
+	std::vector<Entry, StlAllocator<Entry, skeletonDataTag> > attachments;
+
+	/** Returns the index of the first entry that is not less than the slot index and name. */
+	int lowerBound (int slotIndex, const char *name, size_t length) const;
+	Attachment* getAttachment (int slotIndex, const char *name, size_t length) const;
 
 	/** Attach all attachments from this skin if the corresponding attachment from the old skin is currently attached. */
-	void attachAll (BaseSkeleton *skeleton, Skin *oldSkin);
+	void attachAll (BaseSkeleton *skeleton, const Skin *oldSkin) const;
 
 public:
-	std::string name;
+	String name;
 
 	Skin (const std::string &name);
 	~Skin ();
@@ -61,7 +66,11 @@ public:
 	/** The Skin owns the attachment. */
 	void addAttachment (int slotIndex, const std::string &name, Attachment *attachment);
 
-	Attachment* getAttachment (int slotIndex, const std::string &name);
+	Attachment* getAttachment (int slotIndex, const std::string &name) const;
+	Attachment* getAttachment (int slotIndex, const String &name) const;
+
+	/** Returns the bytes used by the skin, its attachment entries and its attachments. */
+	MemoryUsage memoryUsage () const;
 };
 
 } /* namespace spine */
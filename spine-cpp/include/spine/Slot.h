@@ -26,6 +26,8 @@
 #ifndef SPINE_SLOT_H_
 #define SPINE_SLOT_H_
 
+#include <spine/Allocator.h>
+
 namespace spine {
 
 class BaseSkeleton;
@@ -33,7 +35,7 @@ class SlotData;
 class Bone;
 class Attachment;
 
-class Slot {
+class Slot: public Allocated<skeletonTag> {
 	friend class BaseSkeleton;
 
 private:
@@ -42,13 +44,13 @@ private:
 	void setToBindPose (int slotIndex);
 
 public:
-	SlotData *data;
+	const SlotData *data;
 	BaseSkeleton *skeleton;
 	Bone *bone;
 	float r, g, b, a;
 	Attachment *attachment;
 
-	Slot (SlotData *data, BaseSkeleton *skeleton, Bone *bone);
+	Slot (const SlotData *data, BaseSkeleton *skeleton, Bone *bone);
 
 	/** @param attachment May be null. */
 	void setAttachment (Attachment *attachment);
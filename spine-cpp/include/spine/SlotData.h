@@ -27,17 +27,19 @@
 #define SPINE_SLOTDATA_H_
 
 #include <string>
+#include <spine/Allocator.h>
 
 namespace spine {
 
 class BoneData;
 
-class SlotData {
+class SlotData: public Allocated<skeletonDataTag> {
 public:
-	std::string name;
+	String name;
 	BoneData *boneData;
 	float r, g, b, a;
-	std::string *attachmentName;
+	/** May be null. Owned by the SlotData. */
+	String *attachmentName;
 
 	SlotData (const std::string &name, BoneData *boneData);
 	~SlotData ();
@@ -0,0 +1,92 @@
+/*******************************************************************************
+ * Copyright (c) 2013, Esoteric Software
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ******************************************************************************/
+
+#ifndef SPINE_STREAMINGANIMATION_H_
+#define SPINE_STREAMINGANIMATION_H_
+
+#include <string>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <spine/Animation.h>
+
+namespace spine {
+
+/** An animation whose keyframes are stored in fixed duration chunks in a file and only a sliding window of chunks is kept in
+ * memory. Each chunk holds, for every timeline, the keyframes within the chunk plus the keyframe before and after it, so applying
+ * a chunk gives exactly the same pose as applying the fully loaded animation.
+ *
+ * A StreamingAnimation can be used anywhere an Animation is. A chunk that is not resident when applied is decoded immediately, so
+ * seeking works at the cost of a stall. To avoid stalls, call prefetch ahead of playback, either each frame or from a worker
+ * thread. */
+class StreamingAnimation: public Animation {
+public:
+	/** Reads the chunk index from the file. Chunks are read when needed. Applying a chunk throws if its timelines refer to bones
+	 * or slots the skeleton doesn't have.
+	 * @param windowSize The maximum number of chunks kept in memory, at least 1. */
+	StreamingAnimation (const std::string &path, int windowSize = 3);
+	~StreamingAnimation ();
+
+	/** Decodes the chunks from the one containing time through the end of the window and frees the chunks outside it. May be
+	 * called from a different thread than the one applying the animation. */
+	void prefetch (float time, bool loop = false);
+
+	int getChunkCount () const;
+	float getChunkDuration () const;
+	int getResidentChunkCount () const;
+
+	/** Writes the animation in the chunked format.
+	 * @param chunkDuration The duration of each chunk, in seconds. */
+	static void write (std::ostream &output, const Animation &animation, float chunkDuration);
+
+private:
+	class ChunkTimeline;
+	friend class ChunkTimeline;
+
+	struct Chunk {
+		Animation *animation;
+		/** The number of bones and slots a skeleton needs for the chunk's timelines to be applied to it. */
+		int boneCount, slotCount;
+	};
+
+	std::string path;
+	int windowSize;
+	float chunkDuration;
+	std::vector<unsigned int> chunkOffsets; // One more than the number of chunks.
+	std::map<int, Chunk> chunks;
+	mutable std::mutex mutex;
+
+	StreamingAnimation (const StreamingAnimation&);
+	StreamingAnimation& operator= (const StreamingAnimation&);
+
+	int chunkIndex (float time) const;
+	Chunk readChunk (int index) const;
+	/** Must be called with the mutex held. */
+	void evictOutside (int first);
+	void applyChunk (BaseSkeleton *skeleton, float time, float alpha);
+};
+
+} /* namespace spine */
+#endif /* SPINE_STREAMINGANIMATION_H_ */
@@ -2,6 +2,8 @@
 #include <json/value.h>
 #include <utility>
 #include <cstdio>
+#include <cstdlib>
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 #include <iostream>
@@ -108,12 +110,14 @@ static std::string codePointToUTF8(unsigned int cp)
 
 Reader::Reader()
    : features_( Features::all() )
+   , arena_( 0 )
 {
 }
 
 
 Reader::Reader( const Features &features )
    : features_( features )
+   , arena_( 0 )
 {
 }
 
@@ -157,9 +161,33 @@ Reader::parse( const char *beginDoc, const char *endDoc,
       collectComments = false;
    }
 
+   collectComments_ = collectComments;
+   arena_ = 0;
+   return readDocument( beginDoc, endDoc, root );
+}
+
+
+bool 
+Reader::parse( const char *beginDoc, const char *endDoc, 
+               ValueArena &arena,
+               Value &root )
+{
+   collectComments_ = false;
+   arena_ = &arena;
+   arenaMembers_.clear();
+   arenaValues_.clear();
+   bool successful = readDocument( beginDoc, endDoc, root );
+   arena_ = 0;
+   return successful;
+}
+
+
+bool 
+Reader::readDocument( const char *beginDoc, const char *endDoc, 
+                      Value &root )
+{
    begin_ = beginDoc;
    end_ = endDoc;
-   collectComments_ = collectComments;
    current_ = begin_;
    lastValueEnd_ = 0;
    lastValue_ = 0;
@@ -481,7 +509,10 @@ Reader::readObject( Token &tokenStart )
 {
    Token tokenName;
    std::string name;
-   currentValue() = Value( objectValue );
+   Value::ArenaMember member;
+   size_t firstMember = arenaMembers_.size();
+   if ( !arena_ )
+      currentValue() = Value( objectValue );
    while ( readToken( tokenName ) )
    {
       bool initialTokenOk = true;
@@ -489,13 +520,18 @@ Reader::readObject( Token &tokenStart )
          initialTokenOk = readToken( tokenName );
       if  ( !initialTokenOk )
          break;
-      if ( tokenName.type_ == tokenObjectEnd  &&  name.empty() )  // empty object
+      if ( tokenName.type_ == tokenObjectEnd  &&  name.empty()  
+           &&  arenaMembers_.size() == firstMember )  // empty object
+      {
+         if ( arena_ )
+            endArenaObject( firstMember );
          return true;
+      }
       if ( tokenName.type_ != tokenString )
          break;
       
       name = "";
-      if ( !decodeString( tokenName, name ) )
+      if ( arena_ ? !decodeArenaMemberName( tokenName, member ) : !decodeString( tokenName, name ) )
          return recoverFromError( tokenObjectEnd );
 
       Token colon;
@@ -505,12 +541,14 @@ Reader::readObject( Token &tokenStart )
                                     colon, 
                                     tokenObjectEnd );
       }
-      Value &value = currentValue()[ name ];
+      Value &value = arena_ ? member.value_ : currentValue()[ name ];
       nodes_.push( &value );
       bool ok = readValue();
       nodes_.pop();
       if ( !ok ) // error already set
          return recoverFromError( tokenObjectEnd );
+      if ( arena_ )
+         arenaMembers_.push_back( member );
 
       Token comma;
       if ( !readToken( comma )
@@ -527,7 +565,11 @@ Reader::readObject( Token &tokenStart )
               finalizeTokenOk )
          finalizeTokenOk = readToken( comma );
       if ( comma.type_ == tokenObjectEnd )
+      {
+         if ( arena_ )
+            endArenaObject( firstMember );
          return true;
+      }
    }
    return addErrorAndRecover( "Missing '}' or object member name", 
                               tokenName, 
@@ -538,23 +580,30 @@ Reader::readObject( Token &tokenStart )
 bool 
 Reader::readArray( Token &tokenStart )
 {
-   currentValue() = Value( arrayValue );
+   size_t firstValue = arenaValues_.size();
+   if ( !arena_ )
+      currentValue() = Value( arrayValue );
    skipSpaces();
    if ( *current_ == ']' ) // empty array
    {
       Token endArray;
       readToken( endArray );
+      if ( arena_ )
+         endArenaArray( firstValue );
       return true;
    }
    int index = 0;
+   Value arenaValue;
    while ( true )
    {
-      Value &value = currentValue()[ index++ ];
+      Value &value = arena_ ? arenaValue : currentValue()[ index++ ];
       nodes_.push( &value );
       bool ok = readValue();
       nodes_.pop();
       if ( !ok ) // error already set
          return recoverFromError( tokenArrayEnd );
+      if ( arena_ )
+         arenaValues_.push_back( arenaValue );
 
       Token token;
       // Accept Comment after last item in the array.
@@ -574,10 +623,75 @@ Reader::readArray( Token &tokenStart )
       if ( token.type_ == tokenArrayEnd )
          break;
    }
+   if ( arena_ )
+      endArenaArray( firstValue );
+   return true;
+}
+
+
+bool 
+Reader::decodeArenaMemberName( Token &token, Value::ArenaMember &member )
+{
+   Location begin = token.start_ + 1; // skip '"'
+   Location end = token.end_ - 1;     // do not include '"'
+   if ( !memchr( begin, '\\', end - begin ) )
+   {
+      member.name_ = begin;
+      member.nameLength_ = Value::UInt( end - begin );
+      return true;
+   }
+   std::string decoded;
+   if ( !decodeString( token, decoded ) )
+      return false;
+   member.name_ = arena_->duplicate( decoded.data(), decoded.length() );
+   member.nameLength_ = Value::UInt( decoded.length() );
    return true;
 }
 
 
+bool 
+Reader::lessArenaMember( const Value::ArenaMember *member, 
+                         const Value::ArenaMember *other )
+{
+   int result = Value::compareMemberNames( member->name_, member->nameLength_, 
+                                           other->name_, other->nameLength_ );
+   // Members are stacked in document order, so equal names keep that order.
+   return result ? result < 0 : member < other;
+}
+
+
+void 
+Reader::endArenaObject( size_t firstMember )
+{
+   arenaOrder_.clear();
+   for ( size_t index = firstMember; index < arenaMembers_.size(); ++index )
+      arenaOrder_.push_back( &arenaMembers_[index] );
+   std::sort( arenaOrder_.begin(), arenaOrder_.end(), lessArenaMember );
+
+   // When a name is repeated the last member wins, like when reading into a map.
+   size_t size = 0;
+   for ( size_t index = 0; index < arenaOrder_.size(); ++index )
+   {
+      if ( index + 1 < arenaOrder_.size()  
+           &&  Value::compareMemberNames( arenaOrder_[index]->name_, arenaOrder_[index]->nameLength_, 
+                                          arenaOrder_[index + 1]->name_, arenaOrder_[index + 1]->nameLength_ ) == 0 )
+         continue;
+      arenaOrder_[size++] = arenaOrder_[index];
+   }
+   currentValue() = arena_->makeObject( size ? &arenaOrder_[0] : 0, Value::UInt( size ) );
+   arenaMembers_.erase( arenaMembers_.begin() + firstMember, arenaMembers_.end() );
+}
+
+
+void 
+Reader::endArenaArray( size_t firstValue )
+{
+   Value::UInt size = Value::UInt( arenaValues_.size() - firstValue );
+   currentValue() = arena_->makeArray( size ? &arenaValues_[firstValue] : 0, size );
+   arenaValues_.erase( arenaValues_.begin() + firstValue, arenaValues_.end() );
+}
+
+
 bool 
 Reader::decodeNumber( Token &token )
 {
@@ -623,17 +737,21 @@ Reader::decodeDouble( Token &token )
    const int bufferSize = 32;
    int count;
    int length = int(token.end_ - token.start_);
-   if ( length <= bufferSize )
+   // strtod() accepts the same numbers as sscanf( "%lf" ) without its stream setup.
+   char *parsedEnd;
+   if ( length < bufferSize )
    {
       Char buffer[bufferSize];
       memcpy( buffer, token.start_, length );
       buffer[length] = 0;
-      count = sscanf( buffer, "%lf", &value );
+      value = strtod( buffer, &parsedEnd );
+      count = parsedEnd != buffer;
    }
    else
    {
       std::string buffer( token.start_, token.end_ );
-      count = sscanf( buffer.c_str(), "%lf", &value );
+      value = strtod( buffer.c_str(), &parsedEnd );
+      count = parsedEnd != buffer.c_str();
    }
 
    if ( count != 1 )
@@ -646,10 +764,23 @@ Reader::decodeDouble( Token &token )
 bool 
 Reader::decodeString( Token &token )
 {
+   if ( arena_ )
+   {
+      Location begin = token.start_ + 1; // skip '"'
+      Location end = token.end_ - 1;     // do not include '"'
+      if ( !memchr( begin, '\\', end - begin ) )
+      {
+         currentValue() = arena_->makeString( begin, end - begin );
+         return true;
+      }
+   }
    std::string decoded;
    if ( !decodeString( token, decoded ) )
       return false;
-   currentValue() = decoded;
+   if ( arena_ )
+      currentValue() = arena_->makeString( decoded.data(), decoded.length() );
+   else
+      currentValue() = decoded;
    return true;
 }
 
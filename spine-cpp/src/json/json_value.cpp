@@ -5,6 +5,8 @@
 #include <stdexcept>
 #include <cstring>
 #include <cassert>
+#include <cstdlib>
+#include <new>
 #ifdef JSON_USE_CPPTL
 # include <cpptl/conststring.h>
 #endif
@@ -253,6 +255,171 @@ Value::CZString::isStaticString() const
 #endif // ifndef JSON_VALUE_USE_INTERNAL_MAP
 
 
+// //////////////////////////////////////////////////////////////////
+// //////////////////////////////////////////////////////////////////
+// //////////////////////////////////////////////////////////////////
+// class ValueArena
+// //////////////////////////////////////////////////////////////////
+// //////////////////////////////////////////////////////////////////
+// //////////////////////////////////////////////////////////////////
+
+static const size_t arenaAlignment = 8;
+static const size_t maxArenaBlockSize = 1024 * 1024;
+
+static inline size_t
+alignArenaSize( size_t size )
+{
+   return ( size + arenaAlignment - 1 ) & ~( arenaAlignment - 1 );
+}
+
+
+ValueArena::ValueArena( size_t blockSize )
+   : blocks_( 0 )
+   , current_( 0 )
+   , end_( 0 )
+   , firstBlockSize_( blockSize < 256 ? 256 : blockSize )
+   , blockSize_( firstBlockSize_ )
+   , allocatedBytes_( 0 )
+   , usedBytes_( 0 )
+{
+}
+
+
+ValueArena::~ValueArena()
+{
+   clear();
+}
+
+
+void 
+ValueArena::clear()
+{
+   while ( blocks_ )
+   {
+      Block *next = blocks_->next_;
+      free( blocks_ );
+      blocks_ = next;
+   }
+   current_ = 0;
+   end_ = 0;
+   blockSize_ = firstBlockSize_;
+   allocatedBytes_ = 0;
+   usedBytes_ = 0;
+}
+
+
+size_t 
+ValueArena::getAllocatedBytes() const
+{
+   return allocatedBytes_;
+}
+
+
+size_t 
+ValueArena::getUsedBytes() const
+{
+   return usedBytes_;
+}
+
+
+void *
+ValueArena::allocate( size_t size )
+{
+   size = alignArenaSize( size );
+   usedBytes_ += size;
+   if ( size <= size_t( end_ - current_ ) )
+   {
+      void *memory = current_;
+      current_ += size;
+      return memory;
+   }
+
+   const size_t headerSize = alignArenaSize( sizeof(Block) );
+   // Large requests get their own block so the rest of the current block is not wasted.
+   bool dedicated = size > blockSize_ / 4;
+   size_t blockSize = dedicated ? headerSize + size : blockSize_;
+   Block *block = static_cast<Block *>( malloc( blockSize ) );
+   JSON_ASSERT_MESSAGE( block != 0, "Failed to allocate ValueArena block" );
+   block->size_ = blockSize;
+   allocatedBytes_ += blockSize;
+   char *memory = reinterpret_cast<char *>( block ) + headerSize;
+   if ( dedicated  &&  blocks_ )
+   {
+      block->next_ = blocks_->next_;
+      blocks_->next_ = block;
+      return memory;
+   }
+   block->next_ = blocks_;
+   blocks_ = block;
+   current_ = memory + size;
+   end_ = reinterpret_cast<char *>( block ) + blockSize;
+   if ( blockSize_ < maxArenaBlockSize )
+      blockSize_ *= 2;
+   return memory;
+}
+
+
+char *
+ValueArena::duplicate( const char *begin, size_t length )
+{
+   char *string = static_cast<char *>( allocate( length + 1 ) );
+   memcpy( string, begin, length );
+   string[length] = 0;
+   return string;
+}
+
+
+Value 
+ValueArena::makeString( const char *begin, size_t length )
+{
+   Value value;
+   value.type_ = stringValue;
+   value.inArena_ = 1;
+   value.value_.string_ = duplicate( begin, length );
+   return value;
+}
+
+
+Value 
+ValueArena::makeArray( const Value *values, UInt size )
+{
+   const size_t headerSize = alignArenaSize( sizeof(Value::ArenaContainer) );
+   char *memory = static_cast<char *>( allocate( headerSize + sizeof(Value) * size ) );
+   Value::ArenaContainer *container = reinterpret_cast<Value::ArenaContainer *>( memory );
+   container->size_ = size;
+   container->members_ = 0;
+   container->values_ = reinterpret_cast<Value *>( memory + headerSize );
+   for ( UInt index = 0; index < size; ++index )
+      new ( container->values_ + index ) Value( values[index] );
+
+   Value value;
+   value.type_ = arrayValue;
+   value.inArena_ = 1;
+   value.value_.arena_ = container;
+   return value;
+}
+
+
+Value 
+ValueArena::makeObject( const Value::ArenaMember *const *members, UInt size )
+{
+   const size_t headerSize = alignArenaSize( sizeof(Value::ArenaContainer) );
+   char *memory = static_cast<char *>( allocate( headerSize + sizeof(Value::ArenaMember) * size ) );
+   Value::ArenaContainer *container = reinterpret_cast<Value::ArenaContainer *>( memory );
+   container->size_ = size;
+   container->members_ = reinterpret_cast<Value::ArenaMember *>( memory + headerSize );
+   container->values_ = 0;
+   for ( UInt index = 0; index < size; ++index )
+      new ( container->members_ + index ) Value::ArenaMember( *members[index] );
+
+   Value value;
+   value.type_ = objectValue;
+   value.inArena_ = 1;
+   value.value_.arena_ = container;
+   return value;
+}
+
+
 // //////////////////////////////////////////////////////////////////
 // //////////////////////////////////////////////////////////////////
 // //////////////////////////////////////////////////////////////////
@@ -268,6 +435,7 @@ Value::CZString::isStaticString() const
 Value::Value( ValueType type )
    : type_( type )
    , allocated_( 0 )
+   , inArena_( 0 )
    , comments_( 0 )
 # ifdef JSON_VALUE_USE_INTERNAL_MAP
    , itemIsUsed_( 0 )
@@ -311,6 +479,7 @@ Value::Value( ValueType type )
 
 Value::Value( Int value )
    : type_( intValue )
+   , inArena_( 0 )
    , comments_( 0 )
 # ifdef JSON_VALUE_USE_INTERNAL_MAP
    , itemIsUsed_( 0 )
@@ -322,6 +491,7 @@ Value::Value( Int value )
 
 Value::Value( UInt value )
    : type_( uintValue )
+   , inArena_( 0 )
    , comments_( 0 )
 # ifdef JSON_VALUE_USE_INTERNAL_MAP
    , itemIsUsed_( 0 )
@@ -332,6 +502,7 @@ Value::Value( UInt value )
 
 Value::Value( double value )
    : type_( realValue )
+   , inArena_( 0 )
    , comments_( 0 )
 # ifdef JSON_VALUE_USE_INTERNAL_MAP
    , itemIsUsed_( 0 )
@@ -343,6 +514,7 @@ Value::Value( double value )
 Value::Value( const char *value )
    : type_( stringValue )
    , allocated_( true )
+   , inArena_( 0 )
    , comments_( 0 )
 # ifdef JSON_VALUE_USE_INTERNAL_MAP
    , itemIsUsed_( 0 )
@@ -356,6 +528,7 @@ Value::Value( const char *beginValue,
               const char *endValue )
    : type_( stringValue )
    , allocated_( true )
+   , inArena_( 0 )
    , comments_( 0 )
 # ifdef JSON_VALUE_USE_INTERNAL_MAP
    , itemIsUsed_( 0 )
@@ -369,6 +542,7 @@ Value::Value( const char *beginValue,
 Value::Value( const std::string &value )
    : type_( stringValue )
    , allocated_( true )
+   , inArena_( 0 )
    , comments_( 0 )
 # ifdef JSON_VALUE_USE_INTERNAL_MAP
    , itemIsUsed_( 0 )
@@ -382,6 +556,7 @@ Value::Value( const std::string &value )
 Value::Value( const StaticString &value )
    : type_( stringValue )
    , allocated_( false )
+   , inArena_( 0 )
    , comments_( 0 )
 # ifdef JSON_VALUE_USE_INTERNAL_MAP
    , itemIsUsed_( 0 )
@@ -395,6 +570,7 @@ Value::Value( const StaticString &value )
 Value::Value( const CppTL::ConstString &value )
    : type_( stringValue )
    , allocated_( true )
+   , inArena_( 0 )
    , comments_( 0 )
 # ifdef JSON_VALUE_USE_INTERNAL_MAP
    , itemIsUsed_( 0 )
@@ -406,6 +582,7 @@ Value::Value( const CppTL::ConstString &value )
 
 Value::Value( bool value )
    : type_( booleanValue )
+   , inArena_( 0 )
    , comments_( 0 )
 # ifdef JSON_VALUE_USE_INTERNAL_MAP
    , itemIsUsed_( 0 )
@@ -417,12 +594,15 @@ Value::Value( bool value )
 
 Value::Value( const Value &other )
    : type_( other.type_ )
+   , allocated_( 0 )
+   , inArena_( other.inArena_ )
    , comments_( 0 )
 # ifdef JSON_VALUE_USE_INTERNAL_MAP
    , itemIsUsed_( 0 )
 #endif
 {
-   switch ( type_ )
+   // Strings, arrays and objects stored in an arena are shared, not copied.
+   switch ( inArena_ ? nullValue : type_ )
    {
    case nullValue:
    case intValue:
@@ -471,7 +651,7 @@ Value::Value( const Value &other )
 
 Value::~Value()
 {
-   switch ( type_ )
+   switch ( inArena_ ? nullValue : type_ )
    {
    case nullValue:
    case intValue:
@@ -522,6 +702,9 @@ Value::swap( Value &other )
    int temp2 = allocated_;
    allocated_ = other.allocated_;
    other.allocated_ = temp2;
+   unsigned int temp3 = inArena_;
+   inArena_ = other.inArena_;
+   other.inArena_ = temp3;
 }
 
 ValueType 
@@ -531,6 +714,78 @@ Value::type() const
 }
 
 
+int 
+Value::compareMemberNames( const char *name, UInt length,
+                           const char *other, UInt otherLength )
+{
+   int result = memcmp( name, other, length < otherLength ? length : otherLength );
+   if ( result )
+      return result;
+   return length < otherLength ? -1 : ( length > otherLength ? 1 : 0 );
+}
+
+
+const Value::ArenaMember *
+Value::findArenaMember( const char *key ) const
+{
+   UInt keyLength = UInt( strlen( key ) );
+   const ArenaMember *members = value_.arena_->members_;
+   UInt low = 0;
+   UInt high = value_.arena_->size_;
+   while ( low < high )
+   {
+      UInt middle = ( low + high ) / 2;
+      int result = compareMemberNames( members[middle].name_, members[middle].nameLength_, key, keyLength );
+      if ( result == 0 )
+         return members + middle;
+      if ( result < 0 )
+         low = middle + 1;
+      else
+         high = middle;
+   }
+   return 0;
+}
+
+
+/// Compares arrays or objects of the same type member by member, for containers
+/// stored in a ValueArena that can not use the ObjectValues comparisons.
+static int 
+compareContainers( const Value &value, const Value &other )
+{
+   int delta = int( value.size() ) - int( other.size() );
+   if ( delta )
+      return delta;
+   Value::const_iterator it = value.begin();
+   Value::const_iterator itEnd = value.end();
+   Value::const_iterator otherIt = other.begin();
+   Value::const_iterator otherItEnd = other.end();
+   for ( ; it != itEnd  &&  otherIt != otherItEnd; ++it, ++otherIt )
+   {
+      if ( value.type() == arrayValue )
+      {
+         if ( it.index() != otherIt.index() )
+            return it.index() < otherIt.index() ? -1 : 1;
+      }
+      else
+      {
+         Value key = it.key();
+         Value otherKey = otherIt.key();
+         if ( key < otherKey )
+            return -1;
+         if ( otherKey < key )
+            return 1;
+      }
+      if ( *it < *otherIt )
+         return -1;
+      if ( *otherIt < *it )
+         return 1;
+   }
+   if ( it != itEnd )
+      return 1;
+   return otherIt != otherItEnd ? -1 : 0;
+}
+
+
 int 
 Value::compare( const Value &other )
 {
@@ -567,6 +822,8 @@ Value::operator <( const Value &other ) const
    int typeDelta = type_ - other.type_;
    if ( typeDelta )
       return typeDelta < 0 ? true : false;
+   if ( isArenaContainer()  ||  other.isArenaContainer() )
+      return compareContainers( *this, other ) < 0;
    switch ( type_ )
    {
    case nullValue:
@@ -633,6 +890,8 @@ Value::operator ==( const Value &other ) const
    int temp = other.type_;
    if ( type_ != temp )
       return false;
+   if ( isArenaContainer()  ||  other.isArenaContainer() )
+      return compareContainers( *this, other ) == 0;
    switch ( type_ )
    {
    case nullValue:
@@ -809,7 +1068,7 @@ Value::asBool() const
       return value_.string_  &&  value_.string_[0] != 0;
    case arrayValue:
    case objectValue:
-      return value_.map_->size() != 0;
+      return size() != 0;
    default:
       JSON_ASSERT_UNREACHABLE;
    }
@@ -857,10 +1116,10 @@ Value::isConvertibleTo( ValueType other ) const
              || ( other == nullValue  &&  (!value_.string_  ||  value_.string_[0] == 0) );
    case arrayValue:
       return other == arrayValue
-             ||  ( other == nullValue  &&  value_.map_->size() == 0 );
+             ||  ( other == nullValue  &&  size() == 0 );
    case objectValue:
       return other == objectValue
-             ||  ( other == nullValue  &&  value_.map_->size() == 0 );
+             ||  ( other == nullValue  &&  size() == 0 );
    default:
       JSON_ASSERT_UNREACHABLE;
    }
@@ -881,6 +1140,13 @@ Value::size() const
    case booleanValue:
    case stringValue:
       return 0;
+   default:
+      break;
+   }
+   if ( inArena_ )
+      return value_.arena_->size_;
+   switch ( type_ )
+   {
 #ifndef JSON_VALUE_USE_INTERNAL_MAP
    case arrayValue:  // size of the array is highest index + 1
       if ( !value_.map_->empty() )
@@ -926,6 +1192,7 @@ void
 Value::clear()
 {
    JSON_ASSERT( type_ == nullValue  ||  type_ == arrayValue  || type_ == objectValue );
+   JSON_ASSERT_MESSAGE( !isArenaContainer(), "Value::clear(): values stored in a ValueArena are read-only" );
 
    switch ( type_ )
    {
@@ -951,6 +1218,7 @@ void
 Value::resize( UInt newSize )
 {
    JSON_ASSERT( type_ == nullValue  ||  type_ == arrayValue );
+   JSON_ASSERT_MESSAGE( !isArenaContainer(), "Value::resize(): values stored in a ValueArena are read-only" );
    if ( type_ == nullValue )
       *this = Value( arrayValue );
 #ifndef JSON_VALUE_USE_INTERNAL_MAP
@@ -975,6 +1243,11 @@ Value &
 Value::operator[]( UInt index )
 {
    JSON_ASSERT( type_ == nullValue  ||  type_ == arrayValue );
+   if ( isArenaContainer() )
+   {
+      JSON_ASSERT_MESSAGE( index < value_.arena_->size_, "Value::operator[](): values stored in a ValueArena are read-only" );
+      return value_.arena_->values_[index];
+   }
    if ( type_ == nullValue )
       *this = Value( arrayValue );
 #ifndef JSON_VALUE_USE_INTERNAL_MAP
@@ -998,6 +1271,8 @@ Value::operator[]( UInt index ) const
    JSON_ASSERT( type_ == nullValue  ||  type_ == arrayValue );
    if ( type_ == nullValue )
       return null;
+   if ( isArenaContainer() )
+      return index < value_.arena_->size_ ? value_.arena_->values_[index] : null;
 #ifndef JSON_VALUE_USE_INTERNAL_MAP
    CZString key( index );
    ObjectValues::const_iterator it = value_.map_->find( key );
@@ -1023,6 +1298,12 @@ Value::resolveReference( const char *key,
                          bool isStatic )
 {
    JSON_ASSERT( type_ == nullValue  ||  type_ == objectValue );
+   if ( isArenaContainer() )
+   {
+      const ArenaMember *member = findArenaMember( key );
+      JSON_ASSERT_MESSAGE( member, "Value::resolveReference(): values stored in a ValueArena are read-only" );
+      return const_cast<Value &>( member->value_ );
+   }
    if ( type_ == nullValue )
       *this = Value( objectValue );
 #ifndef JSON_VALUE_USE_INTERNAL_MAP
@@ -1065,6 +1346,11 @@ Value::operator[]( const char *key ) const
    JSON_ASSERT( type_ == nullValue  ||  type_ == objectValue );
    if ( type_ == nullValue )
       return null;
+   if ( isArenaContainer() )
+   {
+      const ArenaMember *member = findArenaMember( key );
+      return member ? member->value_ : null;
+   }
 #ifndef JSON_VALUE_USE_INTERNAL_MAP
    CZString actualKey( key, CZString::noDuplication );
    ObjectValues::const_iterator it = value_.map_->find( actualKey );
@@ -1141,6 +1427,7 @@ Value
 Value::removeMember( const char* key )
 {
    JSON_ASSERT( type_ == nullValue  ||  type_ == objectValue );
+   JSON_ASSERT_MESSAGE( !isArenaContainer(), "Value::removeMember(): values stored in a ValueArena are read-only" );
    if ( type_ == nullValue )
       return null;
 #ifndef JSON_VALUE_USE_INTERNAL_MAP
@@ -1208,7 +1495,16 @@ Value::getMemberNames() const
    if ( type_ == nullValue )
        return Value::Members();
    Members members;
-   members.reserve( value_.map_->size() );
+   members.reserve( size() );
+   if ( isArenaContainer() )
+   {
+      for ( UInt index = 0; index < value_.arena_->size_; ++index )
+      {
+         const ArenaMember &member = value_.arena_->members_[index];
+         members.push_back( std::string( member.name_, member.nameLength_ ) );
+      }
+      return members;
+   }
 #ifndef JSON_VALUE_USE_INTERNAL_MAP
    ObjectValues::const_iterator it = value_.map_->begin();
    ObjectValues::const_iterator itEnd = value_.map_->end();
@@ -1367,6 +1663,8 @@ Value::toStyledString() const
 Value::const_iterator 
 Value::begin() const
 {
+   if ( isArenaContainer() )
+      return const_iterator( value_.arena_, 0 );
    switch ( type_ )
    {
 #ifdef JSON_VALUE_USE_INTERNAL_MAP
@@ -1402,6 +1700,8 @@ Value::begin() const
 Value::const_iterator 
 Value::end() const
 {
+   if ( isArenaContainer() )
+      return const_iterator( value_.arena_, value_.arena_->size_ );
    switch ( type_ )
    {
 #ifdef JSON_VALUE_USE_INTERNAL_MAP
@@ -1438,6 +1738,8 @@ Value::end() const
 Value::iterator 
 Value::begin()
 {
+   if ( isArenaContainer() )
+      return iterator( value_.arena_, 0 );
    switch ( type_ )
    {
 #ifdef JSON_VALUE_USE_INTERNAL_MAP
@@ -1473,6 +1775,8 @@ Value::begin()
 Value::iterator 
 Value::end()
 {
+   if ( isArenaContainer() )
+      return iterator( value_.arena_, value_.arena_->size_ );
    switch ( type_ )
    {
 #ifdef JSON_VALUE_USE_INTERNAL_MAP
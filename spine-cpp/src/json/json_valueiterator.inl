@@ -14,11 +14,15 @@ ValueIteratorBase::ValueIteratorBase()
 #ifndef JSON_VALUE_USE_INTERNAL_MAP
    : current_()
    , isNull_( true )
+   , arena_( 0 )
+   , arenaIndex_( 0 )
 {
 }
 #else
    : isArray_( true )
    , isNull_( true )
+   , arena_( 0 )
+   , arenaIndex_( 0 )
 {
    iterator_.array_ = ValueInternalArray::IteratorState();
 }
@@ -29,11 +33,15 @@ ValueIteratorBase::ValueIteratorBase()
 ValueIteratorBase::ValueIteratorBase( const Value::ObjectValues::iterator &current )
    : current_( current )
    , isNull_( false )
+   , arena_( 0 )
+   , arenaIndex_( 0 )
 {
 }
 #else
 ValueIteratorBase::ValueIteratorBase( const ValueInternalArray::IteratorState &state )
    : isArray_( true )
+   , arena_( 0 )
+   , arenaIndex_( 0 )
 {
    iterator_.array_ = state;
 }
@@ -41,14 +49,36 @@ ValueIteratorBase::ValueIteratorBase( const ValueInternalArray::IteratorState &s
 
 ValueIteratorBase::ValueIteratorBase( const ValueInternalMap::IteratorState &state )
    : isArray_( false )
+   , arena_( 0 )
+   , arenaIndex_( 0 )
 {
    iterator_.map_ = state;
 }
 #endif
 
+
+ValueIteratorBase::ValueIteratorBase( Value::ArenaContainer *arena, UInt index )
+#ifndef JSON_VALUE_USE_INTERNAL_MAP
+   : current_()
+   , isNull_( false )
+#else
+   : isArray_( true )
+#endif
+   , arena_( arena )
+   , arenaIndex_( index )
+{
+}
+
+
 Value &
 ValueIteratorBase::deref() const
 {
+   if ( arena_ )
+   {
+      if ( arena_->members_ )
+         return arena_->members_[arenaIndex_].value_;
+      return arena_->values_[arenaIndex_];
+   }
 #ifndef JSON_VALUE_USE_INTERNAL_MAP
    return current_->second;
 #else
@@ -62,6 +92,11 @@ ValueIteratorBase::deref() const
 void 
 ValueIteratorBase::increment()
 {
+   if ( arena_ )
+   {
+      ++arenaIndex_;
+      return;
+   }
 #ifndef JSON_VALUE_USE_INTERNAL_MAP
    ++current_;
 #else
@@ -75,6 +110,11 @@ ValueIteratorBase::increment()
 void 
 ValueIteratorBase::decrement()
 {
+   if ( arena_ )
+   {
+      --arenaIndex_;
+      return;
+   }
 #ifndef JSON_VALUE_USE_INTERNAL_MAP
    --current_;
 #else
@@ -88,6 +128,8 @@ ValueIteratorBase::decrement()
 ValueIteratorBase::difference_type 
 ValueIteratorBase::computeDistance( const SelfType &other ) const
 {
+   if ( arena_ )
+      return difference_type( other.arenaIndex_ ) - difference_type( arenaIndex_ );
 #ifndef JSON_VALUE_USE_INTERNAL_MAP
 # ifdef JSON_USE_CPPTL_SMALLMAP
    return current_ - other.current_;
@@ -125,6 +167,8 @@ ValueIteratorBase::computeDistance( const SelfType &other ) const
 bool 
 ValueIteratorBase::isEqual( const SelfType &other ) const
 {
+   if ( arena_  ||  other.arena_ )
+      return arena_ == other.arena_  &&  arenaIndex_ == other.arenaIndex_;
 #ifndef JSON_VALUE_USE_INTERNAL_MAP
    if ( isNull_ )
    {
@@ -142,6 +186,8 @@ ValueIteratorBase::isEqual( const SelfType &other ) const
 void 
 ValueIteratorBase::copy( const SelfType &other )
 {
+   arena_ = other.arena_;
+   arenaIndex_ = other.arenaIndex_;
 #ifndef JSON_VALUE_USE_INTERNAL_MAP
    current_ = other.current_;
 #else
@@ -155,6 +201,15 @@ ValueIteratorBase::copy( const SelfType &other )
 Value 
 ValueIteratorBase::key() const
 {
+   if ( arena_ )
+   {
+      if ( arena_->members_ )
+      {
+         const Value::ArenaMember &member = arena_->members_[arenaIndex_];
+         return Value( member.name_, member.name_ + member.nameLength_ );
+      }
+      return Value( arenaIndex_ );
+   }
 #ifndef JSON_VALUE_USE_INTERNAL_MAP
    const Value::CZString czstring = (*current_).first;
    if ( czstring.c_str() )
@@ -179,6 +234,8 @@ ValueIteratorBase::key() const
 UInt 
 ValueIteratorBase::index() const
 {
+   if ( arena_ )
+      return arena_->members_ ? Value::UInt( -1 ) : arenaIndex_;
 #ifndef JSON_VALUE_USE_INTERNAL_MAP
    const Value::CZString czstring = (*current_).first;
    if ( !czstring.c_str() )
@@ -195,6 +252,10 @@ ValueIteratorBase::index() const
 const char *
 ValueIteratorBase::memberName() const
 {
+   // Names of members stored in a ValueArena are not null terminated.
+   JSON_ASSERT_MESSAGE( !arena_  ||  !arena_->members_, "ValueIteratorBase::memberName(): use key() for values stored in a ValueArena" );
+   if ( arena_ )
+      return "";
 #ifndef JSON_VALUE_USE_INTERNAL_MAP
    const char *name = (*current_).first.c_str();
    return name ? name : "";
@@ -236,6 +297,11 @@ ValueConstIterator::ValueConstIterator( const ValueInternalMap::IteratorState &s
 }
 #endif
 
+ValueConstIterator::ValueConstIterator( Value::ArenaContainer *arena, UInt index )
+   : ValueIteratorBase( arena, index )
+{
+}
+
 ValueConstIterator &
 ValueConstIterator::operator =( const ValueIteratorBase &other )
 {
@@ -274,6 +340,11 @@ ValueIterator::ValueIterator( const ValueInternalMap::IteratorState &state )
 }
 #endif
 
+ValueIterator::ValueIterator( Value::ArenaContainer *arena, UInt index )
+   : ValueIteratorBase( arena, index )
+{
+}
+
 ValueIterator::ValueIterator( const ValueConstIterator &other )
    : ValueIteratorBase( other )
 {
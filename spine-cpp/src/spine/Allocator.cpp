@@ -0,0 +1,200 @@
+/*******************************************************************************
+ * Copyright (c) 2013, Esoteric Software
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ******************************************************************************/
+
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <spine/Allocator.h>
+
+#if __cplusplus >= 201103L
+#include <atomic>
+#define SPINE_THREAD_LOCAL thread_local
+typedef std::atomic<size_t> Counter;
+#else
+// Without C++11 scopes are global and counters are not thread safe.
+#define SPINE_THREAD_LOCAL
+typedef size_t Counter;
+#endif
+
+using std::string;
+
+namespace spine {
+
+/** Stored before each allocation so it can be freed by the allocator it came from and counted against its tag. */
+struct AllocationHeader {
+	Allocator *allocator;
+	unsigned int size;
+	unsigned int tag;
+};
+
+/** Keeps the memory after the header 16 byte aligned. */
+static const size_t HEADER_SIZE = (sizeof(AllocationHeader) + 15) & ~(size_t)15;
+
+static Allocator *defaultAllocator = 0;
+static SPINE_THREAD_LOCAL Allocator *scopeAllocator = 0;
+static SPINE_THREAD_LOCAL bool scopeSet = false;
+
+static SPINE_THREAD_LOCAL AllocationAudit *currentAudit = 0;
+
+static Counter allocatedBytes[allocationTagCount];
+static Counter allocationCounts[allocationTagCount];
+
+void setDefaultAllocator (Allocator *allocator) {
+	defaultAllocator = allocator;
+}
+
+Allocator* getAllocator () {
+	return scopeSet ? scopeAllocator : defaultAllocator;
+}
+
+AllocatorScope::AllocatorScope (Allocator *allocator) :
+				previous(scopeAllocator),
+				previousSet(scopeSet) {
+	scopeAllocator = allocator;
+	scopeSet = true;
+}
+
+AllocatorScope::~AllocatorScope () {
+	scopeAllocator = previous;
+	scopeSet = previousSet;
+}
+
+void* allocate (size_t size, AllocationTag tag) {
+	if (size > (unsigned int)-1 - HEADER_SIZE) throw std::bad_alloc();
+	Allocator *allocator = getAllocator();
+	size_t total = HEADER_SIZE + size;
+	char *memory = static_cast<char*>(allocator ? allocator->allocate(total, tag) : malloc(total));
+	if (!memory) throw std::bad_alloc();
+
+	AllocationHeader *header = reinterpret_cast<AllocationHeader*>(memory);
+	header->allocator = allocator;
+	header->size = (unsigned int)size;
+	header->tag = tag;
+	allocatedBytes[tag] += size;
+	allocationCounts[tag] += 1;
+	recordAllocation(total);
+	return memory + HEADER_SIZE;
+}
+
+void deallocate (void *memory) {
+	if (!memory) return;
+	char *start = static_cast<char*>(memory) - HEADER_SIZE;
+	AllocationHeader *header = reinterpret_cast<AllocationHeader*>(start);
+	AllocationTag tag = static_cast<AllocationTag>(header->tag);
+	allocatedBytes[tag] -= header->size;
+	if (header->allocator)
+		header->allocator->deallocate(start, HEADER_SIZE + header->size, tag);
+	else
+		free(start);
+}
+
+size_t getAllocatedBytes (AllocationTag tag) {
+	return allocatedBytes[tag];
+}
+
+size_t getAllocationCount (AllocationTag tag) {
+	return allocationCounts[tag];
+}
+
+AllocationAudit::AllocationAudit () :
+				phaseCount(1),
+				current(0) {
+	if (currentAudit) throw std::logic_error("The thread already has an AllocationAudit.");
+	phases[0].name = "";
+	phases[0].count = 0;
+	phases[0].bytes = 0;
+	currentAudit = this;
+}
+
+AllocationAudit::~AllocationAudit () {
+	currentAudit = 0;
+}
+
+const AllocationAudit::Phase* AllocationAudit::findPhase (const char *name) const {
+	for (int i = 0; i < phaseCount; i++)
+		if (phases[i].name == name || strcmp(phases[i].name, name) == 0) return &phases[i];
+	return 0;
+}
+
+void AllocationAudit::setPhase (const char *name) {
+	const Phase *phase = findPhase(name);
+	if (phase) {
+		current = phase - phases;
+		return;
+	}
+	if (phaseCount == MAX_PHASES) throw std::length_error("An AllocationAudit can't have more phases.");
+	current = phaseCount++;
+	phases[current].name = name;
+	phases[current].count = 0;
+	phases[current].bytes = 0;
+}
+
+size_t AllocationAudit::getAllocationCount (const char *phase) const {
+	const Phase *found = findPhase(phase);
+	return found ? found->count : 0;
+}
+
+size_t AllocationAudit::getAllocatedBytes (const char *phase) const {
+	const Phase *found = findPhase(phase);
+	return found ? found->bytes : 0;
+}
+
+size_t AllocationAudit::getAllocationCount () const {
+	size_t count = 0;
+	for (int i = 0; i < phaseCount; i++)
+		count += phases[i].count;
+	return count;
+}
+
+void AllocationAudit::reset () {
+	for (int i = 0; i < phaseCount; i++) {
+		phases[i].count = 0;
+		phases[i].bytes = 0;
+	}
+}
+
+void AllocationAudit::write (std::ostream &output) const {
+	// Counting is paused, so writing to a stream that allocates isn't counted.
+	AllocationAudit *audit = currentAudit;
+	currentAudit = 0;
+	output << '{';
+	for (int i = 0; i < phaseCount; i++) {
+		if (i) output << ',';
+		output << '"' << phases[i].name << "\":{\"allocations\":" << phases[i].count << ",\"bytes\":" << phases[i].bytes << '}';
+	}
+	output << '}';
+	currentAudit = audit;
+}
+
+void AllocationAudit::record (size_t size) {
+	phases[current].count++;
+	phases[current].bytes += size;
+}
+
+void recordAllocation (size_t size) {
+	if (currentAudit) currentAudit->record(size);
+}
+
+} /* namespace spine */
@@ -32,6 +32,7 @@
 #include <spine/Slot.h>
 #include <spine/BaseSkeleton.h>
 #include <spine/BoneData.h>
+#include <spine/Instrumentation.h>
 
 using std::string;
 using std::vector;
@@ -39,7 +40,7 @@ using std::vector;
 namespace spine {
 
 Animation::Animation (const vector<Timeline*> &timelines, float duration) :
-				timelines(timelines),
+				timelines(timelines.begin(), timelines.end()),
 				duration(duration) {
 }
 
@@ -49,6 +50,8 @@ Animation::~Animation () {
 }
 
 void Animation::apply (BaseSkeleton *skeleton, float time, bool loop) const {
+	SPINE_SCOPE("Animation::apply");
+	SPINE_COUNT(timelinesApplied, timelines.size());
 	if (loop && duration) time = fmodf(time, duration);
 
 	for (int i = 0, n = timelines.size(); i < n; i++)
@@ -56,12 +59,29 @@ void Animation::apply (BaseSkeleton *skeleton, float time, bool loop) const {
 }
 
 void Animation::mix (BaseSkeleton *skeleton, float time, bool loop, float alpha) const {
+	SPINE_SCOPE("Animation::mix");
+	SPINE_COUNT(timelinesApplied, timelines.size());
 	if (loop && duration) time = fmodf(time, duration);
 
 	for (int i = 0, n = timelines.size(); i < n; i++)
 		timelines[i]->apply(skeleton, time, alpha);
 }
 
+MemoryUsage Animation::memoryUsage () const {
+	MemoryUsage usage;
+	usage.add(objectMemory, sizeof(Animation));
+	usage.add(arrayMemory, timelines.capacity() * sizeof(Timeline*));
+	for (int i = 0, n = timelines.size(); i < n; i++)
+		timelines[i]->addMemoryUsage(usage);
+	return usage;
+}
+
+//
+
+void Timeline::addMemoryUsage (MemoryUsage &usage) const {
+	usage.add(objectMemory, sizeof(Timeline));
+}
+
 //
 
 static const float LINEAR = 0;
@@ -69,12 +89,12 @@ static const float STEPPED = -1;
 static const int BEZIER_SEGMENTS = 10;
 
 CurveTimeline::CurveTimeline (int keyframeCount) :
-				curves(new float[(keyframeCount - 1) * 6]) {
+				curves(static_cast<float*>(allocate(sizeof(float) * (keyframeCount - 1) * 6, animationTag))) {
 	memset(curves, 0, sizeof(float) * (keyframeCount - 1) * 6);
 }
 
 CurveTimeline::~CurveTimeline () {
-	delete[] curves;
+	deallocate(curves);
 }
 
 void CurveTimeline::setLinear (int keyframeIndex) {
@@ -171,13 +191,19 @@ static const int ROTATE_FRAME_VALUE = 1;
 RotateTimeline::RotateTimeline (int keyframeCount) :
 				CurveTimeline(keyframeCount),
 				framesLength(keyframeCount * 2),
-				frames(new float[framesLength]),
+				frames(static_cast<float*>(allocate(sizeof(float) * framesLength, animationTag))),
 				boneIndex(0) {
 	memset(frames, 0, sizeof(float) * framesLength);
 }
 
 RotateTimeline::~RotateTimeline () {
-	delete[] frames;
+	deallocate(frames);
+}
+
+void RotateTimeline::addMemoryUsage (MemoryUsage &usage) const {
+	usage.add(objectMemory, sizeof(RotateTimeline));
+	usage.add(keyframeMemory, sizeof(float) * framesLength);
+	usage.add(curveMemory, sizeof(float) * (framesLength / 2 - 1) * 6);
 }
 
 void RotateTimeline::setKeyframe (int keyframeIndex, float time, float value) {
@@ -234,13 +260,19 @@ static const int TRANSLATE_FRAME_Y = 2;
 TranslateTimeline::TranslateTimeline (int keyframeCount) :
 				CurveTimeline(keyframeCount),
 				framesLength(keyframeCount * 3),
-				frames(new float[framesLength]),
+				frames(static_cast<float*>(allocate(sizeof(float) * framesLength, animationTag))),
 				boneIndex(0) {
 	memset(frames, 0, sizeof(float) * framesLength);
 }
 
 TranslateTimeline::~TranslateTimeline () {
-	delete[] frames;
+	deallocate(frames);
+}
+
+void TranslateTimeline::addMemoryUsage (MemoryUsage &usage) const {
+	usage.add(objectMemory, sizeof(TranslateTimeline));
+	usage.add(keyframeMemory, sizeof(float) * framesLength);
+	usage.add(curveMemory, sizeof(float) * (framesLength / 3 - 1) * 6);
 }
 
 void TranslateTimeline::setKeyframe (int keyframeIndex, float time, float x, float y) {
@@ -322,13 +354,19 @@ static const int COLOR_FRAME_A = 4;
 ColorTimeline::ColorTimeline (int keyframeCount) :
 				CurveTimeline(keyframeCount),
 				framesLength(keyframeCount * 5),
-				frames(new float[framesLength]),
+				frames(static_cast<float*>(allocate(sizeof(float) * framesLength, animationTag))),
 				slotIndex(0) {
 	memset(frames, 0, sizeof(float) * framesLength);
 }
 
 ColorTimeline::~ColorTimeline () {
-	delete[] frames;
+	deallocate(frames);
+}
+
+void ColorTimeline::addMemoryUsage (MemoryUsage &usage) const {
+	usage.add(objectMemory, sizeof(ColorTimeline));
+	usage.add(keyframeMemory, sizeof(float) * framesLength);
+	usage.add(curveMemory, sizeof(float) * (framesLength / 5 - 1) * 6);
 }
 
 void ColorTimeline::setKeyframe (int keyframeIndex, float time, float r, float g, float b, float a) {
@@ -389,24 +427,32 @@ void ColorTimeline::apply (BaseSkeleton *skeleton, float time, float alpha) cons
 
 AttachmentTimeline::AttachmentTimeline (int keyframeCount) :
 				framesLength(keyframeCount),
-				frames(new float[keyframeCount]),
-				attachmentNames(new string*[keyframeCount]),
+				frames(static_cast<float*>(allocate(sizeof(float) * keyframeCount, animationTag))),
+				attachmentNames(static_cast<String**>(allocate(sizeof(String*) * keyframeCount, animationTag))),
 				slotIndex(0) {
 	memset(frames, 0, sizeof(float) * keyframeCount);
-	memset(attachmentNames, 0, sizeof(string*) * keyframeCount);
+	memset(attachmentNames, 0, sizeof(String*) * keyframeCount);
 }
 
 AttachmentTimeline::~AttachmentTimeline () {
-	delete[] frames;
+	deallocate(frames);
+
+	for (int i = 0; i < framesLength; i++)
+		delete attachmentNames[i];
+	deallocate(attachmentNames);
+}
 
+void AttachmentTimeline::addMemoryUsage (MemoryUsage &usage) const {
+	usage.add(objectMemory, sizeof(AttachmentTimeline));
+	usage.add(keyframeMemory, sizeof(float) * framesLength);
+	usage.add(arrayMemory, sizeof(String*) * framesLength);
 	for (int i = 0; i < framesLength; i++)
-		if (attachmentNames[i]) delete attachmentNames[i];
-	delete[] attachmentNames;
+		usage.addString(attachmentNames[i]);
 }
 
-void AttachmentTimeline::setKeyframe (int keyframeIndex, float time, string *attachmentName) {
+void AttachmentTimeline::setKeyframe (int keyframeIndex, float time, String *attachmentName) {
 	frames[keyframeIndex] = time;
-	if (attachmentNames[keyframeIndex]) delete attachmentNames[keyframeIndex];
+	delete attachmentNames[keyframeIndex];
 	attachmentNames[keyframeIndex] = attachmentName;
 }
 
@@ -419,7 +465,7 @@ void AttachmentTimeline::apply (BaseSkeleton *skeleton, float time, float alpha)
 	else
 		frameIndex = binarySearch(frames, framesLength, time, 1) - 1;
 
-	string *attachmentName = attachmentNames[frameIndex];
+	const String *attachmentName = attachmentNames[frameIndex];
 	skeleton->slots[slotIndex]->setAttachment(attachmentName ? skeleton->getAttachment(slotIndex, *attachmentName) : 0);
 }
 
@@ -0,0 +1,265 @@
+/*******************************************************************************
+ * Copyright (c) 2013, Esoteric Software
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ******************************************************************************/
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <spine/AnimationBundle.h>
+#include <spine/BaseSkeletonJson.h>
+#include <spine/Animation.h>
+#include <spine/ByteOrder.h>
+
+using std::string;
+using std::vector;
+using std::runtime_error;
+using std::invalid_argument;
+
+namespace spine {
+
+/* Bundle format. All fields are 4 bytes and little endian:
+ *
+ * BundleHeader
+ * BundleEntry[count]
+ * char names[] -- referenced by BundleEntry, not NUL terminated
+ * char data[] -- the animation JSON, referenced by BundleEntry with offsets from the start of the bundle */
+
+static const char BUNDLE_MAGIC[4] = {'\x89', 'S', 'P', 'B'};
+static const unsigned int BUNDLE_VERSION = 1;
+
+struct BundleHeader {
+	char magic[4];
+	unsigned int version;
+	unsigned int count;
+	/** Size of the entries and names following the header. */
+	unsigned int indexSize;
+};
+
+struct BundleEntry {
+	unsigned int nameOffset, nameLength;
+	unsigned int offset, length;
+};
+
+AnimationBundle::AnimationBundle (const string &path, const BaseSkeletonJson *json, const SkeletonData *skeletonData) :
+				path(path),
+				data(0),
+				json(json),
+				skeletonData(skeletonData),
+				decodedBytes(0),
+				useCount(0) {
+	if (!json) throw invalid_argument("json cannot be null.");
+	if (!skeletonData) throw invalid_argument("skeletonData cannot be null.");
+
+	std::ifstream file(path.c_str(), std::ios::in | std::ios::binary);
+	if (!file) throw invalid_argument("Error reading animation bundle: " + path);
+	file.seekg(0, std::ios::end);
+	size_t fileLength = file.tellg();
+	file.seekg(0, std::ios::beg);
+
+	BundleHeader header;
+	if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))) throw runtime_error("Invalid animation bundle: " + path);
+	unsigned int indexSize = header.indexSize;
+	swapWords(&indexSize, 1);
+	if (indexSize > fileLength) throw runtime_error("Invalid animation bundle: " + path);
+	string index(sizeof(header) + indexSize, '\0');
+	memcpy(&index[0], &header, sizeof(header));
+	if (!file.read(&index[sizeof(header)], indexSize)) throw runtime_error("Invalid animation bundle: " + path);
+	readIndex(index.data(), index.data() + index.length(), fileLength);
+}
+
+AnimationBundle::AnimationBundle (const char *begin, const char *end, const BaseSkeletonJson *json,
+		const SkeletonData *skeletonData) :
+				data(begin),
+				json(json),
+				skeletonData(skeletonData),
+				decodedBytes(0),
+				useCount(0) {
+	if (!begin) throw invalid_argument("begin cannot be null.");
+	if (!end) throw invalid_argument("end cannot be null.");
+	if (!json) throw invalid_argument("json cannot be null.");
+	if (!skeletonData) throw invalid_argument("skeletonData cannot be null.");
+	readIndex(begin, end, end - begin);
+}
+
+AnimationBundle::~AnimationBundle () {
+	for (int i = 0, n = entries.size(); i < n; i++)
+		delete entries[i].animation;
+}
+
+void AnimationBundle::readIndex (const char *begin, const char *end, size_t dataLength) {
+	size_t length = end - begin;
+	BundleHeader header;
+	if (length < sizeof(header)) throw runtime_error("Invalid animation bundle: truncated header.");
+	memcpy(&header, begin, sizeof(header));
+	swapWords(&header.version, (sizeof(header) - sizeof(header.magic)) / 4);
+	if (memcmp(header.magic, BUNDLE_MAGIC, 4) != 0) throw runtime_error("Invalid animation bundle: bad magic.");
+	if (header.version != BUNDLE_VERSION) throw runtime_error("Unsupported animation bundle version.");
+	size_t namesOffset = sizeof(header) + header.count * sizeof(BundleEntry);
+	if (length < sizeof(header) + header.indexSize || namesOffset > sizeof(header) + header.indexSize)
+		throw runtime_error("Invalid animation bundle: truncated index.");
+	size_t namesEnd = sizeof(header) + header.indexSize;
+
+	entries.resize(header.count);
+	for (unsigned int i = 0; i < header.count; i++) {
+		BundleEntry record;
+		memcpy(&record, begin + sizeof(header) + i * sizeof(record), sizeof(record));
+		swapWords(&record, sizeof(record) / 4);
+		if (namesOffset + record.nameOffset + record.nameLength > namesEnd || record.offset + record.length > dataLength
+				|| record.offset + record.length < record.offset) throw runtime_error("Invalid animation bundle: entry out of range.");
+		Entry &entry = entries[i];
+		entry.name.assign(begin + namesOffset + record.nameOffset, record.nameLength);
+		entry.offset = record.offset;
+		entry.length = record.length;
+		entry.animation = 0;
+		entry.bytes = 0;
+		entry.lastUse = 0;
+		entry.pinned = false;
+		nameToEntry[entry.name] = i;
+	}
+}
+
+int AnimationBundle::getAnimationCount () const {
+	return entries.size();
+}
+
+const string& AnimationBundle::getAnimationName (int index) const {
+	return entries[index].name;
+}
+
+bool AnimationBundle::hasAnimation (const string &name) const {
+	return nameToEntry.find(name) != nameToEntry.end();
+}
+
+AnimationBundle::Entry* AnimationBundle::findEntry (const string &name) {
+	std::map<string, int>::const_iterator iter = nameToEntry.find(name);
+	if (iter == nameToEntry.end()) return 0;
+	return &entries[iter->second];
+}
+
+Animation* AnimationBundle::getAnimation (const string &name) {
+	Entry *entry = findEntry(name);
+	if (!entry) return 0;
+	entry->lastUse = ++useCount;
+	if (entry->animation) return entry->animation;
+
+	if (data)
+		entry->animation = json->readAnimation(data + entry->offset, data + entry->offset + entry->length, skeletonData);
+	else {
+		std::ifstream file(path.c_str(), std::ios::in | std::ios::binary);
+		if (!file) throw runtime_error("Error reading animation bundle: " + path);
+		string text(entry->length, '\0');
+		file.seekg(entry->offset);
+		if (!file.read(&text[0], entry->length)) throw runtime_error("Error reading animation from bundle: " + name);
+		entry->animation = json->readAnimation(text.data(), text.data() + text.length(), skeletonData);
+	}
+	entry->bytes = entry->animation->memoryUsage().getTotalBytes();
+	decodedBytes += entry->bytes;
+	return entry->animation;
+}
+
+bool AnimationBundle::isDecoded (const string &name) const {
+	std::map<string, int>::const_iterator iter = nameToEntry.find(name);
+	return iter != nameToEntry.end() && entries[iter->second].animation;
+}
+
+void AnimationBundle::setPinned (const string &name, bool pinned) {
+	Entry *entry = findEntry(name);
+	if (!entry) throw invalid_argument("Animation not found: " + name);
+	entry->pinned = pinned;
+}
+
+void AnimationBundle::evict (const string &name) {
+	Entry *entry = findEntry(name);
+	if (entry) evict(*entry);
+}
+
+void AnimationBundle::evict (Entry &entry) {
+	if (!entry.animation) return;
+	delete entry.animation;
+	entry.animation = 0;
+	decodedBytes -= entry.bytes;
+	entry.bytes = 0;
+}
+
+size_t AnimationBundle::trim (size_t byteBudget) {
+	while (decodedBytes > byteBudget) {
+		Entry *oldest = 0;
+		for (int i = 0, n = entries.size(); i < n; i++) {
+			Entry &entry = entries[i];
+			if (!entry.animation || entry.pinned) continue;
+			if (!oldest || entry.lastUse < oldest->lastUse) oldest = &entry;
+		}
+		if (!oldest) break;
+		evict(*oldest);
+	}
+	return decodedBytes;
+}
+
+size_t AnimationBundle::getDecodedBytes () const {
+	return decodedBytes;
+}
+
+void AnimationBundle::write (std::ostream &output, const vector<string> &names, const vector<string> &paths) {
+	if (names.size() != paths.size()) throw invalid_argument("names and paths must have the same size.");
+
+	vector<string> animations(paths.size());
+	for (int i = 0, n = paths.size(); i < n; i++) {
+		std::ifstream file(paths[i].c_str(), std::ios::in | std::ios::binary);
+		if (!file) throw invalid_argument("Error reading animation file: " + paths[i]);
+		animations[i].assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	}
+
+	string namesBlob;
+	vector<BundleEntry> records(names.size());
+	for (int i = 0, n = names.size(); i < n; i++) {
+		records[i].nameOffset = namesBlob.length();
+		records[i].nameLength = names[i].length();
+		namesBlob += names[i];
+	}
+
+	BundleHeader header;
+	memcpy(header.magic, BUNDLE_MAGIC, 4);
+	header.version = BUNDLE_VERSION;
+	header.count = records.size();
+	header.indexSize = records.size() * sizeof(BundleEntry) + namesBlob.length();
+
+	unsigned int offset = sizeof(header) + header.indexSize;
+	for (int i = 0, n = records.size(); i < n; i++) {
+		records[i].offset = offset;
+		records[i].length = animations[i].length();
+		offset += records[i].length;
+	}
+
+	swapWords(&header.version, (sizeof(header) - sizeof(header.magic)) / 4);
+	if (!records.empty()) swapWords(&records[0], records.size() * sizeof(BundleEntry) / 4);
+	output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	if (!records.empty()) output.write(reinterpret_cast<const char*>(&records[0]), records.size() * sizeof(BundleEntry));
+	output.write(namesBlob.data(), namesBlob.length());
+	for (int i = 0, n = animations.size(); i < n; i++)
+		output.write(animations[i].data(), animations[i].length());
+	if (!output) throw runtime_error("Error writing animation bundle.");
+}
+
+} /* namespace spine */
@@ -28,6 +28,7 @@
 #include <spine/AnimationStateData.h>
 #include <spine/Animation.h>
 #include <spine/BaseSkeleton.h>
+#include <spine/Instrumentation.h>
 
 namespace spine {
 
@@ -51,6 +52,7 @@ void AnimationState::update (float delta) {
 
 void AnimationState::apply (BaseSkeleton *skeleton) {
 	if (!animation) return;
+	SPINE_SCOPE("AnimationState::apply");
 	if (previous) {
 		previous->apply(skeleton, previousTime, previousLoop);
 		float alpha = mixTime / mixDuration;
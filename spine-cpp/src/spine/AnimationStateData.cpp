@@ -28,6 +28,7 @@
 #include <spine/Animation.h>
 
 using std::invalid_argument;
+using std::map;
 using std::make_pair;
 using std::pair;
 
@@ -39,11 +40,12 @@ void AnimationStateData::setMixing (Animation *from, Animation *to, float durati
 	animationToMixTime[make_pair(from, to)] = duration;
 }
 
-float AnimationStateData::getMixing (Animation *from, Animation *to) {
+float AnimationStateData::getMixing (Animation *from, Animation *to) const {
 	if (!from) throw invalid_argument("from cannot be null.");
 	if (!to) throw invalid_argument("to cannot be null.");
 	pair<Animation*, Animation*> key = make_pair(from, to);
-	if (animationToMixTime.find(key) != animationToMixTime.end()) return animationToMixTime[key];
+	map<pair<Animation*, Animation*>, float>::const_iterator iter = animationToMixTime.find(key);
+	if (iter != animationToMixTime.end()) return iter->second;
 	return 0;
 }
 
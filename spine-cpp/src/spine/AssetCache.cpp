@@ -0,0 +1,345 @@
+/*******************************************************************************
+ * Copyright (c) 2013, Esoteric Software
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ******************************************************************************/
+
+#include <stdexcept>
+#include <exception>
+#include <spine/AssetCache.h>
+#include <spine/BaseSkeletonJson.h>
+#include <spine/SkeletonData.h>
+#include <spine/Animation.h>
+
+using std::string;
+using std::function;
+using std::invalid_argument;
+
+namespace spine {
+
+/** The reference count of an entry whose asset is not loaded. Lookups only succeed while the count is not negative. */
+static const int UNAVAILABLE = -1;
+
+static unsigned int hashKey (int type, const string &path, float scale) {
+	// FNV-1a.
+	unsigned int hash = 2166136261u;
+	for (int i = 0, n = path.length(); i < n; i++) {
+		hash ^= (unsigned char)path[i];
+		hash *= 16777619u;
+	}
+	hash ^= (unsigned int)type;
+	hash *= 16777619u;
+	hash ^= (unsigned int)(scale * 1000);
+	hash *= 16777619u;
+	return hash;
+}
+
+/** Entries are never deleted while the cache exists, so a lookup can't read a deleted entry. Evicting only deletes the asset. */
+class AssetCache::Entry {
+public:
+	enum State {
+		loading, ready, failed, evicted
+	};
+
+	// The key is immutable.
+	const int type;
+	const string path;
+	const float scale;
+	const unsigned int hash;
+
+	/** Handles referencing the asset, or UNAVAILABLE. */
+	std::atomic<int> refCount;
+	std::atomic<unsigned long> lastUse;
+
+	// Guarded by the cache mutex, except that asset may be read while holding a reference.
+	State state;
+	void *asset;
+	void (*destroy) (void*);
+	size_t bytes;
+	/** Requests waiting for the load, including the one loading. */
+	int waiters;
+	/** Incremented each time a load completes or fails. */
+	unsigned int generation;
+	/** The error of the last failed load. */
+	std::exception_ptr error;
+
+	Entry (int type, const string &path, float scale, unsigned int hash) :
+					type(type),
+					path(path),
+					scale(scale),
+					hash(hash),
+					refCount(UNAVAILABLE),
+					lastUse(0),
+					state(evicted),
+					asset(0),
+					destroy(0),
+					bytes(0),
+					waiters(0),
+					generation(0) {
+	}
+};
+
+AssetCache::Table::Table (unsigned int size) :
+				buckets(new std::atomic<Entry*>[size]),
+				mask(size - 1),
+				entryCount(0) {
+	for (unsigned int i = 0; i < size; i++)
+		buckets[i].store(0, std::memory_order_relaxed);
+}
+
+AssetCache::Table::~Table () {
+	delete[] buckets;
+}
+
+//
+
+AssetCache::AssetCache (size_t byteBudget) :
+				table(new Table(64)),
+				byteBudget(byteBudget),
+				useCount(0),
+				hits(0),
+				misses(0),
+				evictions(0),
+				bytes(0) {
+}
+
+AssetCache::~AssetCache () {
+	Table *table = this->table.load();
+	for (unsigned int i = 0; i <= table->mask; i++) {
+		Entry *entry = table->buckets[i].load();
+		if (!entry) continue;
+		if (entry->asset) entry->destroy(entry->asset);
+		delete entry;
+	}
+	delete table;
+	for (int i = 0, n = oldTables.size(); i < n; i++)
+		delete oldTables[i];
+}
+
+static void deleteSkeletonData (void *skeletonData) {
+	delete static_cast<SkeletonData*>(skeletonData);
+}
+
+static void deleteAnimation (void *animation) {
+	delete static_cast<Animation*>(animation);
+}
+
+AssetCache::Handle<SkeletonData> AssetCache::getSkeletonData (const BaseSkeletonJson *json, const string &path) {
+	if (!json) throw invalid_argument("json cannot be null.");
+	Entry *entry;
+	void *skeletonData = get(skeletonDataAsset, path, json->scale, [&] (size_t &size) -> void* {
+		SkeletonData *skeletonData = json->readSkeletonData(path);
+		size = skeletonData->memoryUsage().getTotalBytes();
+		return skeletonData;
+	}, &deleteSkeletonData, entry);
+	return Handle<SkeletonData>(this, entry, skeletonData);
+}
+
+AssetCache::Handle<Animation> AssetCache::getAnimation (const BaseSkeletonJson *json, const string &path,
+		const SkeletonData *skeletonData) {
+	if (!json) throw invalid_argument("json cannot be null.");
+	if (!skeletonData) throw invalid_argument("skeletonData cannot be null.");
+	Entry *entry;
+	void *animation = get(animationAsset, path, json->scale, [&] (size_t &size) -> void* {
+		Animation *animation = json->readAnimation(path, skeletonData);
+		size = animation->memoryUsage().getTotalBytes();
+		return animation;
+	}, &deleteAnimation, entry);
+	return Handle<Animation>(this, entry, animation);
+}
+
+AssetCache::Entry* AssetCache::find (const Table *table, unsigned int hash, AssetType type, const string &path,
+		float scale) const {
+	for (unsigned int i = hash & table->mask;; i = (i + 1) & table->mask) {
+		Entry *entry = table->buckets[i].load(std::memory_order_acquire);
+		if (!entry) return 0;
+		if (entry->hash == hash && entry->type == type && entry->scale == scale && entry->path == path) return entry;
+	}
+}
+
+bool AssetCache::acquire (Entry *entry) {
+	int count = entry->refCount.load(std::memory_order_relaxed);
+	while (count != UNAVAILABLE)
+		if (entry->refCount.compare_exchange_weak(count, count + 1, std::memory_order_acquire)) {
+			entry->lastUse.store(++useCount, std::memory_order_relaxed);
+			return true;
+		}
+	return false;
+}
+
+void AssetCache::insert (Entry *entry) {
+	Table *table = this->table.load(std::memory_order_relaxed);
+	if ((table->entryCount + 1) * 2 > (int)table->mask + 1) {
+		// Keep the load factor under 1/2 by publishing a larger copy.
+		Table *larger = new Table((table->mask + 1) * 2);
+		for (unsigned int i = 0; i <= table->mask; i++) {
+			Entry *existing = table->buckets[i].load(std::memory_order_relaxed);
+			if (!existing) continue;
+			unsigned int ii = existing->hash & larger->mask;
+			while (larger->buckets[ii].load(std::memory_order_relaxed))
+				ii = (ii + 1) & larger->mask;
+			larger->buckets[ii].store(existing, std::memory_order_relaxed);
+		}
+		larger->entryCount = table->entryCount;
+		this->table.store(larger, std::memory_order_release);
+		oldTables.push_back(table);
+		table = larger;
+	}
+	unsigned int i = entry->hash & table->mask;
+	while (table->buckets[i].load(std::memory_order_relaxed))
+		i = (i + 1) & table->mask;
+	table->buckets[i].store(entry, std::memory_order_release);
+	table->entryCount++;
+}
+
+void* AssetCache::get (AssetType type, const string &path, float scale, const function<void*(size_t&)> &load,
+		void (*destroy) (void*), Entry *&result) {
+	unsigned int hash = hashKey(type, path, scale);
+
+	// Lock free when the asset is loaded.
+	Entry *entry = find(table.load(std::memory_order_acquire), hash, type, path, scale);
+	if (entry && acquire(entry)) {
+		hits++;
+		result = entry;
+		return entry->asset;
+	}
+
+	std::unique_lock<std::mutex> lock(mutex);
+	entry = find(table.load(std::memory_order_relaxed), hash, type, path, scale);
+	if (!entry) {
+		entry = new Entry(type, path, scale, hash);
+		insert(entry);
+	}
+	if (acquire(entry)) {
+		hits++;
+		result = entry;
+		return entry->asset;
+	}
+
+	if (entry->state == Entry::loading) {
+		// Another thread is loading it, wait for that load.
+		hits++;
+		entry->waiters++;
+		unsigned int generation = entry->generation;
+		while (entry->generation == generation)
+			loaded.wait(lock);
+		// A successful load counted the waiters as references, so the asset can't have been evicted and reloaded since.
+		if (entry->generation != generation + 1 || entry->state != Entry::ready) std::rethrow_exception(entry->error);
+		result = entry;
+		return entry->asset;
+	}
+
+	misses++;
+	entry->state = Entry::loading;
+	entry->waiters = 1;
+	lock.unlock();
+
+	void *asset = 0;
+	size_t size = 0;
+	std::exception_ptr error;
+	try {
+		asset = load(size);
+	} catch (...) {
+		error = std::current_exception();
+	}
+
+	lock.lock();
+	if (error) {
+		entry->state = Entry::failed;
+		entry->error = error;
+		entry->waiters = 0;
+		entry->generation++;
+		loaded.notify_all();
+		std::rethrow_exception(error);
+	}
+	entry->state = Entry::ready;
+	entry->asset = asset;
+	entry->destroy = destroy;
+	entry->bytes = size;
+	entry->lastUse.store(++useCount, std::memory_order_relaxed);
+	bytes += size;
+	// Publishes the asset to lookups.
+	entry->refCount.store(entry->waiters, std::memory_order_release);
+	entry->waiters = 0;
+	entry->generation++;
+	loaded.notify_all();
+	trim();
+	result = entry;
+	return asset;
+}
+
+void AssetCache::retain (Entry *entry) {
+	entry->refCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+void AssetCache::release (Entry *entry) {
+	if (entry->refCount.fetch_sub(1, std::memory_order_release) == 1 && bytes.load() > byteBudget.load()) {
+		std::lock_guard<std::mutex> lock(mutex);
+		trim();
+	}
+}
+
+void AssetCache::trim () {
+	const Table *table = this->table.load(std::memory_order_relaxed);
+	while (bytes > byteBudget) {
+		// Least recently used unreferenced asset.
+		Entry *oldest = 0;
+		for (unsigned int i = 0; i <= table->mask; i++) {
+			Entry *entry = table->buckets[i].load(std::memory_order_relaxed);
+			if (!entry || entry->state != Entry::ready || entry->refCount.load(std::memory_order_relaxed) != 0) continue;
+			if (!oldest || entry->lastUse.load(std::memory_order_relaxed) < oldest->lastUse.load(std::memory_order_relaxed))
+				oldest = entry;
+		}
+		if (!oldest) return;
+
+		// Fails if a lookup acquired it since the scan.
+		int count = 0;
+		if (!oldest->refCount.compare_exchange_strong(count, UNAVAILABLE, std::memory_order_acquire)) continue;
+		oldest->state = Entry::evicted;
+		oldest->destroy(oldest->asset);
+		oldest->asset = 0;
+		bytes -= oldest->bytes;
+		oldest->bytes = 0;
+		evictions++;
+	}
+}
+
+void AssetCache::setByteBudget (size_t byteBudget) {
+	std::lock_guard<std::mutex> lock(mutex);
+	this->byteBudget = byteBudget;
+	trim();
+}
+
+size_t AssetCache::getByteBudget () const {
+	return byteBudget;
+}
+
+AssetCache::Stats AssetCache::getStats () const {
+	Stats stats;
+	stats.hits = hits;
+	stats.misses = misses;
+	stats.evictions = evictions;
+	stats.bytes = bytes;
+	return stats;
+}
+
+} /* namespace spine */
@@ -0,0 +1,182 @@
+/*******************************************************************************
+ * Copyright (c) 2013, Esoteric Software
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ******************************************************************************/
+
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <spine/AsyncLoader.h>
+#include <spine/BaseSkeletonJson.h>
+#include <spine/SkeletonData.h>
+#include <spine/Animation.h>
+
+using std::string;
+using std::vector;
+using std::function;
+using std::promise;
+using std::shared_ptr;
+using std::shared_future;
+using std::invalid_argument;
+
+namespace spine {
+
+AsyncLoader::AsyncLoader (int threadCount) :
+				stopping(false),
+				pendingCount(0) {
+	if (threadCount < 1) throw invalid_argument("threadCount must be > 0.");
+	workers.reserve(threadCount);
+	for (int i = 0; i < threadCount; i++)
+		workers.push_back(std::thread(&AsyncLoader::run, this));
+}
+
+AsyncLoader::~AsyncLoader () {
+	stop();
+}
+
+void AsyncLoader::stop () {
+	{
+		std::lock_guard<std::mutex> lock(workerMutex);
+		stopping = true;
+	}
+	workerCondition.notify_all();
+	for (int i = 0, n = workers.size(); i < n; i++)
+		workers[i].join();
+	workers.clear();
+	// The workers are done, so nothing more is posted. Free the objects that update would have delivered.
+	for (int i = 0, n = mainTasks.size(); i < n; i++)
+		mainTasks[i].discard();
+	mainTasks.clear();
+}
+
+void AsyncLoader::run () {
+	while (true) {
+		function<void()> task;
+		{
+			std::unique_lock<std::mutex> lock(workerMutex);
+			while (!stopping && workerTasks.empty())
+				workerCondition.wait(lock);
+			if (workerTasks.empty()) return;
+			task = workerTasks.front();
+			workerTasks.pop_front();
+		}
+		task();
+	}
+}
+
+void AsyncLoader::submit (const function<void()> &task) {
+	pendingCount++;
+	{
+		std::lock_guard<std::mutex> lock(workerMutex);
+		workerTasks.push_back(task);
+	}
+	workerCondition.notify_one();
+}
+
+void AsyncLoader::post (const function<void()> &task, const function<void()> &discard) {
+	MainTask mainTask = {task, discard};
+	std::lock_guard<std::mutex> lock(mainMutex);
+	mainTasks.push_back(mainTask);
+}
+
+std::exception_ptr AsyncLoader::destroyedError () {
+	return std::make_exception_ptr(std::runtime_error("AsyncLoader was destroyed before the load completed."));
+}
+
+int AsyncLoader::update () {
+	std::deque<MainTask> tasks;
+	{
+		std::lock_guard<std::mutex> lock(mainMutex);
+		tasks.swap(mainTasks);
+	}
+	// Tasks posted by the callbacks run on the next update.
+	for (int i = 0, n = tasks.size(); i < n; i++)
+		tasks[i].run();
+	return tasks.size();
+}
+
+int AsyncLoader::getPendingCount () {
+	return pendingCount;
+}
+
+void AsyncLoader::readFile (const string &path, string &data) {
+	std::ifstream file(path.c_str(), std::ios::in | std::ios::binary);
+	if (!file) throw invalid_argument("Error reading file: " + path);
+	data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+shared_future<SkeletonData*> AsyncLoader::loadSkeletonData (const BaseSkeletonJson *json, const string &path,
+		const function<void(SkeletonData*)> &callback) {
+	if (!json) throw invalid_argument("json cannot be null.");
+
+	shared_ptr<promise<SkeletonData*> > result(new promise<SkeletonData*>());
+	shared_future<SkeletonData*> future = result->get_future().share();
+	submit([=] () {
+		SkeletonData *value = 0;
+		try {
+			string data;
+			readFile(path, data);
+			value = json->readSkeletonData(data.data(), data.data() + data.length());
+			complete(result, callback, value);
+		} catch (...) {
+			// If complete threw, the skeleton data was not queued.
+			delete value;
+			fail(result, callback, std::current_exception());
+		}
+	});
+	return future;
+}
+
+shared_future<Animation*> AsyncLoader::loadAnimation (const BaseSkeletonJson *json, const string &path,
+		const SkeletonData *skeletonData, const function<void(Animation*)> &callback) {
+	if (!json) throw invalid_argument("json cannot be null.");
+	if (!skeletonData) throw invalid_argument("skeletonData cannot be null.");
+
+	shared_ptr<promise<Animation*> > result(new promise<Animation*>());
+	shared_future<Animation*> future = result->get_future().share();
+	submit([=] () {
+		Animation *value = 0;
+		try {
+			string data;
+			readFile(path, data);
+			value = json->readAnimation(data.data(), data.data() + data.length(), skeletonData);
+			complete(result, callback, value);
+		} catch (...) {
+			// If complete threw, the animation was not queued.
+			delete value;
+			fail(result, callback, std::current_exception());
+		}
+	});
+	return future;
+}
+
+vector<shared_future<Animation*> > AsyncLoader::loadAnimations (const BaseSkeletonJson *json, const vector<string> &paths,
+		const SkeletonData *skeletonData) {
+	vector<shared_future<Animation*> > futures;
+	futures.reserve(paths.size());
+	for (int i = 0, n = paths.size(); i < n; i++)
+		futures.push_back(loadAnimation(json, paths[i], skeletonData));
+	return futures;
+}
+
+} /* namespace spine */
@@ -24,12 +24,16 @@
  ******************************************************************************/
 
 #include <cstdio>
+#include <cstring>
 #include <fstream>
+#include <iterator>
 #include <algorithm>
 #include <functional>
 #include <cctype>
 #include <stdexcept>
 #include <spine/BaseAtlas.h>
+#include <spine/ByteOrder.h>
+#include <spine/Instrumentation.h>
 
 using std::string;
 using std::runtime_error;
@@ -94,6 +98,115 @@ static string textureFilterNames[] = {"Nearest", "Linear", "MipMap", "MipMapNear
 
 //
 
+/* Binary atlas format. All fields are 4 bytes and little endian. Records are copied straight out of the data and, on big endian
+ * hosts, byte swapped in place:
+ *
+ * BinaryAtlasHeader
+ * BinaryAtlasPage[pageCount]
+ * BinaryAtlasRegion[regionCount]
+ * unsigned int regionTable[tableSize] -- region index + 1 at hashName(name) & (tableSize - 1), linear probing, 0 is empty
+ * char strings[stringsSize] -- NUL terminated names, referenced by offset */
+
+static const char BINARY_MAGIC[4] = {'\x89', 'S', 'P', 'A'};
+static const unsigned int BINARY_VERSION = 1;
+
+static const unsigned int REGION_ROTATE = 1;
+static const unsigned int REGION_FLIP = 2;
+static const unsigned int REGION_SPLITS = 4;
+static const unsigned int REGION_PADS = 8;
+
+struct BinaryAtlasHeader {
+	char magic[4];
+	unsigned int version;
+	unsigned int pageCount;
+	unsigned int regionCount;
+	unsigned int tableSize;
+	unsigned int stringsSize;
+};
+
+struct BinaryAtlasPage {
+	unsigned int name;
+	int format, minFilter, magFilter, uWrap, vWrap;
+	int width, height;
+};
+
+struct BinaryAtlasRegion {
+	unsigned int name;
+	unsigned int page;
+	unsigned int flags;
+	int x, y, width, height;
+	float offsetX, offsetY;
+	int originalWidth, originalHeight;
+	int index;
+	int splits[4];
+	int pads[4];
+	float u, v, u2, v2;
+};
+
+/** FNV-1a. */
+static inline unsigned int hashName (const char *name, size_t length) {
+	unsigned int hash = 2166136261u;
+	for (size_t i = 0; i < length; i++) {
+		hash ^= (unsigned char)name[i];
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+/** Returns a power of two with at least twice as many buckets as regions, so probe sequences stay short. */
+static inline unsigned int tableSizeFor (unsigned int regionCount) {
+	unsigned int size = 1;
+	while (size < regionCount * 2)
+		size <<= 1;
+	return size;
+}
+
+template<class Regions, class Table>
+static void buildRegionTable (const Regions &regions, Table &table) {
+	table.assign(tableSizeFor(regions.size()), 0);
+	unsigned int mask = table.size() - 1;
+	for (unsigned int i = 0, n = regions.size(); i < n; i++) {
+		const String &name = regions[i]->name;
+		unsigned int bucket = hashName(name.data(), name.length()) & mask;
+		while (table[bucket]) {
+			if (regions[table[bucket] - 1]->name == name) break; // Keep the first region with a name, as a linear scan would.
+			bucket = (bucket + 1) & mask;
+		}
+		if (!table[bucket]) table[bucket] = i + 1;
+	}
+}
+
+/** Text atlas without textures, used to convert to the binary format. */
+class ConvertAtlas: public BaseAtlas {
+public:
+	ConvertAtlas (const char *begin, const char *end, const std::vector<std::pair<int, int> > &pageSizes) :
+					pageSizes(pageSizes) {
+		load(begin, end);
+	}
+
+private:
+	const std::vector<std::pair<int, int> > &pageSizes;
+
+	virtual BaseAtlasPage* newAtlasPage (const std::string &name) {
+		if (pages.size() >= pageSizes.size()) throw invalid_argument("Page size not specified: " + name);
+		BaseAtlasPage *page = new BaseAtlasPage();
+		page->width = pageSizes[pages.size()].first;
+		page->height = pageSizes[pages.size()].second;
+		return page;
+	}
+
+	virtual BaseAtlasRegion* newAtlasRegion (BaseAtlasPage*) {
+		return new BaseAtlasRegion();
+	}
+};
+
+//
+
+BaseAtlas::BaseAtlas (bool deferTextures) :
+				deferTextures(deferTextures),
+				texturePageCount(0) {
+}
+
 BaseAtlas::~BaseAtlas () {
 	for (int i = 0, n = pages.size(); i < n; i++)
 		delete pages[i];
@@ -102,7 +215,7 @@ BaseAtlas::~BaseAtlas () {
 }
 
 void BaseAtlas::load (const std::string &path) {
-	std::ifstream file(path.c_str());
+	std::ifstream file(path.c_str(), std::ios::in | std::ios::binary);
 	if (!file) throw std::invalid_argument("Error reading atlas file: " + path);
 	load(file);
 }
@@ -110,17 +223,67 @@ void BaseAtlas::load (const std::string &path) {
 void BaseAtlas::load (std::istream &input) {
 	if (!input) throw invalid_argument("input cannot be null.");
 
-	string text;
-	std::getline(input, text, (char)EOF);
-	const char *begin = text.c_str();
-	const char *end = begin + text.length();
+	string data((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+	const char *begin = data.data();
+	const char *end = begin + data.length();
 	load(begin, end);
 }
 
-void BaseAtlas::load (const char *current, const char *end) {
-	if (!current) throw invalid_argument("current cannot be null.");
+void BaseAtlas::load (const char *begin, const char *end) {
+	if (!begin) throw invalid_argument("begin cannot be null.");
 	if (!end) throw invalid_argument("end cannot be null.");
+	SPINE_SCOPE("BaseAtlas::load");
+
+	regionTable.clear();
+	if (end - begin >= 4 && memcmp(begin, BINARY_MAGIC, 4) == 0)
+		loadBinary(begin, end);
+	else
+		loadText(begin, end);
+	indexRegions();
+	if (!deferTextures) loadTextures();
+}
+
+void BaseAtlas::loadTextures () {
+	while (loadNextTexture()) {
+	}
+}
 
+bool BaseAtlas::loadNextTexture () {
+	if (texturePageCount == (int)pages.size()) return false;
+	BaseAtlasPage *page = pages[texturePageCount];
+	int width = page->width, height = page->height;
+	loadTexture(page);
+	texturePageCount++;
+
+	// Binary atlases store the UVs for the stored page size, so they are only recomputed if the texture's size differs.
+	if (page->width && page->height && (page->width != width || page->height != height)) {
+		for (int i = 0, n = regions.size(); i < n; i++) {
+			BaseAtlasRegion *region = regions[i];
+			if (region->page == page) region->updateUVs(page->width, page->height);
+		}
+	}
+	return true;
+}
+
+int BaseAtlas::getPendingTextureCount () const {
+	return pages.size() - texturePageCount;
+}
+
+MemoryUsage BaseAtlas::memoryUsage () const {
+	MemoryUsage usage;
+	usage.add(objectMemory, sizeof(BaseAtlas));
+	usage.add(arrayMemory, (pages.capacity() + regions.capacity()) * sizeof(void*) + regionTable.capacity() * sizeof(unsigned int));
+	for (int i = 0, n = pages.size(); i < n; i++)
+		pages[i]->addMemoryUsage(usage);
+	for (int i = 0, n = regions.size(); i < n; i++)
+		regions[i]->addMemoryUsage(usage);
+	return usage;
+}
+
+void BaseAtlas::loadTexture (BaseAtlasPage*) {
+}
+
+void BaseAtlas::loadText (const char *current, const char *end) {
 	string value;
 	string tuple[4];
 	BaseAtlasPage *page = 0;
@@ -153,6 +316,7 @@ void BaseAtlas::load (const char *current, const char *end) {
 		} else {
 			BaseAtlasRegion *region = newAtlasRegion(page);
 			regions.push_back(region);
+			region->page = page;
 			region->name = value;
 
 			region->rotate = readValue(current, end, value) == "true";
@@ -166,14 +330,14 @@ void BaseAtlas::load (const char *current, const char *end) {
 			region->height = atoi(tuple[1].c_str());
 
 			if (readTuple(current, end, value, tuple) == 4) { // split is optional
-				region->splits = new int[4];
+				region->splits = static_cast<int*>(allocate(sizeof(int) * 4, atlasTag));
 				region->splits[0] = atoi(tuple[0].c_str());
 				region->splits[1] = atoi(tuple[1].c_str());
 				region->splits[2] = atoi(tuple[2].c_str());
 				region->splits[3] = atoi(tuple[3].c_str());
 
 				if (readTuple(current, end, value, tuple) == 4) { // pad is optional, but only present with splits
-					region->pads = new int[4];
+					region->pads = static_cast<int*>(allocate(sizeof(int) * 4, atlasTag));
 					region->pads[0] = atoi(tuple[0].c_str());
 					region->pads[1] = atoi(tuple[1].c_str());
 					region->pads[2] = atoi(tuple[2].c_str());
@@ -195,15 +359,247 @@ void BaseAtlas::load (const char *current, const char *end) {
 	}
 }
 
+void BaseAtlas::loadBinary (const char *begin, const char *end) {
+	size_t length = end - begin;
+	BinaryAtlasHeader header;
+	if (length < sizeof(header)) throw runtime_error("Invalid binary atlas: truncated header.");
+	memcpy(&header, begin, sizeof(header));
+	swapWords(&header.version, (sizeof(header) - sizeof(header.magic)) / 4);
+	if (header.version != BINARY_VERSION) throw runtime_error("Unsupported binary atlas version.");
+
+	size_t pagesOffset = sizeof(header);
+	size_t regionsOffset = pagesOffset + header.pageCount * sizeof(BinaryAtlasPage);
+	size_t tableOffset = regionsOffset + header.regionCount * sizeof(BinaryAtlasRegion);
+	size_t stringsOffset = tableOffset + header.tableSize * sizeof(unsigned int);
+	if (length < stringsOffset + header.stringsSize || header.stringsSize == 0 || begin[stringsOffset + header.stringsSize - 1])
+		throw runtime_error("Invalid binary atlas: truncated data.");
+	if (header.tableSize & (header.tableSize - 1)) throw runtime_error("Invalid binary atlas: table size must be a power of two.");
+	const char *strings = begin + stringsOffset;
+
+	int pageStart = pages.size();
+	pages.reserve(pageStart + header.pageCount);
+	for (unsigned int i = 0; i < header.pageCount; i++) {
+		BinaryAtlasPage record;
+		memcpy(&record, begin + pagesOffset + i * sizeof(record), sizeof(record));
+		swapWords(&record, sizeof(record) / 4);
+		if (record.name >= header.stringsSize) throw runtime_error("Invalid binary atlas: page name out of range.");
+		if (record.format < alpha || record.format > rgba8888) throw runtime_error("Invalid binary atlas: page format out of range.");
+		if (record.minFilter < nearest || record.minFilter > mipMapLinearLinear || record.magFilter < nearest
+				|| record.magFilter > mipMapLinearLinear) throw runtime_error("Invalid binary atlas: page filter out of range.");
+		if (record.uWrap < mirroredRepeat || record.uWrap > repeat || record.vWrap < mirroredRepeat || record.vWrap > repeat)
+			throw runtime_error("Invalid binary atlas: page wrap out of range.");
+
+		string name(strings + record.name);
+		BaseAtlasPage *page = newAtlasPage(name);
+		pages.push_back(page);
+		page->name = name;
+		page->format = static_cast<Format>(record.format);
+		page->minFilter = static_cast<TextureFilter>(record.minFilter);
+		page->magFilter = static_cast<TextureFilter>(record.magFilter);
+		page->uWrap = static_cast<TextureWrap>(record.uWrap);
+		page->vWrap = static_cast<TextureWrap>(record.vWrap);
+		page->width = record.width;
+		page->height = record.height;
+	}
+
+	regions.reserve(regions.size() + header.regionCount);
+	for (unsigned int i = 0; i < header.regionCount; i++) {
+		BinaryAtlasRegion record;
+		memcpy(&record, begin + regionsOffset + i * sizeof(record), sizeof(record));
+		swapWords(&record, sizeof(record) / 4);
+		if (record.name >= header.stringsSize) throw runtime_error("Invalid binary atlas: region name out of range.");
+		if (record.page >= header.pageCount) throw runtime_error("Invalid binary atlas: region page out of range.");
+
+		BaseAtlasPage *page = pages[pageStart + record.page];
+		BaseAtlasRegion *region = newAtlasRegion(page);
+		regions.push_back(region);
+		region->page = page;
+		region->name = strings + record.name;
+		region->rotate = (record.flags & REGION_ROTATE) != 0;
+		region->flip = (record.flags & REGION_FLIP) != 0;
+		region->x = record.x;
+		region->y = record.y;
+		region->width = record.width;
+		region->height = record.height;
+		if (record.flags & REGION_SPLITS) {
+			region->splits = static_cast<int*>(allocate(sizeof(int) * 4, atlasTag));
+			memcpy(region->splits, record.splits, sizeof(record.splits));
+		}
+		if (record.flags & REGION_PADS) {
+			region->pads = static_cast<int*>(allocate(sizeof(int) * 4, atlasTag));
+			memcpy(region->pads, record.pads, sizeof(record.pads));
+		}
+		region->originalWidth = record.originalWidth;
+		region->originalHeight = record.originalHeight;
+		region->offsetX = record.offsetX;
+		region->offsetY = record.offsetY;
+		region->index = record.index;
+		region->u = record.u;
+		region->v = record.v;
+		region->u2 = record.u2;
+		region->v2 = record.v2;
+	}
+
+	// The stored table can be used as is only if this atlas held nothing before.
+	if (pageStart == 0 && regions.size() == header.regionCount && header.tableSize) {
+		regionTable.resize(header.tableSize);
+		memcpy(&regionTable[0], begin + tableOffset, header.tableSize * sizeof(unsigned int));
+		swapWords(&regionTable[0], header.tableSize);
+	}
+}
+
+void BaseAtlas::indexRegions () {
+	if (!isValidRegionTable()) buildRegionTable(regions, regionTable);
+}
+
+bool BaseAtlas::isValidRegionTable () const {
+	unsigned int size = regionTable.size();
+	if (size < regions.size() * 2 || (size & (size - 1))) return false;
+	// findRegion stops at an empty bucket, so there must be one and no entry may be past one from its hash.
+	unsigned int mask = size - 1, empty = size;
+	for (unsigned int i = 0; i < size; i++) {
+		if (regionTable[i] > regions.size()) return false;
+		if (!regionTable[i]) empty = i;
+	}
+	if (empty == size) return false;
+	for (unsigned int i = 0; i < size; i++) {
+		unsigned int entry = regionTable[i];
+		if (!entry) continue;
+		const String &name = regions[entry - 1]->name;
+		for (unsigned int bucket = hashName(name.data(), name.length()) & mask; bucket != i; bucket = (bucket + 1) & mask)
+			if (!regionTable[bucket]) return false;
+	}
+	return true;
+}
+
 BaseAtlasRegion* BaseAtlas::findRegion (const std::string &name) {
-	for (int i = 0, n = regions.size(); i < n; i++)
-		if (regions[i]->name == name) return regions[i];
+	if (regionTable.empty()) {
+		for (int i = 0, n = regions.size(); i < n; i++)
+			if (regions[i]->name == name) return regions[i];
+		return 0;
+	}
+	unsigned int mask = regionTable.size() - 1;
+	unsigned int bucket = hashName(name.data(), name.length()) & mask;
+	while (unsigned int entry = regionTable[bucket]) {
+		if (regions[entry - 1]->name == name) return regions[entry - 1];
+		bucket = (bucket + 1) & mask;
+	}
 	return 0;
 }
 
+void BaseAtlas::writeBinary (std::ostream &output) const {
+	string strings;
+	std::vector<BinaryAtlasPage> pageRecords(pages.size());
+	for (int i = 0, n = pages.size(); i < n; i++) {
+		const BaseAtlasPage *page = pages[i];
+		if (!page->width || !page->height) throw runtime_error("Page size is unknown: " + page->name.str());
+		BinaryAtlasPage &record = pageRecords[i];
+		record.name = strings.length();
+		strings.append(page->name.c_str(), page->name.length() + 1);
+		record.format = page->format;
+		record.minFilter = page->minFilter;
+		record.magFilter = page->magFilter;
+		record.uWrap = page->uWrap;
+		record.vWrap = page->vWrap;
+		record.width = page->width;
+		record.height = page->height;
+	}
+
+	std::vector<BinaryAtlasRegion> regionRecords(regions.size());
+	for (int i = 0, n = regions.size(); i < n; i++) {
+		const BaseAtlasRegion *region = regions[i];
+		BinaryAtlasRegion &record = regionRecords[i];
+		memset(&record, 0, sizeof(record));
+		record.name = strings.length();
+		strings.append(region->name.c_str(), region->name.length() + 1);
+		int pageIndex = std::find(pages.begin(), pages.end(), region->page) - pages.begin();
+		if (pageIndex == (int)pages.size()) throw runtime_error("Region page not found: " + region->name.str());
+		record.page = pageIndex;
+		if (region->rotate) record.flags |= REGION_ROTATE;
+		if (region->flip) record.flags |= REGION_FLIP;
+		if (region->splits) {
+			record.flags |= REGION_SPLITS;
+			memcpy(record.splits, region->splits, sizeof(record.splits));
+		}
+		if (region->pads) {
+			record.flags |= REGION_PADS;
+			memcpy(record.pads, region->pads, sizeof(record.pads));
+		}
+		record.x = region->x;
+		record.y = region->y;
+		record.width = region->width;
+		record.height = region->height;
+		record.offsetX = region->offsetX;
+		record.offsetY = region->offsetY;
+		record.originalWidth = region->originalWidth;
+		record.originalHeight = region->originalHeight;
+		record.index = region->index;
+
+		BaseAtlasRegion uvs;
+		uvs.x = region->x;
+		uvs.y = region->y;
+		uvs.width = region->width;
+		uvs.height = region->height;
+		uvs.rotate = region->rotate;
+		uvs.updateUVs(region->page->width, region->page->height);
+		record.u = uvs.u;
+		record.v = uvs.v;
+		record.u2 = uvs.u2;
+		record.v2 = uvs.v2;
+	}
+
+	std::vector<unsigned int> table;
+	buildRegionTable(regions, table);
+
+	BinaryAtlasHeader header;
+	memcpy(header.magic, BINARY_MAGIC, 4);
+	header.version = BINARY_VERSION;
+	header.pageCount = pageRecords.size();
+	header.regionCount = regionRecords.size();
+	header.tableSize = table.size();
+	header.stringsSize = strings.length();
+
+	swapWords(&header.version, (sizeof(header) - sizeof(header.magic)) / 4);
+	if (!pageRecords.empty()) swapWords(&pageRecords[0], pageRecords.size() * sizeof(BinaryAtlasPage) / 4);
+	if (!regionRecords.empty()) swapWords(&regionRecords[0], regionRecords.size() * sizeof(BinaryAtlasRegion) / 4);
+	swapWords(&table[0], table.size());
+	output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	if (!pageRecords.empty())
+		output.write(reinterpret_cast<const char*>(&pageRecords[0]), pageRecords.size() * sizeof(BinaryAtlasPage));
+	if (!regionRecords.empty())
+		output.write(reinterpret_cast<const char*>(&regionRecords[0]), regionRecords.size() * sizeof(BinaryAtlasRegion));
+	output.write(reinterpret_cast<const char*>(&table[0]), table.size() * sizeof(unsigned int));
+	output.write(strings.data(), strings.length());
+	if (!output) throw runtime_error("Error writing binary atlas.");
+}
+
+void BaseAtlas::convertToBinary (const char *begin, const char *end, const std::vector<std::pair<int, int> > &pageSizes,
+		std::ostream &output) {
+	ConvertAtlas atlas(begin, end, pageSizes);
+	atlas.writeBinary(output);
+}
+
+//
+
+BaseAtlasPage::BaseAtlasPage () :
+				format(rgba8888),
+				minFilter(nearest),
+				magFilter(nearest),
+				uWrap(clampToEdge),
+				vWrap(clampToEdge),
+				width(0),
+				height(0) {
+}
+
+void BaseAtlasPage::addMemoryUsage (MemoryUsage &usage) const {
+	usage.add(objectMemory, sizeof(BaseAtlasPage));
+	usage.addCharacters(name);
+}
+
 //
 
 BaseAtlasRegion::BaseAtlasRegion () :
+				page(0),
 				x(0),
 				y(0),
 				width(0),
@@ -216,12 +612,31 @@ BaseAtlasRegion::BaseAtlasRegion () :
 				rotate(false),
 				flip(false),
 				splits(0),
-				pads(0) {
+				pads(0),
+				u(0),
+				v(0),
+				u2(0),
+				v2(0) {
+}
+
+void BaseAtlasRegion::updateUVs (int pageWidth, int pageHeight) {
+	// A rotated region is stored in the page with its width and height swapped.
+	u = x / (float)pageWidth;
+	v = y / (float)pageHeight;
+	u2 = (x + (rotate ? height : width)) / (float)pageWidth;
+	v2 = (y + (rotate ? width : height)) / (float)pageHeight;
 }
 
 BaseAtlasRegion::~BaseAtlasRegion () {
-	if (splits) delete splits;
-	if (pads) delete pads;
+	deallocate(splits);
+	deallocate(pads);
+}
+
+void BaseAtlasRegion::addMemoryUsage (MemoryUsage &usage) const {
+	usage.add(objectMemory, sizeof(BaseAtlasRegion));
+	usage.addCharacters(name);
+	if (splits) usage.add(arrayMemory, sizeof(int) * 4);
+	if (pads) usage.add(arrayMemory, sizeof(int) * 4);
 }
 
 } /* namespace spine */
@@ -72,4 +72,9 @@ void BaseRegionAttachment::updateOffset () {
 	offset[7] = localYCos + localX2Sin;
 }
 
+void BaseRegionAttachment::addMemoryUsage (MemoryUsage &usage) const {
+	usage.add(objectMemory, sizeof(BaseRegionAttachment));
+	usage.addCharacters(name);
+}
+
 } /* namespace spine */
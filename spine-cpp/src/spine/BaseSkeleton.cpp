@@ -32,13 +32,14 @@
 #include <spine/BoneData.h>
 #include <spine/Bone.h>
 #include <spine/Skin.h>
+#include <spine/Instrumentation.h>
 
 using std::string;
 using std::invalid_argument;
 
 namespace spine {
 
-BaseSkeleton::BaseSkeleton (SkeletonData *data) :
+BaseSkeleton::BaseSkeleton (const SkeletonData *data) :
 				data(data),
 				skin(0),
 				r(1),
@@ -53,7 +54,7 @@ BaseSkeleton::BaseSkeleton (SkeletonData *data) :
 	int boneCount = data->bones.size();
 	bones.reserve(boneCount);
 	for (int i = 0; i < boneCount; i++) {
-		BoneData *boneData = data->bones[i];
+		const BoneData *boneData = data->bones[i];
 		Bone *bone = new Bone(boneData);
 		if (boneData->parent) {
 			for (int ii = 0; ii < boneCount; ii++) {
@@ -70,7 +71,7 @@ BaseSkeleton::BaseSkeleton (SkeletonData *data) :
 	slots.reserve(slotCount);
 	drawOrder.reserve(slotCount);
 	for (int i = 0; i < slotCount; i++) {
-		SlotData *slotData = data->slots[i];
+		const SlotData *slotData = data->slots[i];
 		// Find bone for the slotData's boneData.
 		Bone *bone;
 		for (int ii = 0; ii < boneCount; ii++) {
@@ -93,6 +94,8 @@ BaseSkeleton::~BaseSkeleton () {
 }
 
 void BaseSkeleton::updateWorldTransform () {
+	SPINE_SCOPE("BaseSkeleton::updateWorldTransform");
+	SPINE_COUNT(bonesUpdated, bones.size());
 	for (int i = 0, n = bones.size(); i < n; i++)
 		bones[i]->updateWorldTransform(flipX, flipY);
 }
@@ -147,7 +150,7 @@ void BaseSkeleton::setSkin (const string &skinName) {
 	setSkin(skin);
 }
 
-void BaseSkeleton::setSkin (Skin *newSkin) {
+void BaseSkeleton::setSkin (const Skin *newSkin) {
 	if (skin && newSkin) newSkin->attachAll(this, skin);
 	skin = newSkin;
 }
@@ -156,7 +159,8 @@ Attachment* BaseSkeleton::getAttachment (const string &slotName, const string &a
 	return getAttachment(data->findSlotIndex(slotName), attachmentName);
 }
 
-Attachment* BaseSkeleton::getAttachment (int slotIndex, const string &attachmentName) const {
+template<class Name>
+static Attachment* findAttachment (const Skin *skin, const SkeletonData *data, int slotIndex, const Name &attachmentName) {
 	if (skin) return skin->getAttachment(slotIndex, attachmentName);
 	if (data->defaultSkin) {
 		Attachment *attachment = data->defaultSkin->getAttachment(slotIndex, attachmentName);
@@ -165,6 +169,14 @@ Attachment* BaseSkeleton::getAttachment (int slotIndex, const string &attachment
 	return 0;
 }
 
+Attachment* BaseSkeleton::getAttachment (int slotIndex, const string &attachmentName) const {
+	return findAttachment(skin, data, slotIndex, attachmentName);
+}
+
+Attachment* BaseSkeleton::getAttachment (int slotIndex, const String &attachmentName) const {
+	return findAttachment(skin, data, slotIndex, attachmentName);
+}
+
 void BaseSkeleton::setAttachment (const string &slotName, const string &attachmentName) {
 	for (int i = 0, n = slots.size(); i < n; i++) {
 		Slot *slot = slots[i];
@@ -180,4 +192,12 @@ void BaseSkeleton::update (float deltaTime) {
 	time += deltaTime;
 }
 
+SkeletonMemoryUsage BaseSkeleton::memoryUsage () const {
+	SkeletonMemoryUsage usage;
+	usage.instance.add(objectMemory, sizeof(BaseSkeleton) + bones.size() * sizeof(Bone) + slots.size() * sizeof(Slot));
+	usage.instance.add(arrayMemory, (bones.capacity() + slots.capacity() + drawOrder.capacity()) * sizeof(void*));
+	usage.shared = data->memoryUsage();
+	return usage;
+}
+
 } /* namespace spine */
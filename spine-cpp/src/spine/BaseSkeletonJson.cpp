@@ -36,6 +36,7 @@
 #include <spine/SlotData.h>
 #include <spine/Skin.h>
 #include <spine/Animation.h>
+#include <spine/Instrumentation.h>
 
 using std::string;
 using std::vector;
@@ -86,68 +87,31 @@ SkeletonData* BaseSkeletonJson::readSkeletonData (std::istream &input) const {
 SkeletonData* BaseSkeletonJson::readSkeletonData (const char *begin, const char *end) const {
 	if (!begin) throw invalid_argument("begin cannot be null.");
 	if (!end) throw invalid_argument("end cannot be null.");
+	SPINE_SCOPE("BaseSkeletonJson::readSkeletonData");
 
-	static string const ATTACHMENT_REGION = "region";
-	static string const ATTACHMENT_REGION_SEQUENCE = "regionSequence";
-
-	Json::Value root;
+	Json::ValueArena arena;
+	Json::Value document;
 	Json::Reader reader;
-	if (!reader.parse(begin, end, root)) throw runtime_error("Error parsing skeleton JSON.\n" + reader.getFormatedErrorMessages());
+	if (!reader.parse(begin, end, arena, document))
+		throw runtime_error("Error parsing skeleton JSON.\n" + reader.getFormatedErrorMessages());
+	const Json::Value &root = document;
 
 	SkeletonData *skeletonData = new SkeletonData();
 
-	Json::Value bones = root["bones"];
+	const Json::Value &bones = root["bones"];
 	skeletonData->bones.reserve(bones.size());
-	for (int i = 0, n = bones.size(); i < n; ++i) {
-		Json::Value boneMap = bones[i];
-		string boneName = boneMap["name"].asString();
-
-		BoneData *boneData = new BoneData(boneName);
-		if (boneMap.isMember("parent")) {
-			boneData->parent = skeletonData->findBone(boneMap["parent"].asString());
-			if (!boneData->parent) throw runtime_error("Parent bone not found: " + boneName);
-		}
-
-		boneData->length = (float)(boneMap.get("length", 0).asDouble() * scale);
-		boneData->x = (float)(boneMap.get("x", 0).asDouble() * scale);
-		boneData->y = (float)(boneMap.get("y", 0).asDouble() * scale);
-		boneData->rotation = (float)(boneMap.get("rotation", 0).asDouble());
-		boneData->scaleX = (float)(boneMap.get("scaleX", 1).asDouble());
-		boneData->scaleY = (float)(boneMap.get("scaleY", 1).asDouble());
-		boneData->yDown = yDown;
+	for (int i = 0, n = bones.size(); i < n; ++i)
+		skeletonData->bones.push_back(readBone(skeletonData, bones[i]));
 
-		skeletonData->bones.push_back(boneData);
-	}
-
-	Json::Value slots = root["slots"];
+	const Json::Value &slots = root["slots"];
 	if (!slots.isNull()) {
 		skeletonData->slots.reserve(slots.size());
-		for (int i = 0, n = slots.size(); i < n; ++i) {
-			Json::Value slotMap = slots[i];
-			string slotName = slotMap["name"].asString();
-
-			string boneName = slotMap["bone"].asString();
-			BoneData* boneData = skeletonData->findBone(boneName);
-			if (!boneData) throw runtime_error("Slot bone not found: " + boneName);
-
-			SlotData *slotData = new SlotData(slotName, boneData);
-
-			if (slotMap.isMember("color")) {
-				string s = slotMap["color"].asString();
-				slotData->r = toColor(s, 0);
-				slotData->g = toColor(s, 1);
-				slotData->b = toColor(s, 2);
-				slotData->a = toColor(s, 3);
-			}
-
-			if (slotMap.isMember("attachment")) slotData->attachmentName = new string(slotMap["attachment"].asString());
-
-			skeletonData->slots.push_back(slotData);
-		}
+		for (int i = 0, n = slots.size(); i < n; ++i)
+			skeletonData->slots.push_back(readSlot(skeletonData, slots[i]));
 	}
 
 	if (root.isMember("skins")) {
-		Json::Value skinsMap = root["skins"];
+		const Json::Value &skinsMap = root["skins"];
 		vector<string> skinNames = skinsMap.getMemberNames();
 		skeletonData->skins.reserve(skinNames.size());
 		for (int i = 0, n = skinNames.size(); i < n; i++) {
@@ -156,43 +120,17 @@ SkeletonData* BaseSkeletonJson::readSkeletonData (const char *begin, const char
 			skeletonData->skins.push_back(skin);
 			if (skinName == "default") skeletonData->defaultSkin = skin;
 
-			Json::Value slotMap = skinsMap[skinName];
+			const Json::Value &slotMap = skinsMap[skinName];
 			vector<string> slotNames = slotMap.getMemberNames();
 			for (int i = 0, n = slotNames.size(); i < n; i++) {
 				string slotName = slotNames[i];
 				int slotIndex = skeletonData->findSlotIndex(slotName);
 
-				Json::Value attachmentsMap = slotMap[slotName];
+				const Json::Value &attachmentsMap = slotMap[slotName];
 				vector<string> attachmentNames = attachmentsMap.getMemberNames();
 				for (int i = 0, n = attachmentNames.size(); i < n; i++) {
 					string attachmentName = attachmentNames[i];
-					Json::Value attachmentMap = attachmentsMap[attachmentName];
-
-					AttachmentType type;
-					string typeString = attachmentMap.get("type", ATTACHMENT_REGION).asString();
-					if (typeString == ATTACHMENT_REGION)
-						type = region;
-					else if (typeString == ATTACHMENT_REGION_SEQUENCE)
-						type = regionSequence;
-					else
-						throw runtime_error("Unknown attachment type: " + typeString + " (" + attachmentName + ")");
-
-					Attachment* attachment = attachmentLoader->newAttachment(type,
-							attachmentMap.get("name", attachmentName).asString());
-
-					if (type == region || type == regionSequence) {
-						BaseRegionAttachment *regionAttachment = reinterpret_cast<BaseRegionAttachment*>(attachment);
-						regionAttachment->x = (float)(attachmentMap.get("x", 0).asDouble() * scale);
-						regionAttachment->y = (float)(attachmentMap.get("y", 0).asDouble() * scale);
-						regionAttachment->scaleX = (float)(attachmentMap.get("scaleX", 1).asDouble());
-						regionAttachment->scaleY = (float)(attachmentMap.get("scaleY", 1).asDouble());
-						regionAttachment->rotation = (float)(attachmentMap.get("rotation", 0).asDouble());
-						regionAttachment->width = (float)(attachmentMap.get("width", 32).asDouble() * scale);
-						regionAttachment->height = (float)(attachmentMap.get("height", 32).asDouble() * scale);
-						regionAttachment->updateOffset();
-					}
-
-					skin->addAttachment(slotIndex, attachmentName, attachment);
+					skin->addAttachment(slotIndex, attachmentName, readAttachment(attachmentName, attachmentsMap[attachmentName]));
 				}
 			}
 		}
@@ -201,6 +139,78 @@ SkeletonData* BaseSkeletonJson::readSkeletonData (const char *begin, const char
 	return skeletonData;
 }
 
+BoneData* BaseSkeletonJson::readBone (const SkeletonData *skeletonData, const Json::Value &boneMap) const {
+	string boneName = boneMap["name"].asString();
+
+	BoneData *boneData = new BoneData(boneName);
+	if (boneMap.isMember("parent")) {
+		boneData->parent = skeletonData->findBone(boneMap["parent"].asString());
+		if (!boneData->parent) {
+			delete boneData;
+			throw runtime_error("Parent bone not found: " + boneName);
+		}
+	}
+
+	boneData->length = (float)(boneMap.get("length", 0).asDouble() * scale);
+	boneData->x = (float)(boneMap.get("x", 0).asDouble() * scale);
+	boneData->y = (float)(boneMap.get("y", 0).asDouble() * scale);
+	boneData->rotation = (float)(boneMap.get("rotation", 0).asDouble());
+	boneData->scaleX = (float)(boneMap.get("scaleX", 1).asDouble());
+	boneData->scaleY = (float)(boneMap.get("scaleY", 1).asDouble());
+	boneData->yDown = yDown;
+	return boneData;
+}
+
+SlotData* BaseSkeletonJson::readSlot (const SkeletonData *skeletonData, const Json::Value &slotMap) const {
+	string slotName = slotMap["name"].asString();
+
+	string boneName = slotMap["bone"].asString();
+	BoneData* boneData = skeletonData->findBone(boneName);
+	if (!boneData) throw runtime_error("Slot bone not found: " + boneName);
+
+	SlotData *slotData = new SlotData(slotName, boneData);
+
+	if (slotMap.isMember("color")) {
+		string s = slotMap["color"].asString();
+		slotData->r = toColor(s, 0);
+		slotData->g = toColor(s, 1);
+		slotData->b = toColor(s, 2);
+		slotData->a = toColor(s, 3);
+	}
+
+	if (slotMap.isMember("attachment")) slotData->attachmentName = new String(slotMap["attachment"].asString());
+	return slotData;
+}
+
+Attachment* BaseSkeletonJson::readAttachment (const string &attachmentName, const Json::Value &attachmentMap) const {
+	static string const ATTACHMENT_REGION = "region";
+	static string const ATTACHMENT_REGION_SEQUENCE = "regionSequence";
+
+	AttachmentType type;
+	string typeString = attachmentMap.get("type", ATTACHMENT_REGION).asString();
+	if (typeString == ATTACHMENT_REGION)
+		type = region;
+	else if (typeString == ATTACHMENT_REGION_SEQUENCE)
+		type = regionSequence;
+	else
+		throw runtime_error("Unknown attachment type: " + typeString + " (" + attachmentName + ")");
+
+	Attachment* attachment = attachmentLoader->newAttachment(type, attachmentMap.get("name", attachmentName).asString());
+
+	if (type == region || type == regionSequence) {
+		BaseRegionAttachment *regionAttachment = reinterpret_cast<BaseRegionAttachment*>(attachment);
+		regionAttachment->x = (float)(attachmentMap.get("x", 0).asDouble() * scale);
+		regionAttachment->y = (float)(attachmentMap.get("y", 0).asDouble() * scale);
+		regionAttachment->scaleX = (float)(attachmentMap.get("scaleX", 1).asDouble());
+		regionAttachment->scaleY = (float)(attachmentMap.get("scaleY", 1).asDouble());
+		regionAttachment->rotation = (float)(attachmentMap.get("rotation", 0).asDouble());
+		regionAttachment->width = (float)(attachmentMap.get("width", 32).asDouble() * scale);
+		regionAttachment->height = (float)(attachmentMap.get("height", 32).asDouble() * scale);
+		regionAttachment->updateOffset();
+	}
+	return attachment;
+}
+
 Animation* BaseSkeletonJson::readAnimation (const string &path, const SkeletonData *skeletonData) const {
 	std::ifstream file(path.c_str());
 	if (!file) throw std::invalid_argument("Error reading animation file: " + path);
@@ -218,7 +228,7 @@ Animation* BaseSkeletonJson::readAnimation (std::istream &input, const SkeletonD
 }
 
 static void readCurve (CurveTimeline *timeline, int keyframeIndex, const Json::Value &valueMap) {
-	Json::Value curve = valueMap["curve"];
+	const Json::Value &curve = valueMap["curve"];
 	if (curve.isNull()) return;
 	if (curve.isString() && curve.asString() == "stepped")
 		timeline->setStepped(keyframeIndex);
@@ -231,82 +241,34 @@ Animation* BaseSkeletonJson::readAnimation (const char *begin, const char *end,
 	if (!begin) throw invalid_argument("begin cannot be null.");
 	if (!end) throw invalid_argument("end cannot be null.");
 	if (!skeletonData) throw invalid_argument("skeletonData cannot be null.");
-
-	static string const TIMELINE_SCALE = "scale";
-	static string const TIMELINE_ROTATE = "rotate";
-	static string const TIMELINE_TRANSLATE = "translate";
-	static string const TIMELINE_ATTACHMENT = "attachment";
-	static string const TIMELINE_COLOR = "color";
+	SPINE_SCOPE("BaseSkeletonJson::readAnimation");
 
 	vector<Timeline*> timelines;
 	float duration = 0;
 
-	Json::Value root;
+	Json::ValueArena arena;
+	Json::Value document;
 	Json::Reader reader;
-	if (!reader.parse(begin, end, root))
+	if (!reader.parse(begin, end, arena, document))
 		throw runtime_error("Error parsing animation JSON.\n" + reader.getFormatedErrorMessages());
+	const Json::Value &root = document;
 
-	Json::Value bones = root["bones"];
+	const Json::Value &bones = root["bones"];
 	vector<string> boneNames = bones.getMemberNames();
 	for (int i = 0, n = boneNames.size(); i < n; i++) {
 		string boneName = boneNames[i];
 		int boneIndex = skeletonData->findBoneIndex(boneName);
 		if (boneIndex == -1) throw runtime_error("Bone not found: " + boneName);
 
-		Json::Value timelineMap = bones[boneName];
+		const Json::Value &timelineMap = bones[boneName];
 		vector<string> timelineNames = timelineMap.getMemberNames();
 		for (int i = 0, n = timelineNames.size(); i < n; i++) {
 			string timelineName = timelineNames[i];
-			Json::Value values = timelineMap[timelineName];
-
-			if (timelineName == TIMELINE_ROTATE) {
-				RotateTimeline *timeline = new RotateTimeline(values.size());
-				timeline->boneIndex = boneIndex;
-
-				int keyframeIndex = 0;
-				for (int i = 0, n = values.size(); i < n; i++) {
-					Json::Value valueMap = values[i];
-
-					float time = (float)valueMap["time"].asDouble();
-					timeline->setKeyframe(keyframeIndex, time, (float)valueMap["angle"].asDouble());
-					readCurve(timeline, keyframeIndex, valueMap);
-					keyframeIndex++;
-				}
-				timelines.push_back(timeline);
-				duration = max(duration, timeline->frames[values.size() * 2 - 2]);
-
-			} else if (timelineName == TIMELINE_TRANSLATE || timelineName == TIMELINE_SCALE) {
-				TranslateTimeline *timeline;
-				float timelineScale = 1;
-				if (timelineName == TIMELINE_SCALE)
-					timeline = new ScaleTimeline(values.size());
-				else {
-					timeline = new TranslateTimeline(values.size());
-					timelineScale = scale;
-				}
-				timeline->boneIndex = boneIndex;
-
-				int keyframeIndex = 0;
-				for (int i = 0, n = values.size(); i < n; i++) {
-					Json::Value valueMap = values[i];
-
-					timeline->setKeyframe(keyframeIndex, //
-							(float)valueMap["time"].asDouble(), //
-							(float)valueMap.get("x", 0).asDouble() * timelineScale, //
-							(float)valueMap.get("y", 0).asDouble() * timelineScale);
-					readCurve(timeline, keyframeIndex, valueMap);
-					keyframeIndex++;
-				}
-				timelines.push_back(timeline);
-				duration = max(duration, timeline->frames[values.size() * 3 - 3]);
-
-			} else {
-				throw runtime_error("Invalid timeline type for a bone: " + timelineName + " (" + boneName + ")");
-			}
+			timelines.push_back(readBoneTimeline(boneIndex, boneName, timelineName, timelineMap[timelineName], duration));
 		}
 	}
 
-	Json::Value slots = root["slots"];
+	const Json::Value &slots = root["slots"];
 	if (!slots.isNull()) {
 		vector<string> slotNames = slots.getMemberNames();
 		for (int i = 0, n = slotNames.size(); i < n; i++) {
@@ -314,47 +276,11 @@ Animation* BaseSkeletonJson::readAnimation (const char *begin, const char *end,
 			int slotIndex = skeletonData->findSlotIndex(slotName);
 			if (slotIndex == -1) throw runtime_error("Slot not found: " + slotName);
 
-			Json::Value timelineMap = slots[slotName];
+			const Json::Value &timelineMap = slots[slotName];
 			vector<string> timelineNames = timelineMap.getMemberNames();
 			for (int i = 0, n = timelineNames.size(); i < n; i++) {
 				string timelineName = timelineNames[i];
-				Json::Value values = timelineMap[timelineName];
-
-				if (timelineName == TIMELINE_COLOR) {
-					ColorTimeline *timeline = new ColorTimeline(values.size());
-					timeline->slotIndex = slotIndex;
-
-					int keyframeIndex = 0;
-					for (int i = 0, n = values.size(); i < n; i++) {
-						Json::Value valueMap = values[i];
-
-						string s = valueMap["color"].asString();
-						timeline->setKeyframe(keyframeIndex, (float)valueMap["time"].asDouble(), //
-								toColor(s, 0), toColor(s, 1), toColor(s, 2), toColor(s, 3));
-						readCurve(timeline, keyframeIndex, valueMap);
-						keyframeIndex++;
-					}
-					timelines.push_back(timeline);
-					duration = max(duration, timeline->frames[values.size() * 5 - 5]);
-
-				} else if (timelineName == TIMELINE_ATTACHMENT) {
-					AttachmentTimeline *timeline = new AttachmentTimeline(values.size());
-					timeline->slotIndex = slotIndex;
-
-					int keyframeIndex = 0;
-					for (int i = 0, n = values.size(); i < n; i++) {
-						Json::Value valueMap = values[i];
-
-						Json::Value nameValue = valueMap["name"];
-						timeline->setKeyframe(keyframeIndex++, (float)valueMap["time"].asDouble(),
-								nameValue.isNull() ? 0 : new string(nameValue.asString()));
-					}
-					timelines.push_back(timeline);
-					duration = max(duration, timeline->frames[values.size() - 1]);
-
-				} else {
-					throw runtime_error("Invalid timeline type for a slot: " + timelineName + " (" + slotName + ")");
-				}
+				timelines.push_back(readSlotTimeline(slotIndex, slotName, timelineName, timelineMap[timelineName], duration));
 			}
 		}
 	}
@@ -363,4 +289,98 @@ Animation* BaseSkeletonJson::readAnimation (const char *begin, const char *end,
 	return animation;
 }
 
+Timeline* BaseSkeletonJson::readBoneTimeline (int boneIndex, const string &boneName, const string &timelineName,
+		const Json::Value &values, float &duration) const {
+	static string const TIMELINE_SCALE = "scale";
+	static string const TIMELINE_ROTATE = "rotate";
+	static string const TIMELINE_TRANSLATE = "translate";
+
+	if (timelineName == TIMELINE_ROTATE) {
+		RotateTimeline *timeline = new RotateTimeline(values.size());
+		timeline->boneIndex = boneIndex;
+
+		int keyframeIndex = 0;
+		for (int i = 0, n = values.size(); i < n; i++) {
+			const Json::Value &valueMap = values[i];
+
+			float time = (float)valueMap["time"].asDouble();
+			timeline->setKeyframe(keyframeIndex, time, (float)valueMap["angle"].asDouble());
+			readCurve(timeline, keyframeIndex, valueMap);
+			keyframeIndex++;
+		}
+		duration = max(duration, timeline->frames[values.size() * 2 - 2]);
+		return timeline;
+	}
+
+	if (timelineName == TIMELINE_TRANSLATE || timelineName == TIMELINE_SCALE) {
+		TranslateTimeline *timeline;
+		float timelineScale = 1;
+		if (timelineName == TIMELINE_SCALE)
+			timeline = new ScaleTimeline(values.size());
+		else {
+			timeline = new TranslateTimeline(values.size());
+			timelineScale = scale;
+		}
+		timeline->boneIndex = boneIndex;
+
+		int keyframeIndex = 0;
+		for (int i = 0, n = values.size(); i < n; i++) {
+			const Json::Value &valueMap = values[i];
+
+			timeline->setKeyframe(keyframeIndex, //
+					(float)valueMap["time"].asDouble(), //
+					(float)valueMap.get("x", 0).asDouble() * timelineScale, //
+					(float)valueMap.get("y", 0).asDouble() * timelineScale);
+			readCurve(timeline, keyframeIndex, valueMap);
+			keyframeIndex++;
+		}
+		duration = max(duration, timeline->frames[values.size() * 3 - 3]);
+		return timeline;
+	}
+
+	throw runtime_error("Invalid timeline type for a bone: " + timelineName + " (" + boneName + ")");
+}
+
+Timeline* BaseSkeletonJson::readSlotTimeline (int slotIndex, const string &slotName, const string &timelineName,
+		const Json::Value &values, float &duration) const {
+	static string const TIMELINE_ATTACHMENT = "attachment";
+	static string const TIMELINE_COLOR = "color";
+
+	if (timelineName == TIMELINE_COLOR) {
+		ColorTimeline *timeline = new ColorTimeline(values.size());
+		timeline->slotIndex = slotIndex;
+
+		int keyframeIndex = 0;
+		for (int i = 0, n = values.size(); i < n; i++) {
+			const Json::Value &valueMap = values[i];
+
+			string s = valueMap["color"].asString();
+			timeline->setKeyframe(keyframeIndex, (float)valueMap["time"].asDouble(), //
+					toColor(s, 0), toColor(s, 1), toColor(s, 2), toColor(s, 3));
+			readCurve(timeline, keyframeIndex, valueMap);
+			keyframeIndex++;
+		}
+		duration = max(duration, timeline->frames[values.size() * 5 - 5]);
+		return timeline;
+	}
+
+	if (timelineName == TIMELINE_ATTACHMENT) {
+		AttachmentTimeline *timeline = new AttachmentTimeline(values.size());
+		timeline->slotIndex = slotIndex;
+
+		int keyframeIndex = 0;
+		for (int i = 0, n = values.size(); i < n; i++) {
+			const Json::Value &valueMap = values[i];
+
+			const Json::Value &nameValue = valueMap["name"];
+			timeline->setKeyframe(keyframeIndex++, (float)valueMap["time"].asDouble(),
+					nameValue.isNull() ? 0 : new String(nameValue.asString()));
+		}
+		duration = max(duration, timeline->frames[values.size() - 1]);
+		return timeline;
+	}
+
+	throw runtime_error("Invalid timeline type for a slot: " + timelineName + " (" + slotName + ")");
+}
+
 } /* namespace spine */
@@ -34,7 +34,7 @@
 
 namespace spine {
 
-Bone::Bone (BoneData *data) :
+Bone::Bone (const BoneData *data) :
 				data(data),
 				parent(0),
 				x(data->x),
@@ -0,0 +1,81 @@
+/*******************************************************************************
+ * Copyright (c) 2013, Esoteric Software
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ******************************************************************************/
+
+#include <spine/HeadlessRegionAttachment.h>
+#include <spine/BaseAtlas.h>
+#include <spine/Bone.h>
+#include <spine/Slot.h>
+
+namespace spine {
+
+HeadlessRegionAttachment::HeadlessRegionAttachment (const BaseAtlasRegion *region) {
+	for (int i = 0; i < 8; i++) {
+		vertices[i] = 0;
+		uvs[i] = 0;
+	}
+	if (!region) return;
+	float u = region->u, v = region->v, u2 = region->u2, v2 = region->v2;
+	if (region->rotate) {
+		uvs[0] = u2;
+		uvs[1] = v2;
+		uvs[2] = u;
+		uvs[3] = v2;
+		uvs[4] = u;
+		uvs[5] = v;
+		uvs[6] = u2;
+		uvs[7] = v;
+	} else {
+		uvs[0] = u;
+		uvs[1] = v2;
+		uvs[2] = u;
+		uvs[3] = v;
+		uvs[4] = u2;
+		uvs[5] = v;
+		uvs[6] = u2;
+		uvs[7] = v2;
+	}
+}
+
+void HeadlessRegionAttachment::computeWorldVertices (const Bone *bone, float *worldVertices) const {
+	for (int i = 0; i < 8; i += 2) {
+		worldVertices[i] = offset[i] * bone->m00 + offset[i + 1] * bone->m01 + bone->worldX;
+		worldVertices[i + 1] = offset[i] * bone->m10 + offset[i + 1] * bone->m11 + bone->worldY;
+	}
+}
+
+void HeadlessRegionAttachment::updateWorldVertices (Bone *bone) {
+	computeWorldVertices(bone, vertices);
+}
+
+void HeadlessRegionAttachment::draw (Slot *slot) {
+	computeWorldVertices(slot->bone, vertices);
+}
+
+void HeadlessRegionAttachment::addMemoryUsage (MemoryUsage &usage) const {
+	usage.add(objectMemory, sizeof(HeadlessRegionAttachment));
+	usage.addCharacters(name);
+}
+
+} /* namespace spine */
@@ -0,0 +1,64 @@
+/*******************************************************************************
+ * Copyright (c) 2013, Esoteric Software
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ******************************************************************************/
+
+#include <spine/HeadlessSkeleton.h>
+#include <spine/HeadlessRegionAttachment.h>
+#include <spine/Slot.h>
+#include <spine/Instrumentation.h>
+
+namespace spine {
+
+HeadlessSkeleton::HeadlessSkeleton (const SkeletonData *data) :
+				BaseSkeleton(data) {
+	vertices.reserve(slots.size() * 8);
+}
+
+void HeadlessSkeleton::draw () {
+	SPINE_SCOPE("HeadlessSkeleton::draw");
+	vertices.resize(slots.size() * 8);
+	int count = 0;
+	for (int i = 0, n = drawOrder.size(); i < n; i++) {
+		const Slot *slot = drawOrder[i];
+		const HeadlessRegionAttachment *attachment = dynamic_cast<const HeadlessRegionAttachment*>(slot->attachment);
+		if (!attachment) continue;
+		attachment->computeWorldVertices(slot->bone, &vertices[count * 8]);
+		count++;
+	}
+	vertices.resize(count * 8);
+	SPINE_COUNT(quadsEmitted, count);
+}
+
+int HeadlessSkeleton::getQuadCount () const {
+	return vertices.size() / 8;
+}
+
+SkeletonMemoryUsage HeadlessSkeleton::memoryUsage () const {
+	SkeletonMemoryUsage usage = BaseSkeleton::memoryUsage();
+	usage.instance.add(objectMemory, sizeof(HeadlessSkeleton) - sizeof(BaseSkeleton));
+	usage.instance.add(arrayMemory, vertices.capacity() * sizeof(float));
+	return usage;
+}
+
+} /* namespace spine */
@@ -0,0 +1,493 @@
+/*******************************************************************************
+ * Copyright (c) 2013, Esoteric Software
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ******************************************************************************/
+
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <json/json.h>
+#include <spine/IncrementalLoader.h>
+#include <spine/BaseAtlas.h>
+#include <spine/BaseSkeletonJson.h>
+#include <spine/SkeletonData.h>
+#include <spine/Skin.h>
+#include <spine/Animation.h>
+
+using std::string;
+using std::vector;
+using std::function;
+using std::runtime_error;
+using std::invalid_argument;
+
+namespace spine {
+
+/** The number of bytes read from a file per unit of work. */
+static const int BLOCK_SIZE = 64 * 1024;
+
+/** Fractions of a load's progress at which reading the file and parsing it are complete. */
+static const float READ_PROGRESS = 0.3f;
+static const float PARSE_PROGRESS = 0.5f;
+
+class IncrementalLoader::Load {
+public:
+	virtual ~Load () {
+	}
+
+	/** Runs one unit of work. Throws if loading fails.
+	 * @return True if the load is complete. */
+	virtual bool step () = 0;
+
+	/** Passes the loaded object to the callback, which then owns it. */
+	virtual void complete () = 0;
+
+	/** Discards anything partially loaded and calls the callback with 0 and the error. */
+	virtual void fail (std::exception_ptr error) = 0;
+
+	virtual float getProgress () const = 0;
+};
+
+/** Reads the file a block at a time, then parses it. */
+class IncrementalLoader::FileLoad: public Load {
+public:
+	FileLoad (const string &path) :
+					path(path),
+					size(0),
+					opened(false),
+					parsed(false) {
+	}
+
+	virtual bool step () {
+		if (!opened) {
+			file.open(path.c_str(), std::ios::in | std::ios::binary);
+			if (!file) throw invalid_argument("Error reading file: " + path);
+			file.seekg(0, std::ios::end);
+			size = (size_t)file.tellg();
+			file.seekg(0, std::ios::beg);
+			data.reserve(size);
+			opened = true;
+			return false;
+		}
+		if (file.is_open()) {
+			char buffer[BLOCK_SIZE];
+			file.read(buffer, BLOCK_SIZE);
+			data.append(buffer, (size_t)file.gcount());
+			if (file.eof())
+				file.close();
+			else if (!file)
+				throw runtime_error("Error reading file: " + path);
+			return false;
+		}
+		if (!parsed) {
+			parse(data.data(), data.data() + data.length());
+			string().swap(data);
+			parsed = true;
+			return false;
+		}
+		return stepParsed();
+	}
+
+	virtual float getProgress () const {
+		if (parsed) return PARSE_PROGRESS + (1 - PARSE_PROGRESS) * getParsedProgress();
+		if (!file.is_open() && opened) return READ_PROGRESS;
+		return size ? READ_PROGRESS * data.length() / size : 0;
+	}
+
+protected:
+	string path;
+
+	/** Called once with the whole file. */
+	virtual void parse (const char *begin, const char *end) = 0;
+	/** Runs one unit of work after parsing. */
+	virtual bool stepParsed () = 0;
+	/** Returns the progress after parsing, from 0 to 1. */
+	virtual float getParsedProgress () const = 0;
+
+	static void parseJson (const char *begin, const char *end, Json::Value &root, const string &path) {
+		Json::Reader reader;
+		if (!reader.parse(begin, end, root))
+			throw runtime_error("Error parsing JSON: " + path + "\n" + reader.getFormatedErrorMessages());
+	}
+
+private:
+	std::ifstream file;
+	string data;
+	size_t size;
+	bool opened;
+	bool parsed;
+};
+
+//
+
+class IncrementalLoader::SkeletonDataLoad: public FileLoad {
+public:
+	SkeletonDataLoad (const BaseSkeletonJson *json, const string &path,
+			const function<void(SkeletonData*, std::exception_ptr)> &callback) :
+					FileLoad(path),
+					json(json),
+					callback(callback),
+					skeletonData(0),
+					state(bones),
+					index(0),
+					skinIndex(0),
+					itemCount(0),
+					itemsRead(0) {
+	}
+
+	virtual ~SkeletonDataLoad () {
+		delete skeletonData;
+	}
+
+	virtual void complete () {
+		SkeletonData *result = skeletonData;
+		skeletonData = 0;
+		if (callback) callback(result, std::exception_ptr());
+	}
+
+	virtual void fail (std::exception_ptr error) {
+		delete skeletonData;
+		skeletonData = 0;
+		if (callback) callback(0, error);
+	}
+
+protected:
+	virtual void parse (const char *begin, const char *end) {
+		parseJson(begin, end, root, path);
+		skeletonData = new SkeletonData();
+		bonesMap = root["bones"];
+		slotsMap = root["slots"];
+		skinsMap = root["skins"];
+		if (skinsMap.isObject()) skinNames = skinsMap.getMemberNames();
+		skeletonData->bones.reserve(bonesMap.size());
+		skeletonData->slots.reserve(slotsMap.size());
+		skeletonData->skins.reserve(skinNames.size());
+		itemCount = bonesMap.size() + slotsMap.size() + skinNames.size();
+	}
+
+	virtual bool stepParsed () {
+		switch (state) {
+		case bones:
+			if (index < (int)bonesMap.size()) {
+				skeletonData->bones.push_back(json->readBone(skeletonData, bonesMap[index++]));
+				itemsRead++;
+				return false;
+			}
+			state = slots;
+			index = 0;
+			// Fall through.
+		case slots:
+			if (index < (int)slotsMap.size()) {
+				skeletonData->slots.push_back(json->readSlot(skeletonData, slotsMap[index++]));
+				itemsRead++;
+				return false;
+			}
+			state = skins;
+			index = 0;
+			// Fall through.
+		case skins:
+			if (index < (int)attachments.size()) {
+				// One attachment of the current skin.
+				SkinAttachment &entry = attachments[index++];
+				Skin *skin = skeletonData->skins.back();
+				skin->addAttachment(entry.slotIndex, entry.name, json->readAttachment(entry.name, *entry.map));
+				return false;
+			}
+			if (skinIndex < (int)skinNames.size()) {
+				beginSkin(skinNames[skinIndex++]);
+				itemsRead++;
+				return false;
+			}
+		}
+		return true;
+	}
+
+	virtual float getParsedProgress () const {
+		return itemCount ? (float)itemsRead / itemCount : 1;
+	}
+
+private:
+	enum State {
+		bones, slots, skins
+	};
+
+	struct SkinAttachment {
+		int slotIndex;
+		string name;
+		const Json::Value *map;
+	};
+
+	const BaseSkeletonJson *json;
+	function<void(SkeletonData*, std::exception_ptr)> callback;
+	SkeletonData *skeletonData;
+	Json::Value root, bonesMap, slotsMap, skinsMap;
+	vector<string> skinNames;
+	vector<SkinAttachment> attachments;
+	State state;
+	int index, skinIndex;
+	int itemCount, itemsRead;
+
+	/** Creates the skin and collects its attachments, which are then read one per unit of work. */
+	void beginSkin (const string &skinName) {
+		Skin *skin = new Skin(skinName);
+		skeletonData->skins.push_back(skin);
+		if (skinName == "default") skeletonData->defaultSkin = skin;
+
+		attachments.clear();
+		index = 0;
+		const Json::Value &slotMap = skinsMap[skinName];
+		vector<string> slotNames = slotMap.getMemberNames();
+		for (int i = 0, n = slotNames.size(); i < n; i++) {
+			const Json::Value &attachmentsMap = slotMap[slotNames[i]];
+			int slotIndex = skeletonData->findSlotIndex(slotNames[i]);
+			vector<string> attachmentNames = attachmentsMap.getMemberNames();
+			for (int ii = 0, nn = attachmentNames.size(); ii < nn; ii++) {
+				SkinAttachment entry;
+				entry.slotIndex = slotIndex;
+				entry.name = attachmentNames[ii];
+				entry.map = &attachmentsMap[attachmentNames[ii]];
+				attachments.push_back(entry);
+			}
+		}
+	}
+};
+
+//
+
+class IncrementalLoader::AnimationLoad: public FileLoad {
+public:
+	AnimationLoad (const BaseSkeletonJson *json, const string &path, const SkeletonData *skeletonData,
+			const function<void(Animation*, std::exception_ptr)> &callback) :
+					FileLoad(path),
+					json(json),
+					skeletonData(skeletonData),
+					callback(callback),
+					duration(0),
+					index(0) {
+	}
+
+	virtual ~AnimationLoad () {
+		deleteTimelines();
+	}
+
+	virtual void complete () {
+		Animation *animation = new Animation(timelines, duration);
+		timelines.clear();
+		if (callback) callback(animation, std::exception_ptr());
+	}
+
+	virtual void fail (std::exception_ptr error) {
+		deleteTimelines();
+		if (callback) callback(0, error);
+	}
+
+protected:
+	virtual void parse (const char *begin, const char *end) {
+		parseJson(begin, end, root, path);
+		addEntries(root["bones"], false);
+		addEntries(root["slots"], true);
+		timelines.reserve(entries.size());
+	}
+
+	virtual bool stepParsed () {
+		if (index == (int)entries.size()) return true;
+		TimelineEntry &entry = entries[index++];
+		if (entry.slot)
+			timelines.push_back(json->readSlotTimeline(entry.index, entry.name, entry.timelineName, *entry.values, duration));
+		else
+			timelines.push_back(json->readBoneTimeline(entry.index, entry.name, entry.timelineName, *entry.values, duration));
+		return false;
+	}
+
+	virtual float getParsedProgress () const {
+		return entries.size() ? (float)index / entries.size() : 1;
+	}
+
+private:
+	struct TimelineEntry {
+		bool slot;
+		int index;
+		string name, timelineName;
+		const Json::Value *values;
+	};
+
+	const BaseSkeletonJson *json;
+	const SkeletonData *skeletonData;
+	function<void(Animation*, std::exception_ptr)> callback;
+	Json::Value root;
+	vector<TimelineEntry> entries;
+	vector<Timeline*> timelines;
+	float duration;
+	int index;
+
+	void addEntries (const Json::Value &map, bool slot) {
+		if (map.isNull()) return;
+		vector<string> names = map.getMemberNames();
+		for (int i = 0, n = names.size(); i < n; i++) {
+			TimelineEntry entry;
+			entry.slot = slot;
+			entry.name = names[i];
+			if (slot) {
+				entry.index = skeletonData->findSlotIndex(entry.name);
+				if (entry.index == -1) throw runtime_error("Slot not found: " + entry.name);
+			} else {
+				entry.index = skeletonData->findBoneIndex(entry.name);
+				if (entry.index == -1) throw runtime_error("Bone not found: " + entry.name);
+			}
+			const Json::Value &timelineMap = map[entry.name];
+			vector<string> timelineNames = timelineMap.getMemberNames();
+			for (int ii = 0, nn = timelineNames.size(); ii < nn; ii++) {
+				entry.timelineName = timelineNames[ii];
+				entry.values = &timelineMap[entry.timelineName];
+				entries.push_back(entry);
+			}
+		}
+	}
+
+	void deleteTimelines () {
+		for (int i = 0, n = timelines.size(); i < n; i++)
+			delete timelines[i];
+		timelines.clear();
+	}
+};
+
+//
+
+class IncrementalLoader::AtlasLoad: public FileLoad {
+public:
+	AtlasLoad (const string &path, const function<BaseAtlas*(const char*, const char*)> &create,
+			const function<void(BaseAtlas*)> &destroy, const function<void(BaseAtlas*, std::exception_ptr)> &callback) :
+					FileLoad(path),
+					create(create),
+					destroy(destroy),
+					callback(callback),
+					atlas(0) {
+	}
+
+	virtual ~AtlasLoad () {
+		if (atlas) destroy(atlas);
+	}
+
+	virtual void complete () {
+		BaseAtlas *result = atlas;
+		atlas = 0;
+		callback(result, std::exception_ptr());
+	}
+
+	virtual void fail (std::exception_ptr error) {
+		if (atlas) destroy(atlas);
+		atlas = 0;
+		callback(0, error);
+	}
+
+protected:
+	virtual void parse (const char *begin, const char *end) {
+		atlas = create(begin, end);
+	}
+
+	virtual bool stepParsed () {
+		return !atlas->loadNextTexture();
+	}
+
+	virtual float getParsedProgress () const {
+		int pageCount = atlas->pages.size();
+		return pageCount ? (float)(pageCount - atlas->getPendingTextureCount()) / pageCount : 1;
+	}
+
+private:
+	function<BaseAtlas*(const char*, const char*)> create;
+	function<void(BaseAtlas*)> destroy;
+	function<void(BaseAtlas*, std::exception_ptr)> callback;
+	BaseAtlas *atlas;
+};
+
+//
+
+IncrementalLoader::IncrementalLoader () :
+				completedCount(0) {
+}
+
+IncrementalLoader::~IncrementalLoader () {
+	for (int i = 0, n = loads.size(); i < n; i++)
+		delete loads[i];
+}
+
+void IncrementalLoader::queue (Load *load) {
+	if (loads.empty()) completedCount = 0;
+	loads.push_back(load);
+}
+
+void IncrementalLoader::loadSkeletonData (const BaseSkeletonJson *json, const string &path,
+		const function<void(SkeletonData*, std::exception_ptr)> &callback) {
+	if (!json) throw invalid_argument("json cannot be null.");
+	queue(new SkeletonDataLoad(json, path, callback));
+}
+
+void IncrementalLoader::loadAnimation (const BaseSkeletonJson *json, const string &path, const SkeletonData *skeletonData,
+		const function<void(Animation*, std::exception_ptr)> &callback) {
+	if (!json) throw invalid_argument("json cannot be null.");
+	if (!skeletonData) throw invalid_argument("skeletonData cannot be null.");
+	queue(new AnimationLoad(json, path, skeletonData, callback));
+}
+
+void IncrementalLoader::loadAtlas (const string &path, const function<BaseAtlas*(const char*, const char*)> &create,
+		const function<void(BaseAtlas*)> &destroy, const function<void(BaseAtlas*, std::exception_ptr)> &callback) {
+	queue(new AtlasLoad(path, create, destroy, callback));
+}
+
+bool IncrementalLoader::step (int microseconds) {
+	typedef std::chrono::steady_clock Clock;
+	Clock::time_point deadline = Clock::now() + std::chrono::microseconds(microseconds);
+	while (!loads.empty()) {
+		Load *load = loads.front();
+		bool done;
+		try {
+			done = load->step();
+		} catch (...) {
+			loads.pop_front();
+			completedCount++;
+			std::unique_ptr<Load> owned(load);
+			load->fail(std::current_exception());
+			done = false;
+		}
+		if (done) {
+			loads.pop_front();
+			completedCount++;
+			std::unique_ptr<Load> owned(load);
+			load->complete();
+		}
+		if (Clock::now() >= deadline) break;
+	}
+	return loads.empty();
+}
+
+int IncrementalLoader::getPendingCount () const {
+	return loads.size();
+}
+
+float IncrementalLoader::getProgress () const {
+	if (loads.empty()) return 1;
+	return (completedCount + loads.front()->getProgress()) / (completedCount + loads.size());
+}
+
+} /* namespace spine */
@@ -0,0 +1,260 @@
+/*******************************************************************************
+ * Copyright (c) 2013, Esoteric Software
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ******************************************************************************/
+
+#include <spine/Instrumentation.h>
+
+#ifdef SPINE_INSTRUMENTATION
+
+#include <chrono>
+#include <cstring>
+
+namespace spine {
+
+static const char* const counterNames[counterCount] = {"timelinesApplied", "bonesUpdated", "attachmentSwaps", "quadsEmitted"};
+
+static std::atomic<InstrumentationSink*> currentSink(0);
+
+const char* getCounterName (Counter counter) {
+	return counterNames[counter];
+}
+
+void setInstrumentationSink (InstrumentationSink *sink) {
+	currentSink.store(sink, std::memory_order_release);
+}
+
+InstrumentationSink* getInstrumentationSink () {
+	return currentSink.load(std::memory_order_acquire);
+}
+
+long long getInstrumentationTime () {
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static void writeString (std::ostream &output, const char *value) {
+	output << '"';
+	for (; *value; value++) {
+		if (*value == '"' || *value == '\\') output << '\\';
+		output << *value;
+	}
+	output << '"';
+}
+
+//
+
+HistogramSink::Histogram::Histogram () :
+				count(0),
+				total(0),
+				min(0),
+				max(0) {
+	memset(buckets, 0, sizeof(buckets));
+}
+
+void HistogramSink::Histogram::add (long long duration) {
+	if (count == 0 || duration < min) min = duration;
+	if (count == 0 || duration > max) max = duration;
+	count++;
+	total += duration;
+	int bucket = 0;
+	while (bucket < BUCKET_COUNT - 1 && duration >> (bucket + 1)) bucket++;
+	buckets[bucket]++;
+}
+
+void HistogramSink::Histogram::add (const Histogram &histogram) {
+	if (!histogram.count) return;
+	if (count == 0 || histogram.min < min) min = histogram.min;
+	if (count == 0 || histogram.max > max) max = histogram.max;
+	count += histogram.count;
+	total += histogram.total;
+	for (int i = 0; i < BUCKET_COUNT; i++)
+		buckets[i] += histogram.buckets[i];
+}
+
+long long HistogramSink::Histogram::getPercentile (float fraction) const {
+	if (!count) return 0;
+	long long target = (long long)(count * fraction + 0.5f), seen = 0;
+	if (target < 1) target = 1;
+	for (int i = 0; i < BUCKET_COUNT; i++) {
+		seen += buckets[i];
+		if (seen >= target) {
+			long long bound = (2LL << i) - 1;
+			return bound < max ? bound : max;
+		}
+	}
+	return max;
+}
+
+HistogramSink::HistogramSink () {
+	for (int i = 0; i < counterCount; i++)
+		counts[i] = 0;
+}
+
+void HistogramSink::scope (const char *name, long long start, long long duration) {
+	std::lock_guard<std::mutex> lock(mutex);
+	histograms[name].add(duration);
+}
+
+void HistogramSink::count (Counter counter, int amount) {
+	counts[counter].fetch_add(amount, std::memory_order_relaxed);
+}
+
+std::map<std::string, HistogramSink::Histogram> HistogramSink::mergeHistograms () const {
+	std::map<std::string, Histogram> merged;
+	std::lock_guard<std::mutex> lock(mutex);
+	for (std::map<const char*, Histogram>::const_iterator iter = histograms.begin(); iter != histograms.end(); iter++)
+		merged[iter->first].add(iter->second);
+	return merged;
+}
+
+HistogramSink::Histogram HistogramSink::getHistogram (const std::string &name) const {
+	Histogram histogram;
+	std::lock_guard<std::mutex> lock(mutex);
+	for (std::map<const char*, Histogram>::const_iterator iter = histograms.begin(); iter != histograms.end(); iter++)
+		if (name == iter->first) histogram.add(iter->second);
+	return histogram;
+}
+
+long long HistogramSink::getCount (Counter counter) const {
+	return counts[counter].load(std::memory_order_relaxed);
+}
+
+void HistogramSink::reset () {
+	std::lock_guard<std::mutex> lock(mutex);
+	histograms.clear();
+	for (int i = 0; i < counterCount; i++)
+		counts[i] = 0;
+}
+
+void HistogramSink::write (std::ostream &output) const {
+	std::map<std::string, Histogram> merged = mergeHistograms();
+	output << "{\"scopes\":{";
+	for (std::map<std::string, Histogram>::const_iterator iter = merged.begin(); iter != merged.end(); iter++) {
+		const Histogram &histogram = iter->second;
+		if (iter != merged.begin()) output << ',';
+		writeString(output, iter->first.c_str());
+		output << ":{\"count\":" << histogram.count << ",\"total\":" << histogram.total << ",\"min\":" << histogram.min << ",\"max\":"
+				<< histogram.max << ",\"mean\":" << histogram.total / histogram.count << ",\"p50\":" << histogram.getPercentile(0.5f)
+				<< ",\"p99\":" << histogram.getPercentile(0.99f) << ",\"buckets\":[";
+		int last = BUCKET_COUNT - 1;
+		while (last > 0 && !histogram.buckets[last])
+			last--;
+		for (int i = 0; i <= last; i++)
+			output << (i ? "," : "") << histogram.buckets[i];
+		output << "]}";
+	}
+	output << "},\"counters\":{";
+	for (int i = 0; i < counterCount; i++) {
+		if (i) output << ',';
+		writeString(output, counterNames[i]);
+		output << ':' << getCount((Counter)i);
+	}
+	output << "}}\n";
+}
+
+//
+
+ChromeTraceSink::ChromeTraceSink (size_t maxEvents) :
+				maxEvents(maxEvents),
+				droppedEvents(0) {
+	memset(totals, 0, sizeof(totals));
+}
+
+int ChromeTraceSink::getThread () {
+	std::map<std::thread::id, int>::iterator iter = threads.find(std::this_thread::get_id());
+	if (iter != threads.end()) return iter->second;
+	int thread = threads.size() + 1;
+	threads[std::this_thread::get_id()] = thread;
+	return thread;
+}
+
+void ChromeTraceSink::addEvent (const Event &event) {
+	if (events.size() >= maxEvents) {
+		droppedEvents++;
+		return;
+	}
+	events.push_back(event);
+}
+
+void ChromeTraceSink::scope (const char *name, long long start, long long duration) {
+	std::lock_guard<std::mutex> lock(mutex);
+	Event event = {name, start, duration, getThread(), false};
+	addEvent(event);
+}
+
+void ChromeTraceSink::count (Counter counter, int amount) {
+	long long time = getInstrumentationTime();
+	std::lock_guard<std::mutex> lock(mutex);
+	totals[counter] += amount;
+	Event event = {counterNames[counter], time, totals[counter], getThread(), true};
+	addEvent(event);
+}
+
+size_t ChromeTraceSink::getEventCount () const {
+	std::lock_guard<std::mutex> lock(mutex);
+	return events.size();
+}
+
+size_t ChromeTraceSink::getDroppedEventCount () const {
+	std::lock_guard<std::mutex> lock(mutex);
+	return droppedEvents;
+}
+
+void ChromeTraceSink::clear () {
+	std::lock_guard<std::mutex> lock(mutex);
+	events.clear();
+	droppedEvents = 0;
+	memset(totals, 0, sizeof(totals));
+}
+
+static void writeMicroseconds (std::ostream &output, long long nanos) {
+	output << nanos / 1000 << '.' << (char)('0' + nanos / 100 % 10) << (char)('0' + nanos / 10 % 10) << (char)('0' + nanos % 10);
+}
+
+void ChromeTraceSink::write (std::ostream &output) const {
+	std::lock_guard<std::mutex> lock(mutex);
+	// Scope events are added when they end, so the first event added isn't necessarily the earliest.
+	long long epoch = 0;
+	for (size_t i = 0, n = events.size(); i < n; i++)
+		if (i == 0 || events[i].time < epoch) epoch = events[i].time;
+	output << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+	for (size_t i = 0, n = events.size(); i < n; i++) {
+		const Event &event = events[i];
+		output << (i ? ",\n" : "\n") << "{\"name\":";
+		writeString(output, event.name);
+		output << ",\"ph\":\"" << (event.isCounter ? 'C' : 'X') << "\",\"pid\":1,\"tid\":" << event.thread << ",\"ts\":";
+		writeMicroseconds(output, event.time - epoch);
+		if (event.isCounter)
+			output << ",\"args\":{\"value\":" << event.value << "}}";
+		else {
+			output << ",\"dur\":";
+			writeMicroseconds(output, event.value);
+			output << '}';
+		}
+	}
+	output << "\n]}\n";
+}
+
+} /* namespace spine */
+
+#endif /* SPINE_INSTRUMENTATION */
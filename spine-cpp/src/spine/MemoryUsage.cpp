@@ -0,0 +1,102 @@
+/*******************************************************************************
+ * Copyright (c) 2013, Esoteric Software
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ******************************************************************************/
+
+#include <spine/Allocator.h>
+#include <spine/MemoryUsage.h>
+
+namespace spine {
+
+static const char* const categoryNames[memoryCategoryCount] = {"objects", "keyframes", "curves", "strings", "maps", "arrays"};
+
+/* A red-black tree node has a color and three links before the value. */
+static const size_t MAP_NODE_OVERHEAD = sizeof(void*) * 4;
+
+/** Returns the bytes allocated for a string's characters, or 0 for short strings stored inside the string object. */
+static size_t characterBytes (const char *characters, const void *object, size_t objectSize, size_t capacity) {
+	const char *begin = static_cast<const char*>(object);
+	if (characters >= begin && characters < begin + objectSize) return 0;
+	return capacity + 1;
+}
+
+const char* getMemoryCategoryName (MemoryCategory category) {
+	return categoryNames[category];
+}
+
+MemoryUsage::MemoryUsage () {
+	for (int i = 0; i < memoryCategoryCount; i++)
+		bytes[i] = 0;
+}
+
+void MemoryUsage::add (MemoryCategory category, size_t bytes) {
+	this->bytes[category] += bytes;
+}
+
+void MemoryUsage::addCharacters (const std::string &value) {
+	bytes[stringMemory] += characterBytes(value.data(), &value, sizeof(value), value.capacity());
+}
+
+void MemoryUsage::addCharacters (const String &value) {
+	bytes[stringMemory] += characterBytes(value.data(), &value, sizeof(value), value.capacity());
+}
+
+void MemoryUsage::addString (const String *value) {
+	if (!value) return;
+	bytes[stringMemory] += sizeof(String);
+	addCharacters(*value);
+}
+
+void MemoryUsage::addMapNode (size_t valueSize) {
+	bytes[mapMemory] += MAP_NODE_OVERHEAD + valueSize;
+}
+
+size_t MemoryUsage::getTotalBytes () const {
+	size_t total = 0;
+	for (int i = 0; i < memoryCategoryCount; i++)
+		total += bytes[i];
+	return total;
+}
+
+MemoryUsage& MemoryUsage::operator+= (const MemoryUsage &usage) {
+	for (int i = 0; i < memoryCategoryCount; i++)
+		bytes[i] += usage.bytes[i];
+	return *this;
+}
+
+void MemoryUsage::write (std::ostream &output) const {
+	output << '{';
+	for (int i = 0; i < memoryCategoryCount; i++)
+		output << '"' << categoryNames[i] << "\":" << bytes[i] << ',';
+	output << "\"total\":" << getTotalBytes() << '}';
+}
+
+void SkeletonMemoryUsage::write (std::ostream &output) const {
+	output << "{\"instance\":";
+	instance.write(output);
+	output << ",\"shared\":";
+	shared.write(output);
+	output << '}';
+}
+
+} /* namespace spine */
@@ -0,0 +1,60 @@
+/*******************************************************************************
+ * Copyright (c) 2013, Esoteric Software
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ******************************************************************************/
+
+#include <spine/PoseBuffer.h>
+
+namespace spine {
+
+PoseBuffer::PoseBuffer () :
+				writeIndex(0),
+				readIndex(1),
+				middle(2) {
+}
+
+SkeletonPose& PoseBuffer::getWritePose () {
+	return poses[writeIndex];
+}
+
+void PoseBuffer::publish () {
+	// Release makes the pose's contents visible to the reader that acquires the index.
+	writeIndex = middle.exchange(writeIndex | FRESH, std::memory_order_acq_rel) & INDEX_MASK;
+}
+
+void PoseBuffer::publish (const BaseSkeleton *skeleton) {
+	poses[writeIndex].capture(skeleton);
+	publish();
+}
+
+bool PoseBuffer::acquire () {
+	if (!(middle.load(std::memory_order_relaxed) & FRESH)) return false;
+	readIndex = middle.exchange(readIndex, std::memory_order_acq_rel) & INDEX_MASK;
+	return true;
+}
+
+const SkeletonPose& PoseBuffer::getReadPose () const {
+	return poses[readIndex];
+}
+
+} /* namespace spine */
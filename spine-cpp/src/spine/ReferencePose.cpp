@@ -0,0 +1,379 @@
+/*******************************************************************************
+ * Copyright (c) 2013, Esoteric Software
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ******************************************************************************/
+
+#include <math.h>
+#include <stdexcept>
+#include <spine/ReferencePose.h>
+#include <spine/Animation.h>
+#include <spine/BaseSkeleton.h>
+#include <spine/Bone.h>
+#include <spine/BoneData.h>
+#include <spine/SkeletonData.h>
+#include <spine/SkeletonPose.h>
+#include <spine/Skin.h>
+#include <spine/Slot.h>
+#include <spine/SlotData.h>
+
+#ifndef M_PI
+#define M_PI 3.1415926535897932385
+#endif
+
+using std::string;
+
+namespace spine {
+
+PoseDeviation::PoseDeviation () :
+				position(0),
+				matrix(0),
+				color(0),
+				attachments(0),
+				bone(-1),
+				slot(-1) {
+}
+
+void PoseDeviation::add (const PoseDeviation &deviation) {
+	if (deviation.position > position) {
+		position = deviation.position;
+		bone = deviation.bone;
+	}
+	if (deviation.matrix > matrix) matrix = deviation.matrix;
+	if (deviation.color > color) {
+		color = deviation.color;
+		slot = deviation.slot;
+	}
+	attachments += deviation.attachments;
+}
+
+bool PoseDeviation::exceeds (double positionEpsilon, double matrixEpsilon, double colorEpsilon) const {
+	return position > positionEpsilon || matrix > matrixEpsilon || color > colorEpsilon || attachments > 0;
+}
+
+//
+
+static const int BEZIER_SEGMENTS = 10;
+
+/** Returns the index of the first keyframe after the time, or of the last keyframe if none is after it. */
+static int findKeyframe (const float *frames, int framesLength, float time, int step) {
+	int i = step, last = framesLength - step;
+	while (i < last && frames[i] <= time)
+		i += step;
+	return i;
+}
+
+/** Evaluates keyframe's curve at percent. CurveTimeline only stores the forward differencing terms, so the control points are
+ * recovered from the third and fifth terms and the curve is evaluated at each step directly. */
+static double curvePercent (const float *curves, int keyframeIndex, double percent) {
+	const float *curve = curves + keyframeIndex * 6;
+	if (curve[0] == 0) return percent; // Linear.
+	if (curve[0] == -1) return 0; // Stepped.
+
+	double step = 1.0 / BEZIER_SEGMENTS, step2 = step * step, step3 = step2 * step;
+	double tmp2x = curve[4] / (6 * step3), tmp2y = curve[5] / (6 * step3);
+	double tmp1x = (curve[2] - curve[4]) / (6 * step2), tmp1y = (curve[3] - curve[5]) / (6 * step2);
+	double cx1 = (1 - tmp2x) / 3 - tmp1x, cy1 = (1 - tmp2y) / 3 - tmp1y;
+	double cx2 = tmp1x + 2 * cx1, cy2 = tmp1y + 2 * cy1;
+
+	double lastX = 0, lastY = 0;
+	for (int i = 1; i <= BEZIER_SEGMENTS; i++) {
+		double x = 1, y = 1; // Last point is 1,1.
+		if (i < BEZIER_SEGMENTS) {
+			double t = i * step, u = 1 - t;
+			x = 3 * u * u * t * cx1 + 3 * u * t * t * cx2 + t * t * t;
+			y = 3 * u * u * t * cy1 + 3 * u * t * t * cy2 + t * t * t;
+		}
+		if (x >= percent) return lastY + (y - lastY) * (percent - lastX) / (x - lastX);
+		lastX = x;
+		lastY = y;
+	}
+	return 1;
+}
+
+/** Returns the percent of the time between the keyframe before frameIndex and the one at it, after the curve. */
+static double framePercent (const CurveTimeline *timeline, const float *frames, int frameIndex, float time, int step) {
+	double lastTime = frames[frameIndex - step], frameTime = frames[frameIndex];
+	double percent = (time - lastTime) / (frameTime - lastTime);
+	if (percent < 0)
+		percent = 0;
+	else if (percent > 1) //
+		percent = 1;
+	return curvePercent(timeline->curves, frameIndex / step - 1, percent);
+}
+
+static double wrapDegrees (double degrees) {
+	while (degrees > 180)
+		degrees -= 360;
+	while (degrees < -180)
+		degrees += 360;
+	return degrees;
+}
+
+//
+
+ReferencePose::ReferencePose (const SkeletonData *data) :
+				data(data),
+				skin(0),
+				flipX(false),
+				flipY(false) {
+	if (!data) throw std::invalid_argument("data cannot be null.");
+
+	int boneCount = data->bones.size();
+	bones.resize(boneCount);
+	parents.resize(boneCount, -1);
+	for (int i = 0; i < boneCount; i++) {
+		for (int ii = 0; ii < boneCount; ii++) {
+			if (data->bones[ii] == data->bones[i]->parent) {
+				parents[i] = ii;
+				break;
+			}
+		}
+	}
+	slots.resize(data->slots.size());
+	setToBindPose();
+}
+
+void ReferencePose::setToBindPose () {
+	for (int i = 0, n = bones.size(); i < n; i++) {
+		const BoneData *boneData = data->bones[i];
+		BonePose &bone = bones[i];
+		bone.x = boneData->x;
+		bone.y = boneData->y;
+		bone.rotation = boneData->rotation;
+		bone.scaleX = boneData->scaleX;
+		bone.scaleY = boneData->scaleY;
+	}
+	for (int i = 0, n = slots.size(); i < n; i++) {
+		const SlotData *slotData = data->slots[i];
+		SlotPose &slot = slots[i];
+		slot.r = slotData->r;
+		slot.g = slotData->g;
+		slot.b = slotData->b;
+		slot.a = slotData->a;
+		slot.attachment = getAttachment(i, slotData->attachmentName);
+	}
+}
+
+const Attachment* ReferencePose::getAttachment (int slotIndex, const String *name) const {
+	if (!name) return 0;
+	if (skin) return skin->getAttachment(slotIndex, *name);
+	if (data->defaultSkin) return data->defaultSkin->getAttachment(slotIndex, *name);
+	return 0;
+}
+
+void ReferencePose::apply (const Animation *animation, float time, bool loop, float alpha) {
+	if (loop && animation->duration) time = fmodf(time, animation->duration);
+
+	for (int i = 0, n = animation->timelines.size(); i < n; i++) {
+		const Timeline *timeline = animation->timelines[i];
+
+		// ScaleTimeline extends TranslateTimeline, so it is checked first.
+		if (const ScaleTimeline *scaleTimeline = dynamic_cast<const ScaleTimeline*>(timeline)) {
+			const float *frames = scaleTimeline->frames;
+			int framesLength = scaleTimeline->framesLength;
+			if (time < frames[0]) continue;
+			BonePose &bone = bones[scaleTimeline->boneIndex];
+			const BoneData *boneData = data->bones[scaleTimeline->boneIndex];
+			double x, y;
+			if (time >= frames[framesLength - 3]) {
+				x = frames[framesLength - 2];
+				y = frames[framesLength - 1];
+			} else {
+				int frameIndex = findKeyframe(frames, framesLength, time, 3);
+				double percent = framePercent(scaleTimeline, frames, frameIndex, time, 3);
+				x = frames[frameIndex - 2] + (frames[frameIndex + 1] - frames[frameIndex - 2]) * percent;
+				y = frames[frameIndex - 1] + (frames[frameIndex + 2] - frames[frameIndex - 1]) * percent;
+			}
+			bone.scaleX += (boneData->scaleX - 1 + x - bone.scaleX) * alpha;
+			bone.scaleY += (boneData->scaleY - 1 + y - bone.scaleY) * alpha;
+
+		} else if (const TranslateTimeline *translateTimeline = dynamic_cast<const TranslateTimeline*>(timeline)) {
+			const float *frames = translateTimeline->frames;
+			int framesLength = translateTimeline->framesLength;
+			if (time < frames[0]) continue;
+			BonePose &bone = bones[translateTimeline->boneIndex];
+			const BoneData *boneData = data->bones[translateTimeline->boneIndex];
+			double x, y;
+			if (time >= frames[framesLength - 3]) {
+				x = frames[framesLength - 2];
+				y = frames[framesLength - 1];
+			} else {
+				int frameIndex = findKeyframe(frames, framesLength, time, 3);
+				double percent = framePercent(translateTimeline, frames, frameIndex, time, 3);
+				x = frames[frameIndex - 2] + (frames[frameIndex + 1] - frames[frameIndex - 2]) * percent;
+				y = frames[frameIndex - 1] + (frames[frameIndex + 2] - frames[frameIndex - 1]) * percent;
+			}
+			bone.x += (boneData->x + x - bone.x) * alpha;
+			bone.y += (boneData->y + y - bone.y) * alpha;
+
+		} else if (const RotateTimeline *rotateTimeline = dynamic_cast<const RotateTimeline*>(timeline)) {
+			const float *frames = rotateTimeline->frames;
+			int framesLength = rotateTimeline->framesLength;
+			if (time < frames[0]) continue;
+			BonePose &bone = bones[rotateTimeline->boneIndex];
+			double value;
+			if (time >= frames[framesLength - 2])
+				value = frames[framesLength - 1];
+			else {
+				int frameIndex = findKeyframe(frames, framesLength, time, 2);
+				double percent = framePercent(rotateTimeline, frames, frameIndex, time, 2);
+				double lastValue = frames[frameIndex - 1];
+				value = lastValue + wrapDegrees(frames[frameIndex + 1] - lastValue) * percent;
+			}
+			bone.rotation += wrapDegrees(data->bones[rotateTimeline->boneIndex]->rotation + value - bone.rotation) * alpha;
+
+		} else if (const ColorTimeline *colorTimeline = dynamic_cast<const ColorTimeline*>(timeline)) {
+			const float *frames = colorTimeline->frames;
+			int framesLength = colorTimeline->framesLength;
+			if (time < frames[0]) continue;
+			SlotPose &slot = slots[colorTimeline->slotIndex];
+			if (time >= frames[framesLength - 5]) {
+				// After the last keyframe the color is set regardless of alpha.
+				slot.r = frames[framesLength - 4];
+				slot.g = frames[framesLength - 3];
+				slot.b = frames[framesLength - 2];
+				slot.a = frames[framesLength - 1];
+				continue;
+			}
+			int frameIndex = findKeyframe(frames, framesLength, time, 5);
+			double percent = framePercent(colorTimeline, frames, frameIndex, time, 5);
+			double color[4];
+			for (int ii = 0; ii < 4; ii++) {
+				double last = frames[frameIndex - 4 + ii];
+				color[ii] = last + (frames[frameIndex + 1 + ii] - last) * percent;
+			}
+			if (alpha < 1) {
+				slot.r += (color[0] - slot.r) * alpha;
+				slot.g += (color[1] - slot.g) * alpha;
+				slot.b += (color[2] - slot.b) * alpha;
+				slot.a += (color[3] - slot.a) * alpha;
+			} else {
+				slot.r = color[0];
+				slot.g = color[1];
+				slot.b = color[2];
+				slot.a = color[3];
+			}
+
+		} else if (const AttachmentTimeline *attachmentTimeline = dynamic_cast<const AttachmentTimeline*>(timeline)) {
+			// Attachments are not mixed, the key before the time is used regardless of alpha.
+			const float *frames = attachmentTimeline->frames;
+			if (time < frames[0]) continue;
+			int frameIndex = 0;
+			while (frameIndex + 1 < attachmentTimeline->framesLength && frames[frameIndex + 1] <= time)
+				frameIndex++;
+			slots[attachmentTimeline->slotIndex].attachment = getAttachment(attachmentTimeline->slotIndex,
+					attachmentTimeline->attachmentNames[frameIndex]);
+
+		} else
+			throw std::invalid_argument("Unsupported timeline type.");
+	}
+}
+
+void ReferencePose::updateWorldTransform () {
+	for (int i = 0, n = bones.size(); i < n; i++) {
+		BonePose &bone = bones[i];
+		if (parents[i] != -1) {
+			// Bones come after their parent, so the parent's world transform is current.
+			const BonePose &parent = bones[parents[i]];
+			bone.worldX = bone.x * parent.m00 + bone.y * parent.m01 + parent.worldX;
+			bone.worldY = bone.x * parent.m10 + bone.y * parent.m11 + parent.worldY;
+			bone.worldScaleX = parent.worldScaleX * bone.scaleX;
+			bone.worldScaleY = parent.worldScaleY * bone.scaleY;
+			bone.worldRotation = parent.worldRotation + bone.rotation;
+		} else {
+			bone.worldX = bone.x;
+			bone.worldY = bone.y;
+			bone.worldScaleX = bone.scaleX;
+			bone.worldScaleY = bone.scaleY;
+			bone.worldRotation = bone.rotation;
+		}
+		double radians = bone.worldRotation * M_PI / 180;
+		double cosine = cos(radians), sine = sin(radians);
+		bone.m00 = cosine * bone.worldScaleX;
+		bone.m10 = sine * bone.worldScaleX;
+		bone.m01 = -sine * bone.worldScaleY;
+		bone.m11 = cosine * bone.worldScaleY;
+		if (flipX) {
+			bone.m00 = -bone.m00;
+			bone.m01 = -bone.m01;
+		}
+		if (flipY != (data->bones[i]->yDown != 0)) {
+			bone.m10 = -bone.m10;
+			bone.m11 = -bone.m11;
+		}
+	}
+}
+
+void ReferencePose::compareBone (PoseDeviation &deviation, int boneIndex, double m00, double m01, double worldX, double m10,
+		double m11, double worldY) const {
+	const BonePose &bone = bones[boneIndex];
+	double position = fmax(fabs(worldX - bone.worldX), fabs(worldY - bone.worldY));
+	if (position > deviation.position) {
+		deviation.position = position;
+		deviation.bone = boneIndex;
+	}
+	double matrix = fmax(fmax(fabs(m00 - bone.m00), fabs(m01 - bone.m01)), fmax(fabs(m10 - bone.m10), fabs(m11 - bone.m11)));
+	if (matrix > deviation.matrix) deviation.matrix = matrix;
+}
+
+void ReferencePose::compareSlot (PoseDeviation &deviation, int slotIndex, double r, double g, double b, double a,
+		const Attachment *attachment) const {
+	const SlotPose &slot = slots[slotIndex];
+	double color = fmax(fmax(fabs(r - slot.r), fabs(g - slot.g)), fmax(fabs(b - slot.b), fabs(a - slot.a)));
+	if (color > deviation.color) {
+		deviation.color = color;
+		deviation.slot = slotIndex;
+	}
+	if (attachment != slot.attachment) deviation.attachments++;
+}
+
+PoseDeviation ReferencePose::compare (const BaseSkeleton *skeleton) const {
+	if (skeleton->data != data) throw std::invalid_argument("skeleton must have the same skeleton data.");
+	PoseDeviation deviation;
+	for (int i = 0, n = bones.size(); i < n; i++) {
+		const Bone *bone = skeleton->bones[i];
+		compareBone(deviation, i, bone->m00, bone->m01, bone->worldX, bone->m10, bone->m11, bone->worldY);
+	}
+	for (int i = 0, n = slots.size(); i < n; i++) {
+		const Slot *slot = skeleton->slots[i];
+		compareSlot(deviation, i, slot->r, slot->g, slot->b, slot->a, slot->attachment);
+	}
+	return deviation;
+}
+
+PoseDeviation ReferencePose::compare (const SkeletonPose &pose) const {
+	if (pose.bones.size() != bones.size() || pose.drawOrder.size() != slots.size())
+		throw std::invalid_argument("pose must be captured from a skeleton with the same skeleton data.");
+	PoseDeviation deviation;
+	for (int i = 0, n = bones.size(); i < n; i++) {
+		const SkeletonPose::BonePose &bone = pose.bones[i];
+		compareBone(deviation, i, bone.m00, bone.m01, bone.worldX, bone.m10, bone.m11, bone.worldY);
+	}
+	for (int i = 0, n = slots.size(); i < n; i++) {
+		const SkeletonPose::SlotPose &slot = pose.drawOrder[i];
+		compareSlot(deviation, slot.slotIndex, slot.r, slot.g, slot.b, slot.a, slot.attachment);
+	}
+	return deviation;
+}
+
+} /* namespace spine */
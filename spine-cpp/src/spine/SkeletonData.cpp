@@ -75,4 +75,22 @@ Skin* SkeletonData::findSkin (const string &skinName) const {
 	return 0;
 }
 
+MemoryUsage SkeletonData::memoryUsage () const {
+	MemoryUsage usage;
+	usage.add(objectMemory, sizeof(SkeletonData));
+	usage.add(arrayMemory, (bones.capacity() + slots.capacity() + skins.capacity()) * sizeof(void*));
+	for (int i = 0, n = bones.size(); i < n; i++) {
+		usage.add(objectMemory, sizeof(BoneData));
+		usage.addCharacters(bones[i]->name);
+	}
+	for (int i = 0, n = slots.size(); i < n; i++) {
+		usage.add(objectMemory, sizeof(SlotData));
+		usage.addCharacters(slots[i]->name);
+		usage.addString(slots[i]->attachmentName);
+	}
+	for (int i = 0, n = skins.size(); i < n; i++)
+		usage += skins[i]->memoryUsage();
+	return usage;
+}
+
 } /* namespace spine */
@@ -0,0 +1,132 @@
+/*******************************************************************************
+ * Copyright (c) 2013, Esoteric Software
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ******************************************************************************/
+
+#include <algorithm>
+#include <stdexcept>
+#include <spine/SkeletonPose.h>
+#include <spine/BaseSkeleton.h>
+#include <spine/Bone.h>
+#include <spine/Slot.h>
+#include <spine/SlotData.h>
+
+namespace spine {
+
+SkeletonPose::SkeletonPose () :
+				r(1),
+				g(1),
+				b(1),
+				a(1),
+				indexedSkeleton(0) {
+}
+
+bool SkeletonPose::isIndexed (const BaseSkeleton *skeleton) const {
+	int slotCount = skeleton->slots.size();
+	if (skeleton != indexedSkeleton || slotCount != (int)indexedSlots.size()) return false;
+	int boneCount = skeleton->bones.size();
+	for (int i = 0; i < slotCount; i++) {
+		const Slot *slot = skeleton->slots[i];
+		int boneIndex = slotBoneIndices[i];
+		if (slot != indexedSlots[i] || boneIndex >= boneCount || skeleton->bones[boneIndex] != slot->bone) return false;
+	}
+	return true;
+}
+
+void SkeletonPose::buildIndices (const BaseSkeleton *skeleton) {
+	int boneCount = skeleton->bones.size();
+	int slotCount = skeleton->slots.size();
+
+	std::vector<std::pair<const Bone*, int> > boneIndices;
+	boneIndices.reserve(boneCount);
+	for (int i = 0; i < boneCount; i++)
+		boneIndices.push_back(std::make_pair(skeleton->bones[i], i));
+	std::sort(boneIndices.begin(), boneIndices.end());
+
+	indexedSkeleton = 0;
+	slotIndices.clear();
+	slotIndices.reserve(slotCount);
+	slotBoneIndices.resize(slotCount);
+	indexedSlots.assign(skeleton->slots.begin(), skeleton->slots.end());
+	for (int i = 0; i < slotCount; i++) {
+		const Slot *slot = skeleton->slots[i];
+		slotIndices.push_back(std::make_pair(slot, i));
+		std::vector<std::pair<const Bone*, int> >::const_iterator bone = std::lower_bound(boneIndices.begin(), boneIndices.end(),
+				std::make_pair((const Bone*)slot->bone, 0));
+		if (bone == boneIndices.end() || bone->first != slot->bone)
+			throw std::invalid_argument("Slot bone is not one of the skeleton's bones: " + slot->data->name.str());
+		slotBoneIndices[i] = bone->second;
+	}
+	std::sort(slotIndices.begin(), slotIndices.end());
+
+	bones.reserve(boneCount);
+	drawOrder.reserve(slotCount);
+	indexedSkeleton = skeleton;
+}
+
+void SkeletonPose::capture (const BaseSkeleton *skeleton) {
+	if (!isIndexed(skeleton)) buildIndices(skeleton);
+
+	int boneCount = skeleton->bones.size();
+	bones.resize(boneCount);
+	for (int i = 0; i < boneCount; i++) {
+		const Bone *bone = skeleton->bones[i];
+		BonePose &pose = bones[i];
+		pose.m00 = bone->m00;
+		pose.m01 = bone->m01;
+		pose.worldX = bone->worldX;
+		pose.m10 = bone->m10;
+		pose.m11 = bone->m11;
+		pose.worldY = bone->worldY;
+	}
+
+	int slotCount = skeleton->drawOrder.size();
+	drawOrder.resize(slotCount);
+	for (int i = 0; i < slotCount; i++) {
+		const Slot *slot = skeleton->drawOrder[i];
+		SlotPose &pose = drawOrder[i];
+		// The draw order usually matches the slots, which avoids the search.
+		if (i < (int)skeleton->slots.size() && skeleton->slots[i] == slot)
+			pose.slotIndex = i;
+		else {
+			std::vector<std::pair<const Slot*, int>, StlAllocator<std::pair<const Slot*, int>, skeletonTag> >::const_iterator index =
+					std::lower_bound(slotIndices.begin(), slotIndices.end(), std::make_pair(slot, 0));
+			if (index == slotIndices.end() || index->first != slot)
+				throw std::invalid_argument("Draw order slot is not one of the skeleton's slots: " + slot->data->name.str());
+			pose.slotIndex = index->second;
+		}
+		pose.boneIndex = slotBoneIndices[pose.slotIndex];
+		pose.r = slot->r;
+		pose.g = slot->g;
+		pose.b = slot->b;
+		pose.a = slot->a;
+		pose.attachment = slot->attachment;
+	}
+
+	r = skeleton->r;
+	g = skeleton->g;
+	b = skeleton->b;
+	a = skeleton->a;
+}
+
+} /* namespace spine */
@@ -28,6 +28,7 @@
 #include <spine/Skin.h>
 #include <spine/BaseSkeleton.h>
 #include <spine/Slot.h>
+#include <spine/Instrumentation.h>
 
 namespace spine {
 
@@ -36,28 +37,70 @@ Skin::Skin (const std::string &name) :
 }
 
 Skin::~Skin () {
-	for (std::map<Key, Attachment*>::iterator iter = attachments.begin(); iter != attachments.end(); iter++)
-		delete iter->second;
+	for (int i = 0, n = attachments.size(); i < n; i++)
+		delete attachments[i].attachment;
+}
+
+int Skin::lowerBound (int slotIndex, const char *name, size_t length) const {
+	int low = 0, high = attachments.size();
+	while (low < high) {
+		int middle = (low + high) >> 1;
+		const Entry &entry = attachments[middle];
+		if (entry.slotIndex < slotIndex || (entry.slotIndex == slotIndex && entry.name.compare(0, entry.name.length(), name, length) < 0))
+			low = middle + 1;
+		else
+			high = middle;
+	}
+	return low;
 }
 
 void Skin::addAttachment (int slotIndex, const std::string &name, Attachment *attachment) {
 	if (!attachment) throw std::invalid_argument("attachment cannot be null.");
-	Key key = {slotIndex, name};
-	attachments[key] = attachment;
+	int index = lowerBound(slotIndex, name.data(), name.length());
+	if (index < (int)attachments.size() && attachments[index].slotIndex == slotIndex && attachments[index].name == name) {
+		if (attachments[index].attachment != attachment) delete attachments[index].attachment;
+		attachments[index].attachment = attachment;
+		return;
+	}
+	Entry entry = {slotIndex, name, attachment};
+	attachments.insert(attachments.begin() + index, entry);
+}
+
+Attachment* Skin::getAttachment (int slotIndex, const std::string &name) const {
+	return getAttachment(slotIndex, name.data(), name.length());
 }
 
-Attachment* Skin::getAttachment (int slotIndex, const std::string &name) {
-	Key key = {slotIndex, name};
-	if (attachments.find(key) != attachments.end()) return attachments[key];
-	return 0;
+Attachment* Skin::getAttachment (int slotIndex, const String &name) const {
+	return getAttachment(slotIndex, name.data(), name.length());
+}
+
+Attachment* Skin::getAttachment (int slotIndex, const char *name, size_t length) const {
+	SPINE_SCOPE("Skin::getAttachment");
+	int index = lowerBound(slotIndex, name, length);
+	if (index == (int)attachments.size()) return 0;
+	const Entry &entry = attachments[index];
+	if (entry.slotIndex != slotIndex || entry.name.compare(0, entry.name.length(), name, length) != 0) return 0;
+	return entry.attachment;
+}
+
+MemoryUsage Skin::memoryUsage () const {
+	MemoryUsage usage;
+	usage.add(objectMemory, sizeof(Skin));
+	usage.addCharacters(name);
+	usage.add(arrayMemory, attachments.capacity() * sizeof(Entry));
+	for (int i = 0, n = attachments.size(); i < n; i++) {
+		usage.addCharacters(attachments[i].name);
+		attachments[i].attachment->addMemoryUsage(usage);
+	}
+	return usage;
 }
 
-void Skin::attachAll (BaseSkeleton *skeleton, Skin *oldSkin) {
-	for (std::map<Key, Attachment*>::iterator iter = oldSkin->attachments.begin(); iter != oldSkin->attachments.end(); iter++) {
-		const Key key = iter->first;
-		Slot *slot = skeleton->slots[key.slotIndex];
-		if (slot->attachment == iter->second) {
-			Attachment *attachment = getAttachment(key.slotIndex, key.name);
+void Skin::attachAll (BaseSkeleton *skeleton, const Skin *oldSkin) const {
+	for (int i = 0, n = oldSkin->attachments.size(); i < n; i++) {
+		const Entry &entry = oldSkin->attachments[i];
+		Slot *slot = skeleton->slots[entry.slotIndex];
+		if (slot->attachment == entry.attachment) {
+			Attachment *attachment = getAttachment(entry.slotIndex, entry.name);
 			if (attachment) slot->setAttachment(attachment);
 		}
 	}
@@ -28,10 +28,11 @@
 #include <spine/SlotData.h>
 #include <spine/BaseSkeleton.h>
 #include <spine/SkeletonData.h>
+#include <spine/Instrumentation.h>
 
 namespace spine {
 
-Slot::Slot (SlotData *data, BaseSkeleton *skeleton, Bone *bone) :
+Slot::Slot (const SlotData *data, BaseSkeleton *skeleton, Bone *bone) :
 				attachmentTime(0),
 				data(data),
 				skeleton(skeleton),
@@ -48,6 +49,9 @@ Slot::Slot (SlotData *data, BaseSkeleton *skeleton, Bone *bone) :
 }
 
 void Slot::setAttachment (Attachment *attachment) {
+#ifdef SPINE_INSTRUMENTATION
+	if (attachment != this->attachment) SPINE_COUNT(attachmentSwaps, 1);
+#endif
 	this->attachment = attachment;
 	attachmentTime = skeleton->time;
 }
@@ -0,0 +1,437 @@
+/*******************************************************************************
+ * Copyright (c) 2013, Esoteric Software
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ******************************************************************************/
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <math.h>
+#include <spine/StreamingAnimation.h>
+#include <spine/BaseSkeleton.h>
+#include <spine/ByteOrder.h>
+
+using std::string;
+using std::vector;
+using std::runtime_error;
+using std::invalid_argument;
+
+namespace spine {
+
+/* Chunked animation format. All fields are 4 bytes and little endian:
+ *
+ * StreamHeader
+ * unsigned int chunkOffsets[chunkCount + 1] -- from the start of the file, the last is the end of the last chunk
+ * chunks, each: unsigned int timelineCount, then per timeline:
+ *    unsigned int type, int boneOrSlotIndex, unsigned int keyframeCount, float frames[], float curves[] (curve timelines only),
+ *    and for attachment timelines per keyframe: int nameLength (-1 for none), char name[nameLength] */
+
+static const char STREAM_MAGIC[4] = {'\x89', 'S', 'P', 'S'};
+static const unsigned int STREAM_VERSION = 1;
+
+enum StreamTimelineType {
+	streamRotate, streamTranslate, streamScale, streamColor, streamAttachment
+};
+
+struct StreamHeader {
+	char magic[4];
+	unsigned int version;
+	unsigned int chunkCount;
+	float duration;
+	float chunkDuration;
+};
+
+class ChunkWriter {
+public:
+	string data;
+
+	void writeInt (int value) {
+		swapWords(&value, 1);
+		data.append(reinterpret_cast<const char*>(&value), 4);
+	}
+
+	void writeFloats (const float *values, int count) {
+		if (count <= 0) return;
+		size_t start = data.length();
+		data.append(reinterpret_cast<const char*>(values), count * 4);
+		swapWords(&data[start], count);
+	}
+};
+
+class ChunkReader {
+public:
+	const char *current, *end;
+
+	ChunkReader (const char *begin, const char *end) :
+					current(begin),
+					end(end) {
+	}
+
+	int readInt () {
+		int value;
+		read(&value, 4);
+		swapWords(&value, 1);
+		return value;
+	}
+
+	void readFloats (float *values, int count) {
+		if (count <= 0) return;
+		read(values, count * 4);
+		swapWords(values, count);
+	}
+
+	void read (void *to, int length) {
+		if (end - current < length) throw runtime_error("Invalid streaming animation: truncated chunk.");
+		memcpy(to, current, length);
+		current += length;
+	}
+};
+
+static inline int chunkIndexFor (float time, float chunkDuration, int chunkCount) {
+	int index = (int)floorf(time / chunkDuration);
+	if (index < 0) return 0;
+	if (index >= chunkCount) return chunkCount - 1;
+	return index;
+}
+
+/** Finds the keyframes needed to apply times in chunk, writes the range to first and count. */
+static void sliceFrames (const float *frames, int keyframeCount, int stride, int chunk, float chunkDuration, int chunkCount,
+		int &first, int &count) {
+	int start = 0;
+	while (start < keyframeCount && chunkIndexFor(frames[start * stride], chunkDuration, chunkCount) < chunk)
+		start++;
+	int last = start;
+	while (last < keyframeCount && chunkIndexFor(frames[last * stride], chunkDuration, chunkCount) <= chunk)
+		last++;
+	// Include the keyframe before and the keyframe after the chunk.
+	if (start > 0) start--;
+	if (last == keyframeCount) last--;
+	first = start;
+	count = last - start + 1;
+}
+
+static void writeCurveTimeline (ChunkWriter &writer, StreamTimelineType type, int index, const float *frames, int framesLength,
+		const float *curves, int stride, int chunk, float chunkDuration, int chunkCount) {
+	int first, count;
+	sliceFrames(frames, framesLength / stride, stride, chunk, chunkDuration, chunkCount, first, count);
+	writer.writeInt(type);
+	writer.writeInt(index);
+	writer.writeInt(count);
+	writer.writeFloats(frames + first * stride, count * stride);
+	writer.writeFloats(curves + first * 6, (count - 1) * 6);
+}
+
+static void writeChunk (ChunkWriter &writer, const Animation &animation, int chunk, float chunkDuration, int chunkCount) {
+	writer.writeInt(animation.timelines.size());
+	for (int i = 0, n = animation.timelines.size(); i < n; i++) {
+		const Timeline *timeline = animation.timelines[i];
+		if (const ScaleTimeline *scale = dynamic_cast<const ScaleTimeline*>(timeline)) {
+			writeCurveTimeline(writer, streamScale, scale->boneIndex, scale->frames, scale->framesLength, scale->curves, 3, chunk,
+					chunkDuration, chunkCount);
+		} else if (const TranslateTimeline *translate = dynamic_cast<const TranslateTimeline*>(timeline)) {
+			writeCurveTimeline(writer, streamTranslate, translate->boneIndex, translate->frames, translate->framesLength,
+					translate->curves, 3, chunk, chunkDuration, chunkCount);
+		} else if (const RotateTimeline *rotate = dynamic_cast<const RotateTimeline*>(timeline)) {
+			writeCurveTimeline(writer, streamRotate, rotate->boneIndex, rotate->frames, rotate->framesLength, rotate->curves, 2,
+					chunk, chunkDuration, chunkCount);
+		} else if (const ColorTimeline *color = dynamic_cast<const ColorTimeline*>(timeline)) {
+			writeCurveTimeline(writer, streamColor, color->slotIndex, color->frames, color->framesLength, color->curves, 5, chunk,
+					chunkDuration, chunkCount);
+		} else if (const AttachmentTimeline *attachment = dynamic_cast<const AttachmentTimeline*>(timeline)) {
+			int first, count;
+			sliceFrames(attachment->frames, attachment->framesLength, 1, chunk, chunkDuration, chunkCount, first, count);
+			writer.writeInt(streamAttachment);
+			writer.writeInt(attachment->slotIndex);
+			writer.writeInt(count);
+			writer.writeFloats(attachment->frames + first, count);
+			for (int ii = first; ii < first + count; ii++) {
+				const String *name = attachment->attachmentNames[ii];
+				if (!name) {
+					writer.writeInt(-1);
+					continue;
+				}
+				writer.writeInt(name->length());
+				writer.data.append(name->data(), name->length());
+			}
+		} else
+			throw invalid_argument("Timeline type cannot be streamed.");
+	}
+}
+
+static void readCurves (ChunkReader &reader, CurveTimeline *timeline, int keyframeCount) {
+	reader.readFloats(timeline->curves, (keyframeCount - 1) * 6);
+}
+
+/** Also returns the number of bones and slots the timelines need. */
+static Animation* readChunkTimelines (ChunkReader &reader, float duration, int &boneCount, int &slotCount) {
+	vector<Timeline*> timelines;
+	boneCount = 0;
+	slotCount = 0;
+	try {
+		int timelineCount = reader.readInt();
+		if (timelineCount < 0) throw runtime_error("Invalid streaming animation: bad timeline count.");
+		timelines.reserve(timelineCount);
+		for (int i = 0; i < timelineCount; i++) {
+			int type = reader.readInt();
+			int index = reader.readInt();
+			int keyframeCount = reader.readInt();
+			if (index < 0) throw runtime_error("Invalid streaming animation: bad bone or slot index.");
+			int &count = type == streamColor || type == streamAttachment ? slotCount : boneCount;
+			if (index >= count) count = index + 1;
+			if (keyframeCount < 1 || keyframeCount > (reader.end - reader.current) / 4)
+				throw runtime_error("Invalid streaming animation: bad keyframe count.");
+			switch (type) {
+			case streamRotate: {
+				RotateTimeline *timeline = new RotateTimeline(keyframeCount);
+				timelines.push_back(timeline);
+				timeline->boneIndex = index;
+				reader.readFloats(timeline->frames, timeline->framesLength);
+				readCurves(reader, timeline, keyframeCount);
+				break;
+			}
+			case streamTranslate:
+			case streamScale: {
+				TranslateTimeline *timeline;
+				if (type == streamScale)
+					timeline = new ScaleTimeline(keyframeCount);
+				else
+					timeline = new TranslateTimeline(keyframeCount);
+				timelines.push_back(timeline);
+				timeline->boneIndex = index;
+				reader.readFloats(timeline->frames, timeline->framesLength);
+				readCurves(reader, timeline, keyframeCount);
+				break;
+			}
+			case streamColor: {
+				ColorTimeline *timeline = new ColorTimeline(keyframeCount);
+				timelines.push_back(timeline);
+				timeline->slotIndex = index;
+				reader.readFloats(timeline->frames, timeline->framesLength);
+				readCurves(reader, timeline, keyframeCount);
+				break;
+			}
+			case streamAttachment: {
+				AttachmentTimeline *timeline = new AttachmentTimeline(keyframeCount);
+				timelines.push_back(timeline);
+				timeline->slotIndex = index;
+				reader.readFloats(timeline->frames, keyframeCount);
+				for (int ii = 0; ii < keyframeCount; ii++) {
+					int length = reader.readInt();
+					if (length < 0) continue;
+					if (length > reader.end - reader.current) throw runtime_error("Invalid streaming animation: bad name.");
+					timeline->attachmentNames[ii] = new String(reader.current, length);
+					reader.current += length;
+				}
+				break;
+			}
+			default:
+				throw runtime_error("Invalid streaming animation: unknown timeline type.");
+			}
+		}
+	} catch (...) {
+		for (int i = 0, n = timelines.size(); i < n; i++)
+			delete timelines[i];
+		throw;
+	}
+	return new Animation(timelines, duration);
+}
+
+//
+
+/** The single timeline of a StreamingAnimation, applies the timelines of the chunk for the time. */
+class StreamingAnimation::ChunkTimeline: public Timeline {
+public:
+	StreamingAnimation *animation;
+
+	ChunkTimeline (StreamingAnimation *animation) :
+					animation(animation) {
+	}
+
+	virtual void apply (BaseSkeleton *skeleton, float time, float alpha) const {
+		animation->applyChunk(skeleton, time, alpha);
+	}
+
+	/** Adds the chunk index and the resident chunks, which the StreamingAnimation owns through this timeline. */
+	virtual void addMemoryUsage (MemoryUsage &usage) const {
+		usage.add(objectMemory, sizeof(ChunkTimeline) + sizeof(StreamingAnimation) - sizeof(Animation));
+		usage.addCharacters(animation->path);
+		usage.add(arrayMemory, animation->chunkOffsets.capacity() * sizeof(unsigned int));
+		std::lock_guard<std::mutex> lock(animation->mutex);
+		for (std::map<int, Chunk>::const_iterator iter = animation->chunks.begin(); iter != animation->chunks.end(); iter++) {
+			usage.addMapNode(sizeof(std::pair<const int, Chunk>));
+			usage += iter->second.animation->memoryUsage();
+		}
+	}
+};
+
+StreamingAnimation::StreamingAnimation (const string &path, int windowSize) :
+				Animation(vector<Timeline*>(), 0),
+				path(path),
+				windowSize(windowSize),
+				chunkDuration(0) {
+	if (windowSize < 1) throw invalid_argument("windowSize must be > 0.");
+
+	std::ifstream file(path.c_str(), std::ios::in | std::ios::binary);
+	if (!file) throw invalid_argument("Error reading streaming animation: " + path);
+	StreamHeader header;
+	if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) || memcmp(header.magic, STREAM_MAGIC, 4) != 0)
+		throw runtime_error("Invalid streaming animation: " + path);
+	swapWords(&header.version, (sizeof(header) - sizeof(header.magic)) / 4);
+	if (header.version != STREAM_VERSION) throw runtime_error("Unsupported streaming animation version: " + path);
+	if (header.chunkCount == 0 || header.chunkCount > 1 << 24 || !(header.chunkDuration > 0))
+		throw runtime_error("Invalid streaming animation: " + path);
+
+	duration = header.duration;
+	chunkDuration = header.chunkDuration;
+	chunkOffsets.resize(header.chunkCount + 1);
+	if (!file.read(reinterpret_cast<char*>(&chunkOffsets[0]), chunkOffsets.size() * sizeof(unsigned int)))
+		throw runtime_error("Invalid streaming animation: " + path);
+	swapWords(&chunkOffsets[0], chunkOffsets.size());
+	for (int i = 1, n = chunkOffsets.size(); i < n; i++)
+		if (chunkOffsets[i] < chunkOffsets[i - 1]) throw runtime_error("Invalid streaming animation: " + path);
+
+	timelines.push_back(new ChunkTimeline(this));
+}
+
+StreamingAnimation::~StreamingAnimation () {
+	for (std::map<int, Chunk>::iterator iter = chunks.begin(); iter != chunks.end(); iter++)
+		delete iter->second.animation;
+}
+
+int StreamingAnimation::chunkIndex (float time) const {
+	return chunkIndexFor(time, chunkDuration, chunkOffsets.size() - 1);
+}
+
+StreamingAnimation::Chunk StreamingAnimation::readChunk (int index) const {
+	unsigned int offset = chunkOffsets[index];
+	unsigned int length = chunkOffsets[index + 1] - offset;
+	string data(length, '\0');
+	std::ifstream file(path.c_str(), std::ios::in | std::ios::binary);
+	if (!file) throw runtime_error("Error reading streaming animation: " + path);
+	file.seekg(offset);
+	if (length && !file.read(&data[0], length)) throw runtime_error("Error reading streaming animation chunk: " + path);
+	ChunkReader reader(data.data(), data.data() + data.length());
+	Chunk chunk;
+	chunk.animation = readChunkTimelines(reader, duration, chunk.boneCount, chunk.slotCount);
+	return chunk;
+}
+
+void StreamingAnimation::evictOutside (int first) {
+	int chunkCount = chunkOffsets.size() - 1;
+	for (std::map<int, Chunk>::iterator iter = chunks.begin(); iter != chunks.end();) {
+		// Distance ahead of the first chunk, wrapping so chunks needed soon after looping are kept.
+		int distance = (iter->first - first + chunkCount) % chunkCount;
+		if (distance < windowSize)
+			iter++;
+		else {
+			delete iter->second.animation;
+			chunks.erase(iter++);
+		}
+	}
+}
+
+void StreamingAnimation::prefetch (float time, bool loop) {
+	if (loop && duration) time = fmodf(time, duration);
+	int chunkCount = chunkOffsets.size() - 1;
+	int first = chunkIndex(time);
+	int count = windowSize < chunkCount ? windowSize : chunkCount;
+	for (int i = 0; i < count; i++) {
+		int index = first + i;
+		if (index >= chunkCount) {
+			if (!loop) break;
+			index -= chunkCount;
+		}
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			if (chunks.count(index)) continue;
+		}
+		// Decode without holding the lock so applying the resident chunks isn't blocked.
+		Chunk chunk = readChunk(index);
+		std::lock_guard<std::mutex> lock(mutex);
+		if (!chunks.insert(std::make_pair(index, chunk)).second) delete chunk.animation;
+	}
+	std::lock_guard<std::mutex> lock(mutex);
+	evictOutside(first);
+}
+
+void StreamingAnimation::applyChunk (BaseSkeleton *skeleton, float time, float alpha) {
+	int index = chunkIndex(time);
+	std::lock_guard<std::mutex> lock(mutex);
+	std::map<int, Chunk>::iterator iter = chunks.find(index);
+	Chunk chunk;
+	if (iter != chunks.end())
+		chunk = iter->second;
+	else {
+		// Seek or prefetch fell behind, decode now.
+		chunk = readChunk(index);
+		chunks[index] = chunk;
+		evictOutside(index);
+	}
+	if (chunk.boneCount > (int)skeleton->bones.size() || chunk.slotCount > (int)skeleton->slots.size())
+		throw runtime_error("Streaming animation has bones or slots the skeleton doesn't have: " + path);
+	for (int i = 0, n = chunk.animation->timelines.size(); i < n; i++)
+		chunk.animation->timelines[i]->apply(skeleton, time, alpha);
+}
+
+int StreamingAnimation::getChunkCount () const {
+	return chunkOffsets.size() - 1;
+}
+
+float StreamingAnimation::getChunkDuration () const {
+	return chunkDuration;
+}
+
+int StreamingAnimation::getResidentChunkCount () const {
+	std::lock_guard<std::mutex> lock(mutex);
+	return chunks.size();
+}
+
+void StreamingAnimation::write (std::ostream &output, const Animation &animation, float chunkDuration) {
+	if (!(chunkDuration > 0)) throw invalid_argument("chunkDuration must be > 0.");
+
+	StreamHeader header;
+	memcpy(header.magic, STREAM_MAGIC, 4);
+	header.version = STREAM_VERSION;
+	header.chunkCount = (unsigned int)ceilf(animation.duration / chunkDuration);
+	if (header.chunkCount == 0) header.chunkCount = 1;
+	header.duration = animation.duration;
+	header.chunkDuration = chunkDuration;
+
+	vector<unsigned int> chunkOffsets(header.chunkCount + 1);
+	ChunkWriter writer;
+	unsigned int dataOffset = sizeof(header) + chunkOffsets.size() * sizeof(unsigned int);
+	for (unsigned int i = 0; i < header.chunkCount; i++) {
+		chunkOffsets[i] = dataOffset + writer.data.length();
+		writeChunk(writer, animation, i, chunkDuration, header.chunkCount);
+	}
+	chunkOffsets[header.chunkCount] = dataOffset + writer.data.length();
+
+	swapWords(&header.version, (sizeof(header) - sizeof(header.magic)) / 4);
+	swapWords(&chunkOffsets[0], chunkOffsets.size());
+	output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	output.write(reinterpret_cast<const char*>(&chunkOffsets[0]), chunkOffsets.size() * sizeof(unsigned int));
+	output.write(writer.data.data(), writer.data.length());
+	if (!output) throw runtime_error("Error writing streaming animation.");
+}
+
+} /* namespace spine */
@@ -0,0 +1,202 @@
+/*******************************************************************************
+ * Copyright (c) 2013, Esoteric Software
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ******************************************************************************/
+
+/* Checks that an AnimationBundle written from animation files is stored little endian, lists the animations by name, decodes each
+ * only when first requested, evicts the least recently requested unpinned animations to fit a budget, and rejects truncated and
+ * corrupt files, both when reading from a file and from memory.
+ *
+ * The bundle and its animation files are written to the working directory. */
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <spine/Animation.h>
+#include <spine/AnimationBundle.h>
+#include <spine/BaseSkeletonJson.h>
+#include <spine/HeadlessAttachmentLoader.h>
+#include <spine/SkeletonData.h>
+#include "../benchmark/RigGenerator.h"
+#include "../benchmark/RigLoader.h"
+
+using namespace spine;
+
+static const int BONE_COUNT = 20;
+static const int ANIMATION_COUNT = 3;
+static const char* const NAMES[ANIMATION_COUNT] = {"small", "medium", "large"};
+static const int KEY_COUNTS[ANIMATION_COUNT] = {2, 10, 40};
+static const char* const BUNDLE_PATH = "AnimationBundleTest.bundle";
+
+static int failures;
+
+static void check (bool condition, const std::string &message) {
+	if (condition) return;
+	printf("FAILED: %s\n", message.c_str());
+	failures++;
+}
+
+static unsigned int readWord (const std::string &data, size_t offset) {
+	const unsigned char *bytes = reinterpret_cast<const unsigned char*>(data.data() + offset);
+	return bytes[0] | bytes[1] << 8 | bytes[2] << 16 | (unsigned int)bytes[3] << 24;
+}
+
+static void writeWord (std::string &data, size_t offset, unsigned int word) {
+	for (int i = 0; i < 4; i++)
+		data[offset + i] = (char)(word >> i * 8);
+}
+
+static void writeFile (const std::string &path, const std::string &data) {
+	std::ofstream file(path.c_str(), std::ios::out | std::ios::binary);
+	file.write(data.data(), data.length());
+}
+
+/** Returns true if the bundle can't be opened from the data, in memory or as a file. */
+static bool rejected (const std::string &data, const BaseSkeletonJson &json, const SkeletonData *skeletonData) {
+	int rejections = 0;
+	try {
+		AnimationBundle bundle(data.data(), data.data() + data.length(), &json, skeletonData);
+	} catch (const std::runtime_error &) {
+		rejections++;
+	}
+	writeFile(BUNDLE_PATH, data);
+	try {
+		AnimationBundle bundle(BUNDLE_PATH, &json, skeletonData);
+	} catch (const std::runtime_error &) {
+		rejections++;
+	}
+	return rejections == 2;
+}
+
+static void checkBundle (AnimationBundle &bundle, const std::vector<Animation*> &expected, const std::string &name) {
+	check(bundle.getAnimationCount() == ANIMATION_COUNT, name + ": animation count");
+	for (int i = 0; i < ANIMATION_COUNT && i < bundle.getAnimationCount(); i++) {
+		check(bundle.getAnimationName(i) == NAMES[i], name + ": animation name " + NAMES[i]);
+		check(bundle.hasAnimation(NAMES[i]), name + ": hasAnimation " + NAMES[i]);
+	}
+	check(!bundle.hasAnimation("missing") && !bundle.getAnimation("missing"), name + ": missing animation found");
+
+	// Animations are decoded when first requested and then kept.
+	size_t bytes[ANIMATION_COUNT], total = 0;
+	for (int i = 0; i < ANIMATION_COUNT; i++) {
+		check(!bundle.isDecoded(NAMES[i]), name + ": decoded before requested " + NAMES[i]);
+		Animation *animation = bundle.getAnimation(NAMES[i]);
+		check(animation && bundle.isDecoded(NAMES[i]) && bundle.getAnimation(NAMES[i]) == animation,
+				name + ": not decoded once " + NAMES[i]);
+		if (!animation) return;
+		check(animation->timelines.size() == expected[i]->timelines.size() && animation->duration == expected[i]->duration,
+				name + ": decoded differently " + NAMES[i]);
+		bytes[i] = animation->memoryUsage().getTotalBytes();
+		total += bytes[i];
+		check(bundle.getDecodedBytes() == total, name + ": decoded bytes " + NAMES[i]);
+	}
+
+	// Requested in the order small, medium, large, small: medium is the least recently requested.
+	bundle.getAnimation("small");
+	check(bundle.trim(total - 1) == bytes[0] + bytes[2], name + ": trim kept the wrong bytes");
+	check(!bundle.isDecoded("medium") && bundle.isDecoded("small") && bundle.isDecoded("large"),
+			name + ": trim didn't evict the least recently requested");
+
+	bundle.setPinned("large", true);
+	check(bundle.trim(0) == bytes[2], name + ": trim evicted a pinned animation");
+	check(!bundle.isDecoded("small") && bundle.isDecoded("large"), name + ": trim to 0");
+	bundle.evict("large");
+	check(!bundle.isDecoded("large") && !bundle.getDecodedBytes(), name + ": evict");
+
+	check(bundle.getAnimation("medium") && bundle.getDecodedBytes() == bytes[1], name + ": not decoded again after eviction");
+
+	bool thrown = false;
+	try {
+		bundle.setPinned("missing", true);
+	} catch (const std::invalid_argument &) {
+		thrown = true;
+	}
+	check(thrown, name + ": pinning a missing animation didn't throw");
+}
+
+int main () {
+	BaseSkeletonJson json(new HeadlessAttachmentLoader());
+	std::string skeleton = generateSkeleton(BONE_COUNT);
+	SkeletonData *skeletonData = json.readSkeletonData(skeleton.data(), skeleton.data() + skeleton.length());
+
+	std::vector<std::string> names, paths;
+	std::vector<Animation*> expected;
+	for (int i = 0; i < ANIMATION_COUNT; i++) {
+		std::string animation = generateAnimation(BONE_COUNT, KEY_COUNTS[i], i);
+		names.push_back(NAMES[i]);
+		paths.push_back(std::string("AnimationBundleTest-") + NAMES[i] + ".json");
+		writeFile(paths[i], animation);
+		expected.push_back(json.readAnimation(animation.data(), animation.data() + animation.length(), skeletonData));
+	}
+
+	std::ostringstream output;
+	AnimationBundle::write(output, names, paths);
+	std::string data = output.str();
+	check(readWord(data, 4) == 1 && readWord(data, 8) == ANIMATION_COUNT, "header is not stored little endian");
+
+	{
+		AnimationBundle bundle(data.data(), data.data() + data.length(), &json, skeletonData);
+		checkBundle(bundle, expected, "memory");
+	}
+	writeFile(BUNDLE_PATH, data);
+	{
+		AnimationBundle bundle(BUNDLE_PATH, &json, skeletonData);
+		checkBundle(bundle, expected, "file");
+	}
+
+	// Every truncation cuts the header, the index or an animation that the index refers to.
+	for (size_t length = 0; length < data.length(); length += length < 200 ? 3 : 997) {
+		std::ostringstream message;
+		message << "truncated to " << length << " bytes was opened";
+		check(rejected(data.substr(0, length), json, skeletonData), message.str());
+	}
+	std::string corrupt = data;
+	corrupt[1] = 'X';
+	check(rejected(corrupt, json, skeletonData), "bad magic was opened");
+	corrupt = data;
+	writeWord(corrupt, 4, 2);
+	check(rejected(corrupt, json, skeletonData), "unsupported version was opened");
+	corrupt = data;
+	writeWord(corrupt, 12, 0xffffff00);
+	check(rejected(corrupt, json, skeletonData), "index larger than the file was opened");
+	corrupt = data;
+	writeWord(corrupt, 16 + 8, 0xfffffff0); // The first entry's offset, which overflows when its length is added.
+	check(rejected(corrupt, json, skeletonData), "entry out of range was opened");
+	corrupt = data;
+	writeWord(corrupt, 16 + 4, 1000); // The first entry's name length.
+	check(rejected(corrupt, json, skeletonData), "name out of range was opened");
+
+	std::remove(BUNDLE_PATH);
+	for (int i = 0; i < ANIMATION_COUNT; i++) {
+		std::remove(paths[i].c_str());
+		delete expected[i];
+	}
+	delete skeletonData;
+
+	if (failures) return 1;
+	printf("OK: write, name index, lazy decoding, eviction and corrupt bundles.\n");
+	return 0;
+}
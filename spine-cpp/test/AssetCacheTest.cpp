@@ -0,0 +1,117 @@
+/*******************************************************************************
+ * Copyright (c) 2013, Esoteric Software
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ******************************************************************************/
+
+/* Checks that an AssetCache shares loaded assets, counts them by their memoryUsage totals, keeps referenced assets, evicts the least
+ * recently used unreferenced ones when over its budget, and retries failed loads.
+ *
+ * The optional argument is the directory containing spineboy-skeleton.json, spineboy-walk.json and spineboy.atlas, by default
+ * ../spine-sfml/data/. */
+
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <spine/Animation.h>
+#include <spine/AssetCache.h>
+#include <spine/BaseSkeletonJson.h>
+#include <spine/HeadlessAtlas.h>
+#include <spine/HeadlessAttachmentLoader.h>
+#include <spine/SkeletonData.h>
+
+using namespace spine;
+
+static int failures;
+
+static void check (bool condition, const char *message) {
+	if (condition) return;
+	printf("FAILED: %s\n", message);
+	failures++;
+}
+
+int main (int argc, char **argv) {
+	std::string dir = argc > 1 ? argv[1] : "../spine-sfml/data/";
+	if (dir[dir.size() - 1] != '/') dir += '/';
+	BaseSkeletonJson json(new HeadlessAttachmentLoader());
+	std::string skeletonPath = dir + "spineboy-skeleton.json", walkPath = dir + "spineboy-walk.json";
+	std::string atlasPath = dir + "spineboy.atlas";
+
+	AssetCache cache((size_t)-1);
+	AssetCache::Handle<SkeletonData> skeletonData = cache.getSkeletonData(&json, skeletonPath);
+	check(skeletonData && cache.getSkeletonData(&json, skeletonPath).get() == skeletonData.get(), "skeleton data not shared");
+	AssetCache::Stats stats = cache.getStats();
+	check(stats.misses == 1 && stats.hits == 1, "hits and misses");
+	size_t skeletonBytes = skeletonData->memoryUsage().getTotalBytes();
+	check(stats.bytes == skeletonBytes, "bytes are not the skeleton data's memoryUsage total");
+
+	size_t walkBytes, atlasBytes;
+	{
+		AssetCache::Handle<Animation> walk = cache.getAnimation(&json, walkPath, skeletonData.get());
+		AssetCache::Handle<HeadlessAtlas> atlas = cache.getAtlas<HeadlessAtlas>(atlasPath);
+		walkBytes = walk->memoryUsage().getTotalBytes();
+		atlasBytes = atlas->memoryUsage().getTotalBytes();
+		check(cache.getStats().bytes == skeletonBytes + walkBytes + atlasBytes, "bytes are not the sum of the memoryUsage totals");
+	}
+	check(!cache.getStats().evictions, "evicted within the budget");
+
+	// The walk is used after the atlas, so the atlas is the least recently used unreferenced asset.
+	cache.getAnimation(&json, walkPath, skeletonData.get());
+	cache.setByteBudget(cache.getStats().bytes - 1);
+	stats = cache.getStats();
+	check(stats.evictions == 1 && stats.bytes == skeletonBytes + walkBytes, "least recently used asset not evicted first");
+	unsigned long misses = stats.misses;
+	cache.getAnimation(&json, walkPath, skeletonData.get());
+	check(cache.getStats().misses == misses, "walk reloaded after the atlas was evicted");
+
+	// Referenced assets are kept over the budget and evicted once released.
+	{
+		AssetCache::Handle<HeadlessAtlas> atlas = cache.getAtlas<HeadlessAtlas>(atlasPath);
+		check(cache.getStats().misses == misses + 1, "evicted atlas not reloaded");
+		cache.setByteBudget(0);
+		stats = cache.getStats();
+		check(stats.bytes == skeletonBytes + atlasBytes && stats.evictions == 2, "referenced asset evicted or unreferenced kept");
+	}
+	stats = cache.getStats();
+	check(stats.bytes == skeletonBytes && stats.evictions == 3, "released asset not evicted over the budget");
+
+	// A failed load is reported to every request and retried by the next one.
+	misses = stats.misses;
+	for (int i = 0; i < 2; i++) {
+		bool thrown = false;
+		try {
+			cache.getSkeletonData(&json, dir + "missing.json");
+		} catch (const std::exception &) {
+			thrown = true;
+		}
+		check(thrown, "missing file didn't throw");
+	}
+	check(cache.getStats().misses == misses + 2, "failed load not retried");
+
+	skeletonData = AssetCache::Handle<SkeletonData>();
+	stats = cache.getStats();
+	check(!stats.bytes && stats.evictions == 4, "skeleton data not evicted once released");
+
+	if (failures) return 1;
+	printf("OK: sharing, budget and eviction.\n");
+	return 0;
+}
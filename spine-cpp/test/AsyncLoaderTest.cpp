@@ -0,0 +1,177 @@
+/*******************************************************************************
+ * Copyright (c) 2013, Esoteric Software
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ******************************************************************************/
+
+/* Loads spineboy with an AsyncLoader and checks that completions are delivered by update, that read and parse errors reach both the
+ * future and the callback, and that destroying the loader with completions still queued frees the loaded objects and fails their
+ * futures without calling their callbacks.
+ *
+ * The optional argument is the directory containing spineboy-skeleton.json, spineboy-walk.json and spineboy.atlas, by default
+ * ../spine-sfml/data/. */
+
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <spine/Allocator.h>
+#include <spine/Animation.h>
+#include <spine/AsyncLoader.h>
+#include <spine/BaseSkeletonJson.h>
+#include <spine/HeadlessAttachmentLoader.h>
+#include <spine/SkeletonData.h>
+#include "TestAtlas.h"
+
+using namespace spine;
+
+/** Serves invalid JSON for bad.json. */
+class TestLoader: public AsyncLoader {
+public:
+	virtual ~TestLoader () {
+		stop();
+	}
+
+protected:
+	virtual void readFile (const std::string &path, std::string &data) {
+		if (path == "bad.json")
+			data = "{ \"bones\": [ { \"name\": ";
+		else
+			AsyncLoader::readFile(path, data);
+	}
+};
+
+static int failures;
+
+static void check (bool condition, const char *message) {
+	if (condition) return;
+	printf("FAILED: %s\n", message);
+	failures++;
+}
+
+static size_t getRuntimeBytes () {
+	size_t bytes = 0;
+	for (int i = 0; i < allocationTagCount; i++)
+		bytes += getAllocatedBytes((AllocationTag)i);
+	return bytes;
+}
+
+/** Calls update until nothing is pending, or gives up after 10 seconds. */
+static void finish (AsyncLoader &loader) {
+	std::chrono::steady_clock::time_point timeout = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+	while (loader.getPendingCount() && std::chrono::steady_clock::now() < timeout) {
+		loader.update();
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+}
+
+template<class T>
+static bool throws (const std::shared_future<T*> &future) {
+	try {
+		future.get();
+	} catch (const std::exception &) {
+		return true;
+	}
+	return false;
+}
+
+int main (int argc, char **argv) {
+	std::string dir = argc > 1 ? argv[1] : "../spine-sfml/data/";
+	if (dir[dir.size() - 1] != '/') dir += '/';
+	BaseSkeletonJson json(new HeadlessAttachmentLoader());
+
+	// Completion.
+	{
+		TestLoader loader;
+		SkeletonData *calledSkeletonData = 0;
+		TestAtlas *calledAtlas = 0;
+		std::shared_future<SkeletonData*> skeletonData = loader.loadSkeletonData(&json, dir + "spineboy-skeleton.json",
+				[&] (SkeletonData *value) {
+					calledSkeletonData = value;
+				});
+		std::shared_future<TestAtlas*> atlas = loader.loadAtlas<TestAtlas>(dir + "spineboy.atlas", [&] (TestAtlas *value) {
+			calledAtlas = value;
+		});
+		finish(loader);
+		check(!loader.getPendingCount(), "completion: loads still pending after 10 seconds");
+		check(calledSkeletonData && skeletonData.get() == calledSkeletonData, "completion: skeleton data callback and future");
+		check(calledAtlas && atlas.get() == calledAtlas, "completion: atlas callback and future");
+		check(calledAtlas && calledAtlas->textureCount == 1, "completion: atlas textures not loaded by update");
+		if (calledSkeletonData) {
+			std::vector<std::shared_future<Animation*> > animations = loader.loadAnimations(&json,
+					std::vector<std::string>(3, dir + "spineboy-walk.json"), calledSkeletonData);
+			finish(loader);
+			for (int i = 0, n = animations.size(); i < n; i++) {
+				check(animations[i].get() && animations[i].get()->duration > 0, "completion: animation");
+				delete animations[i].get();
+			}
+		}
+		delete calledSkeletonData;
+		delete calledAtlas;
+	}
+
+	// Errors.
+	{
+		TestLoader loader;
+		int nullCount = 0;
+		std::function<void(SkeletonData*)> callback = [&] (SkeletonData *value) {
+			if (!value) nullCount++;
+		};
+		std::shared_future<SkeletonData*> missing = loader.loadSkeletonData(&json, dir + "missing.json", callback);
+		std::shared_future<SkeletonData*> bad = loader.loadSkeletonData(&json, "bad.json", callback);
+		std::shared_future<TestAtlas*> missingAtlas = loader.loadAtlas<TestAtlas>(dir + "missing.atlas");
+		finish(loader);
+		check(nullCount == 2, "errors: callbacks not called with 0");
+		check(throws(missing), "errors: missing file future didn't throw");
+		check(throws(bad), "errors: invalid JSON future didn't throw");
+		check(throws(missingAtlas), "errors: missing atlas future didn't throw");
+	}
+
+	// Destroying the loader with completions queued.
+	{
+		size_t bytes = getRuntimeBytes();
+		int callbackCount = 0;
+		std::shared_future<SkeletonData*> skeletonData;
+		std::shared_future<TestAtlas*> atlas;
+		{
+			TestLoader loader;
+			skeletonData = loader.loadSkeletonData(&json, dir + "spineboy-skeleton.json", [&] (SkeletonData*) {
+				callbackCount++;
+			});
+			atlas = loader.loadAtlas<TestAtlas>(dir + "spineboy.atlas", [&] (TestAtlas*) {
+				callbackCount++;
+			});
+		}
+		check(!callbackCount, "destroyed: callbacks called");
+		check(throws(skeletonData), "destroyed: skeleton data future didn't throw");
+		check(throws(atlas), "destroyed: atlas future didn't throw");
+		check(!TestAtlas::getLiveCount(), "destroyed: atlas not deleted");
+		check(getRuntimeBytes() == bytes, "destroyed: skeleton data not deleted");
+	}
+
+	if (failures) return 1;
+	printf("OK: completions, errors and destroyed loads.\n");
+	return 0;
+}
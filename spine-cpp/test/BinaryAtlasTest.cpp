@@ -0,0 +1,287 @@
+/*******************************************************************************
+ * Copyright (c) 2013, Esoteric Software
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ******************************************************************************/
+
+/* Converts atlases to the binary format and checks that loading them gives the same pages and regions as the text format, that
+ * rotated regions get UVs for their swapped size, that writing a loaded binary atlas reproduces it byte for byte, and that damaged
+ * binary data is rejected or reindexed rather than trusted.
+ *
+ * The optional argument is the directory containing spineboy.atlas, by default ../spine-sfml/data/. */
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <spine/BaseAtlas.h>
+#include <spine/HeadlessAtlas.h>
+#include "../benchmark/RigLoader.h"
+
+using namespace spine;
+
+static const int HEADER_SIZE = 24;
+static const int PAGE_SIZE = 32;
+static const int REGION_SIZE = 96;
+
+/** One page of 100 by 200 pixels with a rotated region, a region with splits and pads, and two regions with the same name. */
+static const char* const ROTATED_ATLAS = "\n"
+	"rotated.png\n"
+	"format: RGBA8888\n"
+	"filter: Linear,Linear\n"
+	"repeat: none\n"
+	"sideways\n"
+	"  rotate: true\n"
+	"  xy: 10, 20\n"
+	"  size: 30, 40\n"
+	"  orig: 30, 40\n"
+	"  offset: 0, 0\n"
+	"  index: -1\n"
+	"ninepatch\n"
+	"  rotate: false\n"
+	"  xy: 50, 60\n"
+	"  size: 20, 20\n"
+	"  split: 1, 2, 3, 4\n"
+	"  pad: 5, 6, 7, 8\n"
+	"  orig: 20, 20\n"
+	"  offset: 0, 0\n"
+	"  index: -1\n"
+	"frame\n"
+	"  rotate: false\n"
+	"  xy: 0, 100\n"
+	"  size: 10, 10\n"
+	"  orig: 10, 10\n"
+	"  offset: 0, 0\n"
+	"  index: 0\n"
+	"frame\n"
+	"  rotate: false\n"
+	"  xy: 10, 100\n"
+	"  size: 10, 10\n"
+	"  orig: 10, 10\n"
+	"  offset: 0, 0\n"
+	"  index: 1\n";
+
+/** An atlas whose textures all have the given size. */
+class SizedAtlas: public BaseAtlas {
+public:
+	SizedAtlas (const std::string &data, int textureWidth, int textureHeight) :
+					textureWidth(textureWidth),
+					textureHeight(textureHeight) {
+		load(data.data(), data.data() + data.length());
+	}
+
+private:
+	int textureWidth, textureHeight;
+
+	virtual void loadTexture (BaseAtlasPage *page) {
+		page->width = textureWidth;
+		page->height = textureHeight;
+	}
+
+	virtual BaseAtlasPage* newAtlasPage (const std::string&) {
+		return new BaseAtlasPage();
+	}
+
+	virtual BaseAtlasRegion* newAtlasRegion (BaseAtlasPage*) {
+		return new BaseAtlasRegion();
+	}
+};
+
+static int failures;
+
+static void check (bool condition, const std::string &message) {
+	if (condition) return;
+	printf("FAILED: %s\n", message.c_str());
+	failures++;
+}
+
+static unsigned int readWord (const std::string &data, size_t offset) {
+	const unsigned char *bytes = reinterpret_cast<const unsigned char*>(data.data() + offset);
+	return bytes[0] | bytes[1] << 8 | bytes[2] << 16 | (unsigned int)bytes[3] << 24;
+}
+
+static void writeWord (std::string &data, size_t offset, unsigned int word) {
+	for (int i = 0; i < 4; i++)
+		data[offset + i] = (char)(word >> i * 8);
+}
+
+static std::string convert (const std::string &text, int pageWidth, int pageHeight) {
+	std::vector<std::pair<int, int> > pageSizes(1, std::make_pair(pageWidth, pageHeight));
+	std::ostringstream output;
+	BaseAtlas::convertToBinary(text.data(), text.data() + text.length(), pageSizes, output);
+	return output.str();
+}
+
+static bool sameInts (const int *a, const int *b) {
+	if (!a || !b) return a == b;
+	return memcmp(a, b, sizeof(int) * 4) == 0;
+}
+
+static void checkSameRegions (const BaseAtlas &text, const BaseAtlas &binary, const std::string &name) {
+	check(text.pages.size() == binary.pages.size(), name + ": page count");
+	check(text.regions.size() == binary.regions.size(), name + ": region count");
+	for (int i = 0, n = std::min(text.pages.size(), binary.pages.size()); i < n; i++) {
+		const BaseAtlasPage *a = text.pages[i], *b = binary.pages[i];
+		check(a->name == b->name && a->format == b->format && a->minFilter == b->minFilter && a->magFilter == b->magFilter
+				&& a->uWrap == b->uWrap && a->vWrap == b->vWrap, name + ": page " + a->name.str());
+	}
+	for (int i = 0, n = std::min(text.regions.size(), binary.regions.size()); i < n; i++) {
+		const BaseAtlasRegion *a = text.regions[i], *b = binary.regions[i];
+		check(a->name == b->name && a->x == b->x && a->y == b->y && a->width == b->width && a->height == b->height
+				&& a->offsetX == b->offsetX && a->offsetY == b->offsetY && a->originalWidth == b->originalWidth
+				&& a->originalHeight == b->originalHeight && a->index == b->index && a->rotate == b->rotate
+				&& sameInts(a->splits, b->splits) && sameInts(a->pads, b->pads), name + ": region " + a->name.str());
+	}
+}
+
+/** Checks that findRegion returns the first region with each name and nothing for an unknown name. */
+static void checkFindRegion (BaseAtlas &atlas, const std::string &name) {
+	for (int i = 0, n = atlas.regions.size(); i < n; i++) {
+		BaseAtlasRegion *first = 0;
+		for (int ii = 0; ii <= i && !first; ii++)
+			if (atlas.regions[ii]->name == atlas.regions[i]->name) first = atlas.regions[ii];
+		check(atlas.findRegion(atlas.regions[i]->name.str()) == first, name + ": findRegion " + atlas.regions[i]->name.str());
+	}
+	check(!atlas.findRegion("missing"), name + ": findRegion missing");
+}
+
+static void checkRoundTrip (const std::string &text, int pageWidth, int pageHeight, const std::string &name) {
+	std::string binary = convert(text, pageWidth, pageHeight);
+	check(readWord(binary, 4) == 1, name + ": version is not stored little endian");
+
+	HeadlessAtlas fromText(text.data(), text.data() + text.length());
+	HeadlessAtlas fromBinary(binary.data(), binary.data() + binary.length());
+	checkSameRegions(fromText, fromBinary, name);
+	checkFindRegion(fromText, name + " text");
+	checkFindRegion(fromBinary, name + " binary");
+
+	for (int i = 0, n = fromBinary.regions.size(); i < n; i++) {
+		BaseAtlasRegion expected = *fromText.regions[i];
+		expected.splits = expected.pads = 0;
+		expected.updateUVs(pageWidth, pageHeight);
+		const BaseAtlasRegion *region = fromBinary.regions[i];
+		check(region->u == expected.u && region->v == expected.v && region->u2 == expected.u2 && region->v2 == expected.v2,
+				name + ": UVs of " + region->name.str());
+	}
+
+	std::ostringstream rewritten;
+	fromBinary.writeBinary(rewritten);
+	check(rewritten.str() == binary, name + ": writeBinary differs from convertToBinary");
+}
+
+int main (int argc, char **argv) {
+	std::string dir = argc > 1 ? argv[1] : "../spine-sfml/data/";
+	if (dir[dir.size() - 1] != '/') dir += '/';
+
+	std::string spineboy = readFile(dir + "spineboy.atlas");
+	if (spineboy.empty()) {
+		printf("FAILED: Unable to read spineboy.atlas from %s\n", dir.c_str());
+		return 1;
+	}
+	checkRoundTrip(spineboy, 256, 256, "spineboy");
+	checkRoundTrip(ROTATED_ATLAS, 100, 200, "rotated");
+
+	// A rotated region occupies height by width pixels in the page.
+	std::string rotated = convert(ROTATED_ATLAS, 100, 200);
+	{
+		HeadlessAtlas atlas(rotated.data(), rotated.data() + rotated.length());
+		const BaseAtlasRegion *region = atlas.findRegion("sideways");
+		check(region && std::fabs(region->u - 0.1f) < 1e-6f && std::fabs(region->v - 0.1f) < 1e-6f
+				&& std::fabs(region->u2 - 0.5f) < 1e-6f && std::fabs(region->v2 - 0.25f) < 1e-6f, "rotated: sideways UVs");
+	}
+
+	// A table without an empty bucket, or with an entry that findRegion can't reach, must be rebuilt rather than probed forever.
+	size_t tableOffset = HEADER_SIZE + readWord(rotated, 8) * PAGE_SIZE + readWord(rotated, 12) * REGION_SIZE;
+	unsigned int tableSize = readWord(rotated, 16);
+	std::string full = rotated, shifted = rotated;
+	for (unsigned int i = 0; i < tableSize; i++) {
+		writeWord(full, tableOffset + i * 4, 1);
+		writeWord(shifted, tableOffset + i * 4, readWord(rotated, tableOffset + (i + 1) % tableSize * 4));
+	}
+	{
+		HeadlessAtlas atlas(full.data(), full.data() + full.length());
+		checkFindRegion(atlas, "full table");
+	}
+	{
+		HeadlessAtlas atlas(shifted.data(), shifted.data() + shifted.length());
+		checkFindRegion(atlas, "shifted table");
+	}
+	std::string outOfRange = rotated;
+	writeWord(outOfRange, tableOffset, 1000);
+	{
+		HeadlessAtlas atlas(outOfRange.data(), outOfRange.data() + outOfRange.length());
+		checkFindRegion(atlas, "out of range table");
+	}
+
+	// Stored UVs are kept when the texture has the stored page size and recomputed when it doesn't.
+	size_t firstURegion = HEADER_SIZE + readWord(rotated, 8) * PAGE_SIZE + 80;
+	std::string marked = rotated;
+	float marker = 0.125f;
+	unsigned int markerWord;
+	memcpy(&markerWord, &marker, 4);
+	writeWord(marked, firstURegion, markerWord);
+	{
+		SizedAtlas atlas(marked, 100, 200);
+		check(atlas.regions[0]->u == marker, "stored UVs recomputed for a texture of the stored size");
+		SizedAtlas resized(marked, 200, 200);
+		check(std::fabs(resized.regions[0]->u - 0.05f) < 1e-6f, "stored UVs not recomputed for a texture of another size");
+		SizedAtlas text(ROTATED_ATLAS, 100, 200);
+		check(std::fabs(text.regions[0]->u - 0.1f) < 1e-6f, "text atlas UVs not computed");
+	}
+
+	// Page formats, filters and wraps outside their enums are rejected. The format and filters have 7 values, the wraps 3.
+	for (int field = 1; field <= 5; field++) {
+		int values[] = {-1, field <= 3 ? 7 : 3};
+		for (int i = 0; i < 2; i++) {
+			std::string invalid = rotated;
+			writeWord(invalid, HEADER_SIZE + field * 4, values[i]);
+			bool thrown = false;
+			try {
+				HeadlessAtlas atlas(invalid.data(), invalid.data() + invalid.length());
+			} catch (const std::runtime_error &) {
+				thrown = true;
+			}
+			std::ostringstream message;
+			message << "page field " << field << " of " << values[i] << " was loaded";
+			check(thrown, message.str());
+		}
+	}
+
+	for (size_t length = 4; length < rotated.length(); length += 13) {
+		bool thrown = false;
+		try {
+			HeadlessAtlas atlas(rotated.data(), rotated.data() + length);
+		} catch (const std::runtime_error &) {
+			thrown = true;
+		}
+		std::ostringstream message;
+		message << "truncated to " << length << " bytes was loaded";
+		check(thrown, message.str());
+	}
+
+	if (failures) return 1;
+	printf("OK: spineboy and rotated atlases round trip through the binary format, stored UVs and page fields.\n");
+	return 0;
+}
@@ -0,0 +1,208 @@
+/*******************************************************************************
+ * Copyright (c) 2013, Esoteric Software
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ******************************************************************************/
+
+/* Plays every animation of spineboy and of generated rigs through the runtime and through ReferencePose, and checks that bone world
+ * transforms, slot colors and attachments agree. Each animation is sampled from before its first key to past its end, with and
+ * without looping, applied alone and mixed at several alphas over another animation. The pipelines checked are Animation, a
+ * SkeletonPose captured from it, and a StreamingAnimation written from it.
+ *
+ * Usage: DifferentialTest [dir] [--position epsilon] [--matrix epsilon] [--color epsilon]
+ * The directory contains spineboy-skeleton.json and spineboy-walk.json, by default ../spine-sfml/data/. The epsilons are the
+ * largest differences allowed for bone world positions, bone world matrix entries and slot color channels. */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <spine/Animation.h>
+#include <spine/BaseSkeletonJson.h>
+#include <spine/BoneData.h>
+#include <spine/HeadlessAttachmentLoader.h>
+#include <spine/HeadlessSkeleton.h>
+#include <spine/ReferencePose.h>
+#include <spine/SkeletonData.h>
+#include <spine/SkeletonPose.h>
+#include <spine/SlotData.h>
+#include <spine/StreamingAnimation.h>
+#include "../benchmark/RigGenerator.h"
+#include "../benchmark/RigLoader.h"
+
+using namespace spine;
+
+static const int SAMPLE_COUNT = 97;
+static const float ALPHAS[] = {1, 0.75f, 0.5f, 0.25f, 0};
+static const int ALPHA_COUNT = 5;
+
+/** A rig and how its skeleton is posed. */
+struct Case {
+	Rig *rig;
+	/** May be empty. */
+	std::string skin;
+	bool flipX;
+};
+
+enum Pipeline {
+	animationPipeline, capturedPipeline, streamingPipeline, pipelineCount
+};
+static const char* const PIPELINE_NAMES[] = {"animation", "captured", "streaming"};
+
+/** Writes the animation in the chunked format and opens it as a StreamingAnimation. */
+static StreamingAnimation* streamAnimation (const Animation *animation, const std::string &path) {
+	std::ofstream file(path.c_str(), std::ios::binary);
+	StreamingAnimation::write(file, *animation, 0.25f);
+	file.close();
+	return new StreamingAnimation(path, 2);
+}
+
+/** Poses the skeleton and the reference with the animation at the time, mixed over the base animation if alpha is less than 1. */
+static void pose (HeadlessSkeleton *skeleton, const Animation *animation, ReferencePose &reference, const Animation *checked,
+		const Animation *base, float time, bool loop, float alpha) {
+	skeleton->setToBindPose();
+	reference.setToBindPose();
+	if (alpha < 1) {
+		base->apply(skeleton, time * 0.7f, true);
+		reference.apply(base, time * 0.7f, true);
+		animation->mix(skeleton, time, loop, alpha);
+		reference.apply(checked, time, loop, alpha);
+	} else {
+		animation->apply(skeleton, time, loop);
+		reference.apply(checked, time, loop);
+	}
+	skeleton->updateWorldTransform();
+	reference.updateWorldTransform();
+}
+
+int main (int argc, char **argv) {
+	std::string dir = "../spine-sfml/data/";
+	double positionEpsilon = 0.05, matrixEpsilon = 0.001, colorEpsilon = 0.00001;
+	for (int i = 1; i < argc; i++) {
+		if (i + 1 < argc && strcmp(argv[i], "--position") == 0)
+			positionEpsilon = atof(argv[++i]);
+		else if (i + 1 < argc && strcmp(argv[i], "--matrix") == 0)
+			matrixEpsilon = atof(argv[++i]);
+		else if (i + 1 < argc && strcmp(argv[i], "--color") == 0)
+			colorEpsilon = atof(argv[++i]);
+		else
+			dir = argv[i];
+	}
+	if (dir[dir.size() - 1] != '/') dir += '/';
+
+	BaseSkeletonJson json(new HeadlessAttachmentLoader());
+	std::vector<Case> cases;
+	std::string spineboy = readFile(dir + "spineboy-skeleton.json"), walk = readFile(dir + "spineboy-walk.json");
+	if (spineboy.empty() || walk.empty()) {
+		printf("FAILED: Unable to read spineboy from %s\n", dir.c_str());
+		return 1;
+	}
+	Case spineboyCase = {loadRig(json, "spineboy", spineboy, std::vector<std::string>(1, walk), 0), "", false};
+	cases.push_back(spineboyCase);
+	const int boneCounts[] = {15, 40, 100};
+	for (int i = 0; i < 3; i++) {
+		std::vector<std::string> animations;
+		animations.push_back(generateAnimation(boneCounts[i], 12, 1));
+		animations.push_back(generateAnimation(boneCounts[i], 7, 2));
+		std::ostringstream name;
+		name << "generated-" << boneCounts[i];
+		Case generated = {loadRig(json, name.str(), generateSkeleton(boneCounts[i]), animations, 0), i > 0 ? "red" : "", i == 1};
+		cases.push_back(generated);
+	}
+
+	int failures = 0;
+	for (int r = 0, rn = cases.size(); r < rn; r++) {
+		Rig *rig = cases[r].rig;
+		HeadlessSkeleton skeleton(rig->skeletonData);
+		ReferencePose reference(rig->skeletonData);
+		if (!cases[r].skin.empty()) skeleton.setSkin(cases[r].skin);
+		reference.skin = skeleton.skin;
+		skeleton.flipX = reference.flipX = cases[r].flipX;
+		SkeletonPose captured;
+
+		for (int pipeline = 0; pipeline < pipelineCount; pipeline++) {
+			PoseDeviation deviation;
+			int samples = 0;
+			for (int a = 0, an = rig->animations.size(); a < an; a++) {
+				const Animation *checked = rig->animations[a];
+				const Animation *base = rig->animations[(a + 1) % an];
+				StreamingAnimation *streaming = 0;
+				std::string path;
+				if (pipeline == streamingPipeline) {
+					std::ostringstream stream;
+					stream << "DifferentialTest-" << r << "-" << a << ".chunks";
+					path = stream.str();
+					streaming = streamAnimation(checked, path);
+				}
+				const Animation *animation = streaming ? streaming : checked;
+
+				for (int loop = 0; loop < 2; loop++) {
+					for (int s = 0; s < SAMPLE_COUNT; s++) {
+						float time = checked->duration * (-0.1f + 1.35f * s / (SAMPLE_COUNT - 1));
+						for (int i = 0; i < ALPHA_COUNT; i++) {
+							pose(&skeleton, animation, reference, checked, base, time, loop != 0, ALPHAS[i]);
+							PoseDeviation sample;
+							if (pipeline == capturedPipeline) {
+								captured.capture(&skeleton);
+								sample = reference.compare(captured);
+							} else
+								sample = reference.compare(&skeleton);
+							if (sample.exceeds(positionEpsilon, matrixEpsilon, colorEpsilon) && !deviation.exceeds(positionEpsilon,
+									matrixEpsilon, colorEpsilon)) {
+								printf("First failure: %s %s animation %d, time %g, loop %d, alpha %g\n", rig->name.c_str(),
+										PIPELINE_NAMES[pipeline], a, time, loop, ALPHAS[i]);
+							}
+							deviation.add(sample);
+							samples++;
+						}
+					}
+				}
+
+				delete streaming;
+				if (!path.empty()) remove(path.c_str());
+			}
+
+			bool failed = deviation.exceeds(positionEpsilon, matrixEpsilon, colorEpsilon);
+			printf("{ \"rig\": \"%s\", \"pipeline\": \"%s\", \"samples\": %d, \"position\": %g, \"matrix\": %g, \"color\": %g, "
+					"\"attachments\": %d, \"bone\": \"%s\", \"slot\": \"%s\" }%s\n", rig->name.c_str(), PIPELINE_NAMES[pipeline],
+					samples, deviation.position, deviation.matrix, deviation.color, deviation.attachments,
+					deviation.bone == -1 ? "" : rig->skeletonData->bones[deviation.bone]->name.c_str(),
+					deviation.slot == -1 ? "" : rig->skeletonData->slots[deviation.slot]->name.c_str(), failed ? " FAILED" : "");
+			if (failed) failures++;
+		}
+	}
+
+	for (int i = 0, n = cases.size(); i < n; i++)
+		disposeRig(cases[i].rig);
+
+	if (failures) {
+		printf("FAILED: %d of %d rig and pipeline pairs exceeded position %g, matrix %g, color %g.\n", failures,
+				(int)cases.size() * pipelineCount, positionEpsilon, matrixEpsilon, colorEpsilon);
+		return 1;
+	}
+	printf("OK: %d rigs through %d pipelines within position %g, matrix %g, color %g.\n", (int)cases.size(), pipelineCount,
+			positionEpsilon, matrixEpsilon, colorEpsilon);
+	return 0;
+}
@@ -0,0 +1,186 @@
+/*******************************************************************************
+ * Copyright (c) 2013, Esoteric Software
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ******************************************************************************/
+
+/* Loads spineboy with an IncrementalLoader in small steps and checks that callbacks receive the loaded objects, that a callback can
+ * queue a dependent load, that failures pass the exception to the callback, and that destroying the loader with unfinished loads
+ * frees them without calling their callbacks.
+ *
+ * The optional argument is the directory containing spineboy-skeleton.json, spineboy-walk.json and spineboy.atlas, by default
+ * ../spine-sfml/data/. */
+
+#include <cstdio>
+#include <exception>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <spine/Allocator.h>
+#include <spine/Animation.h>
+#include <spine/BaseSkeletonJson.h>
+#include <spine/HeadlessAttachmentLoader.h>
+#include <spine/IncrementalLoader.h>
+#include <spine/SkeletonData.h>
+#include "TestAtlas.h"
+
+using namespace spine;
+
+static int failures;
+
+static void check (bool condition, const char *message) {
+	if (condition) return;
+	printf("FAILED: %s\n", message);
+	failures++;
+}
+
+static size_t getRuntimeBytes () {
+	size_t bytes = 0;
+	for (int i = 0; i < allocationTagCount; i++)
+		bytes += getAllocatedBytes((AllocationTag)i);
+	return bytes;
+}
+
+/** Returns true if error holds an exception of type T. */
+template<class T>
+static bool holds (std::exception_ptr error) {
+	if (!error) return false;
+	try {
+		std::rethrow_exception(error);
+	} catch (const T &) {
+		return true;
+	} catch (...) {
+	}
+	return false;
+}
+
+/** Steps until nothing is pending, checking that progress never exceeds 1. Returns the number of steps. */
+static int finish (IncrementalLoader &loader) {
+	int steps = 0;
+	while (!loader.step(0) && steps < 1000000) {
+		check(loader.getProgress() >= 0 && loader.getProgress() <= 1, "progress out of range");
+		steps++;
+	}
+	check(loader.getProgress() == 1, "progress not 1 when idle");
+	return steps;
+}
+
+int main (int argc, char **argv) {
+	std::string dir = argc > 1 ? argv[1] : "../spine-sfml/data/";
+	if (dir[dir.size() - 1] != '/') dir += '/';
+	BaseSkeletonJson json(new HeadlessAttachmentLoader());
+
+	// Completion, with the animation queued by the skeleton data's callback.
+	{
+		IncrementalLoader loader;
+		SkeletonData *skeletonData = 0;
+		Animation *animation = 0;
+		TestAtlas *atlas = 0;
+		int errorCount = 0;
+		loader.loadSkeletonData(&json, dir + "spineboy-skeleton.json", [&] (SkeletonData *value, std::exception_ptr error) {
+			skeletonData = value;
+			if (error) errorCount++;
+			if (value) {
+				loader.loadAnimation(&json, dir + "spineboy-walk.json", value, [&] (Animation *value, std::exception_ptr error) {
+					animation = value;
+					if (error) errorCount++;
+				});
+			}
+		});
+		loader.loadAtlas<TestAtlas>(dir + "spineboy.atlas", [&] (TestAtlas *value, std::exception_ptr error) {
+			atlas = value;
+			if (error) errorCount++;
+		});
+		int steps = finish(loader);
+		check(steps > 3, "completion: loads were not split into steps");
+		check(!errorCount, "completion: callback received an error");
+		check(skeletonData && skeletonData->bones.size() > 1, "completion: skeleton data");
+		check(animation && animation->duration > 0, "completion: animation");
+		check(atlas && atlas->regions.size() > 1 && atlas->textureCount == 1, "completion: atlas");
+		delete animation;
+		delete skeletonData;
+		delete atlas;
+	}
+
+	// Errors.
+	{
+		const char *badPath = "IncrementalLoaderTest-bad.json";
+		const char *missingBonePath = "IncrementalLoaderTest-missing-bone.json";
+		std::ofstream(badPath) << "{ \"bones\": [ { \"name\": ";
+		std::ofstream(missingBonePath) << "{ \"bones\": { \"nobody\": { \"rotate\": [ { \"time\": 0, \"angle\": 0 } ] } } }";
+
+		IncrementalLoader loader;
+		std::exception_ptr missingError, badError, missingBoneError, atlasError;
+		int valueCount = 0;
+		SkeletonData *skeletonData = json.readSkeletonData(dir + "spineboy-skeleton.json");
+		loader.loadSkeletonData(&json, dir + "missing.json", [&] (SkeletonData *value, std::exception_ptr error) {
+			if (value) valueCount++;
+			missingError = error;
+		});
+		loader.loadSkeletonData(&json, badPath, [&] (SkeletonData *value, std::exception_ptr error) {
+			if (value) valueCount++;
+			badError = error;
+		});
+		loader.loadAnimation(&json, missingBonePath, skeletonData, [&] (Animation *value, std::exception_ptr error) {
+			if (value) valueCount++;
+			missingBoneError = error;
+		});
+		loader.loadAtlas<TestAtlas>(dir + "missing.atlas", [&] (TestAtlas *value, std::exception_ptr error) {
+			if (value) valueCount++;
+			atlasError = error;
+		});
+		finish(loader);
+		check(!valueCount, "errors: callback received an object");
+		check(holds<std::invalid_argument>(missingError), "errors: missing file");
+		check(holds<std::runtime_error>(badError), "errors: invalid JSON");
+		check(holds<std::runtime_error>(missingBoneError), "errors: animation of a missing bone");
+		check(holds<std::invalid_argument>(atlasError), "errors: missing atlas");
+		delete skeletonData;
+		remove(badPath);
+		remove(missingBonePath);
+	}
+
+	// Destroying the loader with loads unfinished.
+	{
+		size_t bytes = getRuntimeBytes();
+		int callbackCount = 0;
+		{
+			IncrementalLoader loader;
+			loader.loadSkeletonData(&json, dir + "spineboy-skeleton.json", [&] (SkeletonData*, std::exception_ptr) {
+				callbackCount++;
+			});
+			loader.loadAtlas<TestAtlas>(dir + "spineboy.atlas", [&] (TestAtlas*, std::exception_ptr) {
+				callbackCount++;
+			});
+			for (int i = 0; i < 5; i++)
+				loader.step(0);
+			check(loader.getPendingCount() == 2, "destroyed: skeleton data finished in 5 steps");
+		}
+		check(!callbackCount, "destroyed: callbacks called");
+		check(!TestAtlas::getLiveCount(), "destroyed: atlas not deleted");
+		check(getRuntimeBytes() == bytes, "destroyed: skeleton data not deleted");
+	}
+
+	if (failures) return 1;
+	printf("OK: completions, errors and destroyed loads.\n");
+	return 0;
+}
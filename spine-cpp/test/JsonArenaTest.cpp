@@ -0,0 +1,160 @@
+/*******************************************************************************
+ * Copyright (c) 2013, Esoteric Software
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ******************************************************************************/
+
+/* Checks that Json::Reader::parse into a ValueArena reads the same values as parsing into the heap: the spineboy and generated
+ * documents compare equal and write the same text, repeated member names keep the last value, escaped member names are decoded,
+ * iteration visits members in name order, modifying the read-only containers throws, and errors are reported the same way.
+ *
+ * The optional argument is the directory containing spineboy-skeleton.json and spineboy-walk.json, by default
+ * ../spine-sfml/data/. */
+
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <json/reader.h>
+#include <json/value.h>
+#include <json/writer.h>
+#include "../benchmark/RigGenerator.h"
+#include "../benchmark/RigLoader.h"
+
+static int failures;
+
+static void check (bool condition, const std::string &message) {
+	if (condition) return;
+	printf("FAILED: %s\n", message.c_str());
+	failures++;
+}
+
+template<typename Op>
+static bool throws (Op op) {
+	try {
+		op();
+	} catch (const std::runtime_error &) {
+		return true;
+	}
+	return false;
+}
+
+/** Member names point into the text, so it must outlive root. */
+static bool parse (Json::Reader &reader, Json::ValueArena &arena, const char *text, Json::Value &root) {
+	return reader.parse(text, text + strlen(text), arena, root);
+}
+
+/** Parses the text both ways and checks that the results match. */
+static void compare (const std::string &name, const std::string &text) {
+	Json::Reader heapReader, arenaReader;
+	Json::Value heap, root;
+	Json::ValueArena arena;
+	bool heapParsed = heapReader.parse(text.data(), text.data() + text.size(), heap, false);
+	bool arenaParsed = parse(arenaReader, arena, text.c_str(), root);
+	check(heapParsed == arenaParsed, name + ": parsed differently");
+	check(heapReader.getFormatedErrorMessages() == arenaReader.getFormatedErrorMessages(), name + ": different errors");
+	if (!heapParsed || !arenaParsed) return;
+
+	check(heap == root && root == heap && !(heap < root) && !(root < heap), name + ": values differ");
+	Json::Value copy = root;
+	check(copy == root, name + ": copy differs");
+	Json::FastWriter writer;
+	check(writer.write(heap) == writer.write(root), name + ": written differently");
+}
+
+int main (int argc, char **argv) {
+	std::string dir = argc > 1 ? argv[1] : "../spine-sfml/data/";
+	if (dir[dir.size() - 1] != '/') dir += '/';
+
+	compare("spineboy-skeleton", readFile(dir + "spineboy-skeleton.json"));
+	compare("spineboy-walk", readFile(dir + "spineboy-walk.json"));
+	compare("generated", generateAnimation(40, 20, 3));
+	compare("values", "[1, -2, 3000000000, 2.5, 1e400, \"x\\n\\u00e9\", true, false, null, [], {}, [[{\"k\": [\"v\"]}]]]");
+	compare("members", "{\"b\": 1, \"a\": [1, 2], \"a\\u0041\": {\"z\": [], \"ab\": 1, \"a\": 2}, \"a\": 3, \"\": \"e\"}");
+	compare("string", "\"str\"");
+
+	Json::Reader reader;
+	Json::ValueArena arena;
+	Json::Value root;
+	const Json::Value &constRoot = root;
+
+	// Duplicate names.
+	check(parse(reader, arena, "{\"k\": 1, \"j\": 0, \"k\": {\"x\": 2}, \"k\": [3]}", root), "duplicates: not parsed");
+	check(root.size() == 2, "duplicates: repeated member not removed");
+	check(constRoot["k"].isArray() && constRoot["k"][0u].asInt() == 3, "duplicates: last member did not win");
+
+	// Escaped names are decoded, sorted and found like any other.
+	check(parse(reader, arena, "{\"a\\u0042\": 1, \"\\\"q\\\"\": 2, \"tab\\t\": 3, \"aA\": 4}", root), "escapes: not parsed");
+	check(constRoot["aB"].asInt() == 1 && constRoot["\"q\""].asInt() == 2 && constRoot["tab\t"].asInt() == 3,
+			"escapes: member not found by its decoded name");
+	check(constRoot.isMember("aA") && !constRoot.isMember("a\\u0042"), "escapes: member found by its escaped name");
+
+	// Iteration.
+	check(parse(reader, arena, "{\"c\": 3, \"a\": 1, \"b\": {\"d\": [4, 5]}}", root), "iteration: not parsed");
+	Json::Value::Members names = root.getMemberNames();
+	check(names.size() == 3 && names[0] == "a" && names[1] == "b" && names[2] == "c", "iteration: member names");
+	std::string keys;
+	int sum = 0;
+	for (Json::Value::const_iterator i = constRoot.begin(); i != constRoot.end(); ++i) {
+		keys += i.key().asString();
+		if ((*i).isInt()) sum += (*i).asInt();
+	}
+	check(keys == "abc" && sum == 4, "iteration: members not visited in name order");
+	const Json::Value &array = constRoot["b"]["d"];
+	sum = 0;
+	for (Json::Value::const_iterator i = array.begin(); i != array.end(); ++i)
+		sum += (*i).asInt();
+	check(array.size() == 2 && sum == 9, "iteration: array elements");
+	check(constRoot["missing"].isNull() && array[7u].isNull(), "iteration: missing members and elements are not null");
+
+	// Existing members and elements can be assigned values that don't own memory, nothing can be added or removed.
+	root["a"] = 7;
+	root["b"]["d"][1u] = true;
+	check(constRoot["a"].asInt() == 7 && array[1u].asBool(), "read-only: existing values not assigned");
+	check(throws([&] { root["missing"]; }), "read-only: adding a member didn't throw");
+	check(throws([&] { root["b"]["d"][2u]; }), "read-only: adding an element didn't throw");
+	check(throws([&] { root["b"]["d"].append(1); }), "read-only: append didn't throw");
+	check(throws([&] { root["b"]["d"].resize(1); }), "read-only: resize didn't throw");
+	check(throws([&] { root.removeMember("a"); }), "read-only: removeMember didn't throw");
+	check(throws([&] { root.clear(); }), "read-only: clear didn't throw");
+	check(root.size() == 3 && array.size() == 2, "read-only: size changed");
+
+	// A heap copy is independent of the arena.
+	Json::Value heapCopy;
+	heapCopy = root;
+	check(heapCopy == root, "copy: differs");
+
+	// Errors, including inside nested containers, don't leave values stacked for the next document.
+	const char *invalid[] = {"{\"x\": 1,}", "{\"x\" 1}", "[1, 2", "{\"a\": [1, {\"b\": }]}", "{\"a\\q\": 1}", ""};
+	for (int i = 0, n = sizeof(invalid) / sizeof(invalid[0]); i < n; i++) {
+		compare(std::string("invalid ") + invalid[i], invalid[i]);
+		check(!parse(reader, arena, invalid[i], root), std::string("errors: parsed ") + invalid[i]);
+		check(!reader.getFormatedErrorMessages().empty(), std::string("errors: no message for ") + invalid[i]);
+	}
+	check(parse(reader, arena, "{\"k\": [1, {\"j\": 2}]}", root), "errors: reader not reusable");
+	check(root.size() == 1 && constRoot["k"].size() == 2 && constRoot["k"][1u]["j"].asInt() == 2 && reader.getFormatedErrorMessages().empty(),
+			"errors: values left from the invalid documents");
+
+	if (failures) return 1;
+	printf("OK: arena parsing matches heap parsing, duplicates, escapes, iteration, read-only containers and errors.\n");
+	return 0;
+}
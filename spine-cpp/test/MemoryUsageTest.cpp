@@ -0,0 +1,113 @@
+/*******************************************************************************
+ * Copyright (c) 2013, Esoteric Software
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ******************************************************************************/
+
+/* Checks that the memoryUsage totals of spineboy's atlas, skeleton data, walk animation and a headless skeleton equal the bytes the
+ * allocator counted for them, summed over all allocation tags, and that deleting each returns those bytes.
+ *
+ * The optional argument is the directory containing spineboy-skeleton.json, spineboy-walk.json and spineboy.atlas, by default
+ * ../spine-sfml/data/. */
+
+#include <cstdio>
+#include <string>
+#include <spine/Allocator.h>
+#include <spine/Animation.h>
+#include <spine/BaseSkeletonJson.h>
+#include <spine/HeadlessAtlas.h>
+#include <spine/HeadlessAttachmentLoader.h>
+#include <spine/HeadlessSkeleton.h>
+#include <spine/MemoryUsage.h>
+#include <spine/SkeletonData.h>
+
+using namespace spine;
+
+static int failures;
+
+static void check (bool condition, const std::string &message) {
+	if (condition) return;
+	printf("FAILED: %s\n", message.c_str());
+	failures++;
+}
+
+static size_t getRuntimeBytes () {
+	size_t bytes = 0;
+	for (int i = 0; i < allocationTagCount; i++)
+		bytes += getAllocatedBytes((AllocationTag)i);
+	return bytes;
+}
+
+/** Checks that the usage accounts for exactly the bytes allocated since before. */
+static void checkUsage (const char *name, const MemoryUsage &usage, size_t before) {
+	size_t allocated = getRuntimeBytes() - before, total = usage.getTotalBytes();
+	char message[128];
+	snprintf(message, sizeof(message), "%s memoryUsage is %lu bytes, allocated %lu", name, (unsigned long)total,
+			(unsigned long)allocated);
+	check(total == allocated, message);
+	check(usage.bytes[objectMemory] != 0, std::string(name) + " has no object bytes");
+}
+
+int main (int argc, char **argv) {
+	std::string dir = argc > 1 ? argv[1] : "../spine-sfml/data/";
+	if (dir[dir.size() - 1] != '/') dir += '/';
+	BaseSkeletonJson json(new HeadlessAttachmentLoader());
+
+	size_t start = getRuntimeBytes();
+	HeadlessAtlas *atlas = new HeadlessAtlas(dir + "spineboy.atlas");
+	MemoryUsage atlasUsage = atlas->memoryUsage();
+	checkUsage("atlas", atlasUsage, start);
+	check(atlasUsage.bytes[stringMemory] != 0, "atlas has no string bytes");
+
+	size_t before = getRuntimeBytes();
+	SkeletonData *skeletonData = json.readSkeletonData(dir + "spineboy-skeleton.json");
+	checkUsage("skeleton data", skeletonData->memoryUsage(), before);
+
+	before = getRuntimeBytes();
+	Animation *walk = json.readAnimation(dir + "spineboy-walk.json", skeletonData);
+	MemoryUsage walkUsage = walk->memoryUsage();
+	checkUsage("walk", walkUsage, before);
+	check(walkUsage.bytes[keyframeMemory] && walkUsage.bytes[curveMemory], "walk has no keyframe or curve bytes");
+
+	// The skeleton's own usage is what it allocates. Its shared usage is the skeleton data's.
+	before = getRuntimeBytes();
+	HeadlessSkeleton *skeleton = new HeadlessSkeleton(skeletonData);
+	SkeletonMemoryUsage skeletonUsage = skeleton->memoryUsage();
+	checkUsage("skeleton", skeletonUsage.instance, before);
+	check(skeletonUsage.shared.getTotalBytes() == skeletonData->memoryUsage().getTotalBytes(),
+			"skeleton shared usage is not the skeleton data's");
+
+	// Deleting returns exactly what memoryUsage reported.
+	before = getRuntimeBytes();
+	delete skeleton;
+	check(before - getRuntimeBytes() == skeletonUsage.instance.getTotalBytes(), "deleting the skeleton freed other bytes");
+	before = getRuntimeBytes();
+	delete walk;
+	check(before - getRuntimeBytes() == walkUsage.getTotalBytes(), "deleting the walk freed other bytes");
+	delete skeletonData;
+	delete atlas;
+	check(getRuntimeBytes() == start, "bytes left after deleting everything");
+
+	if (failures) return 1;
+	printf("OK: memoryUsage matches the allocated bytes.\n");
+	return 0;
+}
@@ -0,0 +1,172 @@
+/*******************************************************************************
+ * Copyright (c) 2013, Esoteric Software
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ******************************************************************************/
+
+/* Checks that SkeletonPose rebuilds its indices when the skeleton's slots change, even at the same address with the same slot count,
+ * and rejects draw order slots that aren't the skeleton's. Then publishes 100k frames through a PoseBuffer on one thread while
+ * another acquires them, checking that every acquired pose is a complete frame, newer than the one before. Run it in a
+ * SPINE_SANITIZE_THREAD build to check the buffer under ThreadSanitizer. */
+
+#include <algorithm>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <spine/BaseSkeletonJson.h>
+#include <spine/Bone.h>
+#include <spine/HeadlessAttachmentLoader.h>
+#include <spine/HeadlessSkeleton.h>
+#include <spine/PoseBuffer.h>
+#include <spine/SkeletonData.h>
+#include <spine/SkeletonPose.h>
+#include <spine/Slot.h>
+#include "../benchmark/RigGenerator.h"
+
+using namespace spine;
+
+static const int FRAME_COUNT = 100000;
+
+static int failures;
+
+static void check (bool condition, const std::string &message) {
+	if (condition) return;
+	printf("FAILED: %s\n", message.c_str());
+	failures++;
+}
+
+static int boneIndex (const BaseSkeleton &skeleton, const Bone *bone) {
+	return std::find(skeleton.bones.begin(), skeleton.bones.end(), bone) - skeleton.bones.begin();
+}
+
+/** Returns true if each draw order entry has the index of its slot and of that slot's bone. */
+static bool indicesMatch (const SkeletonPose &pose, const BaseSkeleton &skeleton) {
+	if (pose.drawOrder.size() != skeleton.drawOrder.size()) return false;
+	for (int i = 0, n = pose.drawOrder.size(); i < n; i++) {
+		const SkeletonPose::SlotPose &slotPose = pose.drawOrder[i];
+		if (skeleton.slots[slotPose.slotIndex] != skeleton.drawOrder[i]) return false;
+		if (slotPose.boneIndex != boneIndex(skeleton, skeleton.drawOrder[i]->bone)) return false;
+	}
+	return true;
+}
+
+/** Sets everything the pose copies to the frame number, and rotates the draw order by it. */
+static void setFrame (BaseSkeleton &skeleton, int frame) {
+	float value = (float)frame;
+	skeleton.r = value;
+	for (int i = 0, n = skeleton.bones.size(); i < n; i++) {
+		skeleton.bones[i]->worldX = value;
+		skeleton.bones[i]->worldY = -value;
+	}
+	int slotCount = skeleton.slots.size();
+	for (int i = 0; i < slotCount; i++) {
+		Slot *slot = skeleton.slots[(i + frame) % slotCount];
+		slot->a = value;
+		skeleton.drawOrder[i] = slot;
+	}
+}
+
+/** Returns the frame of the pose, or -1 if the pose is not all from one frame. */
+static int poseFrame (const SkeletonPose &pose, const std::vector<int> &slotBoneIndices) {
+	float value = pose.r;
+	int frame = (int)value, slotCount = pose.drawOrder.size();
+	for (int i = 0, n = pose.bones.size(); i < n; i++)
+		if (pose.bones[i].worldX != value || pose.bones[i].worldY != -value) return -1;
+	for (int i = 0; i < slotCount; i++) {
+		const SkeletonPose::SlotPose &slotPose = pose.drawOrder[i];
+		if (slotPose.a != value || slotPose.slotIndex != (i + frame) % slotCount
+				|| slotPose.boneIndex != slotBoneIndices[slotPose.slotIndex]) return -1;
+	}
+	return frame;
+}
+
+int main () {
+	BaseSkeletonJson json(new HeadlessAttachmentLoader());
+	std::string skeletonJson = generateSkeleton(16);
+	SkeletonData *skeletonData = json.readSkeletonData(skeletonJson.data(), skeletonJson.data() + skeletonJson.length());
+
+	// Different slots at the same skeleton address with the same slot count must not reuse the previous indices.
+	{
+		HeadlessSkeleton skeleton(skeletonData), other(skeletonData);
+		SkeletonPose pose;
+		pose.capture(&skeleton);
+		check(indicesMatch(pose, skeleton), "indices after the first capture");
+		std::swap(skeleton.slots[0], skeleton.slots[1]);
+		std::swap(skeleton.slots[2], skeleton.slots[5]);
+		pose.capture(&skeleton);
+		check(indicesMatch(pose, skeleton), "stale indices after the slots changed");
+
+		Slot *first = skeleton.drawOrder[0];
+		skeleton.drawOrder[0] = other.slots[3];
+		bool thrown = false;
+		try {
+			pose.capture(&skeleton);
+		} catch (const std::invalid_argument &) {
+			thrown = true;
+		}
+		check(thrown, "draw order slot of another skeleton didn't throw");
+		skeleton.drawOrder[0] = first;
+		pose.capture(&skeleton);
+		check(indicesMatch(pose, skeleton), "indices after rejecting a draw order");
+	}
+
+	HeadlessSkeleton skeleton(skeletonData);
+	std::vector<int> slotBoneIndices;
+	for (int i = 0, n = skeleton.slots.size(); i < n; i++)
+		slotBoneIndices.push_back(boneIndex(skeleton, skeleton.slots[i]->bone));
+
+	PoseBuffer buffer;
+	int acquired = 0, inconsistent = 0, stale = 0, last = -1;
+	std::thread reader([&] () {
+		while (last < FRAME_COUNT - 1) {
+			if (!buffer.acquire()) {
+				std::this_thread::yield();
+				continue;
+			}
+			int frame = poseFrame(buffer.getReadPose(), slotBoneIndices);
+			if (frame < 0)
+				inconsistent++;
+			else if (frame <= last)
+				stale++;
+			else
+				last = frame;
+			acquired++;
+		}
+	});
+	for (int frame = 0; frame < FRAME_COUNT; frame++) {
+		setFrame(skeleton, frame);
+		buffer.publish(&skeleton);
+		std::this_thread::yield();
+	}
+	reader.join();
+	check(!inconsistent, "acquired poses mixed frames");
+	check(!stale, "acquired a pose older than the previous one");
+	check(last == FRAME_COUNT - 1, "the last published pose was not acquired");
+
+	delete skeletonData;
+
+	if (failures) return 1;
+	printf("OK: index rebuilding, and %d of %d frames acquired consistently.\n", acquired, FRAME_COUNT);
+	return 0;
+}
@@ -0,0 +1,169 @@
+/*******************************************************************************
+ * Copyright (c) 2013, Esoteric Software
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ******************************************************************************/
+
+/* Applies animations to many skeletons sharing SkeletonData, Animation and AnimationStateData on many threads and checks the
+ * results match a single threaded run. Skeletons of the generated rig use the red or blue skin and crossfade between animations
+ * with attachment timelines, so skins are read concurrently as well as bones and timelines. Configure with
+ * -DSPINE_SANITIZE_THREAD=ON to check for data races with ThreadSanitizer.
+ *
+ * The optional argument is the directory containing spineboy-skeleton.json and spineboy-walk.json, by default
+ * ../spine-sfml/data/. */
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <thread>
+#include <spine/Animation.h>
+#include <spine/AnimationState.h>
+#include <spine/AnimationStateData.h>
+#include <spine/BaseAttachmentLoader.h>
+#include <spine/BaseRegionAttachment.h>
+#include <spine/BaseSkeleton.h>
+#include <spine/BaseSkeletonJson.h>
+#include <spine/Bone.h>
+#include <spine/SkeletonData.h>
+#include <spine/Slot.h>
+#include "../benchmark/RigGenerator.h"
+#include "../benchmark/RigLoader.h"
+
+using namespace spine;
+
+static const int THREAD_COUNT = 8;
+static const int SKELETONS_PER_THREAD = 16;
+static const int FRAME_COUNT = 300;
+
+class TestRegionAttachment: public BaseRegionAttachment {
+public:
+	virtual void updateWorldVertices (Bone*) {
+	}
+
+	virtual void draw (Slot*) {
+	}
+};
+
+class TestAttachmentLoader: public BaseAttachmentLoader {
+public:
+	virtual Attachment* newAttachment (AttachmentType, const std::string&) {
+		return new TestRegionAttachment();
+	}
+};
+
+class TestSkeleton: public BaseSkeleton {
+public:
+	TestSkeleton (const SkeletonData *data) :
+					BaseSkeleton(data) {
+	}
+};
+
+struct Pose {
+	std::vector<float> values;
+	std::vector<const Attachment*> attachments;
+
+	bool operator== (const Pose &other) const {
+		return values == other.values && attachments == other.attachments;
+	}
+};
+
+/** Runs one skeleton for all frames, switching between the rig's animations, and stores its final pose. */
+static void run (const Rig *rig, int seed, Pose &pose) {
+	TestSkeleton skeleton(rig->skeletonData);
+	if (!rig->skins.empty()) {
+		skeleton.setSkin(rig->skins[seed % rig->skins.size()]);
+		skeleton.setSlotsToBindPose();
+	}
+	AnimationState state(rig->stateData);
+	int animationCount = rig->animations.size();
+	state.setAnimation(rig->animations[seed % animationCount], true);
+	float delta = 1 / 60.f + seed * 0.0001f;
+	for (int frame = 0; frame < FRAME_COUNT; frame++) {
+		if (frame % 40 == seed % 40) state.setAnimation(rig->animations[(seed + frame / 40) % animationCount], true);
+		skeleton.update(delta);
+		state.update(delta);
+		state.apply(&skeleton);
+		skeleton.updateWorldTransform();
+	}
+	pose.values.clear();
+	pose.attachments.clear();
+	for (int i = 0, n = skeleton.bones.size(); i < n; i++) {
+		Bone *bone = skeleton.bones[i];
+		pose.values.push_back(bone->worldX);
+		pose.values.push_back(bone->worldY);
+		pose.values.push_back(bone->worldRotation);
+	}
+	for (int i = 0, n = skeleton.slots.size(); i < n; i++) {
+		Slot *slot = skeleton.slots[i];
+		pose.values.push_back(slot->r);
+		pose.values.push_back(slot->a);
+		pose.attachments.push_back(slot->attachment);
+	}
+}
+
+int main (int argc, char **argv) {
+	std::string dir = argc > 1 ? argv[1] : "../spine-sfml/data/";
+
+	if (dir[dir.size() - 1] != '/') dir += '/';
+
+	BaseSkeletonJson json(new TestAttachmentLoader());
+	std::string spineboy = readFile(dir + "spineboy-skeleton.json"), walk = readFile(dir + "spineboy-walk.json");
+	if (spineboy.empty() || walk.empty()) {
+		printf("FAILED: Unable to read spineboy from %s\n", dir.c_str());
+		return 1;
+	}
+	std::vector<Rig*> rigs;
+	rigs.push_back(loadRig(json, "spineboy", spineboy, std::vector<std::string>(1, walk), 0));
+	std::vector<std::string> animations;
+	for (int seed = 0; seed < 3; seed++)
+		animations.push_back(generateAnimation(40, 24, seed));
+	rigs.push_back(loadRig(json, "generated-40", generateSkeleton(40), animations, 0.3f));
+
+	int skeletonCount = THREAD_COUNT * SKELETONS_PER_THREAD;
+	std::vector<Pose> expected(skeletonCount), actual(skeletonCount);
+	for (int i = 0; i < skeletonCount; i++)
+		run(rigs[i % 2], i, expected[i]);
+
+	std::vector<std::thread> threads;
+	for (int t = 0; t < THREAD_COUNT; t++) {
+		threads.push_back(std::thread([&rigs, &actual, t] () {
+			for (int i = t * SKELETONS_PER_THREAD, n = i + SKELETONS_PER_THREAD; i < n; i++)
+				run(rigs[i % 2], i, actual[i]);
+		}));
+	}
+	for (int t = 0; t < THREAD_COUNT; t++)
+		threads[t].join();
+
+	int failures = 0;
+	for (int i = 0; i < skeletonCount; i++)
+		if (!(actual[i] == expected[i])) failures++;
+
+	for (int i = 0, n = rigs.size(); i < n; i++)
+		disposeRig(rigs[i]);
+
+	if (failures) {
+		printf("FAILED: %d of %d skeletons differ from the single threaded run.\n", failures, skeletonCount);
+		return 1;
+	}
+	printf("OK: %d skeletons on %d threads.\n", skeletonCount, THREAD_COUNT);
+	return 0;
+}
@@ -0,0 +1,217 @@
+/*******************************************************************************
+ * Copyright (c) 2013, Esoteric Software
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ******************************************************************************/
+
+/* Checks that a StreamingAnimation written from an animation is stored little endian and applies the same poses, keeps only its
+ * window of chunks resident as it slides, wraps the window when looping, decodes seeked chunks and evicts the others, and rejects
+ * truncated files, bad bone and slot indices, and skeletons without the bones and slots it animates.
+ *
+ * The streaming animation is written to the working directory. */
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <spine/Animation.h>
+#include <spine/BaseSkeletonJson.h>
+#include <spine/Bone.h>
+#include <spine/HeadlessAttachmentLoader.h>
+#include <spine/HeadlessSkeleton.h>
+#include <spine/SkeletonData.h>
+#include <spine/Slot.h>
+#include <spine/StreamingAnimation.h>
+#include "../benchmark/RigGenerator.h"
+
+using namespace spine;
+
+static const int BONE_COUNT = 10;
+static const float CHUNK_DURATION = 0.25f;
+static const char* const PATH = "StreamingAnimationTest.stream";
+
+static int failures;
+
+static void check (bool condition, const std::string &message) {
+	if (condition) return;
+	printf("FAILED: %s\n", message.c_str());
+	failures++;
+}
+
+static unsigned int readWord (const std::string &data, size_t offset) {
+	const unsigned char *bytes = reinterpret_cast<const unsigned char*>(data.data() + offset);
+	return bytes[0] | bytes[1] << 8 | bytes[2] << 16 | (unsigned int)bytes[3] << 24;
+}
+
+static void writeWord (std::string &data, size_t offset, unsigned int word) {
+	for (int i = 0; i < 4; i++)
+		data[offset + i] = (char)(word >> i * 8);
+}
+
+static void writeFile (const std::string &data) {
+	std::ofstream file(PATH, std::ios::out | std::ios::binary);
+	file.write(data.data(), data.length());
+}
+
+/** The middle of the chunk. */
+static float chunkTime (int chunk) {
+	return (chunk + 0.5f) * CHUNK_DURATION;
+}
+
+/** Returns true if applying the animation at the time throws. */
+static bool applyThrows (StreamingAnimation &animation, BaseSkeleton &skeleton, float time) {
+	try {
+		animation.apply(&skeleton, time);
+	} catch (const std::exception &) {
+		return true;
+	}
+	return false;
+}
+
+/** Returns true if opening the file or decoding any of its chunks throws. */
+static bool rejected (int chunkCount) {
+	try {
+		StreamingAnimation animation(PATH, 1);
+		for (int i = 0; i < chunkCount; i++)
+			animation.prefetch(chunkTime(i));
+	} catch (const std::runtime_error &) {
+		return true;
+	}
+	return false;
+}
+
+static bool samePose (const BaseSkeleton &a, const BaseSkeleton &b) {
+	for (int i = 0, n = a.bones.size(); i < n; i++) {
+		const Bone *x = a.bones[i], *y = b.bones[i];
+		if (x->x != y->x || x->y != y->y || x->rotation != y->rotation || x->scaleX != y->scaleX || x->scaleY != y->scaleY)
+			return false;
+	}
+	for (int i = 0, n = a.slots.size(); i < n; i++) {
+		const Slot *x = a.slots[i], *y = b.slots[i];
+		if (x->r != y->r || x->g != y->g || x->b != y->b || x->a != y->a || x->attachment != y->attachment) return false;
+	}
+	return true;
+}
+
+int main () {
+	BaseSkeletonJson json(new HeadlessAttachmentLoader());
+	std::string skeleton = generateSkeleton(BONE_COUNT), smallSkeleton = generateSkeleton(BONE_COUNT / 2);
+	SkeletonData *skeletonData = json.readSkeletonData(skeleton.data(), skeleton.data() + skeleton.length());
+	SkeletonData *smallSkeletonData = json.readSkeletonData(smallSkeleton.data(), smallSkeleton.data() + smallSkeleton.length());
+	std::string animationJson = generateAnimation(BONE_COUNT, 61, 1);
+	Animation *animation = json.readAnimation(animationJson.data(), animationJson.data() + animationJson.length(), skeletonData);
+
+	std::ostringstream output;
+	StreamingAnimation::write(output, *animation, CHUNK_DURATION);
+	std::string data = output.str();
+	int chunkCount = readWord(data, 8);
+	check(readWord(data, 4) == 1 && chunkCount == 8, "header is not stored little endian");
+	writeFile(data);
+
+	// The same poses as the animation, with at most the window resident.
+	{
+		StreamingAnimation streaming(PATH, 2);
+		check(streaming.getChunkCount() == chunkCount && streaming.getChunkDuration() == CHUNK_DURATION, "chunk index");
+		check(streaming.duration == animation->duration, "duration");
+		HeadlessSkeleton expected(skeletonData), actual(skeletonData);
+		expected.setSkin("red");
+		actual.setSkin("red");
+		for (float time = 0; time < animation->duration + 0.1f; time += 1 / 60.f) {
+			streaming.prefetch(time);
+			animation->apply(&expected, time);
+			streaming.apply(&actual, time);
+			if (!samePose(expected, actual)) {
+				check(false, "pose differs from the animation");
+				break;
+			}
+			if (streaming.getResidentChunkCount() > 2) {
+				check(false, "more chunks resident than the window");
+				break;
+			}
+		}
+	}
+
+	// The window slides with prefetch and wraps when looping. Without the file, only resident chunks can be applied.
+	{
+		StreamingAnimation streaming(PATH, 2);
+		HeadlessSkeleton skeleton(skeletonData);
+		check(!streaming.getResidentChunkCount(), "chunks resident before prefetch");
+		streaming.prefetch(chunkTime(0));
+		streaming.prefetch(chunkTime(3));
+		check(streaming.getResidentChunkCount() == 2, "window size after sliding");
+		std::remove(PATH);
+		check(!applyThrows(streaming, skeleton, chunkTime(3)) && !applyThrows(streaming, skeleton, chunkTime(4)),
+				"window chunks not resident after sliding");
+		check(applyThrows(streaming, skeleton, chunkTime(0)), "chunk behind the window still resident");
+		writeFile(data);
+
+		streaming.prefetch(chunkTime(chunkCount - 1), true);
+		check(streaming.getResidentChunkCount() == 2, "window size after wrapping");
+		std::remove(PATH);
+		check(!applyThrows(streaming, skeleton, chunkTime(chunkCount - 1)) && !applyThrows(streaming, skeleton, chunkTime(0)),
+				"window did not wrap to the first chunk when looping");
+		check(applyThrows(streaming, skeleton, chunkTime(1)), "chunk after the wrapped window resident");
+		writeFile(data);
+	}
+
+	// Seeking decodes the chunk and evicts those outside the window from it.
+	{
+		StreamingAnimation streaming(PATH, 1);
+		HeadlessSkeleton skeleton(skeletonData);
+		streaming.apply(&skeleton, chunkTime(2));
+		streaming.apply(&skeleton, chunkTime(5));
+		check(streaming.getResidentChunkCount() == 1, "seeking kept chunks outside the window");
+	}
+
+	// Applying to a skeleton without the animated bones and slots throws instead of indexing past them.
+	{
+		StreamingAnimation streaming(PATH, 2);
+		HeadlessSkeleton small(smallSkeletonData);
+		check(applyThrows(streaming, small, chunkTime(0)), "applying to a smaller skeleton didn't throw");
+	}
+
+	for (size_t length = 0; length < data.length(); length += length < 200 ? 3 : 499) {
+		writeFile(data.substr(0, length));
+		std::ostringstream message;
+		message << "truncated to " << length << " bytes was read";
+		check(rejected(chunkCount), message.str());
+	}
+	// The first timeline's index follows the first chunk's timeline count and the timeline's type.
+	std::string corrupt = data;
+	writeWord(corrupt, readWord(data, 20) + 8, (unsigned int)-5);
+	writeFile(corrupt);
+	check(rejected(chunkCount), "negative bone index was read");
+	corrupt = data;
+	writeWord(corrupt, 0, 0);
+	writeFile(corrupt);
+	check(rejected(chunkCount), "bad magic was read");
+
+	std::remove(PATH);
+	delete animation;
+	delete smallSkeletonData;
+	delete skeletonData;
+
+	if (failures) return 1;
+	printf("OK: poses, window sliding, wrapping, seeking, eviction and corrupt files.\n");
+	return 0;
+}
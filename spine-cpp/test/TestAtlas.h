@@ -0,0 +1,67 @@
+/*******************************************************************************
+ * Copyright (c) 2013, Esoteric Software
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ******************************************************************************/
+
+#ifndef SPINE_TESTATLAS_H_
+#define SPINE_TESTATLAS_H_
+
+#include <spine/BaseAtlas.h>
+
+/** An atlas without textures that counts the textures it loads and its live instances. It has the constructor the loaders
+ * require. */
+class TestAtlas: public spine::BaseAtlas {
+public:
+	int textureCount;
+
+	TestAtlas (const char *begin, const char *end, bool deferTextures) :
+					BaseAtlas(deferTextures),
+					textureCount(0) {
+		load(begin, end);
+		getLiveCount()++;
+	}
+
+	virtual ~TestAtlas () {
+		getLiveCount()--;
+	}
+
+	static int& getLiveCount () {
+		static int liveCount;
+		return liveCount;
+	}
+
+private:
+	virtual void loadTexture (spine::BaseAtlasPage*) {
+		textureCount++;
+	}
+
+	virtual spine::BaseAtlasPage* newAtlasPage (const std::string&) {
+		return new spine::BaseAtlasPage();
+	}
+
+	virtual spine::BaseAtlasRegion* newAtlasRegion (spine::BaseAtlasPage*) {
+		return new spine::BaseAtlasRegion();
+	}
+};
+
+#endif /* SPINE_TESTATLAS_H_ */
@@ -0,0 +1,152 @@
+/*******************************************************************************
+ * Copyright (c) 2013, Esoteric Software
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ******************************************************************************/
+
+/* Checks that once warmed up, a frame of AnimationState update and apply, updateWorldTransform and draw doesn't touch the heap.
+ * CountingNew.cpp replaces global operator new to pass every allocation to an AllocationAudit, so standard library allocations
+ * are caught as well as runtime ones. Skeletons crossfade between animations with attachment timelines, including attachment
+ * names too long for a std::string to store inline.
+ *
+ * The optional argument is the directory containing spineboy-skeleton.json and spineboy-walk.json, by default
+ * ../spine-sfml/data/. */
+
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <spine/Allocator.h>
+#include <spine/Animation.h>
+#include <spine/AnimationState.h>
+#include <spine/AnimationStateData.h>
+#include <spine/BaseSkeletonJson.h>
+#include <spine/HeadlessAttachmentLoader.h>
+#include <spine/HeadlessSkeleton.h>
+#include <spine/SkeletonData.h>
+#include "../benchmark/CountingNew.h"
+#include "../benchmark/RigLoader.h"
+
+using namespace spine;
+
+static const int WARMUP_FRAMES = 120;
+static const int FRAME_COUNT = 600;
+static const char* const PHASES[] = {"update", "apply", "updateWorldTransform", "draw"};
+
+/** Two bones whose slots switch between attachments with long names. */
+static const char* const LONG_NAMES_SKELETON = "{"
+	"\"bones\": [ { \"name\": \"root\" }, { \"name\": \"arm\", \"parent\": \"root\", \"length\": 20, \"rotation\": 30 } ],"
+	"\"slots\": ["
+	"	{ \"name\": \"body\", \"bone\": \"root\", \"attachment\": \"body-with-a-long-attachment-name\" },"
+	"	{ \"name\": \"arm\", \"bone\": \"arm\", \"attachment\": \"arm-with-a-long-attachment-name-open\" }"
+	"],"
+	"\"skins\": { \"default\": {"
+	"	\"body\": {"
+	"		\"body-with-a-long-attachment-name\": { \"width\": 20, \"height\": 40 },"
+	"		\"body-with-a-long-attachment-name-hurt\": { \"width\": 20, \"height\": 40 }"
+	"	},"
+	"	\"arm\": {"
+	"		\"arm-with-a-long-attachment-name-open\": { \"width\": 10, \"height\": 20 },"
+	"		\"arm-with-a-long-attachment-name-closed\": { \"width\": 10, \"height\": 20 }"
+	"	}"
+	"} }"
+	"}";
+
+static std::string longNamesAnimation (const char *suffix) {
+	std::ostringstream json;
+	json << "{ \"bones\": { \"arm\": { \"rotate\": [ { \"time\": 0, \"angle\": 0 }, { \"time\": 0.5, \"angle\": 90 }, "
+			"{ \"time\": 1, \"angle\": 0 } ] } }, \"slots\": { "
+			"\"body\": { \"attachment\": [ { \"time\": 0, \"name\": \"body-with-a-long-attachment-name\" }, "
+			"{ \"time\": 0.5, \"name\": \"body-with-a-long-attachment-name-hurt\" } ] }, "
+			"\"arm\": { \"attachment\": [ { \"time\": 0.25, \"name\": \"arm-with-a-long-attachment-name-" << suffix << "\" }, "
+			"{ \"time\": 0.75, \"name\": null } ] } } }";
+	return json.str();
+}
+
+int main (int argc, char **argv) {
+	std::string dir = argc > 1 ? argv[1] : "../spine-sfml/data/";
+	if (dir[dir.size() - 1] != '/') dir += '/';
+
+	BaseSkeletonJson json(new HeadlessAttachmentLoader());
+	std::vector<Rig*> rigs;
+	std::string spineboy = readFile(dir + "spineboy-skeleton.json"), walk = readFile(dir + "spineboy-walk.json");
+	if (spineboy.empty() || walk.empty()) {
+		printf("FAILED: Unable to read spineboy from %s\n", dir.c_str());
+		return 1;
+	}
+	rigs.push_back(loadRig(json, "spineboy", spineboy, std::vector<std::string>(2, walk), 0.3f));
+	std::vector<std::string> animations;
+	animations.push_back(longNamesAnimation("open"));
+	animations.push_back(longNamesAnimation("closed"));
+	rigs.push_back(loadRig(json, "long names", LONG_NAMES_SKELETON, animations, 0.3f));
+
+	std::vector<HeadlessSkeleton*> skeletons;
+	std::vector<AnimationState*> states;
+	for (int i = 0; i < 8; i++) {
+		Rig *rig = rigs[i % rigs.size()];
+		skeletons.push_back(new HeadlessSkeleton(rig->skeletonData));
+		states.push_back(new AnimationState(rig->stateData));
+		states.back()->setAnimation(rig->animations[0], true);
+	}
+
+	int failures = 0;
+	{
+		AllocationAudit audit;
+		for (int frame = 0; frame < WARMUP_FRAMES + FRAME_COUNT; frame++) {
+			if (frame == WARMUP_FRAMES) audit.reset();
+			for (int i = 0, n = skeletons.size(); i < n; i++) {
+				HeadlessSkeleton *skeleton = skeletons[i];
+				AnimationState *state = states[i];
+				Rig *rig = rigs[i % rigs.size()];
+				audit.setPhase("update");
+				// Crossfade to the other animation every so often, so mixing is part of the steady state.
+				if (frame % 45 == i * 5) state->setAnimation(rig->animations[frame / 45 % 2], true);
+				skeleton->update(1 / 60.f);
+				state->update(1 / 60.f);
+				audit.setPhase("apply");
+				state->apply(skeleton);
+				audit.setPhase("updateWorldTransform");
+				skeleton->updateWorldTransform();
+				audit.setPhase("draw");
+				skeleton->draw();
+				audit.setPhase("");
+			}
+		}
+		for (int i = 0; i < 4; i++) {
+			if (!audit.getAllocationCount(PHASES[i])) continue;
+			printf("FAILED: %s allocated %lu times (%lu bytes) in %d frames.\n", PHASES[i],
+					(unsigned long)audit.getAllocationCount(PHASES[i]), (unsigned long)audit.getAllocatedBytes(PHASES[i]), FRAME_COUNT);
+			failures++;
+		}
+	}
+
+	for (int i = 0, n = skeletons.size(); i < n; i++) {
+		delete skeletons[i];
+		delete states[i];
+	}
+	for (int i = 0, n = rigs.size(); i < n; i++)
+		disposeRig(rigs[i]);
+
+	if (failures) return 1;
+	printf("OK: %d skeletons for %d frames without allocating.\n", (int)skeletons.size(), FRAME_COUNT);
+	return 0;
+}
@@ -3,7 +3,6 @@
 #include <spine/extension.h>
 #include <spine/util.h>
 #include <SFML/Graphics/Vertex.hpp>
-#include <SFML/Graphics/VertexArray.hpp>
 #include <SFML/Graphics/Texture.hpp>
 #include <SFML/Graphics/RenderTarget.hpp>
 #include <SFML/Graphics/RenderStates.hpp>
@@ -14,7 +13,7 @@ using sf::RenderStates;
 using sf::Texture;
 using sf::Uint8;
 using sf::Vertex;
-using sf::VertexArray;
+using std::vector;
 
 namespace spine {
 
@@ -42,7 +41,6 @@ void _SfmlSkeleton_dispose (Skeleton* skeleton) {
 	SfmlSkeleton* self = (SfmlSkeleton*)skeleton;
 	_Skeleton_deinit(&self->super);
 
-	delete self->vertexArray;
 	delete self->drawable;
 
 	FREE(self)
@@ -54,7 +52,6 @@ Skeleton* Skeleton_create (SkeletonData* data) {
 	self->super._dispose = _SfmlSkeleton_dispose;
 
 	self->drawable = new SkeletonDrawable(&self->super);
-	self->vertexArray = new VertexArray(Quads, data->boneCount * 4);
 
 	return &self->super;
 }
@@ -68,12 +65,129 @@ SkeletonDrawable::SkeletonDrawable (Skeleton* self) {
 }
 
 void SkeletonDrawable::draw (RenderTarget& target, RenderStates states) const {
-	skeleton->vertexArray->clear();
-	for (int i = 0; i < skeleton->super.slotCount; ++i)
-		if (skeleton->super.slots[i]->attachment) ; //skeleton->slots[i]->attachment->draw(slots[i]);
-	// BOZO - Draw the slots!
-	states.texture = skeleton->texture;
-	target.draw(*skeleton->vertexArray, states);
+	vertices.clear();
+	states.texture = 0;
+	Vertex quad[4];
+	for (int i = 0; i < skeleton->super.slotCount; ++i) {
+		const Slot* slot = skeleton->super.drawOrder[i];
+		const Attachment* attachment = slot->attachment;
+		if (!attachment || attachment->type != ATTACHMENT_REGION) continue;
+		const SfmlRegionAttachment* regionAttachment = (const SfmlRegionAttachment*)attachment;
+		if (regionAttachment->texture != states.texture) {
+			// Draw what is on the previous page before starting the next, so later slots are drawn over earlier ones.
+			if (!vertices.empty()) target.draw(&vertices[0], vertices.size(), Quads, states);
+			vertices.clear();
+			states.texture = regionAttachment->texture;
+		}
+		SfmlRegionAttachment_computeVertices(regionAttachment, slot, quad);
+		vertices.insert(vertices.end(), quad, quad + 4);
+	}
+	if (!vertices.empty()) target.draw(&vertices[0], vertices.size(), Quads, states);
+}
+
+/**/
+
+static bool equals (const Vertex& a, const Vertex& b) {
+	return a.position.x == b.position.x && a.position.y == b.position.y && a.color == b.color && a.texCoords.x == b.texCoords.x
+			&& a.texCoords.y == b.texCoords.y;
+}
+
+SkeletonBatch::Page::Page (const Texture* texture) :
+		texture(texture), vertexCount(0), dirtyStart(0), dirtyEnd(0)
+#ifdef SPINE_SFML_VERTEX_BUFFER
+				, buffer(Quads, sf::VertexBuffer::Stream)
+#endif
+{
+}
+
+void SkeletonBatch::Page::add (const Vertex* newVertices, int count) {
+	for (int i = 0; i < count; ++i, ++vertexCount) {
+		if (vertexCount < vertices.size()) {
+			if (equals(vertices[vertexCount], newVertices[i])) continue;
+			vertices[vertexCount] = newVertices[i];
+		} else
+			vertices.push_back(newVertices[i]);
+		if (dirtyStart == dirtyEnd) dirtyStart = vertexCount;
+		dirtyEnd = vertexCount + 1;
+	}
+}
+
+void SkeletonBatch::Page::upload () {
+#ifdef SPINE_SFML_VERTEX_BUFFER
+	if (buffer.getVertexCount() < vertexCount) {
+		// Grow to the capacity of the vertices so the buffer isn't recreated every time a skeleton is added.
+		buffer.create(vertices.capacity());
+		buffer.update(&vertices[0], vertices.size(), 0);
+	} else if (dirtyStart < dirtyEnd) {
+		if (dirtyEnd > vertexCount) dirtyEnd = vertexCount;
+		if (dirtyStart < dirtyEnd) buffer.update(&vertices[dirtyStart], dirtyEnd - dirtyStart, dirtyStart);
+	}
+#endif
+	dirtyStart = dirtyEnd = 0;
+}
+
+SkeletonBatch::SkeletonBatch () :
+		lastPage(0) {
+}
+
+SkeletonBatch::~SkeletonBatch () {
+	for (size_t i = 0; i < pages.size(); ++i)
+		delete pages[i];
+}
+
+void SkeletonBatch::clear () {
+	for (size_t i = 0; i < pages.size(); ++i)
+		pages[i]->vertexCount = 0;
+}
+
+SkeletonBatch::Page* SkeletonBatch::getPage (const Texture* texture) {
+	// Consecutive attachments are usually on the same page.
+	if (lastPage && lastPage->texture == texture) return lastPage;
+	for (size_t i = 0; i < pages.size(); ++i) {
+		if (pages[i]->texture == texture) {
+			lastPage = pages[i];
+			return lastPage;
+		}
+	}
+	lastPage = new Page(texture);
+	pages.push_back(lastPage);
+	return lastPage;
+}
+
+void SkeletonBatch::add (const Skeleton* skeleton) {
+	Vertex vertices[4];
+	for (int i = 0; i < skeleton->slotCount; ++i) {
+		const Slot* slot = skeleton->drawOrder[i];
+		const Attachment* attachment = slot->attachment;
+		if (!attachment || attachment->type != ATTACHMENT_REGION) continue;
+		const SfmlRegionAttachment* regionAttachment = (const SfmlRegionAttachment*)attachment;
+		SfmlRegionAttachment_computeVertices(regionAttachment, slot, vertices);
+		getPage(regionAttachment->texture)->add(vertices, 4);
+	}
+}
+
+void SkeletonBatch::draw (RenderTarget& target, RenderStates states) const {
+	for (size_t i = 0; i < pages.size(); ++i) {
+		Page* page = pages[i];
+		if (!page->vertexCount) continue;
+		states.texture = page->texture;
+#ifdef SPINE_SFML_VERTEX_BUFFER
+		if (sf::VertexBuffer::isAvailable()) {
+			page->upload();
+			target.draw(page->buffer, 0, page->vertexCount, states);
+			continue;
+		}
+#endif
+		page->dirtyStart = page->dirtyEnd = 0;
+		target.draw(&page->vertices[0], page->vertexCount, Quads, states);
+	}
+}
+
+int SkeletonBatch::getPageCount () const {
+	int count = 0;
+	for (size_t i = 0; i < pages.size(); ++i)
+		if (pages[i]->vertexCount) count++;
+	return count;
 }
 
 /**/
@@ -116,47 +230,23 @@ RegionAttachment* RegionAttachment_create (const char* name, AtlasRegion* region
 	return &self->super;
 }
 
-void _RegionAttachment_draw (SfmlRegionAttachment* self, Slot* slot) {
-	SfmlSkeleton* skeleton = (SfmlSkeleton*)slot->skeleton;
-	Uint8 r = skeleton->super.r * slot->r * 255;
-	Uint8 g = skeleton->super.g * slot->g * 255;
-	Uint8 b = skeleton->super.b * slot->b * 255;
-	Uint8 a = skeleton->super.a * slot->a * 255;
-	sf::Vertex* vertices = self->vertices;
-	vertices[0].color.r = r;
-	vertices[0].color.g = g;
-	vertices[0].color.b = b;
-	vertices[0].color.a = a;
-	vertices[1].color.r = r;
-	vertices[1].color.g = g;
-	vertices[1].color.b = b;
-	vertices[1].color.a = a;
-	vertices[2].color.r = r;
-	vertices[2].color.g = g;
-	vertices[2].color.b = b;
-	vertices[2].color.a = a;
-	vertices[3].color.r = r;
-	vertices[3].color.g = g;
-	vertices[3].color.b = b;
-	vertices[3].color.a = a;
-
-	float* offset = self->super.offset;
-	Bone* bone = slot->bone;
-	vertices[0].position.x = offset[0] * bone->m00 + offset[1] * bone->m01 + bone->worldX;
-	vertices[0].position.y = offset[0] * bone->m10 + offset[1] * bone->m11 + bone->worldY;
-	vertices[1].position.x = offset[2] * bone->m00 + offset[3] * bone->m01 + bone->worldX;
-	vertices[1].position.y = offset[2] * bone->m10 + offset[3] * bone->m11 + bone->worldY;
-	vertices[2].position.x = offset[4] * bone->m00 + offset[5] * bone->m01 + bone->worldX;
-	vertices[2].position.y = offset[4] * bone->m10 + offset[5] * bone->m11 + bone->worldY;
-	vertices[3].position.x = offset[6] * bone->m00 + offset[7] * bone->m01 + bone->worldX;
-	vertices[3].position.y = offset[6] * bone->m10 + offset[7] * bone->m11 + bone->worldY;
-
-	// SMFL doesn't handle batching for us, so we'll just force a single texture per skeleton.
-	skeleton->texture = self->texture;
-	skeleton->vertexArray->append(vertices[0]);
-	skeleton->vertexArray->append(vertices[1]);
-	skeleton->vertexArray->append(vertices[2]);
-	skeleton->vertexArray->append(vertices[3]);
+void SfmlRegionAttachment_computeVertices (const SfmlRegionAttachment* self, const Slot* slot, Vertex* vertices) {
+	const Skeleton* skeleton = slot->skeleton;
+	Uint8 r = skeleton->r * slot->r * 255;
+	Uint8 g = skeleton->g * slot->g * 255;
+	Uint8 b = skeleton->b * slot->b * 255;
+	Uint8 a = skeleton->a * slot->a * 255;
+	sf::Color color(r, g, b, a);
+
+	const float* offset = self->super.offset;
+	const Bone* bone = slot->bone;
+	for (int i = 0; i < 4; ++i) {
+		float x = offset[i * 2], y = offset[i * 2 + 1];
+		vertices[i].position.x = x * bone->m00 + y * bone->m01 + bone->worldX;
+		vertices[i].position.y = x * bone->m10 + y * bone->m11 + bone->worldY;
+		vertices[i].color = color;
+		vertices[i].texCoords = self->vertices[i].texCoords;
+	}
 }
 
 }
@@ -1,6 +1,18 @@
+#ifndef SPINE_SFML_H_
+#define SPINE_SFML_H_
+
 #include <spine/spine.h>
+#include <SFML/Config.hpp>
+#include <SFML/Graphics/Drawable.hpp>
 #include <SFML/Graphics/Vertex.hpp>
-#include <SFML/Graphics/VertexArray.hpp>
+#include <SFML/Graphics/Texture.hpp>
+#include <vector>
+
+/* sf::VertexBuffer was added in SFML 2.5. Without it, vertices are sent to the GPU every draw. */
+#if SFML_VERSION_MAJOR > 2 || (SFML_VERSION_MAJOR == 2 && SFML_VERSION_MINOR >= 5)
+#define SPINE_SFML_VERTEX_BUFFER
+#include <SFML/Graphics/VertexBuffer.hpp>
+#endif
 
 namespace spine {
 
@@ -11,15 +23,66 @@ typedef struct {
 
 /**/
 
+/* Collects the region attachments of any number of skeletons into one vertex buffer per texture, so they are drawn with one draw
+ * call per atlas page. Attachments are grouped by page, so draw order is only kept between attachments on the same page. Use a
+ * SkeletonDrawable for a skeleton whose attachments on different pages overlap.
+ *
+ * Vertices are kept between frames. Only the range that changed since the last draw is uploaded, so skeletons that are added in
+ * the same order each frame and don't move cost little more than the comparison. */
+class SkeletonBatch: public sf::Drawable {
+public:
+	SkeletonBatch ();
+	virtual ~SkeletonBatch ();
+
+	/* Removes all skeletons, keeping the vertices from the last draw to compare against. Call before adding each frame. */
+	void clear ();
+
+	/* Adds the skeleton's region attachments using its current world transform. */
+	void add (const Skeleton* skeleton);
+
+	virtual void draw (sf::RenderTarget& target, sf::RenderStates states) const;
+
+	/* Returns the number of draw calls the next draw will make. */
+	int getPageCount () const;
+
+private:
+	struct Page {
+		const sf::Texture* texture;
+		std::vector<sf::Vertex> vertices;
+		/* The vertices added since the last clear. */
+		size_t vertexCount;
+		/* The range of vertices that differ from what was last uploaded. */
+		size_t dirtyStart, dirtyEnd;
+#ifdef SPINE_SFML_VERTEX_BUFFER
+		sf::VertexBuffer buffer;
+#endif
+
+		Page (const sf::Texture* texture);
+
+		void add (const sf::Vertex* vertices, int count);
+		void upload ();
+	};
+
+	std::vector<Page*> pages;
+	Page* lastPage;
+
+	Page* getPage (const sf::Texture* texture);
+
+	SkeletonBatch (const SkeletonBatch&);
+	SkeletonBatch& operator= (const SkeletonBatch&);
+};
+
+/**/
+
 class SkeletonDrawable;
 
 typedef struct {
 	Skeleton super;
-	sf::VertexArray* vertexArray;
-	sf::Texture* texture; // All region attachments must use the same texture.
 	SkeletonDrawable* drawable;
 } SfmlSkeleton;
 
+/* Draws a single skeleton in draw order, making a new draw call each time the next attachment is on a different page. To draw
+ * many skeletons with fewer draw calls, add them to a SkeletonBatch instead. */
 class SkeletonDrawable: public sf::Drawable {
 public:
 	SfmlSkeleton* skeleton;
@@ -27,6 +90,10 @@ public:
 	SkeletonDrawable (Skeleton* skeleton);
 
 	virtual void draw (sf::RenderTarget& target, sf::RenderStates states) const;
+
+private:
+	/* The vertices for the current page, kept to avoid allocating each draw. */
+	mutable std::vector<sf::Vertex> vertices;
 };
 
 SkeletonDrawable& Skeleton_getDrawable (const Skeleton* skeleton);
@@ -39,4 +106,9 @@ typedef struct {
 	sf::Texture* texture;
 } SfmlRegionAttachment;
 
+/* Computes the attachment's 4 vertices for the slot, using the bone's world transform and the skeleton and slot colors. */
+void SfmlRegionAttachment_computeVertices (const SfmlRegionAttachment* attachment, const Slot* slot, sf::Vertex* vertices);
+
 }
+
+#endif /* SPINE_SFML_H_ */